@@ -0,0 +1,137 @@
+#include <atomic>
+#include <cstddef>
+#include "AllocationCounter.h"
+
+#ifdef __GLIBC__
+    #include <malloc.h>
+#endif
+
+
+namespace
+{
+    std::atomic<qint64> s_Allocated {0};    // 確保したバイト数の合計
+    std::atomic<qint64> s_Live      {0};    // 現在確保しているバイト数 (resetメソッドの呼び出し時点を0とする)
+    std::atomic<qint64> s_Peak      {0};    // 同時に確保していたバイト数の最大値
+
+#ifdef __GLIBC__
+    // 確保したメモリのバイト数を集計する (実際に確保されたサイズを使用する)
+    void RecordAllocation(void *ptr)
+    {
+        if (ptr == nullptr) return;
+
+        const auto size = static_cast<qint64>(malloc_usable_size(ptr));
+        s_Allocated.fetch_add(size, std::memory_order_relaxed);
+
+        const auto live = s_Live.fetch_add(size, std::memory_order_relaxed) + size;
+        auto       peak = s_Peak.load(std::memory_order_relaxed);
+        while (live > peak && !s_Peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+
+    // 解放するメモリのバイト数を集計する
+    void RecordFree(void *ptr)
+    {
+        if (ptr == nullptr) return;
+
+        s_Live.fetch_sub(static_cast<qint64>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+    }
+#endif
+}
+
+
+#ifdef __GLIBC__
+// glibcのmalloc関数等を置き換えて、確保量を集計してからglibcの実装を呼び出す
+// (実行ファイルで定義した関数は、Qtおよびlibxml2等の共有ライブラリからの呼び出しにも使用される)
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void  __libc_free(void *ptr);
+
+    void *malloc(size_t size)
+    {
+        auto ptr = __libc_malloc(size);
+        RecordAllocation(ptr);
+
+        return ptr;
+    }
+
+    void *calloc(size_t count, size_t size)
+    {
+        auto ptr = __libc_calloc(count, size);
+        RecordAllocation(ptr);
+
+        return ptr;
+    }
+
+    void *realloc(void *ptr, size_t size)
+    {
+        RecordFree(ptr);
+
+        auto newPtr = __libc_realloc(ptr, size);
+        RecordAllocation(newPtr != nullptr || size == 0 ? newPtr : ptr);
+
+        return newPtr;
+    }
+
+    void *memalign(size_t alignment, size_t size)
+    {
+        auto ptr = __libc_memalign(alignment, size);
+        RecordAllocation(ptr);
+
+        return ptr;
+    }
+
+    void *aligned_alloc(size_t alignment, size_t size)
+    {
+        return memalign(alignment, size);
+    }
+
+    int posix_memalign(void **pPtr, size_t alignment, size_t size)
+    {
+        auto ptr = memalign(alignment, size);
+        if (ptr == nullptr) return 12;  // ENOMEM
+
+        *pPtr = ptr;
+
+        return 0;
+    }
+
+    void free(void *ptr)
+    {
+        RecordFree(ptr);
+        __libc_free(ptr);
+    }
+}
+#endif
+
+
+bool AllocationCounter::isAvailable()
+{
+#ifdef __GLIBC__
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void AllocationCounter::reset()
+{
+    s_Allocated.store(0, std::memory_order_relaxed);
+    s_Live.store(0, std::memory_order_relaxed);
+    s_Peak.store(0, std::memory_order_relaxed);
+}
+
+
+qint64 AllocationCounter::allocated()
+{
+    return s_Allocated.load(std::memory_order_relaxed);
+}
+
+
+qint64 AllocationCounter::peak()
+{
+    return s_Peak.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,26 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+
+// ヒープの確保量を計測するクラス (ベンチマーク専用)
+// malloc関数等を置き換えて、Qt、libxml2および標準ライブラリを含む全ての確保量を集計する
+// glibcを使用するシステム (Linux) のみ使用できる (その他のシステムでは、isAvailableメソッドがfalseを返す)
+//
+// 計測は、resetメソッドを呼び出してから計測する処理を実行して、allocatedメソッドおよびpeakメソッドから取得する
+class AllocationCounter
+{
+public:     // Methods
+    AllocationCounter()                                     = delete;
+    AllocationCounter(const AllocationCounter&)             = delete;
+    AllocationCounter& operator=(const AllocationCounter&)  = delete;
+
+    static bool     isAvailable();      // 確保量を計測できるかどうか
+    static void     reset();            // 確保量の集計を開始する
+    static qint64   allocated();        // resetメソッドの呼び出し以降に確保したバイト数の合計 (解放したバイト数を差し引かない)
+    static qint64   peak();             // resetメソッドの呼び出し以降に、同時に確保していたバイト数の最大値
+};
+
+
+#endif // ALLOCATIONCOUNTER_H
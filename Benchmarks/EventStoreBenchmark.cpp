@@ -0,0 +1,216 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QThreadPool>
+#include "EventStore.h"
+
+
+// ログファイルの検索のベンチマーク
+// 1000件、10000件、100000件のオブジェクトを持つログファイルに対して、各検索の時間を計測する
+// 検索はメモリ上のインデックスのみを使用するため、検索時間はオブジェクト数に依存しない (件数を増やしても一定である) ことを確認する
+//
+// 比較のため、以前の処理 (検索ごとにログファイル全体を読み込み、先頭から検索する) の時間も計測する (scanFile)
+// ログファイルの最初の読み込み (インデックスの作成) の時間は、計測とは別に出力する
+class EventStoreBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir           m_TempDir;      // ログファイルを作成する一時ディレクトリ
+    QHash<int, QString>     m_Files;        // オブジェクト数ごとのログファイル (JSON形式) のパス
+
+    static constexpr int    Hypocentres = 200;  // 震源地の種類の数
+    static constexpr int    LockTimeout = 30000;
+
+    static constexpr int    Sizes[] = {1000, 10000, 100000};    // ログファイルのオブジェクト数
+
+private:
+    static QJsonObject  CreateObject(int index);                        // 発生した地震情報のログファイルのオブジェクトを作成する
+    static QString      EventID(int index);                             // index番目のオブジェクトの地震ID
+    static QString      Hypocentre(int index);                          // index番目のオブジェクトの震源地
+    static QStringList  Prefs(int index);                               // index番目のオブジェクトの最も震度の大きい都道府県
+    static int          ScanFile(const QString &fileName, const QString &id);   // ログファイル全体を読み込み、先頭から地震IDを検索する (以前の処理)
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void lookup_data();
+    void lookup();
+};
+
+
+// 都道府県 (47都道府県)
+static const QStringList s_Prefs = {
+    "北海道", "青森県", "岩手県", "宮城県", "秋田県", "山形県", "福島県", "茨城県", "栃木県", "群馬県",
+    "埼玉県", "千葉県", "東京都", "神奈川県", "新潟県", "富山県", "石川県", "福井県", "山梨県", "長野県",
+    "岐阜県", "静岡県", "愛知県", "三重県", "滋賀県", "京都府", "大阪府", "兵庫県", "奈良県", "和歌山県",
+    "鳥取県", "島根県", "岡山県", "広島県", "山口県", "徳島県", "香川県", "愛媛県", "高知県", "福岡県",
+    "佐賀県", "長崎県", "熊本県", "大分県", "宮崎県", "鹿児島県", "沖縄県"
+};
+
+
+QString EventStoreBenchmark::EventID(int index)
+{
+    return QString("2024%1").arg(index, 10, 10, QLatin1Char('0'));
+}
+
+
+QString EventStoreBenchmark::Hypocentre(int index)
+{
+    return QString("震源地%1").arg(index % Hypocentres, 3, 10, QLatin1Char('0'));
+}
+
+
+// 1つ目から3つ目の都道府県は、隣接する都道府県とする
+QStringList EventStoreBenchmark::Prefs(int index)
+{
+    QStringList prefs;
+    for (int i = 0; i <= index % 3; i++) {
+        prefs.append(s_Prefs.at((index + i) % s_Prefs.size()));
+    }
+
+    return prefs;
+}
+
+
+// 発生した地震情報のログファイルのオブジェクトを作成する (EarthQuakeInfo::AddInfoメソッドと同じキー)
+QJsonObject EventStoreBenchmark::CreateObject(int index)
+{
+    QJsonObject object;
+    object["id"]             = QJsonArray{EventID(index)};
+    object["hypocentre"]     = Hypocentre(index);
+    object["prefs"]          = Prefs(index).join(",");
+    object["title"]          = QString("【地震速報】%1で震度4").arg(Hypocentre(index));
+    object["url"]            = QString("https://example.com/test/read.cgi/eqinfo/%1/").arg(1700000000 + index);
+    object["thread"]         = QString::number(1700000000 + index);
+    object["date"]           = QStringLiteral("2024/08/09 19:57:00");
+    object["reportdatetime"] = QStringLiteral("2024-08-09T19:59:00+09:00");
+    object["logged"]         = QStringLiteral("2024-08-09T11:00:00Z");
+
+    return object;
+}
+
+
+// ログファイル全体を読み込み、先頭から地震IDを検索する (インデックスを使用しない以前の処理)
+int EventStoreBenchmark::ScanFile(const QString &fileName, const QString &id)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return -1;
+
+    const auto array = QJsonDocument::fromJson(file.readAll()).array();
+    for (const auto &value : array) {
+        for (const auto &objectID : value.toObject().value("id").toArray()) {
+            if (objectID.toString() == id) return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+void EventStoreBenchmark::initTestCase()
+{
+    QVERIFY(m_TempDir.isValid());
+
+    // 保持期間および最大数を超えたオブジェクトが削除されないように、保持期間を無効にする
+    EventStore::setRetention(RETENTIONCONFIG{0, 0});
+
+    for (auto size : Sizes) {
+        QJsonArray array;
+        for (int i = 0; i < size; i++) {
+            array.append(CreateObject(i));
+        }
+
+        const auto fileName = m_TempDir.filePath(QString("info_%1.json").arg(size));
+
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QVERIFY(file.write(QJsonDocument(array).toJson(QJsonDocument::Compact)) > 0);
+        file.close();
+
+        m_Files[size] = fileName;
+
+        // 最初の検索時に、ログファイルを読み込んでインデックスを作成する
+        QElapsedTimer timer;
+        timer.start();
+        QCOMPARE(EventStore::open(fileName)->containsID(EventID(0), LockTimeout), 1);
+
+        qInfo().noquote() << QString("%1件 : ログファイル %2[バイト], 最初の読み込み %3[mS]")
+                             .arg(size).arg(QFileInfo(fileName).size()).arg(timer.elapsed());
+    }
+}
+
+
+void EventStoreBenchmark::cleanupTestCase()
+{
+    QThreadPool::globalInstance()->waitForDone();
+    EventStore::cleanup();
+}
+
+
+void EventStoreBenchmark::lookup_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<QString>("operation");
+
+    for (const auto &operation : {"containsID", "containsID (miss)", "containsReport", "findByHypocentre", "findByPrefs", "scanFile"}) {
+        for (auto size : Sizes) {
+            // 以前の処理は、100000件の場合は1回の検索に時間が掛かるため計測しない
+            if (QLatin1String(operation) == QLatin1String("scanFile") && size > 10000) continue;
+
+            QTest::newRow(QString("%1 %2").arg(operation).arg(size).toUtf8().constData()) << size << QString(operation);
+        }
+    }
+}
+
+
+// 検索する地震IDおよび都道府県は、ログファイルの末尾のオブジェクト (以前の処理で最も時間が掛かる位置) とする
+void EventStoreBenchmark::lookup()
+{
+    QFETCH(int,     size);
+    QFETCH(QString, operation);
+
+    const auto fileName = m_Files.value(size);
+    auto       pStore   = EventStore::open(fileName);
+
+    const auto last       = size - 1;
+    const auto id         = EventID(last);
+    const auto hypocentre = Hypocentre(last);
+    const auto prefs      = Prefs(last);
+
+    QJsonObject object;
+
+    if (operation == "containsID") {
+        QCOMPARE(pStore->containsID(id, LockTimeout), 1);
+        QBENCHMARK { pStore->containsID(id, LockTimeout); }
+    }
+    else if (operation == "containsID (miss)") {
+        QCOMPARE(pStore->containsID(EventID(size), LockTimeout), 0);
+        QBENCHMARK { pStore->containsID(EventID(size), LockTimeout); }
+    }
+    else if (operation == "containsReport") {
+        QCOMPARE(pStore->containsReport(id, QStringLiteral("2024-08-09T19:59:00+09:00"), LockTimeout), 1);
+        QBENCHMARK { pStore->containsReport(id, QStringLiteral("2024-08-09T19:59:00+09:00"), LockTimeout); }
+    }
+    else if (operation == "findByHypocentre") {
+        QCOMPARE(pStore->findByHypocentre(hypocentre, object, LockTimeout), 1);
+        QBENCHMARK { pStore->findByHypocentre(hypocentre, object, LockTimeout); }
+    }
+    else if (operation == "findByPrefs") {
+        QCOMPARE(pStore->findByPrefs(prefs, object, LockTimeout), 1);
+        QBENCHMARK { pStore->findByPrefs(prefs, object, LockTimeout); }
+    }
+    else if (operation == "scanFile") {
+        QCOMPARE(ScanFile(fileName, id), 1);
+        QBENCHMARK { ScanFile(fileName, id); }
+    }
+}
+
+
+QTEST_GUILESS_MAIN(EventStoreBenchmark)
+
+#include "EventStoreBenchmark.moc"
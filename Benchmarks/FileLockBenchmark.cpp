@@ -0,0 +1,190 @@
+#include <QtTest>
+#include <QLockFile>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include "FileLock.h"
+
+
+// ログファイルのロックの競合のベンチマーク
+// N個 (1, 2, 4, 8) のプロセスが同じロックファイルに対してロックの取得および解除を繰り返す場合について、
+//   QLockFile : 以前の処理 (QLockFile::tryLockメソッドで取得して、解除するごとにremoveStaleLockFileメソッドを呼び出す)
+//   Exclusive : 現在の処理 (FileLockクラスの排他ロック : ログファイルへの書き込み)
+//   Shared    : 現在の処理 (FileLockクラスの共有ロック : ログファイルの読み込みのみ)
+// の1回の取得あたりの時間 (全てのプロセスの処理時間 / 取得回数) を計測する
+// 1回の取得ごとの待機時間の平均および最大は、計測とは別に出力する
+//
+// 各プロセスは、本ベンチマークの実行ファイルを子プロセスモード (-child オプション) で起動する
+// 全ての子プロセスの起動後に標準入力へ開始を通知するため、プロセスの起動時間は計測に含めない
+class FileLockBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr char   ChildOption[] = "-child";   // 子プロセスモードで起動する場合のオプション
+
+private:
+    QTemporaryDir           m_TempDir;                  // ロックファイルを作成する一時ディレクトリ
+
+    static constexpr int    Iterations     = 50;        // 1つのプロセスがロックを取得する回数
+    static constexpr int    HoldTime       = 200;       // ロックを保持する時間 (ログファイルの読み込み等) [μS]
+    static constexpr int    IntervalTime   = 200;       // ロックを解除してから次に取得するまでの時間 [μS]
+    static constexpr int    LockTimeout    = 30000;     // ロックの待機時間 (ログファイルのロックと同じ値) [mS]
+    static constexpr int    ProcessTimeout = 600000;    // 子プロセスの終了を待機する時間 [mS]
+
+    static constexpr int    Processes[] = {1, 2, 4, 8}; // 競合させるプロセス数
+
+public:
+    static int  Contend(const QString &mode, const QString &lockFile);  // 子プロセスモード : ロックの取得および解除を繰り返して、結果を標準出力へ出力する
+
+private slots:
+    void initTestCase();
+
+    void contention_data();
+    void contention();
+};
+
+
+// ロックの取得および解除をIterations回繰り返す
+// 全ての取得の終了後に、取得した回数、待機時間の合計[nS]、待機時間の最大[nS]を空白区切りで標準出力へ出力する
+int FileLockBenchmark::Contend(const QString &mode, const QString &lockFile)
+{
+    // 親プロセスからの開始の通知を待機する
+    std::string line;
+    if (!std::getline(std::cin, line)) return 1;
+
+    int             count     = 0;
+    qint64          totalWait = 0,
+                    maxWait   = 0;
+    QElapsedTimer   timer;
+
+    for (int i = 0; i < Iterations; i++) {
+        qint64 wait = 0;
+
+        timer.start();
+        if (mode == QLatin1String("QLockFile")) {
+            QLockFile lock(lockFile);
+            if (!lock.tryLock(LockTimeout)) continue;
+
+            wait = timer.nsecsElapsed();
+            QThread::usleep(HoldTime);
+
+            // 以前の処理 (LockFileGuardクラス) と同様に、解除するごとにロックファイルを確認する
+            lock.unlock();
+            lock.removeStaleLockFile();
+        }
+        else {
+            FileLock lock(lockFile, mode == QLatin1String("Shared") ? FileLock::Mode::Shared : FileLock::Mode::Exclusive, LockTimeout);
+            if (!lock.isLocked()) continue;
+
+            wait = timer.nsecsElapsed();
+            QThread::usleep(HoldTime);
+        }
+
+        count++;
+        totalWait += wait;
+        maxWait    = std::max(maxWait, wait);
+
+        QThread::usleep(IntervalTime);
+    }
+
+    std::cout << count << " " << totalWait << " " << maxWait << std::endl;
+
+    return 0;
+}
+
+
+void FileLockBenchmark::initTestCase()
+{
+    QVERIFY(m_TempDir.isValid());
+}
+
+
+void FileLockBenchmark::contention_data()
+{
+    QTest::addColumn<QString>("mode");
+    QTest::addColumn<int>("processes");
+
+    for (const auto &mode : {"QLockFile", "Exclusive", "Shared"}) {
+        for (auto processes : Processes) {
+            QTest::newRow(QString("%1 %2").arg(mode).arg(processes).toUtf8().constData()) << QString(mode) << processes;
+        }
+    }
+}
+
+
+void FileLockBenchmark::contention()
+{
+    QFETCH(QString, mode);
+    QFETCH(int,     processes);
+
+    // QLockFileクラスはロックファイルの内容 (プロセスID等) を使用するため、FileLockクラスとは別のロックファイルとする
+    const auto lockFile = m_TempDir.filePath(mode == QLatin1String("QLockFile") ? "qlockfile.lock" : "eqalert.lock");
+
+    std::vector<std::unique_ptr<QProcess>> children;
+    for (int i = 0; i < processes; i++) {
+        auto pProcess = std::make_unique<QProcess>();
+        pProcess->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        pProcess->start(QCoreApplication::applicationFilePath(), {QString(ChildOption), mode, lockFile});
+        QVERIFY(pProcess->waitForStarted());
+
+        children.push_back(std::move(pProcess));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (const auto &pProcess : children) {
+        pProcess->write("\n");
+        pProcess->closeWriteChannel();
+    }
+
+    int     count     = 0;
+    qint64  totalWait = 0,
+            maxWait   = 0;
+
+    for (const auto &pProcess : children) {
+        QVERIFY(pProcess->waitForFinished(ProcessTimeout));
+        QCOMPARE(pProcess->exitCode(), 0);
+
+        const auto values = pProcess->readAllStandardOutput().trimmed().split(' ');
+        QCOMPARE(values.size(), 3);
+
+        count     += values.at(0).toInt();
+        totalWait += values.at(1).toLongLong();
+        maxWait    = std::max(maxWait, values.at(2).toLongLong());
+    }
+
+    const auto elapsed = timer.nsecsElapsed();
+
+    // 待機時間内に全てのロックを取得できること
+    QCOMPARE(count, processes * Iterations);
+
+    qInfo().noquote() << QString("%1プロセス : %2[回/秒], 待機時間 平均 %3[μS] 最大 %4[μS]")
+                         .arg(processes)
+                         .arg(count * 1.0e9 / elapsed, 0, 'f', 0)
+                         .arg(totalWait / 1000.0 / count, 0, 'f', 1)
+                         .arg(maxWait / 1000.0, 0, 'f', 1);
+
+    QTest::setBenchmarkResult(elapsed / 1.0e6 / count, QTest::WalltimeMilliseconds);
+}
+
+
+// 子プロセスモード (-child <モード> <ロックファイルのパス>) の場合は、ベンチマークを実行せずにロックの取得および解除を繰り返す
+int main(int argc, char *argv[])
+{
+    if (argc == 4 && qstrcmp(argv[1], FileLockBenchmark::ChildOption) == 0) {
+        return FileLockBenchmark::Contend(QString::fromLocal8Bit(argv[2]), QString::fromLocal8Bit(argv[3]));
+    }
+
+    QCoreApplication app(argc, argv);
+    FileLockBenchmark benchmark;
+
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "FileLockBenchmark.moc"
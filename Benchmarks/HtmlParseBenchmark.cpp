@@ -0,0 +1,168 @@
+#include <QtGlobal>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    #include <QStringDecoder>
+#else
+    #include <QTextCodec>
+#endif
+
+#include <QtTest>
+#include <string>
+#include <libxml/HTMLparser.h>
+#include <libxml/xpath.h>
+#include "AllocationCounter.h"
+#include "HtmlParser.h"
+#include "ThreadPage.h"
+#include "XPathCache.h"
+
+
+// ダウンロードしたHTMLのパースのベンチマーク
+// 1000レスのスレッドのページ (Shift-JIS) からスレッドのタイトルを取得する処理について、
+//   decode : 以前の処理 (QStringへデコード → std::stringへ変換 → htmlReadDoc関数でパース)
+//   bytes  : 現在の処理 (ダウンロードしたバイト列をHtmlParser::parseメソッドでパース)
+// の1回あたりのヒープの確保量 (allocationsテスト) および処理時間 (parseテスト) を比較する
+//
+// ネットワークからの受信は計測に含めない (レスポンスの本文は、受信済みのバイト列とする)
+class HtmlParseBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    QByteArray              m_Page;         // スレッドのページ (Shift-JIS)
+
+    static constexpr int    Replies = 1000; // スレッドのレス数
+    static constexpr char   Title[] = "【緊急地震速報】日向灘で地震 最大震度6弱";  // スレッドのタイトル
+
+private:
+    QString FetchTitle(bool bFromBytes) const;  // スレッドのページをパースして、スレッドのタイトルを取得する
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void allocations_data();
+    void allocations();
+    void parse_data();
+    void parse();
+};
+
+
+// スレッドのページをパースして、スレッドのタイトルを取得する (HtmlFetcher::fetchElementメソッドと同じ手順)
+// bFromBytesがtrueの場合はバイト列をそのままパースして、falseの場合はQStringおよびstd::stringへ変換してからパースする
+QString HtmlParseBenchmark::FetchTitle(bool bFromBytes) const
+{
+    xmlDocPtr doc = nullptr;
+
+    if (bFromBytes) {
+        doc = HtmlParser::parse(m_Page, true);
+    }
+    else {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        QStringDecoder decoder("Shift-JIS");
+        QString htmlContent = decoder.decode(m_Page);
+#else
+        auto    codec       = QTextCodec::codecForName("Shift-JIS");
+        QString htmlContent = codec->toUnicode(m_Page);
+#endif
+
+        doc = htmlReadDoc(reinterpret_cast<const xmlChar*>(htmlContent.toStdString().c_str()), nullptr, "UTF-8",
+                          HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    }
+
+    if (doc == nullptr) return QString();
+
+    QString title;
+
+    xmlXPathContextPtr context = xmlXPathNewContext(doc);
+    xmlXPathObjectPtr  result  = XPathCache::eval(QStringLiteral("/html/head/title"), context);
+    if (result && !xmlXPathNodeSetIsEmpty(result->nodesetval)) {
+        for (auto cur = result->nodesetval->nodeTab[0]->xmlChildrenNode; cur != nullptr; cur = cur->next) {
+            if (cur->type == XML_TEXT_NODE) title.append(QString::fromUtf8(reinterpret_cast<const char*>(cur->content)));
+        }
+    }
+
+    xmlXPathFreeObject(result);
+    xmlXPathFreeContext(context);
+    xmlFreeDoc(doc);
+
+    return title;
+}
+
+
+void HtmlParseBenchmark::initTestCase()
+{
+    HtmlParser::initialize();
+
+    m_Page = ThreadPage::generate(QString::fromUtf8(Title), Replies, true);
+    if (m_Page.isEmpty()) QSKIP("Shift-JISのエンコーダが使用できません");
+
+    QVERIFY(XPathCache::compile(QStringLiteral("/html/head/title")));
+
+    qInfo().noquote() << QString("スレッドのページ : %1レス, %2[バイト]").arg(Replies).arg(m_Page.size());
+}
+
+
+void HtmlParseBenchmark::cleanupTestCase()
+{
+    XPathCache::clear();
+    HtmlParser::cleanup();
+}
+
+
+void HtmlParseBenchmark::allocations_data()
+{
+    QTest::addColumn<bool>("bFromBytes");
+
+    QTest::newRow("decode") << false;
+    QTest::newRow("bytes")  << true;
+}
+
+
+// 1回のパースで確保したバイト数の合計 (解放したバイト数を差し引かない) を計測する
+// 同時に確保していたバイト数の最大値は、ページのサイズとの比として出力する
+void HtmlParseBenchmark::allocations()
+{
+    if (!AllocationCounter::isAvailable()) QSKIP("ヒープの確保量は、glibcを使用するシステムでのみ計測できます");
+
+    QFETCH(bool, bFromBytes);
+
+    // 計測の前に、タイトルを取得できることを確認する
+    // (このスレッドのパーサコンテキストの作成等、初回のみの確保は計測に含めない)
+    QCOMPARE(FetchTitle(bFromBytes), QString::fromUtf8(Title));
+
+    AllocationCounter::reset();
+    const auto title = FetchTitle(bFromBytes);
+    const auto allocated = AllocationCounter::allocated();
+    const auto peak      = AllocationCounter::peak();
+
+    QCOMPARE(title, QString::fromUtf8(Title));
+
+    qInfo().noquote() << QString("確保量の合計 : %1[バイト] (ページの%2倍), 最大 : %3[バイト] (ページの%4倍)")
+                         .arg(allocated).arg(static_cast<double>(allocated) / m_Page.size(), 0, 'f', 2)
+                         .arg(peak).arg(static_cast<double>(peak) / m_Page.size(), 0, 'f', 2);
+
+    QTest::setBenchmarkResult(static_cast<qreal>(allocated), QTest::BytesAllocated);
+}
+
+
+void HtmlParseBenchmark::parse_data()
+{
+    allocations_data();
+}
+
+
+void HtmlParseBenchmark::parse()
+{
+    QFETCH(bool, bFromBytes);
+
+    QCOMPARE(FetchTitle(bFromBytes), QString::fromUtf8(Title));
+
+    QBENCHMARK {
+        FetchTitle(bFromBytes);
+    }
+}
+
+
+QTEST_GUILESS_MAIN(HtmlParseBenchmark)
+
+#include "HtmlParseBenchmark.moc"
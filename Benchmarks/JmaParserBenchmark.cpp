@@ -0,0 +1,137 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <memory>
+#include "EarthQuake.h"
+#include "EventStore.h"
+
+
+// JMAのXMLの解析のベンチマーク
+// 緊急地震速報(警報) (VXSE43)、震度速報 (VXSE51)、震源・震度に関する情報 (VXSE53) のXMLを、
+// ストリーム形式 (QXmlStreamReader) およびDOM形式 (QDomDocument) で解析する時間を比較する
+//
+// 報告時刻が古いXMLはHead要素の時点で無視されるため、XMLの日時は計測の直前に現在時刻へ置き換えて、
+// いずれの形式もBody要素まで解析する (地震情報の整形に成功する) ことを確認してから計測する
+class JmaParserBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir           m_TempDir;      // ログファイルを作成する一時ディレクトリ
+    std::unique_ptr<Worker> m_pWorker;      // 計測対象の地震情報オブジェクト
+
+private:
+    static QByteArray   LoadDocument(const QString &fileName);  // dataディレクトリのXMLを読み込み、日時を現在時刻に置き換える
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void parse_data();
+    void parse();
+};
+
+
+// dataディレクトリのXMLを読み込み、日時のプレースホルダを現在時刻 (日本時間) に置き換える
+// 読み込みに失敗した場合は空のデータを返す
+QByteArray JmaParserBenchmark::LoadDocument(const QString &fileName)
+{
+    QFile file(QFINDTESTDATA(QString("data/%1").arg(fileName)));
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+
+    const auto now      = QDateTime::currentDateTime();
+    const auto reported = now.toString("yyyy-MM-ddTHH:mm:ss+09:00").toUtf8();
+    const auto origin   = now.addSecs(-10).toString("yyyy-MM-ddTHH:mm:ss+09:00").toUtf8();
+
+    auto document = file.readAll();
+    document.replace("{{ControlDateTime}}", now.toUTC().toString("yyyy-MM-ddTHH:mm:ssZ").toUtf8());
+    document.replace("{{ReportDateTime}}",  reported);
+    document.replace("{{OriginTime}}",      origin);
+    document.replace("{{ArrivalTime}}",     reported);
+
+    return document;
+}
+
+
+void JmaParserBenchmark::initTestCase()
+{
+    QVERIFY(m_TempDir.isValid());
+
+    // 発生した地震情報は解析中にログファイルを検索するため、空のログファイルを作成する
+    const auto logFile = m_TempDir.filePath(QStringLiteral("info.json"));
+
+    QFile file(logFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write("[]\n") > 0);
+    file.close();
+
+    COMMONDATA data {};
+    data.iGetInfo   = 0;
+    data.AlertScale = 0;
+    data.InfoScale  = 0;
+    data.LogFile    = logFile;
+
+    m_pWorker = std::make_unique<Worker>(data, THREAD_INFO());
+}
+
+
+void JmaParserBenchmark::cleanupTestCase()
+{
+    m_pWorker.reset();
+    EventStore::cleanup();
+}
+
+
+void JmaParserBenchmark::parse_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<bool>("bAlert");
+    QTest::addColumn<bool>("bStream");
+
+    QTest::newRow("VXSE43 stream")  << QStringLiteral("VXSE43.xml") << true  << true;
+    QTest::newRow("VXSE43 DOM")     << QStringLiteral("VXSE43.xml") << true  << false;
+    QTest::newRow("VXSE51 stream")  << QStringLiteral("VXSE51.xml") << false << true;
+    QTest::newRow("VXSE51 DOM")     << QStringLiteral("VXSE51.xml") << false << false;
+    QTest::newRow("VXSE53 stream")  << QStringLiteral("VXSE53.xml") << false << true;
+    QTest::newRow("VXSE53 DOM")     << QStringLiteral("VXSE53.xml") << false << false;
+}
+
+
+// 取得済みのXMLから地震情報を整形する時間を計測する (ダウンロードおよび書き込みは含まない)
+void JmaParserBenchmark::parse()
+{
+    QFETCH(QString, fileName);
+    QFETCH(bool,    bAlert);
+    QFETCH(bool,    bStream);
+
+    const auto document = LoadDocument(fileName);
+    QVERIFY(!document.isEmpty());
+
+    auto Parse = [this, &document, bAlert, bStream]() {
+        m_pWorker->initialize();
+        m_pWorker->m_ReplyData = document;
+
+        return bStream ? m_pWorker->FormattingData_for_JMA_Stream(bAlert) : m_pWorker->FormattingData_for_JMA_DOM(bAlert);
+    };
+
+    // 計測の前に、Body要素まで解析して地震情報を整形できることを確認する
+    QCOMPARE(Parse(), 0);
+
+    QBENCHMARK {
+        Parse();
+    }
+}
+
+
+// JMAのXMLの日時は日本時間であるため、実行するシステムのタイムゾーンに関わらず日本時間を使用する
+// (タイムゾーンは、QCoreApplicationを生成する前に設定する)
+int main(int argc, char *argv[])
+{
+    qputenv("TZ", "Asia/Tokyo");
+
+    QCoreApplication app(argc, argv);
+    JmaParserBenchmark benchmark;
+
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "JmaParserBenchmark.moc"
@@ -0,0 +1,331 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <memory>
+#include "NetworkAccess.h"
+
+// QSslServerクラスを使用できる場合 (Qt 6.4以降) は、HTTPSで応答する (TLSハンドシェイクの回数を計測する)
+// 使用できない場合は、HTTPで応答する (TCPの接続数のみを計測する)
+#if QT_VERSION >= QT_VERSION_CHECK(6, 4, 0) && QT_CONFIG(ssl)
+    #include <QSslServer>
+    #include <QSslCertificate>
+    #include <QSslKey>
+    #define NETWORKACCESSBENCHMARK_TLS
+#endif
+
+
+// 気象庁および掲示板の代わりとなるローカルのHTTPサーバ (スタンドイン)
+// 気象庁 (FeedPath) は地震情報のフィードを返して、掲示板 (BbsPath) はGETリクエストにはクッキー、POSTリクエストには書き込みの完了を返す
+// 全ての応答はKeep-Alive接続とするため、クライアントが接続を再利用する場合は接続数が増加しない
+class StandInServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr char   FeedPath[] = "/developer/xml/feed/eqvol.xml";   // 気象庁のフィードのパス
+    static constexpr char   BbsPath[]  = "/test/bbs.cgi";                   // 掲示板の書き込み用URLのパス
+
+private:
+    std::unique_ptr<QTcpServer>     m_pServer;          // HTTPサーバ
+    QString                         m_Scheme;           // URLのスキーム (httpsまたはhttp)
+    QHash<QTcpSocket*, QByteArray>  m_Buffers;          // 接続ごとの受信途中のリクエスト
+    int                             m_Connections = 0;  // 受け付けた接続数 (HTTPSの場合はTLSハンドシェイクの完了数)
+
+private:
+    // 受信したデータからリクエストを取り出して応答する
+    // 1つの接続で複数のリクエストを受信する場合 (Keep-Alive接続) は、受信した順に応答する
+    void onReadyRead(QTcpSocket *pSocket)
+    {
+        auto &buffer = m_Buffers[pSocket];
+        buffer += pSocket->readAll();
+
+        while (true) {
+            const auto headerEnd = buffer.indexOf("\r\n\r\n");
+            if (headerEnd < 0) return;
+
+            const auto lines       = buffer.left(headerEnd).split('\n');
+            const auto requestLine = lines.first().trimmed().split(' ');
+            if (requestLine.size() < 2) return;
+
+            qint64 contentLength = 0;
+            for (const auto &line : lines.mid(1)) {
+                const auto separator = line.indexOf(':');
+                if (separator > 0 && line.left(separator).trimmed().toLower() == "content-length") {
+                    contentLength = line.mid(separator + 1).trimmed().toLongLong();
+                }
+            }
+
+            const auto requestSize = headerEnd + 4 + contentLength;
+            if (buffer.size() < requestSize) return;
+
+            const auto method = requestLine.at(0);
+            const auto path   = QUrl(QString::fromLatin1(requestLine.at(1))).path();
+            buffer.remove(0, requestSize);
+
+            Respond(pSocket, method, path);
+        }
+    }
+
+    // リクエストに応答する
+    static void Respond(QTcpSocket *pSocket, const QByteArray &method, const QString &path)
+    {
+        if (path == QLatin1String(FeedPath)) {
+            Write(pSocket, "200 OK", "application/atom+xml", QByteArray(),
+                  "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                  "<feed xmlns=\"http://www.w3.org/2005/Atom\"><title>高頻度（地震火山）</title></feed>");
+        }
+        else if (path == QLatin1String(BbsPath) && method == "POST") {
+            Write(pSocket, "200 OK", "text/html", QByteArray(), "<html><head><title>書きこみました。</title></head><body></body></html>");
+        }
+        else if (path == QLatin1String(BbsPath)) {
+            Write(pSocket, "200 OK", "text/html", "Set-Cookie: standin=1; Path=/\r\n", "<html><head><title>掲示板</title></head><body></body></html>");
+        }
+        else {
+            Write(pSocket, "404 Not Found", "text/html", QByteArray(), QByteArray());
+        }
+    }
+
+    static void Write(QTcpSocket *pSocket, const QByteArray &status, const QByteArray &contentType, const QByteArray &headers, const QByteArray &body)
+    {
+        pSocket->write("HTTP/1.1 " + status + "\r\n"
+                       "Content-Type: " + contentType + "; charset=UTF-8\r\n"
+                       "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                       "Connection: keep-alive\r\n" +
+                       headers +
+                       "\r\n" +
+                       body);
+    }
+
+    // 受け付けた接続を登録する
+    void onPendingConnection()
+    {
+        while (m_pServer->hasPendingConnections()) {
+            auto pSocket = m_pServer->nextPendingConnection();
+            m_Connections++;
+
+            connect(pSocket, &QTcpSocket::readyRead, this, [this, pSocket]() {
+                onReadyRead(pSocket);
+            });
+            connect(pSocket, &QTcpSocket::disconnected, this, [this, pSocket]() {
+                m_Buffers.remove(pSocket);
+                pSocket->deleteLater();
+            });
+        }
+    }
+
+public:
+    explicit StandInServer(QObject *parent = nullptr) : QObject{parent}
+    {
+    }
+
+    // サーバ証明書および秘密鍵 (PEM形式) を指定して待ち受けを開始する
+    // HTTPSを使用できない場合、サーバ証明書および秘密鍵は使用しない
+    bool listen(const QString &certFile, const QString &keyFile)
+    {
+#ifdef NETWORKACCESSBENCHMARK_TLS
+        QFile cert(certFile),
+              key(keyFile);
+        if (!cert.open(QIODevice::ReadOnly) || !key.open(QIODevice::ReadOnly)) return false;
+
+        auto config = QSslConfiguration::defaultConfiguration();
+        config.setLocalCertificate(QSslCertificate(cert.readAll(), QSsl::Pem));
+        config.setPrivateKey(QSslKey(key.readAll(), QSsl::Ec, QSsl::Pem));
+
+        auto pServer = std::make_unique<QSslServer>();
+        pServer->setSslConfiguration(config);
+
+        // QSslServerクラスは、TLSハンドシェイクの完了後に接続を登録する
+        connect(pServer.get(), &QSslServer::pendingConnectionAvailable, this, &StandInServer::onPendingConnection);
+
+        m_pServer = std::move(pServer);
+        m_Scheme  = QStringLiteral("https");
+#else
+        Q_UNUSED(certFile)
+        Q_UNUSED(keyFile)
+
+        m_pServer = std::make_unique<QTcpServer>();
+        connect(m_pServer.get(), &QTcpServer::newConnection, this, &StandInServer::onPendingConnection);
+
+        m_Scheme  = QStringLiteral("http");
+#endif
+
+        return m_pServer->listen(QHostAddress::LocalHost, 0);
+    }
+
+    [[nodiscard]] QUrl url(const QString &path) const
+    {
+        return QUrl(QString("%1://127.0.0.1:%2%3").arg(m_Scheme).arg(m_pServer->serverPort()).arg(path));
+    }
+
+    [[nodiscard]] int connections() const
+    {
+        return m_Connections;
+    }
+};
+
+
+// HTTPクライアントの接続の再利用のベンチマーク
+// 緊急地震速報の1回の処理 (気象庁のフィードの取得 → 掲示板のクッキーの取得 (GET) → 書き込み (POST)) をCycles回繰り返す場合について、
+//   fresh  : 以前の処理 (リクエストごとにQNetworkAccessManagerクラスのオブジェクトを作成する)
+//   shared : 現在の処理 (NetworkAccess::managerメソッドで取得した共用のオブジェクトを使用する)
+// の1回の処理の平均時間を計測する
+// 1回の処理あたりの接続数 (スタンドインが受け付けた接続数) およびTLSハンドシェイクの回数 (encryptedシグナル) は、計測とは別に出力する
+//
+// 気象庁と掲示板は、それぞれ別のスタンドイン (別のポート) とする (接続はホストおよびポートごとに再利用される)
+class NetworkAccessBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    StandInServer           m_Jma,                  // 気象庁のスタンドイン
+                            m_Bbs;                  // 掲示板のスタンドイン
+    int                     m_Handshakes = 0;       // クライアントのTLSハンドシェイクの回数
+
+    static constexpr int    Cycles  = 20;           // 緊急地震速報の処理を繰り返す回数
+    static constexpr int    Timeout = 10000;        // 1つのリクエストのタイムアウト [mS]
+
+private:
+    bool    Send(QNetworkAccessManager *pManager, const QUrl &url, bool bPost); // リクエストを送信して、レスポンスを受信するまで待機する (成功した場合はtrueを返す)
+    bool    Cycle(bool bShared);                                                // 緊急地震速報の1回の処理のリクエストを送信する
+
+private slots:
+    void initTestCase();
+
+    void cycle_data();
+    void cycle();
+};
+
+
+bool NetworkAccessBenchmark::Send(QNetworkAccessManager *pManager, const QUrl &url, bool bPost)
+{
+    auto request = NetworkAccess::createRequest(url, Timeout);
+
+    QNetworkReply *pReply = nullptr;
+    if (bPost) {
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+        pReply = pManager->post(request, QByteArray("bbs=eqinfo&key=1700000000&FROM=&mail=sage&MESSAGE=test&submit=%8F%91%82%AB%8D%9E%82%DE"));
+    }
+    else {
+        pReply = pManager->get(request);
+    }
+
+#ifdef NETWORKACCESSBENCHMARK_TLS
+    // スタンドインのサーバ証明書は自己署名証明書のため、証明書の検証のエラーを無視する
+    QObject::connect(pReply, &QNetworkReply::sslErrors, pReply, [pReply](const QList<QSslError> &) {
+        pReply->ignoreSslErrors();
+    });
+#endif
+
+    QEventLoop loop;
+    QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    const auto bSuccess = pReply->error() == QNetworkReply::NoError;
+    if (!bSuccess) qWarning().noquote() << pReply->errorString();
+
+    pReply->deleteLater();
+
+    return bSuccess;
+}
+
+
+// bSharedがfalseの場合は、リクエストごとにネットワークオブジェクトを作成して、レスポンスの受信後に破棄する
+bool NetworkAccessBenchmark::Cycle(bool bShared)
+{
+    const QList<QPair<QUrl, bool>> requests = {
+        {m_Jma.url(QLatin1String(StandInServer::FeedPath)), false},
+        {m_Bbs.url(QLatin1String(StandInServer::BbsPath)),  false},
+        {m_Bbs.url(QLatin1String(StandInServer::BbsPath)),  true}
+    };
+
+    for (const auto &request : requests) {
+        std::unique_ptr<QNetworkAccessManager> pFresh;
+
+        auto pManager = bShared ? NetworkAccess::manager() : (pFresh = std::make_unique<QNetworkAccessManager>()).get();
+
+#ifdef NETWORKACCESSBENCHMARK_TLS
+        auto connection = QObject::connect(pManager, &QNetworkAccessManager::encrypted, this, [this](QNetworkReply *) {
+            m_Handshakes++;
+        });
+#endif
+
+        const auto bSuccess = Send(pManager, request.first, request.second);
+
+#ifdef NETWORKACCESSBENCHMARK_TLS
+        QObject::disconnect(connection);
+#endif
+
+        if (!bSuccess) return false;
+    }
+
+    return true;
+}
+
+
+void NetworkAccessBenchmark::initTestCase()
+{
+    const auto certFile = QFINDTESTDATA("data/localhost.crt");
+    const auto keyFile  = QFINDTESTDATA("data/localhost.key");
+
+    QVERIFY(m_Jma.listen(certFile, keyFile));
+    QVERIFY(m_Bbs.listen(certFile, keyFile));
+
+#ifndef NETWORKACCESSBENCHMARK_TLS
+    qInfo().noquote() << QString("QSslServerクラスを使用できないため、HTTPで計測します (TLSハンドシェイクの回数は計測しません)");
+#endif
+}
+
+
+void NetworkAccessBenchmark::cycle_data()
+{
+    QTest::addColumn<bool>("bShared");
+
+    QTest::newRow("fresh")  << false;
+    QTest::newRow("shared") << true;
+}
+
+
+// 共用のネットワークオブジェクトは、最初の処理でのみ接続する
+// (最初の処理の時間は、1回目の処理として別に出力する)
+void NetworkAccessBenchmark::cycle()
+{
+    QFETCH(bool, bShared);
+
+    const auto connections = m_Jma.connections() + m_Bbs.connections();
+    m_Handshakes = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVERIFY(Cycle(bShared));
+    const auto first = timer.nsecsElapsed();
+
+    for (int i = 1; i < Cycles; i++) {
+        QVERIFY(Cycle(bShared));
+    }
+
+    const auto elapsed = timer.nsecsElapsed();
+
+    // 破棄したネットワークオブジェクトの接続の切断をスタンドインが受信するまで待機する
+    QTest::qWait(100);
+
+    const auto newConnections = m_Jma.connections() + m_Bbs.connections() - connections;
+
+    qInfo().noquote() << QString("%1回 : 接続数 %2 (1回あたり %3), TLSハンドシェイク %4 (1回あたり %5), 1回目 %6[mS]")
+                         .arg(Cycles)
+                         .arg(newConnections).arg(static_cast<double>(newConnections) / Cycles, 0, 'f', 2)
+                         .arg(m_Handshakes).arg(static_cast<double>(m_Handshakes) / Cycles, 0, 'f', 2)
+                         .arg(first / 1.0e6, 0, 'f', 2);
+
+    // 共用のネットワークオブジェクトは、気象庁および掲示板への接続を再利用する
+    if (bShared) QVERIFY(newConnections <= 2);
+
+    QTest::setBenchmarkResult(elapsed / 1.0e6 / Cycles, QTest::WalltimeMilliseconds);
+}
+
+
+QTEST_GUILESS_MAIN(NetworkAccessBenchmark)
+
+#include "NetworkAccessBenchmark.moc"
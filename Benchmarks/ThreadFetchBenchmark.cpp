@@ -0,0 +1,230 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <memory>
+#include "HtmlFetcher.h"
+#include "HtmlParser.h"
+#include "XPathCache.h"
+#include "ThreadPage.h"
+
+
+// 1000レスのスレッドのページを応答するローカルのHTTPサーバ (掲示板のスタンドイン)
+// 実際の掲示板からの受信と同様に、本文はChunkSize[バイト]ずつChunkInterval[mS]ごとに応答する
+// クライアントが転送を中断した (切断した) 場合は、応答を停止する
+class ThreadServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int    ChunkSize     = 64 * 1024;  // 1回に応答する本文のサイズ [バイト]
+    static constexpr int    ChunkInterval = 10;         // 本文を応答する間隔 [mS]
+
+private:
+    QTcpServer              m_Server;                   // HTTPサーバ
+    QByteArray              m_Page;                     // 応答するスレッドのページ
+    qint64                  m_SentBytes = 0;            // 応答した本文のバイト数の合計 (ヘッダを含まない)
+
+private:
+    // スレッドのページをChunkSize[バイト]ずつ応答する
+    // タイマは接続の子オブジェクトとして生成するため、クライアントが切断した場合は接続と共に破棄される
+    void Respond(QTcpSocket *pSocket)
+    {
+        pSocket->write("HTTP/1.1 200 OK\r\n"
+                       "Content-Type: text/html; charset=Shift_JIS\r\n"
+                       "Content-Length: " + QByteArray::number(m_Page.size()) + "\r\n"
+                       "Connection: keep-alive\r\n"
+                       "\r\n");
+
+        auto pTimer  = new QTimer(pSocket);
+        auto pOffset = std::make_shared<qsizetype>(0);
+        connect(pTimer, &QTimer::timeout, this, [this, pSocket, pTimer, pOffset]() {
+            // 切断の通知を受信する前に書き込んだ場合は、書き込みに失敗するため集計しない
+            const auto written = pSocket->state() == QAbstractSocket::ConnectedState ? pSocket->write(m_Page.mid(*pOffset, ChunkSize)) : -1;
+            if (written > 0) {
+                *pOffset    += written;
+                m_SentBytes += written;
+            }
+
+            if (written < 0 || *pOffset >= m_Page.size()) {
+                pTimer->stop();
+                pTimer->deleteLater();
+            }
+        });
+
+        pTimer->start(ChunkInterval);
+    }
+
+public:
+    explicit ThreadServer(QObject *parent = nullptr) : QObject{parent}
+    {
+        connect(&m_Server, &QTcpServer::newConnection, this, [this]() {
+            while (m_Server.hasPendingConnections()) {
+                auto pSocket = m_Server.nextPendingConnection();
+
+                // リクエストの本文は無いため、ヘッダの終端を受信した時点で応答する
+                auto pBuffer = std::make_shared<QByteArray>();
+                connect(pSocket, &QTcpSocket::readyRead, this, [this, pSocket, pBuffer]() {
+                    *pBuffer += pSocket->readAll();
+                    while (pBuffer->contains("\r\n\r\n")) {
+                        pBuffer->remove(0, pBuffer->indexOf("\r\n\r\n") + 4);
+                        Respond(pSocket);
+                    }
+                });
+                connect(pSocket, &QTcpSocket::disconnected, pSocket, &QObject::deleteLater);
+            }
+        });
+    }
+
+    bool listen(const QByteArray &page)
+    {
+        m_Page = page;
+        return m_Server.listen(QHostAddress::LocalHost, 0);
+    }
+
+    [[nodiscard]] QUrl url() const
+    {
+        return QUrl(QString("http://127.0.0.1:%1/test/read.cgi/eqinfo/1700000000/").arg(m_Server.serverPort()));
+    }
+
+    [[nodiscard]] qint64 sentBytes() const
+    {
+        return m_SentBytes;
+    }
+};
+
+
+// スレッドのタイトルの取得 (HtmlFetcher::fetchメソッド) のベンチマーク
+// 1000レスのスレッドのページ (Shift-JIS) からスレッドのタイトルを取得する場合について、
+//   full  : 以前の処理 (本文の全てを受信してからパースする)
+//   title : 現在の処理 (</title>タグを受信した時点で転送を中断して、受信済みの先頭部分のみをパースする)
+// の1回あたりの受信バイト数 (bytesテスト) および処理時間 (fetchテスト) を比較する
+//
+// 以前の処理は、<title>タグと同じ要素を指す別のXPath式 (/html/head/title[1]) を指定することにより再現する
+class ThreadFetchBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    ThreadServer            m_Server;           // スレッドのページを応答するスタンドイン
+    QByteArray              m_Page;             // スレッドのページ (Shift-JIS)
+
+    static constexpr int    Replies = 1000;     // スレッドのレス数
+    static constexpr int    Timeout = 10000;    // 1回の取得のタイムアウト [mS]
+    static constexpr char   Title[] = "【緊急地震速報】日向灘で地震 最大震度6弱";  // スレッドのタイトル
+
+private:
+    QString FetchTitle(const QString &xpath);   // スタンドインからスレッドのタイトルを取得する (失敗した場合は空の文字列を返す)
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void bytes_data();
+    void bytes();
+    void fetch_data();
+    void fetch();
+};
+
+
+QString ThreadFetchBenchmark::FetchTitle(const QString &xpath)
+{
+    HtmlFetcher fetcher;
+    bool        bDone = false;
+    int         iRet  = -1;
+
+    fetcher.fetch(m_Server.url(), false, xpath, true, Timeout, [&bDone, &iRet](int ret) {
+        iRet  = ret;
+        bDone = true;
+    });
+
+    if (!QTest::qWaitFor([&bDone]() { return bDone; }, Timeout) || iRet != 0) return QString();
+
+    return fetcher.GetElement();
+}
+
+
+void ThreadFetchBenchmark::initTestCase()
+{
+    HtmlParser::initialize();
+
+    m_Page = ThreadPage::generate(QString::fromUtf8(Title), Replies, true);
+    if (m_Page.isEmpty()) QSKIP("Shift-JISのエンコーダが使用できません");
+
+    QVERIFY(m_Server.listen(m_Page));
+
+    QVERIFY(XPathCache::compile(QStringLiteral("/html/head/title")));
+    QVERIFY(XPathCache::compile(QStringLiteral("/html/head/title[1]")));
+
+    qInfo().noquote() << QString("スレッドのページ : %1レス, %2[バイト]").arg(Replies).arg(m_Page.size());
+}
+
+
+void ThreadFetchBenchmark::cleanupTestCase()
+{
+    XPathCache::clear();
+    HtmlParser::cleanup();
+}
+
+
+void ThreadFetchBenchmark::bytes_data()
+{
+    QTest::addColumn<QString>("xpath");
+
+    QTest::newRow("full")  << QStringLiteral("/html/head/title[1]");
+    QTest::newRow("title") << QStringLiteral("/html/head/title");
+}
+
+
+// 1回の取得でスタンドインが応答した本文のバイト数を計測する
+// 転送を中断した場合は、中断するまでに応答した本文のバイト数となる (最大でChunkSize[バイト]の誤差を含む)
+void ThreadFetchBenchmark::bytes()
+{
+    QFETCH(QString, xpath);
+
+    const auto sentBytes = m_Server.sentBytes();
+    const auto stats     = HtmlFetcher::GetStats();
+
+    QCOMPARE(FetchTitle(xpath), QString::fromUtf8(Title));
+
+    // 中断した転送の応答が停止するまで待機する
+    QTest::qWait(ThreadServer::ChunkInterval * 5);
+
+    const auto sent     = m_Server.sentBytes() - sentBytes;
+    const auto received = HtmlFetcher::GetStats().TitleBytes - stats.TitleBytes;
+
+    if (xpath == QLatin1String("/html/head/title")) {
+        qInfo().noquote() << QString("応答 : %1[バイト], 受信 : %2[バイト] (ページの%3%)")
+                             .arg(sent).arg(received).arg(100.0 * received / m_Page.size(), 0, 'f', 1);
+
+        QVERIFY(sent < m_Page.size());
+    }
+    else {
+        qInfo().noquote() << QString("応答 : %1[バイト] (ページの全て)").arg(sent);
+
+        QCOMPARE(sent, static_cast<qint64>(m_Page.size()));
+    }
+}
+
+
+void ThreadFetchBenchmark::fetch_data()
+{
+    bytes_data();
+}
+
+
+// 転送を中断した場合は接続を再利用できないため、処理時間には新規接続の時間も含まれる
+void ThreadFetchBenchmark::fetch()
+{
+    QFETCH(QString, xpath);
+
+    QCOMPARE(FetchTitle(xpath), QString::fromUtf8(Title));
+
+    QBENCHMARK {
+        FetchTitle(xpath);
+    }
+}
+
+
+QTEST_GUILESS_MAIN(ThreadFetchBenchmark)
+
+#include "ThreadFetchBenchmark.moc"
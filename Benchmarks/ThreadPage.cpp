@@ -0,0 +1,73 @@
+#include <QtGlobal>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    #include <QStringEncoder>
+#else
+    #include <QTextCodec>
+#endif
+
+#include "ThreadPage.h"
+
+
+// 指定したタイトルおよびレス数のスレッドのページを生成する
+// エンコードに失敗した場合 (Shift-JISが使用できない場合) は、空のバイト列を返す
+QByteArray ThreadPage::generate(const QString &title, int replies, bool bShiftJIS)
+{
+    QString html;
+    html.reserve(replies * 600);
+
+    html += QString("<!DOCTYPE html>\n"
+                    "<html lang=\"ja\">\n"
+                    "<head>\n"
+                    "<meta http-equiv=\"Content-Type\" content=\"text/html; charset=%1\">\n"
+                    "<title>%2</title>\n"
+                    "<link rel=\"stylesheet\" href=\"/css/read.css\">\n"
+                    "</head>\n"
+                    "<body>\n"
+                    "<div class=\"navbar\"><a href=\"/test/read.cgi/eqalert/1723200000/\">全部</a> "
+                    "<a href=\"/test/read.cgi/eqalert/1723200000/l50\">最新50</a></div>\n"
+                    "<h1 class=\"title\">%2</h1>\n"
+                    "<div class=\"thread\">\n").arg(bShiftJIS ? "Shift_JIS" : "UTF-8", title);
+
+    for (int i = 1; i <= replies; i++) {
+        const auto second = i % 60;
+        const auto minute = (57 + i / 60) % 60;
+
+        html += QString("<div class=\"post\" id=\"%1\" data-userid=\"ID:Eq%2\" data-id=\"%1\">"
+                        "<div class=\"meta\"><span class=\"number\">%1</span>"
+                        "<span class=\"name\"><b>地震速報</b></span>"
+                        "<span class=\"date\">2024/08/09(金) 19:%3:%4.%5</span>"
+                        "<span class=\"uid\">ID:Eq%2</span></div>"
+                        "<div class=\"message\"><span class=\"escaped\"> "
+                        "震源地 : 日向灘 <br> 最大震度 : 震度%6 <br> マグニチュード : M%7 <br> "
+                        "震源の深さ : 約30[km] <br> この地震による津波の心配はありません。 <br> "
+                        "<a href=\"https://typhoon.yahoo.co.jp/weather/jp/earthquake/\">https://typhoon.yahoo.co.jp/weather/jp/earthquake/</a> "
+                        "</span></div></div><br>\n")
+                    .arg(i)
+                    .arg(i % 97, 4, 10, QLatin1Char('0'))
+                    .arg(minute, 2, 10, QLatin1Char('0'))
+                    .arg(second, 2, 10, QLatin1Char('0'))
+                    .arg(i % 100, 2, 10, QLatin1Char('0'))
+                    .arg(1 + i % 6)
+                    .arg(QString::number(3.0 + (i % 40) / 10.0, 'f', 1));
+    }
+
+    html += QString("</div>\n"
+                    "<div class=\"footer\">このスレッドは%1を超えました。</div>\n"
+                    "</body>\n"
+                    "</html>\n").arg(replies);
+
+    if (!bShiftJIS) return html.toUtf8();
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QStringEncoder encoder("Shift-JIS");
+    if (!encoder.isValid()) return QByteArray();
+
+    return encoder(html);
+#else
+    auto codec = QTextCodec::codecForName("Shift-JIS");
+    if (codec == nullptr) return QByteArray();
+
+    return codec->fromUnicode(html);
+#endif
+}
@@ -0,0 +1,22 @@
+#ifndef THREADPAGE_H
+#define THREADPAGE_H
+
+#include <QByteArray>
+#include <QString>
+
+
+// ベンチマークで使用する掲示板のスレッドのページ (read.cgiの応答と同じ形式のHTML) を生成するクラス
+// 書き込み (レス) の本文は、地震情報の書き込みと同程度の長さとする
+class ThreadPage
+{
+public:     // Methods
+    ThreadPage()                                = delete;
+    ThreadPage(const ThreadPage&)               = delete;
+    ThreadPage& operator=(const ThreadPage&)    = delete;
+
+    static QByteArray   generate(const QString &title, int replies, bool bShiftJIS);   // 指定したタイトルおよびレス数のスレッドのページを生成する
+                                                                                        // bShiftJISがtrueの場合はShift-JIS、falseの場合はUTF-8でエンコードする
+};
+
+
+#endif // THREADPAGE_H
@@ -0,0 +1,142 @@
+#include <QtTest>
+#include <libxml/HTMLparser.h>
+#include <libxml/xpath.h>
+#include "HtmlParser.h"
+#include "XPathCache.h"
+
+
+// 震度画像の検索 (Image::FetchUrlメソッド) におけるXPath式の評価のベンチマーク
+// 保存したYahoo天気・災害の地震情報一覧のページ (data/eqlist.html) から、設定ファイルのデフォルトのXPath式を使用して、
+// 指定した日時の地震情報のURLを検索する時間を、XPath式を評価ごとにコンパイルする場合 (xmlXPathEvalExpression関数および
+// xmlXPathNodeEval関数) と、コンパイル済みのXPath式 (XPathCacheクラス) を使用する場合で比較する
+//
+// HTMLのパースは計測に含めない (ページは最初に1度だけパースする)
+class XPathCacheBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    xmlDocPtr           m_pDoc = nullptr;   // パースした地震情報一覧のページ
+
+    // 設定ファイル (etc/qEQAlert.json.in) のデフォルトのXPath式
+    const QString       m_ListXPath   = QStringLiteral("/html/body/div[@id='wrapper']/div[@id='contents']/div[@id='contents-body']/div[@id='main']"
+                                                       "/div[@class='yjw_main_md']/div[@id='eqhist']/table[@class='yjw_table yjSt boderset']"
+                                                       "/descendant::tr[position()>1 and position()<=11]");
+    const QString       m_DetailXPath = QStringLiteral("./td");
+    const QString       m_UrlXPath    = QStringLiteral("./a/@href");
+
+    // 検索する日時 (一覧の10行目 : 全ての行を検索する場合)
+    const QByteArray    m_Date        = QStringLiteral("2024年8月8日 12時51分ごろ").toUtf8();
+
+private:
+    QString FindUrl(bool bCompiled) const;  // 指定した日時の地震情報のURLを検索する
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void findUrl_data();
+    void findUrl();
+};
+
+
+// 指定した日時の地震情報のURLを検索する (Image::FetchUrlメソッドと同じ手順)
+// bCompiledがtrueの場合はコンパイル済みのXPath式を使用して、falseの場合は評価ごとにXPath式をコンパイルする
+// 見つからない場合は空の文字列を返す
+QString XPathCacheBenchmark::FindUrl(bool bCompiled) const
+{
+    auto Eval = [bCompiled](const QString &expression, xmlXPathContextPtr context, xmlNodePtr node) {
+        if (bCompiled) return XPathCache::eval(expression, context, node);
+
+        if (node == nullptr) return xmlXPathEvalExpression(reinterpret_cast<const xmlChar*>(expression.toUtf8().constData()), context);
+
+        return xmlXPathNodeEval(node, reinterpret_cast<const xmlChar*>(expression.toUtf8().constData()), context);
+    };
+
+    QString url;
+
+    xmlXPathContextPtr context = xmlXPathNewContext(m_pDoc);
+    xmlXPathObjectPtr  result  = Eval(m_ListXPath, context, nullptr);
+
+    for (int i = 0; result && result->nodesetval && i < result->nodesetval->nodeNr && url.isEmpty(); i++) {
+        xmlXPathObjectPtr tdResult = Eval(m_DetailXPath, context, result->nodesetval->nodeTab[i]);
+
+        for (int j = 0; tdResult && tdResult->nodesetval && j < tdResult->nodesetval->nodeNr && url.isEmpty(); j++) {
+            xmlNodePtr tdNode  = tdResult->nodesetval->nodeTab[j];
+            xmlChar   *content = xmlNodeGetContent(tdNode);
+
+            if (xmlStrEqual(content, reinterpret_cast<const xmlChar*>(m_Date.constData()))) {
+                xmlXPathObjectPtr aResult = Eval(m_UrlXPath, context, tdNode);
+                if (aResult && !xmlXPathNodeSetIsEmpty(aResult->nodesetval)) {
+                    xmlChar *href = xmlNodeGetContent(aResult->nodesetval->nodeTab[0]);
+                    url           = QString::fromUtf8(reinterpret_cast<const char*>(href));
+                    xmlFree(href);
+                }
+
+                xmlXPathFreeObject(aResult);
+            }
+
+            xmlFree(content);
+        }
+
+        xmlXPathFreeObject(tdResult);
+    }
+
+    xmlXPathFreeObject(result);
+    xmlXPathFreeContext(context);
+
+    return url;
+}
+
+
+void XPathCacheBenchmark::initTestCase()
+{
+    HtmlParser::initialize();
+
+    QFile file(QFINDTESTDATA("data/eqlist.html"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    m_pDoc = HtmlParser::parse(file.readAll(), false);
+    QVERIFY(m_pDoc != nullptr);
+
+    // 設定ファイルの読み込み時と同様に、XPath式を事前にコンパイルする
+    QVERIFY(XPathCache::compile(m_ListXPath));
+    QVERIFY(XPathCache::compile(m_DetailXPath));
+    QVERIFY(XPathCache::compile(m_UrlXPath));
+}
+
+
+void XPathCacheBenchmark::cleanupTestCase()
+{
+    if (m_pDoc != nullptr) xmlFreeDoc(m_pDoc);
+
+    XPathCache::clear();
+    HtmlParser::cleanup();
+}
+
+
+void XPathCacheBenchmark::findUrl_data()
+{
+    QTest::addColumn<bool>("bCompiled");
+
+    QTest::newRow("xmlXPathEvalExpression") << false;
+    QTest::newRow("XPathCache")             << true;
+}
+
+
+void XPathCacheBenchmark::findUrl()
+{
+    QFETCH(bool, bCompiled);
+
+    // 計測の前に、いずれの方法でも同じURLが見つかることを確認する
+    QCOMPARE(FindUrl(bCompiled), QStringLiteral("/weather/jp/earthquake/20240808125114.html?e=1"));
+
+    QBENCHMARK {
+        FindUrl(bCompiled);
+    }
+}
+
+
+QTEST_GUILESS_MAIN(XPathCacheBenchmark)
+
+#include "XPathCacheBenchmark.moc"
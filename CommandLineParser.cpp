@@ -22,6 +22,12 @@ void CommandLineParser::process(const QStringList &arguments)
         else if (arg.startsWith("--test-file=")) {
             m_TestFileSet  = true;
         }
+        else if (arg.startsWith("--convert-log=")) {
+            m_ConvertLogSet = true;
+        }
+        else if (arg.startsWith("--confdir=")) {
+            m_ConfDirSet = true;
+        }
         else if (arg.startsWith("-")) {
             // 未知のオプションとして扱う
             m_unknownOptionNames.append(arg);
@@ -61,3 +67,15 @@ bool CommandLineParser::isTestFileSet() const
 {
     return m_TestFileSet;
 }
+
+
+bool CommandLineParser::isConvertLogSet() const
+{
+    return m_ConvertLogSet;
+}
+
+
+bool CommandLineParser::isConfDirSet() const
+{
+    return m_ConfDirSet;
+}
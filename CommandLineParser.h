@@ -13,6 +13,8 @@ private:
     bool        m_VersionSet   = false;
     bool        m_SysConfSet   = false;
     bool        m_TestFileSet  = false;
+    bool        m_ConvertLogSet = false;
+    bool        m_ConfDirSet   = false;
     QStringList m_unknownOptionNames;
 
 public:
@@ -24,6 +26,8 @@ public:
     bool        isVersionSet()          const;
     bool        isSysConfSet()          const;
     bool        isTestFileSet()         const;
+    bool        isConvertLogSet()       const;
+    bool        isConfDirSet()          const;
 };
 
 #endif // COMMANDLINEPARSER_H
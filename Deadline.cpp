@@ -0,0 +1,216 @@
+#include <QStringList>
+#include <algorithm>
+#include <utility>
+#include "Deadline.h"
+
+
+// 指定した時刻を起点として期限を開始する
+// 前回の各段階の所要時間は破棄する
+void Deadline::start(std::chrono::steady_clock::time_point origin, qint64 budget)
+{
+    m_Start  = origin;
+    m_Budget = std::max<qint64>(budget, 0);
+    m_Stages.clear();
+}
+
+
+// 期限を無効にして、各段階の所要時間を破棄する
+void Deadline::reset()
+{
+    m_Budget = 0;
+    m_Stages.clear();
+}
+
+
+// 期限が有効かどうかを確認する
+bool Deadline::isActive() const
+{
+    return m_Budget > 0;
+}
+
+
+// 予算 [mS] を取得する
+qint64 Deadline::budget() const
+{
+    return m_Budget;
+}
+
+
+// 起点からの経過時間 [mS] を取得する
+qint64 Deadline::elapsed() const
+{
+    return static_cast<qint64>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_Start).count());
+}
+
+
+// 残り時間 [mS] を取得する
+// 無効の場合は-1、期限切れの場合は0を返す
+qint64 Deadline::remaining() const
+{
+    if (!isActive()) return -1;
+
+    return std::max<qint64>(m_Budget - elapsed(), 0);
+}
+
+
+// 期限切れかどうかを確認する
+bool Deadline::hasExpired() const
+{
+    return isActive() && remaining() == 0;
+}
+
+
+// 指定した時間 [mS] 以上の残り時間があるかどうかを確認する
+// 無効の場合は、常にtrueを返す
+bool Deadline::hasBudget(qint64 required) const
+{
+    return !isActive() || remaining() >= required;
+}
+
+
+// 残り時間に制限したタイムアウト [mS] を取得する
+// 無効の場合はfallbackをそのまま返す
+// 期限切れの場合も0 (タイムアウトしない) にならないように、最小値は1[mS]とする
+int Deadline::timeout(int fallback) const
+{
+    if (!isActive()) return fallback;
+
+    auto limit = remaining();
+    if (fallback > 0) limit = std::min<qint64>(limit, fallback);
+
+    return static_cast<int>(std::max<qint64>(limit, 1));
+}
+
+
+// 段階の開始を記録する
+void Deadline::beginStage(const QString &name)
+{
+    STAGETIME stage;
+    stage.Name  = name;
+    stage.Start = elapsed();
+
+    m_Stages.append(stage);
+}
+
+
+// 段階の終了を記録する
+// 同じ名前の段階のうち、実行中の最後の段階を終了する
+void Deadline::endStage(const QString &name)
+{
+    for (auto i = m_Stages.count() - 1; i >= 0; i--) {
+        auto &stage = m_Stages[i];
+        if (stage.Name != name || stage.bSkipped || stage.Msecs >= 0) continue;
+
+        stage.Msecs = elapsed() - stage.Start;
+        return;
+    }
+}
+
+
+// 残り時間が少ないため段階を省略したことを記録する
+void Deadline::skipStage(const QString &name)
+{
+    STAGETIME stage;
+    stage.Name     = name;
+    stage.Start    = elapsed();
+    stage.Msecs    = 0;
+    stage.bSkipped = true;
+
+    m_Stages.append(stage);
+}
+
+
+// 他の段階と並行して実行する段階の開始を記録する
+// 段階の終了は、通常の段階と同様にendStageメソッドで記録する
+void Deadline::beginBackgroundStage(const QString &name)
+{
+    STAGETIME stage;
+    stage.Name        = name;
+    stage.Start       = elapsed();
+    stage.bBackground = true;
+
+    m_Stages.append(stage);
+}
+
+
+// 並行して実行する段階の完了の待機を開始したことを記録する
+// 待機を開始するまでの時間は他の段階と並行して実行できた時間、待機を開始した後の時間は待機した時間となる
+void Deadline::joinStage(const QString &name)
+{
+    for (auto i = m_Stages.count() - 1; i >= 0; i--) {
+        auto &stage = m_Stages[i];
+        if (stage.Name != name || !stage.bBackground || stage.Joined >= 0) continue;
+
+        stage.Joined = elapsed();
+        return;
+    }
+}
+
+
+// 並行して実行する段階が、他の段階と並行して実行できた時間 [mS] を取得する
+// 完了を待機する前に終了した場合は所要時間の全て、待機中に終了した場合は待機を開始するまでの時間となる
+qint64 Deadline::overlap(const STAGETIME &stage)
+{
+    if (!stage.bBackground || stage.Msecs < 0) return 0;
+
+    auto end = stage.Start + stage.Msecs;
+    if (stage.Joined >= 0) end = std::min(end, stage.Joined);
+
+    return std::max<qint64>(end - stage.Start, 0);
+}
+
+
+// 各段階の所要時間を取得する
+QList<STAGETIME> Deadline::stages() const
+{
+    return m_Stages;
+}
+
+
+// 各段階が使用した予算を表す文字列を取得する
+// 並行して実行する段階は、他の段階と並行して実行できた時間を付加する
+// 例 : "予算 : 15000 [mS], 経過 : 820 [mS] (書き込みの準備 : 180 [mS] (1.2 %, 並行 : 180 [mS]), ダウンロード : 120 [mS] (0.8 %), 書き込み : 650 [mS] (4.3 %))"
+QString Deadline::report() const
+{
+    QStringList items;
+    for (const auto &stage : m_Stages) {
+        if (stage.bSkipped) {
+            items.append(QString("%1 : 省略").arg(stage.Name));
+        }
+        else if (stage.Msecs < 0) {
+            items.append(QString("%1 : 中断").arg(stage.Name));
+        }
+        else if (isActive()) {
+            auto item = QString("%1 : %2 [mS] (%3 %")
+                        .arg(stage.Name)
+                        .arg(stage.Msecs)
+                        .arg(static_cast<double>(stage.Msecs) * 100.0 / static_cast<double>(m_Budget), 0, 'f', 1);
+            if (stage.bBackground) item += QString(", 並行 : %1 [mS]").arg(overlap(stage));
+
+            items.append(item + ")");
+        }
+        else if (stage.bBackground) {
+            items.append(QString("%1 : %2 [mS] (並行 : %3 [mS])").arg(stage.Name).arg(stage.Msecs).arg(overlap(stage)));
+        }
+        else {
+            items.append(QString("%1 : %2 [mS]").arg(stage.Name).arg(stage.Msecs));
+        }
+    }
+
+    auto header = isActive() ? QString("予算 : %1 [mS], 経過 : %2 [mS]").arg(m_Budget).arg(elapsed())
+                             : QString("経過 : %1 [mS]").arg(elapsed());
+
+    return items.isEmpty() ? header : QString("%1 (%2)").arg(header, items.join(", "));
+}
+
+
+DeadlineStage::DeadlineStage(Deadline &deadline, QString name) : m_Deadline(deadline), m_Name(std::move(name))
+{
+    m_Deadline.beginStage(m_Name);
+}
+
+
+DeadlineStage::~DeadlineStage()
+{
+    m_Deadline.endStage(m_Name);
+}
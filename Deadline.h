@@ -0,0 +1,74 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <QString>
+#include <QList>
+#include <chrono>
+
+
+// 処理の各段階の所要時間
+struct STAGETIME {
+    QString         Name;               // 段階の名前
+    qint64          Start    = 0,       // 段階を開始した時刻 (期限の起点からの経過時間) [mS]
+                    Msecs    = -1,      // 段階の所要時間 [mS] (-1の場合は実行中)
+                    Joined   = -1;      // 並行して実行する段階の完了の待機を開始した時刻 [mS] (-1の場合は待機していない)
+    bool            bSkipped    = false,    // 残り時間が少ないため省略したかどうか
+                    bBackground = false;    // 他の段階と並行して実行する段階かどうか
+};
+
+
+// 地震情報を検出した時刻を起点とする処理の期限 (予算)
+// 各段階 (ダウンロード、解析、ログファイルの確認、クッキーの取得、書き込み) は、
+// 開始前に残り時間を確認して、リクエストのタイムアウトおよびロックの待機時間を残り時間以内に制限する
+// 書き込みの準備 (クッキーの取得および接続の確立) は、ダウンロードおよび解析と並行して実行するため、並行して実行できた時間も記録する
+//
+// 予算が0以下の場合は無効となり、期限切れにならない (各段階は従来のタイムアウトを使用する)
+class Deadline
+{
+private:    // Variables
+    std::chrono::steady_clock::time_point   m_Start;        // 期限の起点 (地震情報を検出した時刻)
+    qint64                                  m_Budget = 0;   // 予算 [mS]
+    QList<STAGETIME>                        m_Stages;       // 各段階の所要時間 (開始順)
+
+public:     // Methods
+    Deadline() = default;
+    void    start(std::chrono::steady_clock::time_point origin, qint64 budget);     // 指定した時刻を起点として期限を開始する
+    void    reset();                                                                // 期限を無効にして、各段階の所要時間を破棄する
+    [[nodiscard]] bool      isActive() const;                                       // 期限が有効かどうかを確認する
+    [[nodiscard]] qint64    budget() const;                                         // 予算 [mS] を取得する
+    [[nodiscard]] qint64    elapsed() const;                                        // 起点からの経過時間 [mS] を取得する
+    [[nodiscard]] qint64    remaining() const;                                      // 残り時間 [mS] を取得する (無効の場合は-1)
+    [[nodiscard]] bool      hasExpired() const;                                     // 期限切れかどうかを確認する
+    [[nodiscard]] bool      hasBudget(qint64 required) const;                       // 指定した時間 [mS] 以上の残り時間があるかどうかを確認する
+    [[nodiscard]] int       timeout(int fallback) const;                            // 残り時間に制限したタイムアウト [mS] を取得する
+                                                                                    // 無効の場合はfallbackを返す (fallbackが0以下の場合は残り時間を返す)
+    void    beginStage(const QString &name);                                        // 段階の開始を記録する
+    void    endStage(const QString &name);                                          // 段階の終了を記録する
+    void    skipStage(const QString &name);                                         // 残り時間が少ないため段階を省略したことを記録する
+    void    beginBackgroundStage(const QString &name);                              // 他の段階と並行して実行する段階の開始を記録する
+    void    joinStage(const QString &name);                                         // 並行して実行する段階の完了の待機を開始したことを記録する
+    [[nodiscard]] static qint64     overlap(const STAGETIME &stage);                // 並行して実行する段階が、他の段階と並行して実行できた時間 [mS] を取得する
+    [[nodiscard]] QList<STAGETIME>  stages() const;                                 // 各段階の所要時間を取得する
+    [[nodiscard]] QString           report() const;                                 // 各段階が使用した予算を表す文字列を取得する
+};
+
+
+// 段階の開始と終了を記録するクラス (RAIIパターンを使用)
+// スコープを抜ける時に、段階の終了を記録する
+class DeadlineStage
+{
+private:    // Variables
+    Deadline    &m_Deadline;
+    QString     m_Name;
+
+private:    // Methods
+    DeadlineStage(const DeadlineStage&)             = delete;
+    DeadlineStage& operator=(const DeadlineStage&)  = delete;
+
+public:     // Methods
+    DeadlineStage(Deadline &deadline, QString name);
+    ~DeadlineStage();
+};
+
+
+#endif // DEADLINE_H
@@ -1,83 +1,267 @@
 #include <QTimeZone>
+#include <QTimer>
+#include <QElapsedTimer>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 #include <utility>
 #include "EarthQuake.h"
 #include "HtmlFetcher.h"
-#include "LockFileGuard.h"
+#include "NetworkAccess.h"
+#include "EventStore.h"
+#include "ThreadCache.h"
+#include "FeedFetcher.h"
 
 
-EarthQuake::EarthQuake(COMMONDATA CommonData, THREAD_INFO ThreadInfo, EQIMAGEINFO &EQImageInfo,
-                       bool bEQAlert,         QString EQAlertURL,     QString AlertFile,
-                       bool bEQInfo,          QString EQInfoURL,      QString InfoFile,
+EarthQuake::EarthQuake(COMMONDATA CommonData, QList<BOARDCONFIG> Boards, EQIMAGEINFO &EQImageInfo,
+                       bool bEQAlert,         QString EQAlertURL,
+                       bool bEQInfo,          QString EQInfoURL,
                        QObject *parent) :
-    m_CommonData(CommonData), m_ThreadInfo(ThreadInfo),            m_EQImageInfo(EQImageInfo),
-    m_bEQAlert(bEQAlert),     m_EQAlertURL(std::move(EQAlertURL)), m_AlertFile(std::move(AlertFile)),
-    m_bEQInfo(bEQInfo),       m_EQInfoURL(std::move(EQInfoURL)),   m_InfoFile(std::move(InfoFile)),
+    m_CommonData(CommonData), m_Boards(std::move(Boards)),          m_EQImageInfo(EQImageInfo),
+    m_bEQAlert(bEQAlert),     m_EQAlertURL(std::move(EQAlertURL)),
+    m_bEQInfo(bEQInfo),       m_EQInfoURL(std::move(EQInfoURL)),
     QObject{parent}
 {
 }
 
 
-EarthQuake::~EarthQuake() = default;
+EarthQuake::~EarthQuake()
+{
+    // 各スレッドを終了してから、地震情報オブジェクトを破棄する
+    StopWorkers(m_EQAlertWorkers, m_EQAlertThreads);
+    StopWorkers(m_EQInfoWorkers,  m_EQInfoThreads);
+}
 
 
-int EarthQuake::EQProcessAlert()
+// 掲示板ごとに地震情報オブジェクトを生成して、それぞれ専用のスレッドで実行する
+// 地震情報の取得および解析は、先頭の掲示板のオブジェクトのみで行う (フィードの取得は、掲示板の数に関わらず1度のみ)
+// 2つ目以降の掲示板のオブジェクトは、先頭の掲示板のオブジェクトから整形した地震情報を受け取り、それぞれのスレッドで並行して書き込む
+// 各掲示板のオブジェクトは、クッキー、Shift-JISの有効 / 無効、ログファイルおよび送信待ちの書き込みを個別に持つ
+void EarthQuake::CreateWorkers(COMMONDATA data, bool bAlert,
+                               std::vector<std::unique_ptr<Worker>> &workers, std::vector<std::unique_ptr<QThread>> &threads,
+                               const QString &name)
 {
-    // 緊急地震速報(警報)の処理を実行
-    // 現在は非同期(マルチスレッド)で実行しない
-    if (m_bEQAlert) {
-        if (m_pEQAlertWorker == nullptr) {
-            COMMONDATA data   = m_CommonData;
-            data.EQInfoURL    = m_EQAlertURL;
-            data.LogFile      = m_AlertFile;
-            data.bChangeTitle = false;
+    for (qsizetype i = 0; i < m_Boards.size(); i++) {
+        const auto &board = m_Boards.at(i);
+
+        data.RequestURL = board.RequestURL;
+        data.BoardName  = m_Boards.size() > 1 ? board.ThreadInfo.bbs : QString();
 
-            m_pEQAlertWorker = std::make_unique<Worker>(data, m_ThreadInfo);
+        if (bAlert) {
+            data.LogFile      = board.AlertFile;
         }
         else {
-            m_pEQAlertWorker->initialize();
+            data.LogFile      = board.InfoFile;
+            data.bChangeTitle = board.bChangeTitle;
+            data.MaxThreadNum = board.MaxReplies;
         }
 
-        m_pEQAlertWorker->ProcessEQAlert();
+        std::unique_ptr<QThread> pThread;
+        auto pWorker = CreateWorker(data, board.ThreadInfo, pThread, i == 0 ? name : QString("%1-%2").arg(name).arg(i));
+
+        // 先頭の掲示板のオブジェクトのメンバは、先頭の掲示板のオブジェクトのスレッドでのみ操作する
+        // 最初の地震情報の処理より前に実行されるように、キューイングする
+        if (i != 0) {
+            QMetaObject::invokeMethod(workers.front().get(), [pLead = workers.front().get(), pBoard = pWorker.get()]() {
+                pLead->AddBoard(pBoard);
+            }, Qt::QueuedConnection);
+        }
+
+        workers.push_back(std::move(pWorker));
+        threads.push_back(std::move(pThread));
+    }
+}
+
+
+// 地震情報オブジェクトを生成して、専用のスレッドで実行する
+// 緊急地震速報(警報)と発生した地震情報はそれぞれ別のスレッドおよびイベントループで処理するため、
+// 発生した地震情報の処理 (震度画像の検索、スレッドの生存確認等) に時間が掛かる場合でも、緊急地震速報(警報)の書き込みは遅延しない
+// また、HTTPクライアントはスレッドごとに作成されるため、ネットワークの接続も共用しない
+std::unique_ptr<Worker> EarthQuake::CreateWorker(const COMMONDATA &data, const THREAD_INFO &threadInfo, std::unique_ptr<QThread> &pThread, const QString &name)
+{
+    auto pWorker = std::make_unique<Worker>(data, threadInfo);
+
+    // finishedシグナルは、地震情報オブジェクトのスレッドからこのオブジェクトのスレッドへキューイングされる
+    // 2つ目以降の掲示板のオブジェクトは地震情報を取得しないため、finishedシグナルを送信しない
+    connect(pWorker.get(), &Worker::finished, this, &EarthQuake::finished);
+
+    pThread = std::make_unique<QThread>();
+    pThread->setObjectName(name);
+    pWorker->moveToThread(pThread.get());
+    pThread->start();
+
+    // 書き込み時の遅延を削減するため、掲示板との接続を事前に確立する
+    QMetaObject::invokeMethod(pWorker.get(), &Worker::WarmUp, Qt::QueuedConnection);
+
+    return pWorker;
+}
+
+
+// 地震情報オブジェクトの処理をキャンセルして、スレッドを終了する
+// スレッドを終了する場合は、送信中のリクエスト (書き込み等) も中断する
+// 各地震情報オブジェクトは専用のスレッドで実行されるため、中断するリクエストはそのオブジェクトのリクエストのみである
+// (他の設定ファイルと共有しているリクエストは中断しない)
+// 先頭の掲示板のオブジェクトは他の掲示板のオブジェクトへ地震情報を配信するため、先頭の掲示板のオブジェクトから順に終了する
+void EarthQuake::StopWorkers(std::vector<std::unique_ptr<Worker>> &workers, std::vector<std::unique_ptr<QThread>> &threads)
+{
+    for (size_t i = 0; i < threads.size(); i++) {
+        // スレッドを終了する前に実行されるように、処理の完了を待機する
+        QMetaObject::invokeMethod(workers.at(i).get(), [pTarget = workers.at(i).get()]() {
+            pTarget->cancel();
+            NetworkAccess::abortAll();
+        }, Qt::BlockingQueuedConnection);
+
+        threads.at(i)->quit();
+        threads.at(i)->wait();
+    }
+
+    workers.clear();
+    threads.clear();
+}
+
+
+int EarthQuake::EQProcessAlert(const QByteArray &pushedData)
+{
+    // 緊急地震速報(警報)の処理を実行
+    // 地震情報の取得は専用のスレッドで非同期で実行して、処理の終了時にfinishedシグナルを送信する
+    if (!m_bEQAlert || m_Boards.isEmpty()) return -1;
+
+    if (m_EQAlertWorkers.empty()) {
+        COMMONDATA data   = m_CommonData;
+        data.EQInfoURL    = m_EQAlertURL;
+        data.bChangeTitle = false;
+
+        CreateWorkers(data, true, m_EQAlertWorkers, m_EQAlertThreads, QStringLiteral("EQAlert"));
     }
 
+    // 地震情報オブジェクトのメンバは、地震情報オブジェクトのスレッドでのみ操作する
+    QMetaObject::invokeMethod(m_EQAlertWorkers.front().get(), [pWorker = m_EQAlertWorkers.front().get(), pushedData]() {
+        if (pWorker->IsRunning()) {
+            // 処理中の場合、WebSocket APIから受信したデータは処理の終了後に処理する
+            // JSON APIからの取得は、処理中の取得と重複するため行わない
+            if (!pushedData.isEmpty()) pWorker->EnqueuePushedData(pushedData);
+
+            return;
+        }
+
+        pWorker->initialize();
+
+        // P2P地震情報のWebSocket APIから受信したデータ (空の場合はJSON APIから取得する)
+        pWorker->SetPushedData(pushedData);
+        pWorker->ProcessEQAlert();
+    }, Qt::QueuedConnection);
+
     return 0;
 }
 
 
-int EarthQuake::EQProcessInfo()
+int EarthQuake::EQProcessInfo(const QByteArray &pushedData)
 {
     // 発生した地震情報の処理を実行
-    // 現在は非同期(マルチスレッド)で実行しない
-    if (m_bEQInfo) {
-        if (m_pEQInfoWorker == nullptr) {
-            COMMONDATA data   = m_CommonData;
-            data.EQInfoURL    = m_EQInfoURL;
-            data.LogFile      = m_InfoFile;
-            data.bSubjectTime = false;
+    // 地震情報の取得は専用のスレッドで非同期で実行して、処理の終了時にfinishedシグナルを送信する
+    if (!m_bEQInfo || m_Boards.isEmpty()) return -1;
+
+    if (m_EQInfoWorkers.empty()) {
+        COMMONDATA data   = m_CommonData;
+        data.EQInfoURL    = m_EQInfoURL;
+        data.bSubjectTime = false;
+
+        CreateWorkers(data, false, m_EQInfoWorkers, m_EQInfoThreads, QStringLiteral("EQInfo"));
+    }
+
+    // 地震情報オブジェクトのメンバは、地震情報オブジェクトのスレッドでのみ操作する
+    // 震度画像を取得するための設定オブジェクトは、処理中に日時を書き換えるため、呼び出し元のスレッドで複製して渡す
+    QMetaObject::invokeMethod(m_EQInfoWorkers.front().get(), [pWorker = m_EQInfoWorkers.front().get(), pushedData, imageInfo = m_EQImageInfo]() {
+        if (pWorker->IsRunning()) {
+            // 処理中の場合、WebSocket APIから受信したデータは処理の終了後に処理する
+            // JSON APIからの取得は、処理中の取得と重複するため行わない
+            if (!pushedData.isEmpty()) pWorker->EnqueuePushedData(pushedData);
 
-            m_pEQInfoWorker = std::make_unique<Worker>(data, m_ThreadInfo);
+            return;
         }
-        else {
-            m_pEQInfoWorker->initialize();
+
+        pWorker->initialize();
+
+        // P2P地震情報のWebSocket APIから受信したデータ (空の場合はJSON APIから取得する)
+        pWorker->SetPushedData(pushedData);
+        pWorker->ProcessEQInfo(imageInfo);
+    }, Qt::QueuedConnection);
+
+    return 0;
+}
+
+
+// 処理中の地震情報の処理をキャンセルする
+// 各地震情報オブジェクトのスレッドで、そのオブジェクトが送信中のリクエストを中断する (他の設定ファイルと共有しているリクエストは中断しない)
+void EarthQuake::cancel()
+{
+    for (const auto *pWorkers : {&m_EQAlertWorkers, &m_EQInfoWorkers}) {
+        for (const auto &pWorker : *pWorkers) {
+            QMetaObject::invokeMethod(pWorker.get(), [pTarget = pWorker.get()]() {
+                pTarget->cancel();
+                NetworkAccess::abortAll();
+            }, Qt::QueuedConnection);
         }
+    }
+}
+
 
-        m_pEQInfoWorker->ProcessEQInfo(m_EQImageInfo);
+// 条件付きGETリクエストおよびXMLの解析の統計を取得する
+// 緊急地震速報(警報)および発生した地震情報の全ての掲示板の合計値を返す
+FEEDSTATS EarthQuake::GetFeedStats() const
+{
+    FEEDSTATS stats;
+
+    for (const auto *pWorkers : {&m_EQAlertWorkers, &m_EQInfoWorkers}) {
+        for (const auto &pWorker : *pWorkers) {
+            auto workerStats    = pWorker->GetFeedStats();
+            stats.NotModified  += workerStats.NotModified;
+            stats.Modified     += workerStats.Modified;
+            stats.StreamParsed += workerStats.StreamParsed;
+            stats.DomParsed    += workerStats.DomParsed;
+            stats.Fallbacks    += workerStats.Fallbacks;
+            stats.StreamNsecs  += workerStats.StreamNsecs;
+            stats.DomNsecs     += workerStats.DomNsecs;
+            stats.Posts        += workerStats.Posts;
+            stats.PostNsecs    += workerStats.PostNsecs;
+            stats.MaxPostNsecs  = std::max(stats.MaxPostNsecs, workerStats.MaxPostNsecs);
+            stats.CookieReuses += workerStats.CookieReuses;
+            stats.CookieFetches += workerStats.CookieFetches;
+            stats.DeadlineMisses += workerStats.DeadlineMisses;
+        }
     }
 
-    return 0;
+    return stats;
 }
 
 
-Worker::Worker(QObject *parent) : QObject(parent)
+// 掲示板に書き込むオブジェクトおよびタイマは、スレッドへ移動する場合に共に移動するため、このオブジェクトの子オブジェクトとして生成する
+Worker::Worker(QObject *parent) : m_pPoster(std::make_unique<Poster>(this)), m_OutboxTimer(this), QObject(parent)
 {
+    m_OutboxTimer.setSingleShot(true);
+    connect(&m_OutboxTimer, &QTimer::timeout, this, &Worker::ProcessOutbox);
 }
 
 
 Worker::Worker(COMMONDATA commondata, THREAD_INFO threadInfo, QObject *parent)
-    : m_CommonData(std::move(commondata)), m_ThreadInfo(std::move(threadInfo)), QObject(parent)
+    : m_pPoster(std::make_unique<Poster>(this)), m_CommonData(std::move(commondata)), m_ThreadInfo(std::move(threadInfo)), m_OutboxTimer(this), QObject(parent)
+{
+    m_OutboxTimer.setSingleShot(true);
+    connect(&m_OutboxTimer, &QTimer::timeout, this, &Worker::ProcessOutbox);
+
+    // バックグラウンドでのクッキーの取得が完了した場合は、書き込みの準備の終了を記録する
+    // 書き込みの準備を開始していない場合 (接続の維持による定期的な更新の場合) は、何も記録されない
+    connect(m_pPoster.get(), &Poster::cookiesRefreshed, this, [this]() {
+        m_Deadline.endStage(QStringLiteral("書き込みの準備"));
+    });
+}
+
+
+// 取得を共有している場合は、破棄したオブジェクトへレスポンスが渡されないように、待機を解除する
+Worker::~Worker()
 {
+    FeedFetcher::cancel(this);
 }
 
 
@@ -92,52 +276,148 @@ void Worker::initialize()
 }
 
 
-// 取得したデータを整形およびスレッド情報へ変換後、新規スレッドを作成する (緊急地震速報用)
+// P2P地震情報のWebSocket APIから受信した地震情報のデータを設定する
+void Worker::SetPushedData(const QByteArray &data)
+{
+    m_PushedData = data;
+}
+
+
+// 掲示板との接続を事前に確立して、クッキーをバックグラウンドで取得する
+// 以降は、接続を維持しつつクッキーの有効期限が近づいた場合に更新するため、書き込み時にクッキーの取得を待機しない
+void Worker::WarmUp()
+{
+    if (m_CommonData.RequestURL.isEmpty()) return;
+
+    m_pPoster->startKeepWarm(QUrl(m_CommonData.RequestURL));
+
+    // 前回の終了時に送信できなかった書き込みが存在する場合は、再送する
+    ScheduleOutbox(0);
+}
+
+
+// 条件付きGETリクエストおよびXMLの解析の統計を取得する
+// 他のスレッドから呼び出されるため、処理の終了時に保存した統計を返す
+FEEDSTATS Worker::GetFeedStats() const
+{
+    QMutexLocker locker(&m_StatsMutex);
+
+    return m_FeedStatsSnapshot;
+}
+
+
+// 緊急地震速報(警報)の処理 (取得 → 整形 → 書き込み) を開始する (緊急地震速報用)
+// 地震情報の取得は非同期で行い、処理の完了時にfinishedシグナルを送信する
+// 既に処理中の場合は何もせずに-1を返す
 int Worker::ProcessEQAlert()
 {
-    if (m_CommonData.iGetInfo == 0) {
-        // JMAから緊急地震速報(警報)のデータを取得
-        if (onEQDownloaded_for_JMA(true)) {
-            // JMAから地震情報のデータの取得に失敗した場合
-            return -1;
+    if (m_bRunning) return -1;
+
+    m_bAlert = true;
+    StartPipeline();
+
+    return 0;
+}
+
+
+// 取得した1件の緊急地震速報(警報)を整形およびスレッド情報へ変換後、新規スレッドを作成する
+// 書き込みは非同期で行い、処理の終了時にonProcessedを呼び出す
+void Worker::ProcessAlertEvent(const Callback &onProcessed)
+{
+    int ret = 0;
+    {
+        DeadlineStage stage(m_Deadline, QStringLiteral("解析"));
+
+        // 取得したデータを整形
+        if (m_CommonData.iGetInfo == 0) {
+            // JMA (気象庁) からデータを取得
+            // JMA (気象庁) のデータの取得に失敗した場合は、書き込まない
+            ret = FormattingData_for_JMA(true);
         }
-    }
-    else if (m_CommonData.iGetInfo == 1) {
-        // P2P地震情報からデータを取得
-        if (onEQDownloaded_for_P2P()) {
-            // P2P地震情報のデータの取得に失敗した場合
-            return -1;
+        else if (m_CommonData.iGetInfo == 1) {
+            // 古い地震情報、以前スレッドを立てた地震情報、データの整形に失敗した場合は、書き込まない
+            ret = FormattingData_for_P2P();
         }
+
+        // 整形したデータをスレッド情報へ変換
+        if (ret == 0) ret = FormattingThreadInfo();
     }
 
-    // 取得したデータを整形
-    if (m_CommonData.iGetInfo == 0) {
-        // JMA (気象庁) からデータを取得
-        if (FormattingData_for_JMA(true)) {
-            // JMA (気象庁) のデータの取得に失敗した場合
-            return -1;
-        }
+    if (ret != 0) {
+        onProcessed(-1);
+        return;
     }
-    else if (m_CommonData.iGetInfo == 1) {
-        if (FormattingData_for_P2P()) {
-            // 古い地震情報、以前スレッドを立てた地震情報、データの整形に失敗した場合
-            return -1;
-        }
+
+    // 複数の掲示板に書き込む場合は、整形した地震情報を他の掲示板のオブジェクトへ配信して、各掲示板へ並行して書き込む
+    // 他の掲示板の書き込みの終了は待機せず、書き込みの結果はdeliveredシグナルで非同期に受け取る
+    DispatchEvent();
+
+    DeliverAlertEvent(onProcessed);
+}
+
+
+// 整形した緊急地震速報(警報)で、この掲示板にスレッドを新規作成して、ログファイルに保存する
+// 2つ目以降の掲示板のオブジェクトは、配信された地震情報に対してこのメソッドのみを実行する
+// 書き込みのレスポンスの受信後に、処理結果をonDeliveredへ渡す
+void Worker::DeliverAlertEvent(const Callback &onDelivered)
+{
+    // 複数の掲示板に書き込む場合、解析時は全ての掲示板のログファイルを確認しているため、この掲示板に書き込み済みかどうかを確認する
+    if (!m_CommonData.BoardName.isEmpty() && IsLogged()) {
+        onDelivered(-1);
+        return;
     }
 
-    // 整形したデータをスレッド情報へ変換
-    if (FormattingThreadInfo()) {
-        return -1;
+    // 同じ緊急地震速報(警報)が送信待ちの書き込みに存在する場合 (再起動前に書き込みに失敗した場合) は、重複して書き込まない
+    if (Outbox::contains(m_CommonData.LogFile, OutboxKey())) {
+        onDelivered(-1);
+        return;
+    }
+
+    // 期限切れの場合は、書き込みを中止する
+    // 揺れが到達した後の緊急地震速報(警報)は無意味であるため、失敗としてログファイルに保存して以降も書き込まない
+    if (m_Deadline.hasExpired()) {
+        ExpireAlertEvent(QStringLiteral("期限切れのため書き込みを中止"));
+        onDelivered(-1);
+        return;
     }
 
     // 緊急地震速報(警報)の場合は掲示板にスレッドを新規作成する
     // 発生した地震情報の場合は既存のスレッドが存在すれば該当スレッドに書き込む
     // 該当スレッドが存在しない場合はスレッドを新規作成する
-    if (Post(m_Alert.m_Code)) {
+    Post(m_Alert.m_Code, true, [this, onDelivered](int ret) {
+        onDelivered(FinishAlertEvent(ret));
+    });
+}
+
+
+// 緊急地震速報(警報)の書き込みの結果を記録する
+// 書き込みに失敗した場合は、送信待ちの書き込みに追加して再送する
+int Worker::FinishAlertEvent(int postResult)
+{
+    if (postResult) {
         // スレッドの新規作成に失敗した場合
+        if (m_Deadline.hasExpired()) {
+            // 期限切れの場合は、次回の取得時に再試行しても間に合わないため、再試行しない
+            ExpireAlertEvent(QStringLiteral("期限切れのため書き込みに失敗"));
+            return -1;
+        }
+
+        // 送信待ちの書き込みに追加して、処理の期限以内に再送する
+        // 処理位置は進めるため、後続の地震情報の取得は書き込みの成功を待機しない
+        if (EnqueuePost()) {
+            ReportDeadline(QStringLiteral("書き込みに失敗 (再送待ち)"));
+            return -1;
+        }
+
+        // 送信待ちの書き込みを使用しない場合は、次回の取得時に304 (Not Modified) で読み飛ばされないように、検証子を破棄して再試行できるようにする
+        RequestRetry();
+        ReportDeadline(QStringLiteral("書き込みに失敗"));
+
         return -1;
     }
 
+    ReportDeadline(QStringLiteral("書き込み完了"));
+
     // 地震IDを地震情報のログファイルに保存
     if (!m_Alert.m_ID.isEmpty()) m_Alert.AddLog(m_CommonData.LogFile, m_AlertLog);
 
@@ -145,444 +425,2284 @@ int Worker::ProcessEQAlert()
 }
 
 
-// 取得したデータを整形およびスレッド情報へ変換後、
-// 既存スレッドに書き込み、または、新規スレッドを作成する (発生した地震情報用)
-int Worker::ProcessEQInfo(EQIMAGEINFO &EQImageInfo)
+// 期限切れのため書き込めなかった緊急地震速報(警報)を、失敗としてログファイルに記録する
+// 書き込み済みの地震情報と区別するため、ログファイルのオブジェクトに"result"キーを付加する
+// ログファイルに保存した緊急地震速報(警報)は、以降の取得時に重複して書き込まない
+void Worker::ExpireAlertEvent(const QString &result)
 {
-    if (m_CommonData.iGetInfo == 0) {
-        // JMA (気象庁) からデータを取得
-        if (onEQDownloaded_for_JMA(false)) {
-            // JMA (気象庁) のデータの取得に失敗した場合
-            return -1;
-        }
-    }
-    else if (m_CommonData.iGetInfo == 1) {
-        // P2P地震情報からデータを取得
-        if (onEQDownloaded_for_P2P()) {
-            // P2P地震情報のデータの取得に失敗した場合
-            return -1;
-        }
-    }
+    m_FeedStats.DeadlineMisses++;
+    ReportDeadline(result);
+
+    // 複数の掲示板に書き込む場合は、掲示板の名前 (BBS名) を付加する
+    const auto board = m_CommonData.BoardName.isEmpty() ? QString("") : QString(" (%1)").arg(m_CommonData.BoardName);
+    std::cerr << QString("エラー : 期限切れのため緊急地震速報(警報)を書き込めませんでした%1 : %2").arg(board, m_Alert.m_ID).toStdString() << std::endl;
+
+    if (m_Alert.m_ID.isEmpty()) return;
+
+    auto alertLog   = m_AlertLog;
+    alertLog.Result = QStringLiteral("expired");
+    m_Alert.AddLog(m_CommonData.LogFile, alertLog);
+}
+
+
+// 発生した地震情報の処理 (取得 → 整形 → 書き込み) を開始する (発生した地震情報用)
+// 地震情報の取得は非同期で行い、処理の完了時にfinishedシグナルを送信する
+// 既に処理中の場合は何もせずに-1を返す
+int Worker::ProcessEQInfo(const EQIMAGEINFO &EQImageInfo)
+{
+    if (m_bRunning) return -1;
+
+    m_bAlert      = false;
+    m_EQImageInfo = EQImageInfo;
+    StartPipeline();
+
+    return 0;
+}
+
 
+// 取得した1件の発生した地震情報を整形およびスレッド情報へ変換後、
+// 既存スレッドに書き込み、または、新規スレッドを作成する
+// 震度画像の検索および書き込みは非同期で行い、処理の終了時にonProcessedを呼び出す
+void Worker::ProcessInfoEvent(EQIMAGEINFO &EQImageInfo, const Callback &onProcessed)
+{
     if (m_CommonData.iGetInfo == 0) {
         // JMA (気象庁) からデータを取得
         if (FormattingData_for_JMA(false)) {
             // JMA (気象庁) のデータの取得に失敗した場合
-            return -1;
+            onProcessed(-1);
+            return;
         }
     }
     else if (m_CommonData.iGetInfo == 1) {
         // 取得したデータを整形
         if (FormattingData_for_P2P()) {
             // 古い地震情報、以前スレッドを立てた地震情報、データの整形に失敗した場合
-            return -1;
+            onProcessed(-1);
+            return;
         }
     }
 
     // 整形したデータをスレッド情報へ変換
     if (FormattingThreadInfo()) {
-        return -1;
+        onProcessed(-1);
+        return;
     }
 
+    // 複数の掲示板に書き込む場合は、整形した地震情報 (震度画像のURLを含む) を他の掲示板のオブジェクトへ配信して、各掲示板へ並行して書き込む
+    // 他の掲示板の書き込みの終了は待機せず、書き込みの結果はdeliveredシグナルで非同期に受け取る
+    auto deliver = [this, onProcessed]() {
+        DispatchEvent();
+        DeliverInfoEvent(onProcessed);
+    };
+
     // 発生した地震情報の場合、
     // Yahoo天気・災害の地震情報一覧にアクセスして、震度分布の画像を検索する
     // 震度分布の画像が存在する場合は、スレッド本文に画像のURLを追記する
     if (m_Info.m_Code == 551 && EQImageInfo.bEnable) {
         EQImageInfo.DateStr = m_Info.m_Time;  // 該当する地震情報の震度画像を取得するための日時
 
-        if (AddEQInfoImage(EQImageInfo) == 0) {
-            m_ThreadInfo.message += m_Info.m_ImageURL.isEmpty() ? QString("") :
-                                                                  QString("\n") + QString("\n") + m_Info.m_ImageURL;
-            m_ThreadInfo.message += m_Info.m_ImageSiteURL.isEmpty() ? QString("") :
-                                                                      QString("\n") + m_Info.m_ImageSiteURL;
-        }
+        AddEQInfoImage(EQImageInfo, [this, deliver, onProcessed](int iRet) {
+            // 検索中に処理がキャンセルされた場合は、書き込まない
+            if (m_bCancelled) {
+                onProcessed(-1);
+                return;
+            }
+
+            if (iRet == 0) {
+                m_ThreadInfo.message += m_Info.m_ImageURL.isEmpty() ? QString("") :
+                                                                      QString("\n") + QString("\n") + m_Info.m_ImageURL;
+                m_ThreadInfo.message += m_Info.m_ImageSiteURL.isEmpty() ? QString("") :
+                                                                          QString("\n") + m_Info.m_ImageSiteURL;
+            }
+
+            deliver();
+        });
+
+        return;
+    }
+
+    deliver();
+}
+
+
+// 整形した発生した地震情報を、この掲示板の既存のスレッドに書き込み、または、スレッドを新規作成する
+// 書き込みに失敗した場合は、送信待ちの書き込みに追加して再送する
+// 2つ目以降の掲示板のオブジェクトは、配信された地震情報に対してこのメソッドのみを実行する
+// 書き込みのレスポンスの受信後に、処理結果をonDeliveredへ渡す
+void Worker::DeliverInfoEvent(const Callback &onDelivered)
+{
+    // 複数の掲示板に書き込む場合、解析時は全ての掲示板のログファイルを確認しているため、この掲示板に書き込み済みかどうかを確認する
+    if (!m_CommonData.BoardName.isEmpty() && IsLogged()) {
+        onDelivered(-1);
+        return;
+    }
+
+    // 同じ地震情報が送信待ちの書き込みに存在する場合 (再起動前に書き込みに失敗した場合) は、重複して書き込まない
+    if (Outbox::contains(m_CommonData.LogFile, OutboxKey())) {
+        onDelivered(-1);
+        return;
+    }
+
+    // 先に書き込みに失敗した地震情報が送信待ちの場合は、書き込みの順序を保つため、その後に追加する
+    // 同じ地震の続報は、先の地震情報で新規作成したスレッドに書き込む必要があるため、先に再送させる
+    if (Outbox::hasPending(m_CommonData.LogFile) && EnqueuePost(0)) {
+        onDelivered(-1);
+        return;
     }
 
+    // 書き込みに失敗した場合は、送信待ちの書き込みに追加して再送する
+    // 再送時は、!chttコマンドを付加する前のスレッド情報を使用して、既存のスレッドに書き込むかどうかを再度判断する
+    const auto threadInfo = m_ThreadInfo;
+
+    PostInfoEvent([this, threadInfo, onDelivered](int ret) {
+        if (ret == PostError) {
+            m_ThreadInfo = threadInfo;
+            if (!EnqueuePost()) RequestRetry();
+
+            onDelivered(-1);
+            return;
+        }
+
+        onDelivered(ret);
+    });
+}
+
+
+// 発生した地震情報を既存のスレッドに書き込み、または、スレッドを新規作成して、ログファイルを更新する
+// 送信待ちの書き込みを再送する場合も、このメソッドを使用する
+// スレッドの確認および書き込みのレスポンスを順に受信して、処理結果をonPostedへ渡す
+void Worker::PostInfoEvent(const Callback &onPosted)
+{
 #if (QEQALERT_VERSION_MAJOR == 0 && QEQALERT_VERSION_MINOR == 1 && QEQALERT_VERSION_PATCH <= 2)
     // 発生した地震情報のログファイルに同じ震源地が存在し、かつ、該当スレッドが生存している場合のみ既存のスレッドに書き込む
     // それ以外は、スレッドを新規作成する
     // ただし、ログファイルに同じ震源地が存在し、かつ、該当スレッドが生存していない場合は、ログファイルから該当するオブジェクトを削除する
-    if (GetExistObject(m_Info.m_Name)) {
+    if (!GetExistObject(m_Info.m_Name)) {
 #else
     // 発生した地震情報のログファイルに同じ都道府県(最大震度)が存在し、かつ、該当スレッドが生存している場合のみ既存のスレッドに書き込む
     // それ以外は、スレッドを新規作成する
     // ただし、ログファイルに同じ都道府県(最大震度)が存在し、かつ、該当スレッドが生存していない場合は、ログファイルから該当するオブジェクトを削除する
-    if (GetExistObject()) {
+    if (!GetExistObject()) {
+#endif
+        // 地震情報のログファイルに同じ震源地(都道府県)が存在しない場合は、スレッドを新規作成する
+        CreateInfoThread(false, onPosted);
+        return;
+    }
+
+    // 発生した地震情報のログファイルに同じ震源地が存在する場合
+
+    // ログファイルから過去に作成したスレッドのURLが生存しているかどうかを確認
+    // 生存している場合でも、レス数が上限に近い場合は新規スレッドを作成する (レス数の取得に失敗した場合は既存のスレッドに書き込む)
+    isExistThread(QUrl(m_InfoLog.ThreadURL), m_InfoLog.Title, [this, onPosted](int bExist) {
+        if (!bExist) {
+            // 過去に作成したスレッドのURLが生存していない場合、スレッドを新規作成
+            CreateInfoThread(true, onPosted);
+            return;
+        }
+
+        CheckLastThreadNum([this, onPosted](int iRet) {
+            if (iRet == 1) CreateInfoThread(true, onPosted);
+            else           WriteInfoThread(onPosted);
+        });
+    });
+}
+
+
+// 過去に作成したスレッドのURLが生存している場合、既存のスレッドに書き込み、ログファイルを更新する
+void Worker::WriteInfoThread(const Callback &onPosted)
+{
+    // !chttコマンドを使用する場合 (防弾嫌儲系の掲示板で使用可能)
+    if (m_CommonData.bChangeTitle) {
+        m_ThreadInfo.message = AddChttCommand(m_ThreadInfo.subject, m_ThreadInfo.message);
+    }
+
+    // 地震情報のログファイルからスレッド番号をセット
+    if (!m_InfoLog.ThreadNum.isEmpty()) {
+        m_ThreadInfo.key = m_InfoLog.ThreadNum;
+    }
+    else {
+        std::cerr << QString("エラー : スレッド番号が不明です").toStdString() << std::endl;
+        onPosted(-1);
+        return;
+    }
+
+    // 既存のスレッドに書き込む
+    Post(m_Info.m_Code, false, [this, onPosted](int ret) {
+        if (ret) {
+            // 既存のスレッドの書き込みに失敗した場合
+            // スレッド一覧の取得後にスレッドが落ちた可能性があるため、再試行時はスレッド一覧を再取得する
+            ThreadCache::invalidate(QUrl(m_InfoLog.ThreadURL));
+            onPosted(PostError);
+            return;
+        }
+
+        // ログファイルの更新
+        if (!m_CommonData.bChangeTitle) {
+            // !chttコマンドが無効の場合
+            // 地震IDおよび地震発生日時を地震情報のログファイルに追加・更新
+            onPosted((!m_Info.m_ID.isEmpty() && m_Info.UpdateInfo(m_CommonData.LogFile, false, "", m_CommonData.iGetInfo)) ? -1 : 0);
+            return;
+        }
+
+        // !chttコマンドが有効の場合
+        // スレッドのタイトルが変更されているかどうかを確認
+        CompareThreadTitle(QUrl(m_InfoLog.ThreadURL), m_InfoLog.Title, [this, onPosted](int iRet) {
+            if (m_Info.m_ID.isEmpty()) {
+                onPosted(0);
+                return;
+            }
+
+            if (!iRet) {
+                // スレッドのタイトルが変更された場合 (!chttコマンドが成功した場合)
+                // 変更されたスレッドのタイトル、地震ID、地震発生日時を地震情報のログファイルに追加・更新
+                onPosted(m_Info.UpdateInfo(m_CommonData.LogFile, true, m_ThreadInfo.subject, m_CommonData.iGetInfo) ? -1 : 0);
+            }
+            else {
+                // スレッドのタイトルが変更されていない場合 (!chttコマンドが失敗している場合)
+                // または、スレッドのタイトルの抽出に失敗した場合
+                // 地震IDおよび地震発生日時を地震情報のログファイルに追加・更新
+                onPosted(m_Info.UpdateInfo(m_CommonData.LogFile, false, "", m_CommonData.iGetInfo) ? -1 : 0);
+            }
+        });
+    });
+}
+
+
+// 発生した地震情報でスレッドを新規作成して、ログファイルに保存する
+// bDeleteObjectがtrueの場合は、過去に作成したスレッド (生存していない、または、レス数が上限に近い) のオブジェクトをログファイルから削除する
+void Worker::CreateInfoThread(bool bDeleteObject, const Callback &onPosted)
+{
+    Post(m_Info.m_Code, true, [this, bDeleteObject, onPosted](int ret) {
+        if (ret) {
+            // スレッドの新規作成に失敗した場合
+            onPosted(PostError);
+            return;
+        }
+
+        // 過去に作成したスレッドがあるオブジェクトをログファイルから削除
+#if (QEQALERT_VERSION_MAJOR == 0 && QEQALERT_VERSION_MINOR == 1 && QEQALERT_VERSION_PATCH <= 2)
+        if (bDeleteObject && DeleteObject(m_Info.m_Name)) {
+#else
+        if (bDeleteObject && DeleteObject(m_Info.m_MaxIntPrefs)) {
 #endif
-        // 発生した地震情報のログファイルに同じ震源地が存在する場合
+            // ログファイルから生存していないスレッド情報の削除に失敗した場合
+            onPosted(-1);
+            return;
+        }
+
+        // 地震ID、地震発生日時、スレッド情報を地震情報のログファイルに新規保存
+        if (!m_Info.m_ID.isEmpty()) {
+            if (m_Info.AddInfo(m_CommonData.LogFile, m_InfoLog.Title, m_InfoLog.ThreadURL, m_InfoLog.ThreadNum, m_CommonData.iGetInfo)) {
+                onPosted(-1);
+                return;
+            }
+
+            ScheduleTitleCheck();
+        }
+
+        onPosted(0);
+    });
+}
+
+
+// 地震情報の処理を開始する
+// 各段階 (フィードの取得 → 各エントリの取得 → 整形 → 書き込み) は、前の段階のレスポンスを受信した時に実行する
+// そのため、レスポンスの待機中も他の処理 (緊急地震速報(警報)と発生した地震情報の処理、タイマ等) を実行できる
+void Worker::StartPipeline()
+{
+    m_bRunning   = true;
+    m_bCancelled = false;
+    m_Result     = -1;
+
+    // 処理の期限は、地震情報を検出した時に開始する
+    m_Deadline.reset();
+
+    // テストファイルを使用する場合は、テストファイルのデータを処理する
+    if (!m_CommonData.TestFile.isEmpty()) {
+        // JMAの場合、ログファイルに同じ緊急地震速報 (警報) のURLが存在する場合は無視する
+        if (m_CommonData.iGetInfo == 0 && !SearchAlertEQID(m_CommonData.TestFile)) {
+            FinishPipeline(-1);
+            return;
+        }
+
+        m_DetectedTime = std::chrono::steady_clock::now();
+        StartDeadline();
+
+        if (ReadTestFile()) {
+            FinishPipeline(-1);
+            return;
+        }
+
+        ProcessEvent([this](int result) { FinishPipeline(result); });
+        return;
+    }
+
+    // P2P地震情報のWebSocket APIから受信したデータが存在する場合は、JSON APIから取得しない
+    if (m_CommonData.iGetInfo == 1 && !m_PushedData.isEmpty()) {
+        m_ReplyData    = m_PushedData;
+        m_DetectedTime = std::chrono::steady_clock::now();
+        m_PushedData.clear();
+        StartDeadline();
+
+        ProcessEvent([this](int result) { FinishPipeline(result); });
+        return;
+    }
+
+    // 他の掲示板で再試行が必要なエントリが存在する場合は、処理位置を戻す
+    if (m_CommonData.iGetInfo == 0) RewindFeedCursor();
+
+    // JMAのAtomフィード、または、P2P地震情報へGETリクエストを送信
+    // 前回から更新が無い場合は304 (Not Modified) を返すように条件付きGETリクエストにする
+    SendRequest(QUrl(m_CommonData.EQInfoURL), true, m_CommonData.iGetInfo == 0 ? &Worker::onFeedReplied : &Worker::onP2PReplied);
+}
+
+
+// テストファイルのデータを読み込む
+int Worker::ReadTestFile()
+{
+    try {
+        // テストファイルを開く
+        QFile TestFile(m_CommonData.TestFile);
+        if (!TestFile.open(QIODevice::ReadOnly)) {
+            throw std::runtime_error(TestFile.errorString().toStdString());
+        }
+
+        // テストファイルの読み込み
+        m_ReplyData = TestFile.readAll();
+
+        // テストファイルを閉じる
+        TestFile.close();
+
+        // 取得した地震情報のURLにテストファイルのパスを指定
+        m_Alert.m_URL = m_CommonData.TestFile;
+    }
+    catch (const std::exception &e) {
+        std::cerr << QString("エラー: テスト用%1ファイルの読み込み中にエラーが発生しました: %2")
+                     .arg(m_CommonData.iGetInfo == 0 ? "XML" : "JSON").arg(e.what()).toStdString() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// GETリクエストを非同期で送信する
+// レスポンスを受信した時に、指定したメソッドを実行する (このメソッドはレスポンスを待機しない)
+// 共用のHTTPクライアントを使用して、接続 (Keep-Alive接続およびTLSセッション) を再利用する
+// タイムアウトは、デフォルトで3[秒] (処理の期限が有効の場合は、残り時間以内に制限する)
+//
+// 複数の設定ファイルを読み込んでいる場合 (デーモンモード) は、同じURLの取得を他の設定ファイルの地震情報オブジェクトと共有する
+// フィード (条件付きGETリクエスト) は取得の周期ごとに1度のみ、各地震情報のXMLは有効期間内に1度のみ取得する
+void Worker::SendRequest(const QUrl &url, bool bConditional, void (Worker::*onReplied)(const FEEDRESPONSE&), int timeout)
+{
+    if (FeedFetcher::isEnabled()) {
+        // キャンセル後に渡されたレスポンス (キューイング済みのコールバック) は無視する
+        const auto sequence = ++m_FetchSequence;
+        m_bWaitingFeed      = true;
+
+        FeedFetcher::fetch(url, bConditional ? FeedFetcher::FeedTTL : FeedFetcher::ContentsTTL, timeout, this,
+                           [this, onReplied, sequence](const FEEDRESPONSE &response) {
+            if (!m_bWaitingFeed || sequence != m_FetchSequence) return;
+            m_bWaitingFeed = false;
+
+            if (m_bCancelled) {
+                // 処理がキャンセルされた場合は、以降の段階を実行しない
+                FinishPipeline(-1);
+            }
+            else {
+                (this->*onReplied)(response);
+            }
+        });
+
+        return;
+    }
+
+    auto request = NetworkAccess::createRequest(url, timeout);
+
+    // 条件付きGETリクエストにする場合
+    if (bConditional) SetConditionalHeaders(request);
+
+    auto pReply = NetworkAccess::manager()->get(request);
+    m_pReply    = pReply;
+
+    connect(pReply, &QNetworkReply::finished, this, [this, pReply, onReplied]() {
+        m_pReply = nullptr;
+
+        if (m_bCancelled) {
+            // 処理がキャンセルされた場合は、以降の段階を実行しない
+            FinishPipeline(-1);
+        }
+        else {
+            (this->*onReplied)(FeedFetcher::toResponse(pReply));
+        }
+
+        pReply->deleteLater();
+    });
+}
+
+
+// JMA(気象庁)のAtomフィードのレスポンスを受信した場合
+void Worker::onFeedReplied(const FEEDRESPONSE &response)
+{
+    // レスポンスの確認
+    if (IsNotModified(response)) {
+        // フィードが更新されていない場合は、パースを行わない
+        FinishPipeline(-1);
+        return;
+    }
+
+    if (response.Error != QNetworkReply::NoError) {
+        // 地震情報の取得に失敗した場合
+        std::cerr << QString("エラー : 地震情報の取得に失敗 %1").arg(response.ErrorString).toStdString() << std::endl;
+        FinishPipeline(-1);
+        return;
+    }
+
+    // 正常に取得した場合
+    // XMLファイルをダウンロード
+    m_ReplyData    = response.Data;
+    m_DetectedTime = std::chrono::steady_clock::now();
+
+#ifdef _DEBUG
+    std::cout << m_ReplyData.constData() << std::endl;
+#endif
+
+    // JMAから処理位置より新しい地震情報のURLを取得する
+    if (ScanFeed(m_bAlert)) {
+        FinishPipeline(-1);
+        return;
+    }
+
+    // 前回の処理位置より新しい地震情報を古い順に処理する
+    m_EntryIndex = 0;
+    ProcessNextEntry();
+}
+
+
+// JMA(気象庁)のAtomフィードから、処理位置より新しい地震情報のURLを取得する
+int Worker::ScanFeed(bool bAlert)
+{
+    // 前回の処理位置 (カーソル) より新しいエントリを取得する
+    // 初回の取得時は処理位置が存在しないため、最新の1件のみを処理する (過去の地震情報を一括で書き込まないため)
+    const bool bFirstPoll = !m_FeedCursor.Updated.isValid();
+
+    // まず、QXmlStreamReaderクラスを使用してXMLデータを先頭から順に解析する
+    // 処理位置より古いエントリに到達した時点で解析を終了するため、フィード全体のDOMを構築しない
+    // ストリーム形式での解析に失敗した場合は、QDomDocumentクラスを使用して再解析する
+    QElapsedTimer timer;
+    int           ret = StreamParseError;
+
+    if (m_CommonData.bStreamParser) {
+        timer.start();
+        ret = ScanFeed_Stream(bAlert, bFirstPoll);
+
+        m_FeedStats.StreamParsed++;
+        m_FeedStats.StreamNsecs += timer.nsecsElapsed();
+
+        if (ret == StreamParseError) m_FeedStats.Fallbacks++;
+    }
+
+    if (ret == StreamParseError) {
+        timer.start();
+        ret = ScanFeed_DOM(bAlert, bFirstPoll);
+
+        m_FeedStats.DomParsed++;
+        m_FeedStats.DomNsecs += timer.nsecsElapsed();
+    }
+
+    if (ret != 0) return -1;
+
+    if (m_FeedEntries.isEmpty()) {
+        // 新しい地震情報のURLが記載されていない場合は、処理位置をフィードの先頭へ移動する
+        std::cout << QString("地震情報のURLがありません").toStdString() << std::endl;
+        m_FeedCursor = m_FeedHead;
+
+        return -1;
+    }
+
+#ifdef _DEBUG
+    std::cout << QString("新しい地震情報のURL : %1 件").arg(m_FeedEntries.count()).toStdString() << std::endl;
+#endif
+
+    return 0;
+}
+
+
+// 前回の処理位置より新しいエントリを古い順に1件ずつ処理する
+// 各エントリの地震情報を非同期で取得して、レスポンスを受信した時に次のエントリへ進む
+//
+// 再試行が必要なエラー (地震情報のダウンロードの失敗、書き込みの失敗) が発生した場合は、処理位置を進めずに終了する
+// この場合、次回の取得時にそのエントリ以降を再度処理する
+void Worker::ProcessNextEntry()
+{
+    while (m_EntryIndex < m_FeedEntries.count()) {
+        if (m_bCancelled) {
+            FinishPipeline(-1);
+            return;
+        }
+
+        const auto entry = m_FeedEntries.at(m_EntryIndex);
+
+        // エントリごとに地震情報のデータを初期化
+        // 処理の期限は、フィードを受信した時刻を起点としてエントリごとに開始する
+        initialize();
+        m_bRetryEvent = false;
+        StartDeadline();
+
+        // 緊急地震速報(警報)において、ログファイルに同じ緊急地震速報 (警報) のURLが存在する場合は無視する
+        if (m_bAlert) {
+            m_Deadline.beginStage(QStringLiteral("ログの確認"));
+            auto bNew = SearchAlertEQID(entry.ID);
+            m_Deadline.endStage(QStringLiteral("ログの確認"));
+
+            if (!bNew) {
+                AdvanceFeedCursor(entry);
+                m_EntryIndex++;
+
+                continue;
+            }
+
+            // 新しい緊急地震速報(警報)の場合は、地震情報のダウンロードおよび解析と並行して書き込みの準備を開始する
+            // クッキーを保持していない場合 (有効期限切れ、前回の書き込みの失敗等) も、書き込み時にクッキーの取得を待機しないようにする
+            if (m_pPoster->prepare(QUrl(m_CommonData.RequestURL))) {
+                m_Deadline.beginBackgroundStage(QStringLiteral("書き込みの準備"));
+            }
+
+            // 複数の掲示板に書き込む場合は、他の掲示板の書き込みの準備も開始する
+            PrepareBoards();
+        }
+
+        // 期限切れの場合は、地震情報を取得せずに次のエントリへ進む
+        if (m_Deadline.hasExpired()) {
+            m_FeedStats.DeadlineMisses++;
+            ReportDeadline(QStringLiteral("期限切れのため取得を中止 : %1").arg(entry.ID));
+
+            AdvanceFeedCursor(entry);
+            m_EntryIndex++;
+
+            continue;
+        }
+
+        // 地震情報のURLから地震情報を取得する
+        m_Deadline.beginStage(QStringLiteral("ダウンロード"));
+        SendRequest(QUrl(entry.ID), false, &Worker::onContentsReplied, m_Deadline.timeout(RequestTimeout));
+
+        return;
+    }
+
+    // 全てのエントリを処理した場合は、処理位置をフィードの先頭へ移動する
+    m_FeedCursor = m_FeedHead;
+
+    FinishPipeline(m_Result);
+}
+
+
+// JMAから取得した地震情報のレスポンスを受信した場合
+void Worker::onContentsReplied(const FEEDRESPONSE &response)
+{
+    const auto entry = m_FeedEntries.at(m_EntryIndex);
+
+    m_Deadline.endStage(QStringLiteral("ダウンロード"));
+
+    if (response.Error != QNetworkReply::NoError) {
+        std::cerr << QString("エラー : 地震情報の取得に失敗 %1").arg(response.ErrorString).toStdString() << std::endl;
+
+        if (m_Deadline.hasExpired()) {
+            // 期限切れの場合は、再試行しても間に合わないため、処理位置を進めて次のエントリを処理する
+            m_FeedStats.DeadlineMisses++;
+            ReportDeadline(QStringLiteral("期限切れのため取得を中止 : %1").arg(entry.ID));
+
+            AdvanceFeedCursor(entry);
+            m_EntryIndex++;
+
+            ProcessNextEntry();
+            return;
+        }
+
+        // 地震情報の取得に失敗した場合は、処理位置を進めずに終了する
+        RequestRetry();
+        FinishPipeline(-1);
+
+        return;
+    }
+
+    // 正常に取得した場合
+    m_ReplyData = response.Data;
+
+#ifdef _DEBUG
+    std::cout << m_ReplyData.constData() << std::endl;
+#endif
+
+    // 取得した緊急地震速報(警報)のURLを保存
+    if (m_bAlert) m_Alert.m_URL = entry.ID;
+
+    // 取得した地震情報を整形して書き込む
+    // 書き込みのレスポンスの受信後に、次のエントリを処理する
+    ProcessEvent([this, entry](int result) { onEntryProcessed(entry, result); });
+}
+
+
+// 1件のエントリの処理 (整形および書き込み) が終了した場合
+void Worker::onEntryProcessed(const FEEDENTRY &entry, int result)
+{
+    if (result == 0) m_Result = 0;
+
+    // 再試行が必要な場合は、処理位置を進めない
+    if (m_bRetryEvent) {
+        FinishPipeline(-1);
+        return;
+    }
+
+    // 処理位置を進めて、次のエントリを処理する
+    AdvanceFeedCursor(entry);
+    m_EntryIndex++;
+
+    ProcessNextEntry();
+}
+
+
+// P2P地震情報のレスポンスを受信した場合
+void Worker::onP2PReplied(const FEEDRESPONSE &response)
+{
+    // レスポンスの確認
+    if (IsNotModified(response)) {
+        // 地震情報が更新されていない場合は、パースを行わない
+        FinishPipeline(-1);
+        return;
+    }
+
+    if (response.Error != QNetworkReply::NoError) {
+        // 地震情報の取得に失敗した場合
+        std::cerr << QString("エラー : 地震情報の取得に失敗 %1").arg(response.ErrorString).toStdString() << std::endl;
+        FinishPipeline(-1);
+        return;
+    }
+
+    // 正常に取得した場合
+    m_ReplyData    = response.Data;
+    m_DetectedTime = std::chrono::steady_clock::now();
+    StartDeadline();
+
+#ifdef _DEBUG
+    std::cout << m_ReplyData.constData() << std::endl;
+#endif
+
+    ProcessEvent([this](int result) { FinishPipeline(result); });
+}
+
+
+// 取得した1件の地震情報を整形およびスレッド情報へ変換後、書き込む
+// 処理の終了時に、処理結果をonProcessedへ渡す
+void Worker::ProcessEvent(const Callback &onProcessed)
+{
+    if (m_bAlert) ProcessAlertEvent(onProcessed);
+    else          ProcessInfoEvent(m_EQImageInfo, onProcessed);
+}
+
+
+// 地震情報の処理を終了して、finishedシグナルを送信する
+// 処理中にWebSocket APIから受信した地震情報が存在する場合は、次のイベントループで処理する
+void Worker::FinishPipeline(int result)
+{
+    m_bRunning = false;
+    m_PushedData.clear();
+
+    SaveFeedStats();
+
+    emit finished(result);
+
+    ProcessPendingPushes();
+}
+
+
+// 他のスレッドから取得できるように、条件付きGETリクエストおよびXMLの解析の統計を保存する
+void Worker::SaveFeedStats()
+{
+    QMutexLocker locker(&m_StatsMutex);
+    m_FeedStatsSnapshot               = m_FeedStats;
+    m_FeedStatsSnapshot.CookieReuses  = m_pPoster->GetCookieReuses();
+    m_FeedStatsSnapshot.CookieFetches = m_pPoster->GetCookieFetches();
+}
+
+
+// 処理中にWebSocket APIから受信した地震情報が存在する場合は、次のイベントループで処理する
+// 2つ目以降の掲示板のオブジェクトの場合は、処理中に配信された地震情報を配信された順に書き込む
+void Worker::ProcessPendingPushes()
+{
+    if (m_bCancelled || (m_PendingPushes.isEmpty() && m_PendingEvents.isEmpty())) return;
+
+    QMetaObject::invokeMethod(this, [this]() {
+        if (m_bRunning || m_bCancelled) return;
+
+        if (!m_PendingEvents.isEmpty()) {
+            DeliverEvent(m_PendingEvents.dequeue());
+            return;
+        }
+
+        if (m_PendingPushes.isEmpty()) return;
+
+        initialize();
+        SetPushedData(m_PendingPushes.dequeue());
+        StartPipeline();
+    }, Qt::QueuedConnection);
+}
+
+
+// 新規作成したスレッドのタイトルの確認を予約する (発生した地震情報のみ)
+// ログファイルには、POSTデータで送信したタイトルを保存しているため、掲示板により変更されたタイトルと異なる場合がある
+// 確認は書き込みの終了後に行うため、書き込みまでの時間には影響しない
+void Worker::ScheduleTitleCheck()
+{
+    PENDINGTITLE pending;
+    pending.ThreadURL   = m_InfoLog.ThreadURL;
+    pending.Title       = m_InfoLog.Title;
+    pending.Hypocenter  = m_Info.m_Name;
+    pending.MaxIntPrefs = m_Info.m_MaxIntPrefs;
+
+    if (pending.ThreadURL.isEmpty()) return;
+
+    m_PendingTitles.append(pending);
+    if (m_PendingTitles.size() == 1) {
+        QTimer::singleShot(TitleCheckDelay, this, &Worker::VerifyThreadTitles);
+    }
+}
+
+
+// 新規作成したスレッドのタイトルを確認して、送信したタイトルと異なる場合はログファイルのタイトルを更新する
+// 地震情報の処理中の場合は、処理の終了後に確認する (確認中に受信した地震情報は、確認の終了後に処理する)
+void Worker::VerifyThreadTitles()
+{
+    if (m_bCancelled || m_PendingTitles.isEmpty()) return;
+
+    if (m_bRunning) {
+        QTimer::singleShot(TitleCheckDelay, this, &Worker::VerifyThreadTitles);
+        return;
+    }
+
+    m_bRunning = true;
+
+    VerifyNextTitle(std::exchange(m_PendingTitles, {}));
+}
+
+
+// 確認待ちのスレッドのタイトルを1件ずつ取得して確認する
+// タイトルの受信後に次のスレッドを確認して、全て確認した場合は待機中の地震情報を処理する
+void Worker::VerifyNextTitle(QList<PENDINGTITLE> pendingTitles)
+{
+    if (m_bCancelled || pendingTitles.isEmpty()) {
+        m_bRunning = false;
+
+        ProcessPendingPushes();
+        return;
+    }
+
+    const auto pending = pendingTitles.takeFirst();
+
+    // スレッド一覧 (subject.txt) は新規作成する前に取得している可能性があるため、破棄して再取得する
+    ThreadCache::invalidate(QUrl(pending.ThreadURL));
+
+    FetchThreadTitle(QUrl(pending.ThreadURL), true, [this, pending, pendingTitles](int iRet, const QString &title) {
+        if (iRet == 0 && !title.isEmpty() && title != pending.Title) {
+            std::cout << QString("新規作成したスレッドのタイトルが送信したタイトルと異なるため、ログファイルを更新します : %1").arg(title).toStdString() << std::endl;
+
+            // 同じスレッドのオブジェクトのうち、タイトルが変更されていないオブジェクト (!chttコマンドを使用していない) のみ更新する
+            auto update = [&pending, &title](QJsonObject &obj) {
+                if (obj["url"].toString() == pending.ThreadURL && obj["title"].toString() == pending.Title) obj["title"] = title;
+            };
+
+#if (QEQALERT_VERSION_MAJOR == 0 && QEQALERT_VERSION_MINOR == 1 && QEQALERT_VERSION_PATCH <= 2)
+            auto ret = EventStore::open(m_CommonData.LogFile)->updateByHypocentre(pending.Hypocenter, update, LockTimeout);
+#else
+            auto ret = EventStore::open(m_CommonData.LogFile)->updateByPrefs(pending.MaxIntPrefs, update, LockTimeout);
+#endif
+            if (ret) {
+                std::cerr << QString("エラー : 発生した地震情報のログファイルの更新に失敗").toStdString() << std::endl;
+            }
+        }
+
+        VerifyNextTitle(pendingTitles);
+    });
+}
+
+
+// 処理中の地震情報の書き込みを送信待ちの書き込みに追加する
+// 緊急地震速報(警報)は処理の期限 (無効の場合は60[秒]) 以内、発生した地震情報は1時間以内に再送する
+// attemptsには、書き込みに失敗した回数を指定する (0の場合は、先に追加した書き込みの再送後に直ちに再送する)
+bool Worker::EnqueuePost(int attempts)
+{
+    if (!Outbox::isEnabled()) return false;
+
+    OUTBOXENTRY entry;
+    entry.Owner      = m_CommonData.LogFile;
+    entry.Key        = OutboxKey();
+    entry.Board      = BoardName();
+    entry.Priority   = m_bAlert ? 0 : 1;
+    entry.ThreadInfo = m_ThreadInfo;
+    entry.Event      = SaveEvent();
+    entry.Attempts   = attempts;
+
+    qint64 age = InfoOutboxAge;
+    if (m_bAlert) age = m_Deadline.isActive() ? m_Deadline.remaining() : AlertOutboxAge;
+
+    entry.Expires = QDateTime::currentDateTimeUtc().addMSecs(age);
+
+    auto wait = Outbox::enqueue(entry);
+
+    std::cout << QString("書き込みを送信待ちにしました (%1[mS]後に再送します) : %2").arg(wait).arg(m_ThreadInfo.subject).toStdString() << std::endl;
+
+    ScheduleOutbox(wait);
+
+    return true;
+}
+
+
+// 指定した時間 [mS] の経過後に、送信待ちの書き込みの再送を予約する
+// 既に予約済みの場合は、早い方の時刻に再送する
+void Worker::ScheduleOutbox(qint64 msecs)
+{
+    if (m_bCancelled || !Outbox::isEnabled()) return;
+
+    const auto interval = static_cast<int>(std::clamp<qint64>(msecs, 0, std::numeric_limits<int>::max()));
+    if (m_OutboxTimer.isActive() && m_OutboxTimer.remainingTime() <= interval) return;
+
+    m_OutboxTimer.start(interval);
+}
+
+
+// 送信待ちの書き込みを1件再送する
+// 地震情報の処理中の場合は、処理の終了後に再送する (再送中に受信した地震情報は、再送の終了後に処理する)
+// 再送の終了後は、次の送信待ちの書き込みの再送を予約する
+void Worker::ProcessOutbox()
+{
+    if (m_bCancelled) return;
+
+    if (m_bRunning) {
+        ScheduleOutbox(OutboxBusyDelay);
+        return;
+    }
+
+    OUTBOXENTRY entry;
+    const auto  wait = Outbox::takeDue(m_CommonData.LogFile, entry);
+    if (wait != 0) {
+        // 再送の時刻ではない場合、または、同じ掲示板に優先度の高い書き込みが存在する場合
+        if (wait > 0) ScheduleOutbox(wait);
+        return;
+    }
+
+    m_bRunning = true;
+    m_bReplay  = true;
+
+    initialize();
+    m_bAlert          = entry.Priority == 0;
+    m_ThreadInfo      = entry.ThreadInfo;
+    m_ThreadInfo.time = QString::number(GetEpocTime());
+    RestoreEvent(entry.Event);
+
+    // 再送は、再送の期限 (緊急地震速報(警報)の場合は処理の期限) 以内に制限する
+    auto budget = std::min<qint64>(QDateTime::currentDateTimeUtc().msecsTo(entry.Expires), ReplayTimeout);
+    m_DetectedTime = std::chrono::steady_clock::now();
+    m_Deadline.start(m_DetectedTime, std::max<qint64>(budget, 1));
+
+    std::cout << QString("送信待ちの書き込みを再送します (失敗 : %1 回) : %2").arg(entry.Attempts).arg(entry.ThreadInfo.subject).toStdString() << std::endl;
+
+    // 書き込みのレスポンスの受信後に、再送の結果を記録する
+    auto onPosted = [this, entry](int ret) {
+        // ログファイルの更新に失敗した場合も、書き込みは完了しているため再送しない
+        Outbox::finish(entry, ret != PostError);
+
+        m_Deadline.reset();
+        m_bReplay  = false;
+        m_bRunning = false;
+
+        ProcessPendingPushes();
+        ScheduleOutbox(0);
+    };
+
+    if (m_bAlert) {
+        Post(m_Alert.m_Code, true, [this, onPosted](int ret) {
+            if (ret) {
+                onPosted(PostError);
+                return;
+            }
+
+            ReportDeadline(QStringLiteral("再送完了"));
+
+            // 地震IDを地震情報のログファイルに保存
+            if (!m_Alert.m_ID.isEmpty()) m_Alert.AddLog(m_CommonData.LogFile, m_AlertLog);
+
+            onPosted(0);
+        });
+    }
+    else {
+        PostInfoEvent(onPosted);
+    }
+}
+
+
+// 処理中の地震情報の識別子を取得する
+// 同じ地震情報が送信待ちの書き込みに存在するかどうかの確認に使用する
+QString Worker::OutboxKey() const
+{
+    if (m_bAlert) return m_Alert.m_ID.isEmpty() ? QString() : QString("%1/%2").arg(m_Alert.m_ID, m_Alert.m_ReportDateTime);
+
+    return m_Info.m_ID.isEmpty() ? QString() : QString("%1/%2/%3").arg(m_Info.m_ID, m_Info.m_ReportDateTime, m_Info.m_Time);
+}
+
+
+// 書き込み先の掲示板の名前を取得する
+// 同じ掲示板への書き込みの間隔を空けるために使用する
+QString Worker::BoardName() const
+{
+    return QString("%1#%2").arg(m_CommonData.RequestURL, m_ThreadInfo.bbs);
+}
+
+
+// ログファイルに保存する地震情報をJSONオブジェクトへ変換する
+// 送信待ちの書き込みの再送後に、ログファイルを更新するために使用する
+QJsonObject Worker::SaveEvent() const
+{
+    QJsonObject event;
+
+    if (m_bAlert) {
+        event["code"]           = m_Alert.m_Code;
+        event["id"]             = m_Alert.m_ID;
+        event["reportdatetime"] = m_Alert.m_ReportDateTime;
+        event["url"]            = m_Alert.m_URL;
+    }
+    else {
+        event["code"]           = m_Info.m_Code;
+        event["id"]             = m_Info.m_ID;
+        event["hypocentre"]     = m_Info.m_Name;
+        event["prefs"]          = QJsonArray::fromStringList(m_Info.m_MaxIntPrefs);
+        event["date"]           = m_Info.m_Time;
+        event["reportdatetime"] = m_Info.m_ReportDateTime;
+    }
+
+    return event;
+}
+
+
+// JSONオブジェクトからログファイルに保存する地震情報を復元する
+void Worker::RestoreEvent(const QJsonObject &event)
+{
+    if (m_bAlert) {
+        m_Alert.m_Code           = event["code"].toInt();
+        m_Alert.m_ID             = event["id"].toString();
+        m_Alert.m_ReportDateTime = event["reportdatetime"].toString();
+        m_Alert.m_URL            = event["url"].toString();
+    }
+    else {
+        m_Info.m_Code            = event["code"].toInt();
+        m_Info.m_ID              = event["id"].toString();
+        m_Info.m_Name            = event["hypocentre"].toString();
+        m_Info.m_Time            = event["date"].toString();
+        m_Info.m_ReportDateTime  = event["reportdatetime"].toString();
+
+        m_Info.m_MaxIntPrefs.clear();
+        const auto prefs = event["prefs"].toArray();
+        for (const auto &pref : prefs) {
+            m_Info.m_MaxIntPrefs.append(pref.toString());
+        }
+    }
+}
+
+
+// 地震情報を配信する他の掲示板のオブジェクトを追加する (先頭の掲示板のオブジェクトのスレッドで呼び出す)
+// 他の掲示板のオブジェクトは、それぞれ専用のスレッドで並行して書き込み、書き込みの結果をdeliveredシグナルで通知する
+void Worker::AddBoard(Worker *pBoard)
+{
+    m_Boards.append(pBoard);
+    m_BoardLogFiles.append(pBoard->m_CommonData.LogFile);
+
+    connect(pBoard, &Worker::delivered, this, [this](quint64 sequence, [[maybe_unused]] int result, bool bRetry) {
+        FinishBoard(sequence, bRetry);
+    });
+}
+
+
+// 書き込みの準備 (掲示板との接続およびクッキーの取得) をバックグラウンドで開始する
+// 2つ目以降の掲示板のオブジェクトは、先頭の掲示板のオブジェクトが新しいエントリを発見した時点で呼び出される
+void Worker::PrepareBoard()
+{
+    if (m_bCancelled) return;
+
+    m_pPoster->prepare(QUrl(m_CommonData.RequestURL));
+}
+
+
+// 他の掲示板の書き込みの準備を開始する
+// 各掲示板のオブジェクトのスレッドで実行するため、ダウンロードおよび解析と並行して実行される
+void Worker::PrepareBoards()
+{
+    for (auto pBoard : std::as_const(m_Boards)) {
+        QMetaObject::invokeMethod(pBoard, &Worker::PrepareBoard, Qt::QueuedConnection);
+    }
+}
+
+
+// 整形した地震情報を他の掲示板のオブジェクトへ配信する
+// 他の掲示板への書き込みは、この掲示板への書き込みと並行して実行されて、終了を待機しない
+void Worker::DispatchEvent()
+{
+    if (m_Boards.isEmpty()) return;
+
+    // 書き込みの結果が通知されない配信済みの地震情報は破棄する
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = m_Dispatches.begin(); it != m_Dispatches.end();) {
+        if (now - it->Dispatched < std::chrono::milliseconds(BoardTimeout)) {
+            ++it;
+            continue;
+        }
+
+        std::cerr << QString("エラー : 他の掲示板の書き込みが終了しませんでした (残り : %1)").arg(it->Pending).toStdString() << std::endl;
+        it = m_Dispatches.erase(it);
+    }
+
+    BOARDEVENT event;
+    event.Sequence     = ++m_EventSequence;
+    event.bAlert       = m_bAlert;
+    event.Alert        = m_Alert;
+    event.Info         = m_Info;
+    event.ThreadInfo   = m_ThreadInfo;
+    event.DetectedTime = m_DetectedTime;
+
+    for (auto pBoard : std::as_const(m_Boards)) {
+        QMetaObject::invokeMethod(pBoard, [pBoard, event]() { pBoard->DeliverEvent(event); }, Qt::QueuedConnection);
+    }
+
+    // JMAの場合は、再試行時に処理位置を戻すため、処理中のエントリを記録する
+    BOARDDISPATCH dispatch;
+    dispatch.Pending    = static_cast<int>(m_Boards.size());
+    dispatch.Dispatched = now;
+    if (m_CommonData.iGetInfo == 0 && m_CommonData.TestFile.isEmpty() && m_EntryIndex < m_FeedEntries.size()) {
+        dispatch.Entry = m_FeedEntries.at(m_EntryIndex);
+    }
+
+    m_Dispatches.insert(event.Sequence, dispatch);
+}
+
+
+// 他の掲示板の書き込みの終了を記録する (deliveredシグナルを受信した場合)
+// 書き込みの終了を待機せずに処理位置を進めているため、再試行が必要な掲示板が存在する場合は、次回の取得時に処理位置を戻す
+// 書き込み済みの掲示板は、再試行時にログファイルから書き込み済みであることを確認して、重複して書き込まない
+void Worker::FinishBoard(quint64 sequence, bool bRetry)
+{
+    auto it = m_Dispatches.find(sequence);
+    if (it == m_Dispatches.end()) return;
+
+    if (bRetry) {
+        ResetValidator(m_CommonData.EQInfoURL);
+        if (!it->Entry.ID.isEmpty()) m_RetryEntries.append(it->Entry);
+    }
+
+    if (--it->Pending <= 0) m_Dispatches.erase(it);
+}
+
+
+// 他の掲示板で再試行が必要なエントリが存在する場合は、そのエントリを再度処理するように処理位置を戻す
+void Worker::RewindFeedCursor()
+{
+    for (const auto &entry : std::as_const(m_RetryEntries)) {
+        // 処理位置より新しいエントリは、次回の取得時に処理される
+        if (!m_FeedCursor.Updated.isValid() || entry.Updated > m_FeedCursor.Updated) continue;
+
+        if (entry.Updated < m_FeedCursor.Updated) {
+            m_FeedCursor.Updated = entry.Updated;
+            m_FeedCursor.IDs.clear();
+        }
+        else {
+            m_FeedCursor.IDs.remove(entry.ID);
+        }
+    }
+
+    m_RetryEntries.clear();
+}
+
+
+// 配信された地震情報をこの掲示板に書き込む (2つ目以降の掲示板のオブジェクトのみ)
+// 地震情報の処理中 (送信待ちの書き込みの再送中) の場合は、処理の終了後に配信された順に書き込む
+void Worker::DeliverEvent(const BOARDEVENT &event)
+{
+    if (m_bCancelled) {
+        emit delivered(event.Sequence, -1, false);
+        return;
+    }
+
+    if (m_bRunning) {
+        m_PendingEvents.enqueue(event);
+        return;
+    }
+
+    m_bRunning    = true;
+    m_bRetryEvent = false;
+
+    initialize();
+    m_bAlert = event.bAlert;
+    if (m_bAlert) m_Alert = event.Alert;
+    else          m_Info  = event.Info;
+
+    // スレッドのタイトルおよび本文のみ配信された値を使用して、名前欄、メール欄、BBS名はこの掲示板の値を使用する
+    m_ThreadInfo.subject = event.ThreadInfo.subject;
+    m_ThreadInfo.message = event.ThreadInfo.message;
+    m_ThreadInfo.time    = event.ThreadInfo.time;
+
+    // 処理の期限は、先頭の掲示板のオブジェクトが地震情報を検出した時刻を起点とする
+    m_DetectedTime = event.DetectedTime;
+    StartDeadline();
+
+    // 書き込みのレスポンスの受信後に、書き込みの結果を通知する
+    auto onDelivered = [this, sequence = event.Sequence](int result) {
+        m_Deadline.reset();
+        m_bRunning = false;
+
+        SaveFeedStats();
+
+        emit delivered(sequence, result, m_bRetryEvent);
+
+        ProcessPendingPushes();
+        ScheduleOutbox(0);
+    };
+
+    if (m_bAlert) DeliverAlertEvent(onDelivered);
+    else          DeliverInfoEvent(onDelivered);
+}
+
+
+// 処理中の地震情報がこの掲示板のログファイルに存在するかどうかを確認する
+// 複数の掲示板に書き込む場合、再試行時に書き込み済みの掲示板へ重複して書き込まないために使用する
+bool Worker::IsLogged() const
+{
+    auto       pStore      = EventStore::open(m_CommonData.LogFile);
+    const auto lockTimeout = GetLockTimeout();
+
+    int ret = 0;
+    if (m_bAlert) {
+        ret = (m_CommonData.iGetInfo == 0) ? pStore->containsURL(m_Alert.m_URL, lockTimeout)
+                                           : pStore->containsID(m_Alert.m_ID, lockTimeout);
+    }
+    else {
+        ret = (m_CommonData.iGetInfo == 0) ? pStore->containsReport(m_Info.m_ID, m_Info.m_ReportDateTime, lockTimeout)
+                                           : pStore->containsID(m_Info.m_ID, lockTimeout);
+    }
+
+    return ret == 1;
+}
+
+
+// 処理中の地震情報の処理をキャンセルする
+// 送信中のリクエストを中断して、以降の段階を実行しない (掲示板との接続の維持も停止する)
+void Worker::cancel()
+{
+    m_bCancelled = true;
+    m_PendingPushes.clear();
+    m_PendingEvents.clear();
+    m_pPoster->stopKeepWarm();
+    m_OutboxTimer.stop();
+
+    if (m_pReply) m_pReply->abort();
+
+    // 取得を共有している場合は、共有しているリクエストを中断せずに、このオブジェクトの待機のみを解除する
+    // リクエストは、他の設定ファイルの地震情報オブジェクトへのレスポンスのために継続する
+    if (m_bWaitingFeed) {
+        m_bWaitingFeed = false;
+        FeedFetcher::cancel(this);
+        FinishPipeline(-1);
+    }
+}
+
+
+// 地震情報の処理中かどうかを確認する
+bool Worker::IsRunning() const
+{
+    return m_bRunning;
+}
+
+
+// 処理中にP2P地震情報のWebSocket APIから受信した地震情報のデータを、処理の終了後に処理するように保存する
+void Worker::EnqueuePushedData(const QByteArray &data)
+{
+    m_PendingPushes.enqueue(data);
+}
+
+
+// QXmlStreamReaderクラスを使用して、JMAのAtomフィードから処理位置より新しいエントリを取得する
+// フィードの<entry>タグは<updated>タグの日時の降順 (新しい順) に並んでいるため、
+// 処理位置より古いエントリに到達した時点で解析を終了する (残りのエントリは読み込まない)
+int Worker::ScanFeed_Stream(bool bAlert, bool bFirstPoll)
+{
+    m_FeedEntries.clear();
+    m_FeedHead = FEEDCURSOR();
+
+    QXmlStreamReader reader(m_ReplyData);
+    bool             bEntry = false;
+
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (!reader.isStartElement() || reader.qualifiedName() != QLatin1String("entry")) continue;
+
+        bEntry = true;
+
+        // <entry>タグ内にある<id>タグおよび<updated>タグの値を取得する
+        QString id,
+                updated;
+        bool    bID      = false,
+                bUpdated = false;
+
+        while (reader.readNextStartElement()) {
+            if (!bID && reader.qualifiedName() == QLatin1String("id")) {
+                id  = ReadElementText(reader);
+                bID = true;
+            }
+            else if (!bUpdated && reader.qualifiedName() == QLatin1String("updated")) {
+                updated  = ReadElementText(reader);
+                bUpdated = true;
+            }
+            else {
+                reader.skipCurrentElement();
+            }
+        }
+
+        if (reader.hasError()) break;
+
+        // 処理位置より古いエントリに到達した場合は、解析を終了する
+        if (!AddFeedEntry(id, QDateTime::fromString(updated, Qt::ISODate), bAlert, bFirstPoll)) return 0;
+    }
+
+    if (reader.hasError()) {
+        std::cerr << QString("警告 : XMLファイル(JMA)のストリーム形式での解析に失敗しました %1 (行: %2, 列: %3)")
+                     .arg(reader.errorString()).arg(reader.lineNumber()).arg(reader.columnNumber()).toStdString() << std::endl;
+
+        return StreamParseError;
+    }
+
+    // XMLファイルに<entry>タグが存在するかどうかを確認する
+    if (!bEntry) {
+        // <entry>タグが存在しない場合
+        std::cerr << QString("エラー : <entry>タグが存在しません").toStdString() << std::endl;
+
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// QDomDocumentクラスを使用して、JMAのAtomフィードから処理位置より新しいエントリを取得する
+// ストリーム形式での解析に失敗した場合、または、ストリーム形式の解析が無効の場合に使用する
+int Worker::ScanFeed_DOM(bool bAlert, bool bFirstPoll)
+{
+    m_FeedEntries.clear();
+    m_FeedHead = FEEDCURSOR();
+
+    // QDomDocumentクラスを使用してXMLデータをパース
+    QDomDocument doc;
+    if (!doc.setContent(m_ReplyData)) {
+        // XMLファイルのパースに失敗した場合
+        std::cerr << QString("エラー : XMLファイル(JMA)のパースに失敗しました").toStdString() << std::endl;
+
+        return -1;
+    }
+
+    // ドキュメントのルート要素から、<entry>タグを持つ要素のリストを取得する
+    QDomElement  root      = doc.documentElement();
+    QDomNodeList entryList = root.elementsByTagName("entry");
+
+    // XMLファイルに<entry>タグが存在するかどうかを確認する
+    if (entryList.isEmpty()) {
+        // <entry>タグが存在しない場合
+        std::cerr << QString("エラー : <entry>タグが存在しません").toStdString() << std::endl;
+
+        return -1;
+    }
+
+    for (auto i = 0; i < entryList.count(); i++) {
+        // <entry>タグ内にある<id>タグおよび<updated>タグの値を取得する
+        QDomElement entry   = entryList.at(i).toElement();
+        auto        id      = entry.firstChildElement("id").text();
+        auto        updated = QDateTime::fromString(entry.firstChildElement("updated").text(), Qt::ISODate);
+
+        // 処理位置より古いエントリに到達した場合は、走査を終了する
+        if (!AddFeedEntry(id, updated, bAlert, bFirstPoll)) break;
+    }
+
+    return 0;
+}
+
+
+// 取得したエントリが処理位置より新しい地震情報の場合は、処理するエントリのリストに追加する
+// 処理位置より古いエントリに到達した場合はfalseを返す (以降のエントリも処理済みであるため、走査を終了する)
+//
+// 初回の取得時は、最新の1件のみを追加する
+// ただし、フィードの先頭の位置を取得するため、全てのエントリを走査する
+bool Worker::AddFeedEntry(const QString &id, const QDateTime &updated, bool bAlert, bool bFirstPoll)
+{
+    if (id.isEmpty() || !updated.isValid()) return true;
+
+    // フィードの先頭 (最新) の位置を保存
+    if (!m_FeedHead.Updated.isValid() || updated > m_FeedHead.Updated) {
+        m_FeedHead.Updated = updated;
+        m_FeedHead.IDs     = QSet<QString>{id};
+    }
+    else if (updated == m_FeedHead.Updated) {
+        m_FeedHead.IDs.insert(id);
+    }
+
+    if (!bFirstPoll) {
+        // 処理位置より古いエントリに到達した場合は、以降のエントリも処理済みであるため走査を終了する
+        if (updated < m_FeedCursor.Updated) return false;
+
+        // 処理位置と同じ日時の処理済みのエントリは無視する
+        if (updated == m_FeedCursor.Updated && m_FeedCursor.IDs.contains(id)) return true;
+    }
+    else if (!m_FeedEntries.isEmpty()) {
+        // 初回の取得時において、既に最新の1件を取得している場合
+        return true;
+    }
+
+    // <id>タグの値に"VXSE"という文字列が含まれているかどうかを確認する
+    if (bAlert) {
+        // "VXSE43"という文字列が含まれている場合は、それが緊急地震速報 (警報) のURLである
+        // "VXSE44" : 緊急地震速報 (予報 - 配信終了予定)
+        // "VXSE45" : 緊急地震速報 (地震動予報)
+        // "VXSE47" : リアルタイム震度電文
+        // 仕様 : https://www.data.jma.go.jp/eew/data/nc/katsuyou/reference.pdf
+        // 仕様 : https://xml.kishou.go.jp/tec_material.html
+        if (!id.contains("VXSE43", Qt::CaseSensitive)) return true;
+    }
+    else {
+        // "VXSE51"(震度速報) あるいは "VXSE53"(震源・震度に関する情報) という文字列が含まれている場合は、それが発生した地震情報のURLである
+        // なお、"VXSE52"(震源速報) はフォーマットが異なる部分も多いため、取得しない
+        if (!id.contains("VXSE51", Qt::CaseSensitive) && !id.contains("VXSE53", Qt::CaseSensitive)) return true;
+    }
+
+    // 古い順に処理するため、先頭に追加する
+    m_FeedEntries.prepend(FEEDENTRY{id, updated});
+
+    return true;
+}
+
+
+// 処理位置 (カーソル) を指定したエントリまで進める
+void Worker::AdvanceFeedCursor(const FEEDENTRY &entry)
+{
+    if (!m_FeedCursor.Updated.isValid() || entry.Updated > m_FeedCursor.Updated) {
+        m_FeedCursor.Updated = entry.Updated;
+        m_FeedCursor.IDs     = QSet<QString>{entry.ID};
+    }
+    else if (entry.Updated == m_FeedCursor.Updated) {
+        m_FeedCursor.IDs.insert(entry.ID);
+    }
+}
+
+
+// 再試行が必要なエラーが発生したことを記録する
+// 次回の取得時に304 (Not Modified) で読み飛ばされないように、検証子を破棄する
+void Worker::RequestRetry()
+{
+    m_bRetryEvent = true;
+    ResetValidator(m_CommonData.EQInfoURL);
+}
+
+
+// 前回の検証子を使用して条件付きGETリクエストのヘッダを設定する
+void Worker::SetConditionalHeaders(QNetworkRequest &request) const
+{
+    auto it = m_FeedValidators.constFind(request.url().toString());
+    if (it == m_FeedValidators.constEnd()) return;
+
+    if (!it->ETag.isEmpty())         request.setRawHeader("If-None-Match",     it->ETag);
+    if (!it->LastModified.isEmpty()) request.setRawHeader("If-Modified-Since", it->LastModified);
+}
+
+
+// レスポンスが304 (Not Modified) かどうかを確認する
+// 200 (OK) の場合は、レスポンスのETagヘッダおよびLast-Modifiedヘッダを次回の検証子として保存する
+//
+// 取得を共有している場合 (デーモンモード) は、条件付きGETリクエストを共有の取得で行うため、
+// 前回処理したレスポンスと同じ番号の場合に、304 (Not Modified) と同様に扱う
+bool Worker::IsNotModified(const FEEDRESPONSE &response)
+{
+    if (response.Version != 0) {
+        if (m_FeedValidators.value(response.Url.toString()).Version == response.Version) {
+            m_FeedStats.NotModified++;
+            return true;
+        }
+
+        m_FeedStats.Modified++;
+
+        FEEDVALIDATOR validator;
+        validator.Version = response.Version;
+        m_FeedValidators.insert(response.Url.toString(), validator);
+
+        return false;
+    }
+
+    if (response.StatusCode == 304) {
+        m_FeedStats.NotModified++;
+
+#ifdef _DEBUG
+        std::cout << QString("地震情報は更新されていません (304 Not Modified) : %1").arg(response.Url.toString()).toStdString() << std::endl;
+#endif
+
+        return true;
+    }
+
+    if (response.Error == QNetworkReply::NoError) {
+        m_FeedStats.Modified++;
+
+        FEEDVALIDATOR validator;
+        validator.ETag         = response.ETag;
+        validator.LastModified = response.LastModified;
+
+        if (validator.ETag.isEmpty() && validator.LastModified.isEmpty()) {
+            // サーバが検証子を返さない場合は、条件付きGETリクエストを使用しない
+            m_FeedValidators.remove(response.Url.toString());
+        }
+        else {
+            m_FeedValidators.insert(response.Url.toString(), validator);
+        }
+    }
+
+    return false;
+}
+
+
+// 検証子を破棄する
+// 取得したデータの処理に失敗した場合、次回の取得時に304 (Not Modified) で読み飛ばされることを防ぐ
+void Worker::ResetValidator(const QString &url)
+{
+    m_FeedValidators.remove(url);
+}
+
+
+// JMAから取得した地震情報を整形する
+// まず、QXmlStreamReaderクラスを使用してXMLデータを先頭から順に解析して、地震情報のデータへ直接格納する
+// ストリーム形式での解析に失敗した場合は、解析途中のデータを破棄して、QDomDocumentクラスを使用して再解析する
+int Worker::FormattingData_for_JMA(bool bAlert)
+{
+    QElapsedTimer timer;
+
+    if (m_CommonData.bStreamParser) {
+        // 再解析する場合に備えて、解析前の地震情報のデータを保存
+        const EarthQuakeAlert alert(m_Alert);
+        const EarthQuakeInfo  info(m_Info);
+
+        timer.start();
+        auto ret = FormattingData_for_JMA_Stream(bAlert);
+
+        m_FeedStats.StreamParsed++;
+        m_FeedStats.StreamNsecs += timer.nsecsElapsed();
+
+        if (ret != StreamParseError) return ret;
+
+        m_Alert = alert;
+        m_Info  = info;
+        m_FeedStats.Fallbacks++;
+    }
+
+    timer.start();
+    auto ret = FormattingData_for_JMA_DOM(bAlert);
+
+    m_FeedStats.DomParsed++;
+    m_FeedStats.DomNsecs += timer.nsecsElapsed();
+
+    return ret;
+}
+
+
+// QXmlStreamReaderクラスを使用して、JMAから取得した地震情報を整形する
+// Head要素の時点で無視する地震情報 (報告時刻の超過、処理済みの地震ID等) と判断できる場合は、Body要素を解析せずに終了する
+// また、必要な要素を全て取得した時点で、残りの要素を読み込まずに終了する
+//
+// 戻り値 : 0 (正常)、-1 (無視する地震情報、または、地震情報に異常がある場合)、
+//         StreamParseError (XMLの解析に失敗した場合、DOM形式で再解析する)
+int Worker::FormattingData_for_JMA_Stream(bool bAlert)
+{
+    QXmlStreamReader reader(m_ReplyData);
+
+    // ルート (Report要素) まで読み進める
+    int ret = StreamParseError;
+    if (reader.readNextStartElement()) {
+        ret = bAlert ? ReadAlertReport_Stream(reader) : ReadInfoReport_Stream(reader);
+    }
+
+    if (ret == StreamParseError) {
+        std::cerr << QString("警告 : XMLのストリーム形式での解析に失敗したため、DOM形式で再解析します: %1 (行: %2, 列: %3)")
+                     .arg(reader.errorString()).arg(reader.lineNumber()).arg(reader.columnNumber()).toStdString() << std::endl;
+    }
+
+    return ret;
+}
+
+
+// 緊急地震速報(警報)のReport要素を解析する
+int Worker::ReadAlertReport_Stream(QXmlStreamReader &reader)
+{
+    // ルート (Report要素) の確認
+    if (reader.qualifiedName() != QLatin1String("Report")) {
+        std::cerr << QString("エラー: 予期しないルート要素です: %1 (JMA 緊急地震速報(警報))").arg(reader.qualifiedName().toString()).toStdString() << std::endl;
+        return -1;
+    }
+
+    QString reportDateTime, // 報告時刻
+            eventID,        // 地震ID
+            headline;       // ヘッドライン
+    bool    bHead           = false,
+            bReportDateTime = false,
+            bEventID        = false,
+            bHeadline       = false,
+            bBody           = false,
+            bEarthquake     = false,
+            bIntensity      = false,
+            bComments       = false;
+
+    while (reader.readNextStartElement()) {
+        if (!bHead && reader.qualifiedName() == QLatin1String("Head")) {
+            // Head要素の解析
+            bHead = true;
+
+            while (reader.readNextStartElement()) {
+                if (!bReportDateTime && reader.qualifiedName() == QLatin1String("ReportDateTime")) {
+                    reportDateTime  = ReadElementText(reader);
+                    bReportDateTime = true;
+                }
+                else if (!bEventID && reader.qualifiedName() == QLatin1String("EventID")) {
+                    eventID  = ReadElementText(reader);
+                    bEventID = true;
+                }
+                else if (!bHeadline && reader.qualifiedName() == QLatin1String("Headline")) {
+                    bHeadline = true;
+                    if (!GetElementText(reader, "Text", headline)) headline = "";
+                }
+                else {
+                    reader.skipCurrentElement();
+                }
+            }
+
+            if (reader.hasError()) return StreamParseError;
+
+            // 現在時刻と比較して、緊急地震速報(警報)の報告時刻が30[秒]以内かどうかを確認
+            // 30[秒]を超過している場合は、Body要素を解析せずに終了する
+            if (!bReportDateTime) {
+                std::cerr << QString("エラー: 報告時刻 (ReportDateTime要素) が存在しません (JMA 緊急地震速報(警報))").toStdString() << std::endl;
+                return -1;
+            }
+
+            qint64 diff = GetElapsedSeconds(reportDateTime);
+            if (!(diff >= 0 && diff <= 30)) {
+                std::cout << QString("緊急地震速報 (警報) は30[秒]を超過しているため無視します").toStdString() << std::endl;
+                return -1;
+            }
+
+            m_Alert.m_ReportDateTime = reportDateTime;
+
+            // 地震IDの取得
+            if (!bEventID) {
+                std::cerr << QString("エラー: 地震ID (EventID要素) が存在しません (JMA 緊急地震速報(警報))").toStdString() << std::endl;
+                return -1;
+            }
+
+            m_Alert.m_ID = eventID;
+
+            // ヘッドラインの取得
+            if (bHeadline) m_Alert.m_Headline = headline;
+        }
+        else if (!bBody && reader.qualifiedName() == QLatin1String("Body")) {
+            // Head要素より先にBody要素が存在する場合は、報告時刻が存在しない
+            if (!bHead) {
+                std::cerr << QString("エラー: 報告時刻 (ReportDateTime要素) が存在しません (JMA 緊急地震速報(警報))").toStdString() << std::endl;
+                return -1;
+            }
+
+            // Body要素の解析
+            bBody = true;
+
+            while (reader.readNextStartElement()) {
+                if (!bEarthquake && reader.qualifiedName() == QLatin1String("Earthquake")) {
+                    // 緊急地震速報(警報)の地震に関する基本情報の取得
+                    bEarthquake = true;
+                    ReadAlertEarthquake_Stream(reader);
+                }
+                else if (!bIntensity && reader.qualifiedName() == QLatin1String("Intensity")) {
+                    // 予想される各地域の震度の取得
+                    bIntensity = true;
+
+                    bool bForecast = false;
+                    while (reader.readNextStartElement()) {
+                        if (!bForecast && reader.qualifiedName() == QLatin1String("Forecast")) {
+                            bForecast = true;
+                            ReadAlertForecast_Stream(reader);
+                        }
+                        else {
+                            reader.skipCurrentElement();
+                        }
+                    }
+                }
+                else if (!bComments && reader.qualifiedName() == QLatin1String("Comments")) {
+                    // 固定付加文の取得
+                    bComments = true;
+
+                    bool bWarningComment = false;
+                    while (reader.readNextStartElement()) {
+                        if (!bWarningComment && reader.qualifiedName() == QLatin1String("WarningComment")) {
+                            bWarningComment = true;
+
+                            QString warningText;
+                            if (reader.attributes().value(QLatin1String("codeType")) == QString("固定付加文")) {
+                                if (GetElementText(reader, "Text", warningText)) m_Alert.m_Text = warningText;
+                            }
+                            else {
+                                reader.skipCurrentElement();
+                            }
+                        }
+                        else {
+                            reader.skipCurrentElement();
+                        }
+                    }
+                }
+                else {
+                    reader.skipCurrentElement();
+                }
+
+                if (reader.hasError()) return StreamParseError;
+
+                // 必要な要素を全て取得した場合は、残りの要素を読み込まない
+                if (bEarthquake && bIntensity && bComments) break;
+            }
+
+            if (reader.hasError()) return StreamParseError;
+
+            // Body要素以降の要素は使用しない
+            break;
+        }
+        else {
+            reader.skipCurrentElement();
+        }
+    }
+
+    if (reader.hasError()) return StreamParseError;
+
+    if (!bHead) {
+        std::cerr << QString("エラー: 報告時刻 (ReportDateTime要素) が存在しません (JMA 緊急地震速報(警報))").toStdString() << std::endl;
+        return -1;
+    }
+
+    if (!bBody) {
+        std::cerr << QString("エラー: 緊急地震速報(警報)の基本情報 (Body要素) が見つかりません (JMA 緊急地震速報(警報))").toStdString() << std::endl;
+        return -1;
+    }
+
+    if (!bEarthquake) {
+        std::cerr << QString("エラー: 緊急地震速報(警報)の基本情報 (Earthquake要素) が見つかりません (JMA 緊急地震速報(警報))").toStdString() << std::endl;
+        return -1;
+    }
+
+    /// 緊急地震速報(警報)の地域に対して、最大震度の大きさで降順にソート
+    if (m_Alert.m_Areas.count() > 1) {
+        std::sort(m_Alert.m_Areas.begin(), m_Alert.m_Areas.end(), sortAreas);
+    }
+
+    /// 地震の情報を表すコード
+    m_Alert.m_Code = 556;
+
+    return 0;
+}
+
+
+// 緊急地震速報(警報)のEarthquake要素を解析する
+void Worker::ReadAlertEarthquake_Stream(QXmlStreamReader &reader)
+{
+    // 予想される震源の情報の初期値
+    m_Alert.m_Name      = "";
+    m_Alert.m_Latitude  = "-200";
+    m_Alert.m_Longitude = "-200";
+    m_Alert.m_Depth     = "-1";
+    m_Alert.m_Magnitude = "-1";
+
+    bool bOriginTime  = false,
+         bArrivalTime = false,
+         bHypocenter  = false,
+         bMagnitude   = false;
+
+    while (reader.readNextStartElement()) {
+        if (!bOriginTime && reader.qualifiedName() == QLatin1String("OriginTime")) {
+            // 地震発生時刻の取得
+            bOriginTime = true;
+
+            QDateTime dateTime    = QDateTime::fromString(ReadElementText(reader), Qt::ISODateWithMs);
+            dateTime.setTimeZone(QTimeZone("Asia/Tokyo"));
+            m_Alert.m_OriginTime  = dateTime.toString("yyyy年M月d日 h時m分s秒");
+        }
+        else if (!bArrivalTime && reader.qualifiedName() == QLatin1String("ArrivalTime")) {
+            // 地震発現(到達)時刻の取得
+            bArrivalTime = true;
+
+            QDateTime dateTime    = QDateTime::fromString(ReadElementText(reader), Qt::ISODateWithMs);
+            dateTime.setTimeZone(QTimeZone("Asia/Tokyo"));
+            m_Alert.m_ArrivalTime = dateTime.toString("yyyy年M月d日 h時m分s秒");
+        }
+        else if (!bHypocenter && reader.qualifiedName() == QLatin1String("Hypocenter")) {
+            // 予想される震源地、緯度・経度・震源の深さの取得
+            bHypocenter = true;
+
+            QString epicenter,
+                    coordinate;
+            ReadHypocenter_Stream(reader, epicenter, coordinate);
+
+            if (!epicenter.isEmpty()) m_Alert.m_Name = epicenter;
+            ParseCoordinate(coordinate, m_Alert.m_Latitude, m_Alert.m_Longitude, m_Alert.m_Depth);
+        }
+        else if (!bMagnitude && reader.qualifiedName() == QLatin1String("jmx_eb:Magnitude")) {
+            // 予想されるマグニチュードの取得
+            bMagnitude          = true;
+            m_Alert.m_Magnitude = ReadElementText(reader);
+        }
+        else {
+            reader.skipCurrentElement();
+        }
+    }
+}
+
+
+// 緊急地震速報(警報)のForecast要素を解析して、予想される各地域の震度を取得する
+// 予想される各地域 (Pref要素) は、最大8個に制限する
+void Worker::ReadAlertForecast_Stream(QXmlStreamReader &reader)
+{
+    int count = 0;
+
+    while (reader.readNextStartElement()) {
+        if (count >= 8 || reader.qualifiedName() != QLatin1String("Pref")) {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        count++;
+
+        /// 予想される場所とその震度の取得 (Pref要素内の最初のArea要素のみ)
+        QString kind,
+                areaName,
+                fromScale,
+                toScale,
+                time;
+        bool    bArea        = false,
+                bName        = false,
+                bForecastInt = false,
+                bFrom        = false,
+                bTo          = false,
+                bCategory    = false,
+                bKind        = false,
+                bTime        = false;
+
+        while (reader.readNextStartElement()) {
+            if (bArea || reader.qualifiedName() != QLatin1String("Area")) {
+                reader.skipCurrentElement();
+                continue;
+            }
+
+            bArea = true;
+
+            while (reader.readNextStartElement()) {
+                if (!bName && reader.qualifiedName() == QLatin1String("Name")) {
+                    areaName = ReadElementText(reader);
+                    bName    = true;
+                }
+                else if (!bForecastInt && reader.qualifiedName() == QLatin1String("ForecastInt")) {
+                    bForecastInt = true;
+
+                    while (reader.readNextStartElement()) {
+                        if (!bFrom && reader.qualifiedName() == QLatin1String("From")) {
+                            fromScale = ReadElementText(reader);
+                            bFrom     = true;
+                        }
+                        else if (!bTo && reader.qualifiedName() == QLatin1String("To")) {
+                            toScale = ReadElementText(reader);
+                            bTo     = true;
+                        }
+                        else {
+                            reader.skipCurrentElement();
+                        }
+                    }
+                }
+                else if (!bCategory && reader.qualifiedName() == QLatin1String("Category")) {
+                    bCategory = true;
+
+                    while (reader.readNextStartElement()) {
+                        if (!bKind && reader.qualifiedName() == QLatin1String("Kind")) {
+                            bKind = true;
+                            if (!GetElementText(reader, "Code", kind)) kind = "";
+                        }
+                        else {
+                            reader.skipCurrentElement();
+                        }
+                    }
+                }
+                else if (!bTime && reader.qualifiedName() == QLatin1String("ArrivalTime")) {
+                    time  = ReadElementText(reader);
+                    bTime = true;
+                }
+                else {
+                    reader.skipCurrentElement();
+                }
+            }
+        }
+
+        if (bName && bFrom && bTo) {
+            AREA area = {};
+            area.KindCode    = kind;
+            area.Name        = areaName;
+            area.ScaleFrom   = ConvertJMAScale<int>(fromScale);
+            area.ScaleTo     = ConvertJMAScale<int>(toScale);
+            area.ArrivalTime = bTime ? ConvertDateTimeFormat(time) : "";
+            m_Alert.m_Areas.append(area);
+        }
+    }
+}
+
+
+// 発生した地震情報のReport要素を解析する
+int Worker::ReadInfoReport_Stream(QXmlStreamReader &reader)
+{
+    QString eventID,            // 地震ID
+            reportDateTime,     // 報告時刻
+            targetDateTime,     // 基点時刻 (OriginTime要素が存在しない場合に使用する)
+            headLineKind,       // 地震情報のタイトル
+            headLineText;       // 地震情報のヘッドライン
+    bool    bHead           = false,
+            bEventID        = false,
+            bReportDateTime = false,
+            bTargetDateTime = false,
+            bTitle          = false,
+            bHeadline       = false,
+            bBody           = false,
+            bEarthquake     = false,
+            bIntensity      = false,
+            bObservation    = false,
+            bComments       = false;
+
+    while (reader.readNextStartElement()) {
+        if (!bHead && reader.qualifiedName() == QLatin1String("Head")) {
+            // Head要素の解析
+            bHead = true;
+
+            while (reader.readNextStartElement()) {
+                if (!bEventID && reader.qualifiedName() == QLatin1String("EventID")) {
+                    eventID  = ReadElementText(reader);
+                    bEventID = true;
+                }
+                else if (!bReportDateTime && reader.qualifiedName() == QLatin1String("ReportDateTime")) {
+                    reportDateTime  = ReadElementText(reader);
+                    bReportDateTime = true;
+                }
+                else if (!bTargetDateTime && reader.qualifiedName() == QLatin1String("TargetDateTime")) {
+                    targetDateTime  = ReadElementText(reader);
+                    bTargetDateTime = true;
+                }
+                else if (!bTitle && reader.qualifiedName() == QLatin1String("Title")) {
+                    headLineKind = ReadElementText(reader);
+                    bTitle       = true;
+                }
+                else if (!bHeadline && reader.qualifiedName() == QLatin1String("Headline")) {
+                    bHeadline = true;
+                    if (!GetElementText(reader, "Text", headLineText)) headLineText = "";
+                }
+                else {
+                    reader.skipCurrentElement();
+                }
+            }
 
-        // ログファイルから過去に作成したスレッドのURLが生存しているかどうかを確認
-        if (isExistThread(QUrl(m_InfoLog.ThreadURL), m_InfoLog.Title)) {
-            // 過去に作成したスレッドのURLが生存している場合、既存のスレッドに書き込む
+            if (reader.hasError()) return StreamParseError;
 
-            // !chttコマンドを使用する場合 (防弾嫌儲系の掲示板で使用可能)
-            if (m_CommonData.bChangeTitle) {
-                m_ThreadInfo.message = AddChttCommand(m_ThreadInfo.subject, m_ThreadInfo.message);
-            }
+            /// ログファイルに同じ地震IDが存在するかどうかを確認する
+            m_Info.m_ID = eventID;
 
-            // 地震情報のログファイルからスレッド番号をセット
-            if (!m_InfoLog.ThreadNum.isEmpty()) {
-                m_ThreadInfo.key = m_InfoLog.ThreadNum;
-            }
-            else {
-                std::cerr << QString("エラー : スレッド番号が不明です").toStdString() << std::endl;
+            /// ログファイルにある同じ地震IDの"ReportDateTime"キー (報告時刻) の日時が同じ場合は、Body要素を解析せずに終了する
+            if (!SearchInfoEQID(eventID, reportDateTime)) {
                 return -1;
             }
 
-            // 既存のスレッドに書き込む
-            if (Post(m_Info.m_Code, false)) {
-                // 既存のスレッドの書き込みに失敗した場合
+            /// 現在時刻と比較して、発生した地震情報の最新情報 (報告時刻) が10[分]以内かどうかを確認
+            /// 600[秒](10[分])を超過している場合は、Body要素を解析せずに終了する
+            qint64 diff = GetElapsedSeconds(reportDateTime);
+            if (!(diff >= 0 && diff <= 600)) {
+                std::cout << QString("発生した地震情報は10[分]を超過しているため無視します").toStdString() << std::endl;
                 return -1;
             }
 
-            // ログファイルの更新
-            if (m_CommonData.bChangeTitle) {
-                // !chttコマンドが有効の場合
-                // スレッドのタイトルが変更されているかどうかを確認
-                if (!CompareThreadTitle(QUrl(m_InfoLog.ThreadURL), m_InfoLog.Title)) {
-                    // スレッドのタイトルが変更された場合 (!chttコマンドが成功した場合)
-                    // 変更されたスレッドのタイトル、地震ID、地震発生日時を地震情報のログファイルに追加・更新
-                    if (!m_Info.m_ID.isEmpty()) {
-                        if (m_Info.UpdateInfo(m_CommonData.LogFile, true, m_ThreadInfo.subject, m_CommonData.iGetInfo)) return -1;
+            /// 地震情報のヘッドラインを取得
+            /// 本文の先頭に記載 : "【タイトル】ヘッドラインの文章"形式
+            if (bHeadline) {
+                /// 先頭の全角スペースと半角スペースを除去
+                static QRegularExpression RegEx("^[　 ]+");
+                headLineText.remove(RegEx);
+
+                if (!headLineKind.isEmpty()) {
+                    m_Info.m_Headline  = QString("【%1】").arg(headLineKind) + QString("\n");
+                }
+
+                if (!headLineText.isEmpty()) {
+                    m_Info.m_Headline +=  headLineText;
+                }
+            }
+
+            /// JMAの地震情報の報告日時を取得
+            m_Info.m_ReportDateTime = reportDateTime;
+
+            m_Info.m_Latitude  = "-200";
+            m_Info.m_Longitude = "-200";
+            m_Info.m_Depth     = "-1";
+            m_Info.m_Magnitude = "-1";
+        }
+        else if (!bBody && reader.qualifiedName() == QLatin1String("Body")) {
+            // Head要素より先にBody要素が存在する場合は無視する
+            if (!bHead) return -1;
+
+            // Body要素の解析
+            bBody = true;
+
+            while (reader.readNextStartElement()) {
+                if (!bEarthquake && reader.qualifiedName() == QLatin1String("Earthquake")) {
+                    // 震源地、震源の深さ、緯度、経度、マグニチュードの取得
+                    bEarthquake = true;
+                    ReadInfoEarthquake_Stream(reader, targetDateTime);
+                }
+                else if (!bIntensity && reader.qualifiedName() == QLatin1String("Intensity")) {
+                    // 各地域の震度の取得
+                    bIntensity = true;
+
+                    while (reader.readNextStartElement()) {
+                        if (!bObservation && reader.qualifiedName() == QLatin1String("Observation")) {
+                            bObservation = true;
+
+                            /// 最大震度が設定した震度より小さい場合は、各地域の震度を解析せずに終了する
+                            auto ret = ReadInfoObservation_Stream(reader);
+                            if (ret != 0) return ret;
+                        }
+                        else {
+                            reader.skipCurrentElement();
+                        }
                     }
+
+                    if (reader.hasError())  return StreamParseError;
+                    if (!bObservation)      return -1;
                 }
-                else {
-                    // スレッドのタイトルが変更されていない場合 (!chttコマンドが失敗している場合)
-                    // または、スレッドのタイトルの抽出に失敗した場合
-                    // 地震IDおよび地震発生日時を地震情報のログファイルに追加・更新
-                    if (!m_Info.m_ID.isEmpty()) {
-                        if (m_Info.UpdateInfo(m_CommonData.LogFile, false, "", m_CommonData.iGetInfo)) return -1;
+                else if (!bComments && reader.qualifiedName() == QLatin1String("Comments")) {
+                    // 地震情報に関する速報テキストの取得 (ForecastComment要素、VarComment要素、FreeFormComment要素)
+                    // Comments要素は、Intensity要素より後に存在する
+                    if (!bIntensity) {
+                        std::cout << QString("地震速報または震源・震度に関する情報ではないため、このデータを無視します").toStdString() << std::endl;
+                        return -1;
                     }
+
+                    bComments = true;
+                    ReadInfoComments_Stream(reader);
                 }
-            }
-            else {
-                // !chttコマンドが無効の場合
-                // 地震IDおよび地震発生日時を地震情報のログファイルに追加・更新
-                if (!m_Info.m_ID.isEmpty()) {
-                    if (m_Info.UpdateInfo(m_CommonData.LogFile, false, "", m_CommonData.iGetInfo)) return -1;
+                else {
+                    reader.skipCurrentElement();
                 }
-            }
-        }
-        else {
-            // 過去に作成したスレッドのURLが生存していない場合、スレッドを新規作成
-            if (Post(m_Info.m_Code)) {
-                // スレッドの新規作成に失敗した場合
-                return -1;
-            }
 
-            // 過去に作成したスレッドがあるオブジェクトをログファイルから削除
-#if (QEQALERT_VERSION_MAJOR == 0 && QEQALERT_VERSION_MINOR == 1 && QEQALERT_VERSION_PATCH <= 2)
-            if (DeleteObject(m_Info.m_Name)) {
-#else
-            if (DeleteObject(m_Info.m_MaxIntPrefs)) {
-#endif
-                // ログファイルから生存していないスレッド情報の削除に失敗した場合
-                return -1;
-            }
+                if (reader.hasError()) return StreamParseError;
 
-            // 地震ID、地震発生日時、スレッド情報を地震情報のログファイルに新規保存
-            if (!m_Info.m_ID.isEmpty()) {
-                if (m_Info.AddInfo(m_CommonData.LogFile, m_InfoLog.Title, m_InfoLog.ThreadURL, m_InfoLog.ThreadNum, m_CommonData.iGetInfo)) return -1;
+                // Comments要素はBody要素の最後の要素であるため、残りの要素を読み込まない
+                if (bComments) break;
             }
+
+            if (reader.hasError()) return StreamParseError;
+
+            // Body要素以降の要素は使用しない
+            break;
+        }
+        else {
+            reader.skipCurrentElement();
         }
     }
-    else {
-        // 地震情報のログファイルに同じ震源地(都道府県)が存在しない場合
 
-        // スレッドを新規作成する
-        if (Post(m_Info.m_Code)) {
-            // スレッドの新規作成に失敗した場合
-            return -1;
-        }
+    if (reader.hasError()) return StreamParseError;
 
-        // 地震ID、地震発生日時、スレッド情報を地震情報のログファイルに新規保存
-        if (!m_Info.m_ID.isEmpty()) {
-            if (m_Info.AddInfo(m_CommonData.LogFile, m_InfoLog.Title, m_InfoLog.ThreadURL, m_InfoLog.ThreadNum, m_CommonData.iGetInfo)) return -1;
-        }
+    if (!bHead || !bBody) return -1;
+
+    if (!bIntensity) {
+        std::cout << QString("地震速報または震源・震度に関する情報ではないため、このデータを無視します").toStdString() << std::endl;
+        return -1;
     }
 
     return 0;
 }
 
 
-// JMA(気象庁)から発生した地震情報のURLを取得する
-int Worker::onEQDownloaded_for_JMA(bool bAlert)
+// 発生した地震情報のEarthquake要素を解析する
+// OriginTime要素が存在しない場合は、Head要素のTargetDateTime要素の値を使用する
+void Worker::ReadInfoEarthquake_Stream(QXmlStreamReader &reader, const QString &targetDateTime)
 {
-    // テストファイルを使用するかどうかの確認
-    if (!m_CommonData.TestFile.isEmpty()) {
-        // テストファイルを使用する場合
-        try {
-            // ログファイルに同じ緊急地震速報 (警報) のURLが存在する場合は無視する
-            if (!SearchAlertEQID(m_CommonData.TestFile))       return -1;
-
-            // テストファイルを開く
-            QFile TestFile(m_CommonData.TestFile);
-            if (!TestFile.open(QIODevice::ReadOnly)) {
-                throw std::runtime_error(TestFile.errorString().toStdString());
-            }
-
-            // テストファイルの読み込み
-            m_ReplyData = TestFile.readAll();
-
-            // テストファイルを閉じる
-            TestFile.close();
+    QString originTime;
+    bool    bOriginTime = false,
+            bHypocenter = false,
+            bMagnitude  = false;
+
+    while (reader.readNextStartElement()) {
+        if (!bOriginTime && reader.qualifiedName() == QLatin1String("OriginTime")) {
+            originTime  = ReadElementText(reader);
+            bOriginTime = true;
+        }
+        else if (!bHypocenter && reader.qualifiedName() == QLatin1String("Hypocenter")) {
+            // 震源地、緯度・経度および震源の深さ
+            // なお、発生直後の地震情報には、これらが記載されていない場合が多い
+            bHypocenter = true;
 
-            // 取得した緊急地震速報(警報)のURLにテストファイルのパスを指定
-            m_Alert.m_URL = m_CommonData.TestFile;
+            QString name,
+                    coordinate;
+            ReadHypocenter_Stream(reader, name, coordinate);
 
-            return 0;
+            if (!name.isEmpty()) m_Info.m_Name = name;
+            ParseCoordinate(coordinate, m_Info.m_Latitude, m_Info.m_Longitude, m_Info.m_Depth);
         }
-        catch (const std::exception &e) {
-            std::cerr << QString("エラー: テスト用XMLファイルの読み込み中にエラーが発生しました: %1").arg(e.what()).toStdString() << std::endl;
-            return -1;
+        else if (!bMagnitude && reader.qualifiedName() == QLatin1String("jmx_eb:Magnitude")) {
+            m_Info.m_Magnitude = ReadElementText(reader);
+            bMagnitude         = true;
+        }
+        else {
+            reader.skipCurrentElement();
         }
     }
 
-    // レスポンス待機の設定
-    QEventLoop loop;
-    m_pEQManager = std::make_unique<QNetworkAccessManager>();
-    connect(m_pEQManager.get(), &QNetworkAccessManager::finished, &loop, &QEventLoop::quit);
+    if (originTime.isEmpty()) originTime = targetDateTime;
 
-    // JMA(気象庁)の地震情報へGETリクエストを送信
-    QUrl url(m_CommonData.EQInfoURL);
-    QNetworkRequest request(url);
-
-    // タイムアウトを3[秒]に設定
-    request.setTransferTimeout(3000);
-
-    auto pReply = m_pEQManager->get(request);
-
-    // レスポンス待機
-    loop.exec();
+    m_Info.m_Time = ConvertDateTimeFormat(originTime);
+}
 
-    // レスポンスの確認
-    QString idValue = "";  // 発生した地震情報のURL
 
-    if (pReply->error() == QNetworkReply::NoError) {
-        // 正常に取得した場合
-        // XMLファイルをダウンロード
-        m_ReplyData = pReply->readAll();
+// 発生した地震情報のObservation要素を解析して、各地域の震度を取得する
+// 最大震度 (MaxInt要素) が設定した震度の閾値より小さい場合は、各地域 (Pref要素) を解析せずに-1を返す
+int Worker::ReadInfoObservation_Stream(QXmlStreamReader &reader)
+{
+    bool bMaxInt = false;
+
+    // ユーザが設定した震度の閾値を確認
+    // 1つでも閾値以上の地震が各地域で発生した場合は、発生した地震情報を取得
+    auto CheckMaxScale = [this](const QString &maxInt) {
+        auto MaxScale = ConvertJMAScale<int>(maxInt);
+        if (MaxScale < m_CommonData.InfoScale) {
+            std::cout << QString("発生した地震情報は、設定した震度より小さいため無視します").toStdString() << std::endl;
+            return false;
+        }
 
-        // QDomDocumentクラスを使用してXMLデータをパース
-        QDomDocument doc;
-        if (doc.setContent(m_ReplyData)) {
-            // ドキュメントのルート要素から、<entry>タグを持つ要素のリストを取得する
-            QDomElement  root      = doc.documentElement();
-            QDomNodeList entryList = root.elementsByTagName("entry");
-
-            // XMLファイルに<entry>タグが存在するかどうかを確認する
-            if (!entryList.isEmpty()) {
-                // <entry>タグが存在する場合
-
-                for (auto i = 0; i < entryList.count(); i++) {
-                    // <entry>タグの値を取得する
-                    QDomElement firstEntry = entryList.at(i).toElement();
-
-                    // <entry>タグ内にある<id>タグの値を取得する
-                    QDomElement idElement = firstEntry.firstChildElement("id");
-
-                    // XMLファイルに<entry>タグ -> <id>タグが存在するかどうかを確認する
-                    if (!idElement.isNull()) {
-                        // <id>タグが存在する場合、その値を取得する
-                        idValue = idElement.text();
-
-                        // <id>タグの値に"VXSE"という文字列が含まれているかどうかを確認する
-                        if (bAlert) {
-                            // "VXSE43"という文字列が含まれている場合は、それが緊急地震速報 (警報) のURLである
-                            // "VXSE44" : 緊急地震速報 (予報 - 配信終了予定)
-                            // "VXSE45" : 緊急地震速報 (地震動予報)
-                            // "VXSE47" : リアルタイム震度電文
-                            // 仕様 : https://www.data.jma.go.jp/eew/data/nc/katsuyou/reference.pdf
-                            // 仕様 : https://xml.kishou.go.jp/tec_material.html
-                            if (idValue.contains("VXSE43", Qt::CaseSensitive)) {
-                                // JMAから緊急地震速報 (警報) の地震情報(XML)の取得
-                                pReply->deleteLater();
-
-                                // ログファイルに同じ緊急地震速報 (警報) のURLが存在する場合は無視する
-                                if (!SearchAlertEQID(idValue))       return -1;
-
-                                // 緊急地震速報 (警報) のURLから地震情報を取得する
-                                if (DownloadContents(QUrl(idValue))) return -1;
-
-                                // 取得した緊急地震速報(警報)のURLを保存
-                                m_Alert.m_URL = idValue;
-
-                                return 0;
-                            }
-                        }
-                        else {
-                            // "VXSE51"(震度速報) あるいは "VXSE53"(震源・震度に関する情報) という文字列が含まれている場合は、それが発生した地震情報のURLである
-                            // なお、"VXSE52"(震源速報) はフォーマットが異なる部分も多いため、取得しない
-                            if (idValue.contains("VXSE51", Qt::CaseSensitive) || idValue.contains("VXSE53", Qt::CaseSensitive)) {
-                                // JMAから発生した地震情報(XML)の取得
-                                pReply->deleteLater();
+        m_Info.m_MaxScale = ConvertScale(MaxScale);
 
-                                // 震度速報あるいは震源・震度に関する情報のURLから発生した地震情報の取得
-                                if (DownloadContents(QUrl(idValue))) return -1;
+        return true;
+    };
 
-                                return 0;
-                            }
-                        }
-                    }
+    while (reader.readNextStartElement()) {
+        if (!bMaxInt && reader.qualifiedName() == QLatin1String("MaxInt")) {
+            bMaxInt = true;
+            if (!CheckMaxScale(ReadElementText(reader))) return -1;
+        }
+        else if (reader.qualifiedName() == QLatin1String("Pref")) {
+            // 都道府県名とその都道府県内の各地域の震度を取得する
+            QString      prefName;
+            bool         bPrefName = false;
+            QList<POINT> points;
+
+            while (reader.readNextStartElement()) {
+                if (!bPrefName && reader.qualifiedName() == QLatin1String("Name")) {
+                    prefName  = ReadElementText(reader);
+                    bPrefName = true;
+                }
+                else if (reader.qualifiedName() == QLatin1String("Area")) {
+                    ReadInfoArea_Stream(reader, points);
+                }
+                else {
+                    reader.skipCurrentElement();
                 }
-
-                // 地震情報のURLが記載されていない場合
-                std::cout << QString("地震情報のURLがありません").toStdString() << std::endl;
-                pReply->deleteLater();
-
-                return -1;
             }
-            else {
-                // <entry>タグが存在しない場合
-                std::cerr << QString("エラー : <entry>タグが存在しません").toStdString() << std::endl;
-                pReply->deleteLater();
 
-                return -1;
+            for (auto &point : points) {
+                point.Pref = prefName;
+                m_Info.m_Points.append(point);
             }
         }
         else {
-            // XMLファイルのパースに失敗した場合
-            std::cerr << QString("エラー : XMLファイル(JMA)のパースに失敗しました").toStdString() << std::endl;
-            pReply->deleteLater();
-
-            return -1;
+            reader.skipCurrentElement();
         }
+    }
 
-#ifdef _DEBUG
-        std::cout << m_ReplyData.constData() << std::endl;
-#endif
+    if (reader.hasError()) return StreamParseError;
 
-    }
-    else {
-        // 地震情報の取得に失敗した場合
-        std::cerr << QString("エラー : 地震情報の取得に失敗 %1").arg(pReply->errorString()).toStdString() << std::endl;
-        pReply->deleteLater();
+    // MaxInt要素が存在しない場合
+    if (!bMaxInt && !CheckMaxScale("")) return -1;
 
-        return -1;
+    /// 発生した地震情報の地域に対して、震度の大きさで降順にソート
+    if (m_Info.m_Points.count() > 1) {
+        std::sort(m_Info.m_Points.begin(), m_Info.m_Points.end(), sortPoints);
     }
 
-    pReply->deleteLater();
+    /// 発生した地震情報から最も震度の大きい都道府県を取得
+    m_Info.m_MaxIntPrefs     = GetMaxIntPrefs();
+
+    /// 地震の情報を表すコード
+    m_Info.m_Code            = 551;
 
     return 0;
 }
 
 
-// JMAから取得した地震情報のデータを取得する
-int Worker::DownloadContents(const QUrl &url)
+// 発生した地震情報のArea要素を解析する
+// City要素が存在する場合は市区町村ごと、存在しない場合はエリアの震度を取得する (震度はArea要素のMaxInt要素の値)
+void Worker::ReadInfoArea_Stream(QXmlStreamReader &reader, QList<POINT> &points)
 {
-    // レスポンス待機の設定
-    QEventLoop loop;
-    m_pEQManager = std::make_unique<QNetworkAccessManager>();
-    connect(m_pEQManager.get(), &QNetworkAccessManager::finished, &loop, &QEventLoop::quit);
-
-    // JMAへGETリクエストを送信
-    QNetworkRequest request(url);
-
-    // タイムアウトを3[秒]に設定
-    request.setTransferTimeout(3000);
-
-    auto pReply = m_pEQManager->get(request);
-
-    // レスポンス待機
-    loop.exec();
-
-    // レスポンスの確認
-    if (pReply->error() == QNetworkReply::NoError) {
-        // 正常に取得した場合
-        m_ReplyData = pReply->readAll();
-
-#ifdef _DEBUG
-        std::cout << m_ReplyData.constData() << std::endl;
-#endif
+    QString     areaName,
+                maxInt;
+    bool        bName   = false,
+                bMaxInt = false;
+    QStringList cityNames;
+
+    while (reader.readNextStartElement()) {
+        if (!bName && reader.qualifiedName() == QLatin1String("Name")) {
+            areaName = ReadElementText(reader);
+            bName    = true;
+        }
+        else if (!bMaxInt && reader.qualifiedName() == QLatin1String("MaxInt")) {
+            maxInt  = ReadElementText(reader);
+            bMaxInt = true;
+        }
+        else if (reader.qualifiedName() == QLatin1String("City")) {
+            // 市区町村名を取得する
+            QString cityName;
+            if (!GetElementText(reader, "Name", cityName)) cityName = "";
+            cityNames.append(cityName);
+        }
+        else {
+            reader.skipCurrentElement();
+        }
+    }
 
+    int scale = ConvertJMAScale<int>(maxInt);
+
+    if (!cityNames.isEmpty()) {
+        // City要素が存在する場合
+        for (const auto &cityName : cityNames) {
+            POINT point = {.Addr   = cityName,
+                .Pref   = "",
+                .Scale  = scale,
+                .IsArea = false
+            };
+            points.append(point);
+        }
     }
     else {
-        // 地震情報の取得に失敗した場合
-        std::cerr << QString("エラー : 地震情報の取得に失敗 %1").arg(pReply->errorString()).toStdString() << std::endl;
-        pReply->deleteLater();
-
-        return -1;
+        // City要素が存在しない場合
+        POINT point = {.Addr   = areaName,
+            .Pref   = "",
+            .Scale  = scale,
+            .IsArea = true
+        };
+        points.append(point);
     }
-
-    pReply->deleteLater();
-
-    return 0;
 }
 
 
-// P2P地震情報から緊急地震速報(警報)および発生した地震情報のデータを取得する
-int Worker::onEQDownloaded_for_P2P()
+// 発生した地震情報のComments要素を解析する
+// 各要素のcodeType属性が"固定付加文"の場合のみ取得する
+void Worker::ReadInfoComments_Stream(QXmlStreamReader &reader)
 {
-    // テストファイルを使用するかどうかの確認
-    if (!m_CommonData.TestFile.isEmpty()) {
-        // テストファイルを使用する場合
-        try {
-            // テストファイルを開く
-            QFile TestFile(m_CommonData.TestFile);
-            if (!TestFile.open(QIODevice::ReadOnly)) {
-                throw std::runtime_error(TestFile.errorString().toStdString());
-            }
-
-            // テストファイルの読み込み
-            m_ReplyData = TestFile.readAll();
-
-            // テストファイルを閉じる
-            TestFile.close();
+    bool bForecastComment = false,
+         bVarComment      = false,
+         bFreeFormComment = false;
 
-            // 取得した地震情報のURLにテストファイルのパスを指定
-            m_Alert.m_URL = m_CommonData.TestFile;
+    while (reader.readNextStartElement()) {
+        QString *pText = nullptr;
 
-            return 0;
+        if (!bForecastComment && reader.qualifiedName() == QLatin1String("ForecastComment")) {
+            bForecastComment = true;
+            pText            = &m_Info.m_Text;
         }
-        catch (const std::exception &e) {
-            std::cerr << QString("エラー: テスト用JSONファイルの読み込み中にエラーが発生しました: %1").arg(e.what()).toStdString() << std::endl;
-            return -1;
+        else if (!bVarComment && reader.qualifiedName() == QLatin1String("VarComment")) {
+            bVarComment = true;
+            pText       = &m_Info.m_VarComment;
+        }
+        else if (!bFreeFormComment && reader.qualifiedName() == QLatin1String("FreeFormComment")) {
+            bFreeFormComment = true;
+            pText            = &m_Info.m_FreeFormComment;
+        }
+
+        if (pText == nullptr || reader.attributes().value(QLatin1String("codeType")) != QString("固定付加文")) {
+            reader.skipCurrentElement();
+            continue;
         }
+
+        QString text;
+        if (GetElementText(reader, "Text", text)) *pText = text;
     }
+}
 
-    // レスポンス待機の設定
-    QEventLoop loop;
-    m_pEQManager = std::make_unique<QNetworkAccessManager>();
-    connect(m_pEQManager.get(), &QNetworkAccessManager::finished, &loop, &QEventLoop::quit);
 
-    // P2P地震情報へGETリクエストを送信
-    QUrl url(m_CommonData.EQInfoURL);
-    QNetworkRequest request(url);
+// Hypocenter要素内の最初のArea要素から、震源地 (Name要素) および緯度・経度・震源の深さ (jmx_eb:Coordinate要素) を取得する
+void Worker::ReadHypocenter_Stream(QXmlStreamReader &reader, QString &name, QString &coordinate)
+{
+    bool bArea       = false,
+         bName       = false,
+         bCoordinate = false;
+
+    while (reader.readNextStartElement()) {
+        if (bArea || reader.qualifiedName() != QLatin1String("Area")) {
+            reader.skipCurrentElement();
+            continue;
+        }
 
-    // タイムアウトを3[秒]に設定
-    request.setTransferTimeout(3000);
+        bArea = true;
 
-    auto pReply = m_pEQManager->get(request);
+        while (reader.readNextStartElement()) {
+            if (!bName && reader.qualifiedName() == QLatin1String("Name")) {
+                name  = ReadElementText(reader);
+                bName = true;
+            }
+            else if (!bCoordinate && reader.qualifiedName() == QLatin1String("jmx_eb:Coordinate")) {
+                coordinate  = ReadElementText(reader);
+                bCoordinate = true;
+            }
+            else {
+                reader.skipCurrentElement();
+            }
+        }
+    }
+}
 
-    // レスポンス待機
-    loop.exec();
 
-    // レスポンスの確認
-    if (pReply->error() == QNetworkReply::NoError) {
-        // 正常に取得した場合
-        m_ReplyData = pReply->readAll();
+// jmx_eb:Coordinate要素の値 (例: "+35.7+139.8-10000/") から、緯度・経度・震源の深さを取得する
+// 値の形式が異なる場合は、引数の値を変更しない
+void Worker::ParseCoordinate(QString coordinate, QString &latitude, QString &longitude, QString &depth)
+{
+    /// 文字列から '/' を削除
+    coordinate.remove('/');
 
-#ifdef _DEBUG
-        std::cout << m_ReplyData.constData() << std::endl;
-#endif
+    /// '+' と '-' で文字列を分割
+    static QRegularExpression RegEx("[+-]");
+    QStringList parts = coordinate.split(RegEx, Qt::SkipEmptyParts);
 
+    if (parts.size() == 3) {
+        latitude  = QString::number(parts[0].toDouble(), 'f', 1);
+        longitude = QString::number(parts[1].toDouble(), 'f', 1);
+        depth     = QString::number(static_cast<int>(parts[2].toDouble()) / 1000, 10);
     }
-    else {
-        // 地震情報の取得に失敗した場合
-        std::cerr << QString("エラー : 地震情報の取得に失敗 %1").arg(pReply->errorString()).toStdString() << std::endl;
-        pReply->deleteLater();
+}
 
-        return -1;
-    }
 
-    pReply->deleteLater();
+// 現在時刻と比較して、JMAの地震情報の報告時刻からの経過時間 [秒] を取得する
+qint64 Worker::GetElapsedSeconds(const QString &reportDateTime)
+{
+    /// まず、地震情報の報告時刻を変換
+    QDateTime issueTime     = QDateTime::fromString(reportDateTime, Qt::ISODate);
+    issueTime.setTimeZone(QTimeZone("Asia/Tokyo"));
+
+    /// 次に、現在時刻を取得
+    auto currentTime        = QDateTime::currentDateTime();
+    currentTime.setTimeZone(QTimeZone("Asia/Tokyo"));
 
-    return 0;
+    return static_cast<int>(issueTime.msecsTo(currentTime) / 1000);
 }
 
 
-// JMAから取得した地震情報を整形する
-int Worker::FormattingData_for_JMA(bool bAlert)
+// QDomDocumentクラスを使用して、JMAから取得した地震情報を整形する
+// ストリーム形式での解析に失敗した場合、または、ストリーム形式の解析が無効の場合に使用する
+int Worker::FormattingData_for_JMA_DOM(bool bAlert)
 {
     if (bAlert) {
         // 緊急地震速報(警報)の場合
@@ -1069,6 +3189,34 @@ bool Worker::GetElementText(const QDomElement &parent, const QString &tagName, Q
 }
 
 
+// 現在の要素の子要素のうち、指定した名前を持つ最初の要素の値を取得する
+// 現在の要素の終了タグまで読み進める
+bool Worker::GetElementText(QXmlStreamReader &reader, const QString &tagName, QString &result)
+{
+    bool bFound = false;
+
+    while (reader.readNextStartElement()) {
+        if (!bFound && reader.qualifiedName() == tagName) {
+            result = ReadElementText(reader);
+            bFound = true;
+        }
+        else {
+            reader.skipCurrentElement();
+        }
+    }
+
+    return bFound;
+}
+
+
+// 現在の要素の値を取得する (子要素の値も含む)
+// QDomElement::text()メソッドと同様に、子要素のテキストを連結した値を返す
+QString Worker::ReadElementText(QXmlStreamReader &reader)
+{
+    return reader.readElementText(QXmlStreamReader::IncludeChildElements);
+}
+
+
 // P2P地震情報から取得した地震情報を整形する
 int Worker::FormattingData_for_P2P()
 {
@@ -1117,7 +3265,11 @@ int Worker::FormattingData_for_P2P()
             /// 以前と同じ地震情報かどうかをログファイルに保存されている地震IDから確認
             /// 過去に同じIDの緊急地震速報(警報)を取得しているかどうか
             auto id = obj["id"].toString();
-            if (!SearchAlertEQID(id)) {
+            m_Deadline.beginStage(QStringLiteral("ログの確認"));
+            auto bNew = SearchAlertEQID(id);
+            m_Deadline.endStage(QStringLiteral("ログの確認"));
+
+            if (!bNew) {
                 /// ログファイルに同じ地震IDが存在する場合は無視する
                 continue;
             }
@@ -1609,159 +3761,236 @@ int Worker::FormattingThreadInfo()
 
 
 // Yahoo天気・災害の地震情報一覧にアクセスして、震度分布の画像を検索・追記する
-int Worker::AddEQInfoImage(EQIMAGEINFO &EQImageInfo)
+// 地震情報一覧および画像URLのレスポンスを順に受信して、結果をonAddedへ渡す
+void Worker::AddEQInfoImage(EQIMAGEINFO &EQImageInfo, const Callback &onAdded)
 {
-    Image EQImage(EQImageInfo);
+    if (m_bCancelled) {
+        onAdded(-1);
+        return;
+    }
+
+    // レスポンスの受信後に破棄する
+    auto pEQImage = new Image(EQImageInfo, this);
+    auto finish   = [pEQImage, onAdded](int ret) {
+        pEQImage->deleteLater();
+        onAdded(ret);
+    };
 
     // Yahoo天気・災害の地震情報一覧にアクセスして、該当する地震情報を取得
-    if (EQImage.FetchUrl(true, false)) {
-        // 該当する地震情報が存在しない、または、取得に失敗した場合
-        return -1;
-    }
+    pEQImage->FetchUrl(true, false, [this, pEQImage, &EQImageInfo, finish](int iRet) {
+        if (iRet || m_bCancelled) {
+            // 該当する地震情報が存在しない、または、取得に失敗した場合
+            finish(-1);
+            return;
+        }
 
-    // 地震分布の画像が存在するURLを生成
-    auto Url = EQImageInfo.BaseUrl + EQImage.GetUrl();
+        // 地震分布の画像が存在するURLを生成
+        auto Url = EQImageInfo.BaseUrl + pEQImage->GetUrl();
 
-    // 該当する地震情報のURLにアクセスして、震度分布の画像URLを取得
-    if (EQImage.FetchImageUrl(QUrl(Url), true, false)) {
-        // 画像URLの取得に失敗した場合
-        return -1;
-    }
+        // 該当する地震情報のURLにアクセスして、震度分布の画像URLを取得
+        pEQImage->FetchImageUrl(QUrl(Url), true, false, [this, pEQImage, Url, finish](int iRet) {
+            if (iRet) {
+                // 画像URLの取得に失敗した場合
+                finish(-1);
+                return;
+            }
 
-    m_Info.m_ImageSiteURL = Url;
-    m_Info.m_ImageURL     = EQImage.GetImageUrl();
+            m_Info.m_ImageSiteURL = Url;
+            m_Info.m_ImageURL     = pEQImage->GetImageUrl();
 
-    return 0;
+            finish(0);
+        });
+    });
 }
 
 
-int Worker::Post(int EQCode, bool bCreateThread)
+// スレッドを新規作成する、または、既存のスレッドに書き込む
+// クッキーの取得および書き込みのレスポンスを順に受信して、結果をonPostedへ渡す
+void Worker::Post(int EQCode, bool bCreateThread, const Callback &onPosted)
 {
-    Poster poster(nullptr);
+    // 処理がキャンセルされた場合は、リクエストを送信しない
+    if (m_bCancelled) {
+        onPosted(-1);
+        return;
+    }
 
     // 掲示板のクッキーを取得
-    if (poster.fetchCookies(QUrl(m_CommonData.RequestURL))) {
-        // クッキーの取得に失敗した場合
-        return -1;
+    // 有効期限内のクッキーを保持している場合 (バックグラウンドで取得済みの場合) は、再利用する
+    // 処理の期限が有効の場合、クッキーの取得および書き込みは残り時間以内に制限する
+    // 処理の期限が無効の場合も、掲示板が応答しない場合に処理が停止しないように、クッキーの取得はCookieTimeout[mS]以内に制限する
+
+    // 書き込みの準備 (バックグラウンドでのクッキーの取得) を開始している場合は、ここから完了を待機する
+    m_Deadline.joinStage(QStringLiteral("書き込みの準備"));
+
+    if (m_Deadline.hasExpired()) {
+        onPosted(-1);
+        return;
     }
 
-    // POSTデータの送信
-    if (bCreateThread) {
-        // スレッドを新規作成
-        // 緊急地震速報(警報)の場合、または、発生した地震情報において既存のスレッドが存在しない場合
-        if (poster.PostforCreateThread(QUrl(m_CommonData.RequestURL), m_ThreadInfo)) {
+    m_Deadline.beginStage(QStringLiteral("クッキーの取得"));
+    m_pPoster->PrepareCookies(QUrl(m_CommonData.RequestURL), m_Deadline.timeout(CookieTimeout), [this, EQCode, bCreateThread, onPosted](int ret) {
+        m_Deadline.endStage(QStringLiteral("クッキーの取得"));
+
+        // クッキーの取得に失敗した場合、または、期限切れの場合は、POSTデータを送信しない
+        if (ret || m_bCancelled || m_Deadline.hasExpired()) {
+            onPosted(-1);
+            return;
+        }
+
+        SendPost(EQCode, bCreateThread, onPosted);
+    });
+}
+
+
+// クッキーの取得後に、POSTデータを送信する
+void Worker::SendPost(int EQCode, bool bCreateThread, const Callback &onPosted)
+{
+    auto &poster = *m_pPoster;
+
+    // 書き込みのレスポンスを受信した場合
+    auto onReplied = [this, EQCode, bCreateThread, onPosted](int ret) {
+        m_Deadline.endStage(QStringLiteral("書き込み"));
+        RecordPostLatency();
+        Outbox::recordPost(BoardName());
+
+        if (ret) {
             // スレッドの新規作成に失敗した場合、または、スレッドの書き込みに失敗した場合
-            return -1;
+            onPosted(-1);
+            return;
         }
 
-        // 新規作成したスレッドのURLとスレッド番号を取得
-        auto threadURL = poster.GetNewThreadURL();
-        auto threadNum = poster.GetNewThreadNum();
+        if (bCreateThread) {
+            // 新規作成したスレッドのURLとスレッド番号は、POSTデータのレスポンスから取得済み
+            // スレッドのタイトルは、POSTデータで送信したタイトルを使用する (新規作成したスレッドにアクセスしない)
+            // 掲示板によりタイトルが変更される場合 (IDの付加等) は、書き込みの終了後にバックグラウンドで確認する
+            auto threadURL = m_pPoster->GetNewThreadURL();
+            auto threadNum = m_pPoster->GetNewThreadNum();
+
+            // 取得済みのスレッド一覧に新規作成したスレッドを追加して、次回の生存確認で落ちていると判断しないようにする
+            // (緊急地震速報(警報)、発生した地震情報、送信待ちの書き込みの再送のいずれも、このメソッドでスレッドを新規作成する)
+            ThreadCache::insert(QUrl(threadURL), m_ThreadInfo.subject);
 
-        // 新規作成したスレッドにアクセスしてタイトルを抽出
-        HtmlFetcher fetcher(nullptr);
-        if (fetcher.fetch(threadURL, true, m_CommonData.ExpiredXPath, m_ThreadInfo.shiftjis) == 0) {
-            // 新規作成したスレッドのタイトル抽出に成功した場合
             if (EQCode == 556) {
-                m_AlertLog.Title     = fetcher.GetElement();
+                m_AlertLog.Title     = m_ThreadInfo.subject;
                 m_AlertLog.ThreadURL = threadURL;
                 m_AlertLog.ThreadNum = threadNum;
             }
             else if (EQCode == 551) {
-                m_InfoLog.Title     = fetcher.GetElement();
+                m_InfoLog.Title     = m_ThreadInfo.subject;
                 m_InfoLog.ThreadURL = threadURL;
                 m_InfoLog.ThreadNum = threadNum;
             }
         }
 
+        onPosted(0);
+    };
+
+    // POSTデータの送信
+    m_Deadline.beginStage(QStringLiteral("書き込み"));
+
+    if (bCreateThread) {
+        // スレッドを新規作成
+        // 緊急地震速報(警報)の場合、または、発生した地震情報において既存のスレッドが存在しない場合
+        poster.PostforCreateThread(QUrl(m_CommonData.RequestURL), m_ThreadInfo, m_Deadline.timeout(0), onReplied);
     }
     else {
         // 既存のスレッドに書き込む
         // 発生した地震情報において既存のスレッドが存在する場合
-        if (poster.PostforWriteThread(QUrl(m_CommonData.RequestURL), m_ThreadInfo)) {
-            // スレッドの新規作成に失敗した場合、または、スレッドの書き込みに失敗した場合
-            return -1;
-        }
+        poster.PostforWriteThread(QUrl(m_CommonData.RequestURL), m_ThreadInfo, m_Deadline.timeout(0), onReplied);
     }
-
-    return 0;
 }
 
 
-// 緊急地震速報(警報)のログファイルから地震情報を検索する
-bool Worker::SearchAlertEQID(const QString &searchValue) const
+// 地震情報を検出してからPOSTデータを送信するまでの時間を記録する
+// クッキーの再利用および掲示板との接続の維持による効果を測定するため、POSTデータの送信を開始した時刻までの時間とする
+void Worker::RecordPostLatency()
 {
-    QFileInfo alertLogFileInfo(m_CommonData.LogFile);
-    QString   lockFilePath = alertLogFileInfo.dir().filePath(alertLogFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
+    // 送信待ちの書き込みの再送は、地震情報の検出時刻が存在しないため記録しない
+    if (m_bReplay) return;
 
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内に緊急地震速報のログファイルのロックの取得に失敗しました").toStdString() << std::endl;
-        return false;
-    }
+    auto latency = static_cast<qint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(m_pPoster->GetPostSentTime() - m_DetectedTime).count());
+    if (latency < 0) return;
 
-    // ロックの解除とファイルの削除を保証 (RAIIパターンを使用)
-    LockFileGuard guard(lockFile);
+    m_FeedStats.Posts++;
+    m_FeedStats.PostNsecs    += latency;
+    m_FeedStats.MaxPostNsecs  = std::max(m_FeedStats.MaxPostNsecs, latency);
 
-    try {
-        // 緊急地震速報のログファイルを読み込む
-        QFile alertLogFile(m_CommonData.LogFile);
-        if (!alertLogFile.open(QIODevice::ReadOnly)) {
-            throw std::runtime_error(QString("エラー : 緊急地震速報のログファイルのオープンに失敗しました %1").arg(alertLogFile.errorString()).toStdString());
-        }
+#ifdef _DEBUG
+    std::cout << QString("地震情報の検出から書き込みまでの時間 : %1 [mS]").arg(static_cast<double>(latency) / 1000000.0, 0, 'f', 1).toStdString() << std::endl;
+#endif
+}
 
-        QJsonDocument jsonDoc = QJsonDocument::fromJson(alertLogFile.readAll());
 
-        // 緊急地震速報のログファイルを閉じる
-        alertLogFile.close();
+// 地震情報を検出した時刻を起点として処理の期限を開始する
+// 期限は、地震情報ごとに設定ファイルの予算 (0の場合は無効) で開始する
+void Worker::StartDeadline()
+{
+    m_Deadline.start(m_DetectedTime, m_CommonData.DeadlineBudget);
+}
 
-        if (jsonDoc.isNull()) {
-            throw std::runtime_error("エラー: 緊急地震速報のログファイルが不正です");
-        }
 
-        QJsonArray jsonArray = jsonDoc.array();
-        for (const QJsonValue &value : jsonArray) {
-            QJsonObject obj = value.toObject();
-            if (m_CommonData.iGetInfo == 0) {
-                // JMAから緊急地震速報 (警報) を取得している場合
-                if (obj["url"].toString() == searchValue) {
-                    // 書き込み済みの緊急地震速報 (警報) のデータが存在する場合
-#ifdef _DEBUG
-                    std::cout << QString("同じ緊急地震速報(警報)が存在するため、この地震情報を無視します : %1").arg(searchValue).toStdString() << std::endl;
+// 各段階 (ログの確認、書き込みの準備、ダウンロード、解析、クッキーの取得、書き込み) が使用した処理の期限 (予算) を表示する
+// 書き込みの準備は、ダウンロードおよび解析と並行して実行できた時間も表示する
+// 処理の期限が無効の場合は、デバッグビルドのみ表示する
+void Worker::ReportDeadline(const QString &result)
+{
+#ifndef _DEBUG
+    if (!m_Deadline.isActive()) return;
 #endif
-                    return false;
-                }
-            }
-            else {
-                // P2P地震情報から緊急地震速報 (警報) を取得している場合
-                if (obj["id"].toString() == searchValue) {
-                    // 書き込み済みの緊急地震速報 (警報) のデータが存在する場合
+
+    // 複数の掲示板に書き込む場合は、掲示板の名前 (BBS名) を付加する
+    const auto board = m_CommonData.BoardName.isEmpty() ? QString("") : QString(" : %1").arg(m_CommonData.BoardName);
+
+    std::cout << QString("処理の期限 (%1%2) : %3").arg(result, board, m_Deadline.report()).toStdString() << std::endl;
+}
+
+
+// 処理の期限に制限したログファイルのロックの待機時間 [mS] を取得する
+// 処理の期限が無効の場合は、最大30[秒]待機する
+int Worker::GetLockTimeout() const
+{
+    return m_Deadline.timeout(LockTimeout);
+}
+
+
+// 緊急地震速報(警報)のログファイルから地震情報を検索する
+// ログファイルはメモリ上のインデックスを使用して検索するため、他のプロセスがログファイルを変更した場合のみ読み込む
+bool Worker::SearchAlertEQID(const QString &searchValue) const
+{
+    // JMAから緊急地震速報 (警報) を取得している場合はURL、P2P地震情報から取得している場合は地震IDを検索する
+    // ログファイルの読み込みが必要な場合、最大30秒 (処理の期限が有効の場合は残り時間) の間にロックの取得を試みる
+    // 複数の掲示板に書き込む場合は、いずれかの掲示板のログファイルに存在しない場合に新しい地震情報とする
+    int ret = 1;
+    for (const auto &logFile : QStringList{m_CommonData.LogFile} + m_BoardLogFiles) {
+        auto       pStore      = EventStore::open(logFile);
+        const auto lockTimeout = GetLockTimeout();
+        ret = (m_CommonData.iGetInfo == 0) ? pStore->containsURL(searchValue, lockTimeout)
+                                           : pStore->containsID(searchValue, lockTimeout);
+        if (ret != 1) break;
+    }
+
+    if (ret == -1) {
+        std::cerr << QString("エラー: 緊急地震速報(警報)のログファイルの検索に失敗しました").toStdString() << std::endl;
+        return false;
+    }
+    else if (ret == 1) {
+        // 書き込み済みの緊急地震速報 (警報) のデータが存在する場合
 #ifdef _DEBUG
-                    std::cout << QString("同じ地震IDが存在するため、この地震情報を無視します : %1").arg(searchValue).toStdString() << std::endl;
-#endif
-                    return false;
-                }
-            }
+        if (m_CommonData.iGetInfo == 0) {
+            std::cout << QString("同じ緊急地震速報(警報)が存在するため、この地震情報を無視します : %1").arg(searchValue).toStdString() << std::endl;
+        }
+        else {
+            std::cout << QString("同じ地震IDが存在するため、この地震情報を無視します : %1").arg(searchValue).toStdString() << std::endl;
         }
+#endif
+        return false;
+    }
 
 #ifdef _DEBUG
     std::cout << QString("同じ地震情報は存在しないため、緊急地震速報(警報)の取得を開始します").toStdString() << std::endl;
     std::cout << QString("地震ID または テストファイルのパス : %1").arg(searchValue).toStdString() << std::endl;
 #endif
 
-    }
-    catch (const std::exception &ex) {
-        std::cerr << QString("エラー: %1").arg(ex.what()).toStdString() << std::endl;
-        return false;
-    }
-    catch (...) {
-        std::cerr << QString("エラー: 予期しないエラーが発生しました (緊急地震速報 (警報))").toStdString() << std::endl;
-        return false;
-    }
-
-    // guardのデストラクタが呼ばれてロックが解除される
-    // 可能であればロックファイルが削除される
     return true;
 }
 
@@ -1769,52 +3998,19 @@ bool Worker::SearchAlertEQID(const QString &searchValue) const
 // 発生した地震情報のログファイルから地震IDを検索する
 bool Worker::SearchInfoEQID(const QString &ID) const
 {
-    QFileInfo infoLogFileInfo(m_CommonData.LogFile);
-    QString   lockFilePath = infoLogFileInfo.dir().filePath(infoLogFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
-
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内にログファイルのロックの取得に失敗しました").toStdString() << std::endl;
-        return false;
-    }
-
-    // ロックの解除とファイルの削除を保証 (RAIIパターンを使用)
-    LockFileGuard guard(lockFile);
-
-    // ログファイルを読み込む
-    QFile File(m_CommonData.LogFile);
-    if (!File.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        std::cerr << QString("エラー : 地震情報のログファイルのオープンに失敗しました %1").arg(File.errorString()).toStdString() << std::endl;
-        return false;
-    }
-
-    QJsonParseError parseError;
-    const auto document = QJsonDocument::fromJson(File.readAll(), &parseError);
-    if (parseError.error != QJsonParseError::NoError) {
-        if (File.isOpen()) File.close();
-        std::cerr << QString("エラー: 地震情報のログファイルの読み込みに失敗しました %1").arg(parseError.errorString()).toStdString() << std::endl;
-
-        return false;
+    // ログファイルの読み込みが必要な場合、最大30秒 (処理の期限が有効の場合は残り時間) の間にロックの取得を試みる
+    // 複数の掲示板に書き込む場合は、いずれかの掲示板のログファイルに存在しない場合に新しい地震情報とする
+    int ret = 1;
+    for (const auto &logFile : QStringList{m_CommonData.LogFile} + m_BoardLogFiles) {
+        ret = EventStore::open(logFile)->containsID(ID, GetLockTimeout());
+        if (ret != 1) break;
     }
 
-    // ファイルを閉じる
-    File.close();
-
-    if (!document.isArray()) {
-        std::cerr << QString("エラー : 地震情報のログファイルの値が不正です").toStdString() << std::endl;
+    if (ret == -1) {
+        std::cerr << QString("エラー : 地震情報のログファイルの検索に失敗しました").toStdString() << std::endl;
         return false;
     }
-
-    const auto jsonArray = document.array();
-    const bool idExists = std::any_of(jsonArray.begin(), jsonArray.end(), [&ID](const auto &value) {
-        const auto idArray = value.toObject()["id"].toArray();
-        return std::any_of(idArray.begin(), idArray.end(), [&ID](const auto &idValue) {
-            return idValue.toString().compare(ID, Qt::CaseSensitive) == 0;
-        });
-    });
-
-    if (idExists) {
+    else if (ret == 1) {
 #ifdef _DEBUG
         std::cout << QString("同じ地震IDが存在するため、この地震情報を無視します : %1").arg(ID).toStdString() << std::endl;
 #endif
@@ -1825,8 +4021,6 @@ bool Worker::SearchInfoEQID(const QString &ID) const
     std::cout << QString("同じ地震IDは存在しないため、地震情報の取得を開始します : %1").arg(ID).toStdString() << std::endl;
 #endif
 
-    // guardのデストラクタが呼ばれてロックが解除される
-    // 可能であればロックファイルが削除される
     return true;
 }
 
@@ -1834,63 +4028,29 @@ bool Worker::SearchInfoEQID(const QString &ID) const
 // 地震情報のログファイルから同じ地震IDの"ReportDateTime"キーの日時が存在するかどうかを確認する
 bool Worker::SearchInfoEQID(const QString &ID, const QString &reportDateTime) const
 {
-    QFileInfo infoLogFileInfo(m_CommonData.LogFile);
-    QString   lockFilePath = infoLogFileInfo.dir().filePath(infoLogFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
-
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内にログファイルのロックの取得に失敗しました").toStdString() << std::endl;
-        return false;
-    }
-
-    // ロックの解除とファイルの削除を保証 (RAIIパターンを使用)
-    LockFileGuard guard(lockFile);
-
-    // ログファイルを読み込む
-    QFile File(m_CommonData.LogFile);
-    if (!File.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        std::cerr << QString("エラー : 地震情報のログファイルのオープンに失敗しました %1").arg(File.errorString()).toStdString() << std::endl;
-        return false;
-    }
-
-    QJsonParseError parseError;
-    const auto document = QJsonDocument::fromJson(File.readAll(), &parseError);
-    if (parseError.error != QJsonParseError::NoError) {
-        std::cerr << QString("エラー : 地震情報のログファイルの読み込みに失敗しました %1").arg(parseError.errorString()).toStdString() << std::endl;
-        return false;
+    // ログファイルの読み込みが必要な場合、最大30秒 (処理の期限が有効の場合は残り時間) の間にロックの取得を試みる
+    // 複数の掲示板に書き込む場合は、いずれかの掲示板のログファイルに存在しない場合に新しい地震情報とする
+    int ret = 1;
+    for (const auto &logFile : QStringList{m_CommonData.LogFile} + m_BoardLogFiles) {
+        ret = EventStore::open(logFile)->containsReport(ID, reportDateTime, GetLockTimeout());
+        if (ret != 1) break;
     }
 
-    if (!document.isArray()) {
-        std::cerr << QString("エラー : 地震情報のログファイルの値が不正です").toStdString() << std::endl;
+    if (ret == -1) {
+        std::cerr << QString("エラー : 地震情報のログファイルの検索に失敗しました").toStdString() << std::endl;
         return false;
     }
-
-    const auto jsonArray = document.array();
-    for (const auto &value : jsonArray) {
-        const auto obj = value.toObject();
-        const auto idArray = obj["id"].toArray();
-
-        if (std::any_of(idArray.begin(), idArray.end(), [&ID](const auto &idValue) {
-                return idValue.toString().compare(ID, Qt::CaseSensitive) == 0;
-            })) {
-            const auto dateTime = obj["reportdatetime"].toString();
-
-            if (dateTime == reportDateTime) {
+    else if (ret == 1) {
 #ifdef _DEBUG
-                std::cerr << QString("同じ地震IDに同じ\"reportdatetime\"キーの値が存在するため、この地震情報を無視します: %1").arg(ID).toStdString();
+        std::cerr << QString("同じ地震IDに同じ\"reportdatetime\"キーの値が存在するため、この地震情報を無視します: %1").arg(ID).toStdString();
 #endif
-                return false;
-            }
-        }
+        return false;
     }
 
 #ifdef _DEBUG
     std::cout << QString("同じ地震IDは存在しないため、地震情報の取得を開始します : %1").arg(ID).toStdString() << std::endl;
 #endif
 
-    // guardのデストラクタが呼ばれてロックが解除される
-    // 可能であればロックファイルが削除される
     return true;
 }
 
@@ -1898,111 +4058,61 @@ bool Worker::SearchInfoEQID(const QString &ID, const QString &reportDateTime) co
 // 地震情報のログファイルから同じ震源地のオブジェクトを取得する
 bool Worker::GetExistObject(const QString &hypo)
 {
-    // 地震情報のログファイルを開く
-    QFile File(m_CommonData.LogFile);
-    if (!File.open(QIODevice::ReadOnly)) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
+    QJsonObject obj;
+    const auto  ret = EventStore::open(m_CommonData.LogFile)->findByHypocentre(hypo, obj, LockTimeout);
+    if (ret == -1) {
+        std::cerr << QString("エラー : 発生した地震情報のログファイルの読み込みに失敗").toStdString() << std::endl;
+        return false;
+    }
+    else if (ret == 0) {
         return false;
     }
 
-    try {
-        // 地震情報のログファイルを読み込む
-        auto document = QJsonDocument::fromJson(File.readAll());
-
-        // ファイルを閉じる
-        File.close();
-
-        // 地震情報のログファイルから同じ震源地のオブジェクトが存在するかどうかを検索する
-        auto jsonArray = document.array();
-        for (const auto &value : jsonArray) {
-            auto obj    = value.toObject();
-            auto hypocentre = obj["hypocentre"].toString();
-
-            // 同じ震源地かどうかを確認
-            if (hypocentre.compare(hypo, Qt::CaseSensitive) == 0) {
-                // 同じ震源地が存在する場合
-                auto idArray = obj["id"].toArray();
-                for(const auto &id : idArray) {
-                    if(id.isString()) {
-                        m_InfoLog.IDs.append(id.toString());
-                    }
-                }
-                m_InfoLog.Hypocenter  = obj["hypocentre"].toString();
-                m_InfoLog.Title       = obj["title"].toString();
-                m_InfoLog.ThreadURL   = obj["url"].toString();
-                m_InfoLog.ThreadNum   = obj["thread"].toString();
-                m_InfoLog.Date        = obj["date"].toString();
-
-                return true;
-            }
+    // 同じ震源地が存在する場合
+    auto idArray = obj["id"].toArray();
+    for (const auto &id : idArray) {
+        if (id.isString()) {
+            m_InfoLog.IDs.append(id.toString());
         }
     }
-    catch (QException &ex) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルの読み込みに失敗").toStdString() << std::endl;
-        if (File.isOpen()) File.close();
-    }
+    m_InfoLog.Hypocenter  = obj["hypocentre"].toString();
+    m_InfoLog.Title       = obj["title"].toString();
+    m_InfoLog.ThreadURL   = obj["url"].toString();
+    m_InfoLog.ThreadNum   = obj["thread"].toString();
+    m_InfoLog.Date        = obj["date"].toString();
 
-    return false;
+    return true;
 }
 
 
 // 地震情報のログファイルから最も震度の大きい都道府県名のオブジェクトを取得する
 bool Worker::GetExistObject()
 {
-    // 地震情報のログファイルを開く
-    QFile File(m_CommonData.LogFile);
-    if (!File.open(QIODevice::ReadOnly)) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
+    QJsonObject obj;
+    const auto  ret = EventStore::open(m_CommonData.LogFile)->findByPrefs(m_Info.m_MaxIntPrefs, obj, LockTimeout);
+    if (ret == -1) {
+        std::cerr << QString("エラー : 発生した地震情報のログファイルの読み込みに失敗").toStdString() << std::endl;
+        return false;
+    }
+    else if (ret == 0) {
         return false;
     }
 
-    try {
-        // 地震情報のログファイルを読み込む
-        auto document = QJsonDocument::fromJson(File.readAll());
-
-        // ファイルを閉じる
-        File.close();
-
-        // 地震情報のログファイルから同じ都道府県のオブジェクトが存在するかどうかを検索する
-        auto jsonArray = document.array();
-        for (const auto &value : jsonArray) {
-            auto obj    = value.toObject();
-
-            // ログファイルから最も震度の大きい都道府県名を取得
-            auto        prefs           = obj["prefs"].toString("");
-            QStringList LogMaxIntPrefs  = {};
-            if (!prefs.isEmpty()) {
-                LogMaxIntPrefs = prefs.split(",");
-
-                for (auto &MaxIntPref : m_Info.m_MaxIntPrefs) {
-                    // 同じ都道府県かどうかを確認
-                    if (LogMaxIntPrefs.contains(MaxIntPref)) {
-                        // 同じ都道府県が存在する場合
-                        auto idArray = obj["id"].toArray();
-                        for (const auto &id : idArray) {
-                            if (id.isString()) {
-                                m_InfoLog.IDs.append(id.toString());
-                            }
-                        }
-                        m_InfoLog.Hypocenter  = obj["hypocentre"].toString();
-                        m_InfoLog.MaxIntPrefs = obj["prefs"].toString("").split(",");
-                        m_InfoLog.Title       = obj["title"].toString();
-                        m_InfoLog.ThreadURL   = obj["url"].toString();
-                        m_InfoLog.ThreadNum   = obj["thread"].toString();
-                        m_InfoLog.Date        = obj["date"].toString();
-
-                        return true;
-                    }
-                }
-            }
+    // 同じ都道府県が存在する場合
+    auto idArray = obj["id"].toArray();
+    for (const auto &id : idArray) {
+        if (id.isString()) {
+            m_InfoLog.IDs.append(id.toString());
         }
     }
-    catch (QException &ex) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルの読み込みに失敗").toStdString() << std::endl;
-        if (File.isOpen()) File.close();
-    }
+    m_InfoLog.Hypocenter  = obj["hypocentre"].toString();
+    m_InfoLog.MaxIntPrefs = obj["prefs"].toString("").split(",");
+    m_InfoLog.Title       = obj["title"].toString();
+    m_InfoLog.ThreadURL   = obj["url"].toString();
+    m_InfoLog.ThreadNum   = obj["thread"].toString();
+    m_InfoLog.Date        = obj["date"].toString();
 
-    return false;
+    return true;
 }
 
 
@@ -2111,48 +4221,99 @@ T Worker::ConvertJMAScale(const QString &strScale)
 //}
 
 
-// 過去に作成したスレッドが生存しているかどうかを確認する
-// HTMLの<head>タグ内の<title>タグを確認することにより判断する
-bool Worker::isExistThread(const QUrl &url, const QString &title)
+// スレッドのタイトルを取得して、結果およびタイトルをonFetchedへ渡す
+// "expiredxpath"キーがデフォルト (<title>タグ) の場合は、掲示板のスレッド一覧 (subject.txt) のキャッシュから取得する
+// スレッド一覧が使用できない場合、または、bUseCacheがfalseの場合は、スレッドのHTMLから<title>タグをXPathを使用して抽出する
+// 0  : スレッドのタイトルを取得した場合
+// 1  : スレッドが生存していない(落ちている)場合
+// -1 : スレッドのタイトルの取得に失敗した場合
+void Worker::FetchThreadTitle(const QUrl &url, bool bUseCache, const TitleCallback &onFetched)
 {
-    // 過去に作成したスレッドから<title>タグをXPathを使用して抽出する
-    HtmlFetcher fetcher(this);
-    auto iRet = fetcher.fetch(url, true, m_CommonData.ExpiredXPath, m_ThreadInfo.shiftjis);
-    if (iRet == -1) {
-        // <title>タグの取得に失敗した場合
-        std::cerr << QString("エラー : スレッドの生存確認に失敗\n新規スレッドを作成します").toStdString() << std::endl;
-        return false;
-    }
-    else if (iRet == 1) {
-        // スレッドが生存していない(落ちている)場合
-        std::cout << QString("スレッドが落ちているため、新規スレッドを作成します").toStdString() << std::endl;
-        return false;
+    if (m_bCancelled) {
+        onFetched(-1, QString());
+        return;
     }
 
-    // ログファイルに保存しているスレッドタイトルと同じスレッドタイトルか存在するかどうかを確認する
-    // これは、スレッドが生存していない場合でもHTTPレスポンスが200(成功)を返す可能性があるためである
-    auto ExistThread = fetcher.GetElement();
+    if (bUseCache && m_CommonData.ExpiredXPath == QStringLiteral("/html/head/title")) {
+        ThreadCache::lookup(url, m_ThreadInfo.shiftjis, this, [this, url, onFetched](int iRet, const QString &title) {
+            if (iRet == 1)      onFetched(0, title);
+            else if (iRet == 0) onFetched(1, QString());
+            else                FetchThreadHtmlTitle(url, onFetched);
+        });
 
-    /// 末尾の半角スペースを削除
-    /// (現在は使用しない)
-    //if (ExistThread.endsWith(" ")) ExistThread.chop(1);
+        return;
+    }
 
-    /// 正規表現を定義（スペースを含む [ と ] の間に任意の文字列があるパターン）
-    /// 0ch掲示板の設定でスレッドタイトルにIDが付加される場合がある
-    /// そのため、そのIDを除去したスレッドのタイトルを抽出する
-    /// (現在は使用しない)
-    //static const QRegularExpression RegEx(" \\[.*\\]$");
+    FetchThreadHtmlTitle(url, onFetched);
+}
 
-    /// 文字列からパターンに一致する部分を削除
-    /// (現在は使用しない)
-    //ExistThread = ExistThread.remove(RegEx);
 
-    if (ExistThread.compare(title, Qt::CaseSensitive) == 0) {
-        // 既存のスレッドが生存している場合
-        return true;
+// スレッドのHTMLからタイトルを取得する
+// 掲示板が応答しない場合に処理が停止しないように、処理の期限 (無効の場合は地震情報の取得と同じタイムアウト) 以内に制限する
+void Worker::FetchThreadHtmlTitle(const QUrl &url, const TitleCallback &onFetched)
+{
+    if (m_bCancelled) {
+        onFetched(-1, QString());
+        return;
     }
 
-    return false;
+    // レスポンスの受信後に破棄する
+    auto pFetcher = new HtmlFetcher(this);
+    pFetcher->fetch(url, true, m_CommonData.ExpiredXPath, m_ThreadInfo.shiftjis, m_Deadline.timeout(RequestTimeout), [pFetcher, onFetched](int iRet) {
+        pFetcher->deleteLater();
+        onFetched(iRet, iRet == 0 ? pFetcher->GetElement() : QString());
+    });
+}
+
+
+// 過去に作成したスレッドが生存しているかどうかを確認する
+// HTMLの<head>タグ内の<title>タグ (または、スレッド一覧のタイトル) を確認することにより判断する
+void Worker::isExistThread(const QUrl &url, const QString &title, const Callback &onChecked)
+{
+    // 過去に作成したスレッドのタイトルを取得する
+    FetchThreadTitle(url, true, [this, url, title, onChecked](int iRet, const QString &ExistThread) {
+        if (iRet == -1) {
+            // <title>タグの取得に失敗した場合
+            std::cerr << QString("エラー : スレッドの生存確認に失敗\n新規スレッドを作成します").toStdString() << std::endl;
+            onChecked(0);
+            return;
+        }
+        else if (iRet == 1) {
+            // スレッドが生存していない(落ちている)場合
+            std::cout << QString("スレッドが落ちているため、新規スレッドを作成します").toStdString() << std::endl;
+            onChecked(0);
+            return;
+        }
+
+        // ログファイルに保存しているスレッドタイトルと同じスレッドタイトルか存在するかどうかを確認する
+        // これは、スレッドが生存していない場合でもHTTPレスポンスが200(成功)を返す可能性があるためである
+
+        /// 末尾の半角スペースを削除
+        /// (現在は使用しない)
+        //if (ExistThread.endsWith(" ")) ExistThread.chop(1);
+
+        /// 正規表現を定義（スペースを含む [ と ] の間に任意の文字列があるパターン）
+        /// 0ch掲示板の設定でスレッドタイトルにIDが付加される場合がある
+        /// そのため、そのIDを除去したスレッドのタイトルを抽出する
+        /// (現在は使用しない)
+        //static const QRegularExpression RegEx(" \\[.*\\]$");
+
+        /// 文字列からパターンに一致する部分を削除
+        /// (現在は使用しない)
+        //ExistThread = ExistThread.remove(RegEx);
+
+        if (ExistThread.compare(title, Qt::CaseSensitive) == 0) {
+            // 既存のスレッドが生存している場合
+            onChecked(1);
+            return;
+        }
+
+        // スレッド一覧のタイトルと<title>タグのタイトルは、掲示板の設定により異なる場合がある (IDの付加等)
+        // そのため、一致しない場合のみスレッドのHTMLから<title>タグを取得して再確認する
+        FetchThreadTitle(url, false, [title, onChecked](int iRet, const QString &ExistThread) {
+            onChecked((iRet == 0 && ExistThread.compare(title, Qt::CaseSensitive) == 0) ? 1 : 0);
+        });
+    });
 }
 
 
@@ -2161,209 +4322,219 @@ bool Worker::isExistThread(const QUrl &url, const QString &title)
 // 0  : スレッドのタイトルが正常に変更された場合
 // 1  : !chttコマンドが失敗している場合
 // -1 : スレッドのタイトルの取得に失敗した場合
-int Worker::CompareThreadTitle(const QUrl &url, const QString &title)
+void Worker::CompareThreadTitle(const QUrl &url, const QString &title, const Callback &onCompared)
 {
-    // 過去に作成したスレッドから<title>タグをXPathを使用して抽出する
-    HtmlFetcher fetcher(this);
-    if (fetcher.fetch(url, true, m_CommonData.ExpiredXPath, m_ThreadInfo.shiftjis)) {
-        // <title>タグの取得に失敗した場合
-        return -1;
-    }
+    // 書き込み前に取得したスレッド一覧には変更後のタイトルが記載されていないため、破棄して再取得する
+    ThreadCache::invalidate(url);
+
+    // 過去に作成したスレッドのタイトルを取得する
+    FetchThreadTitle(url, true, [this, title, onCompared](int iRet, const QString &ThreadTitle) {
+        if (iRet) {
+            // タイトルの取得に失敗した場合
+            onCompared(-1);
+            return;
+        }
 
-    // ログファイルに保存しているスレッドタイトルと同じスレッドタイトルか存在するかどうかを確認する
-    // これは、スレッドが生存していない場合でもHTTPレスポンスが200(成功)を返す可能性があるためである
-    auto ThreadTitle = fetcher.GetElement();
+        // ログファイルに保存しているスレッドタイトルと同じスレッドタイトルか存在するかどうかを確認する
+        // これは、スレッドが生存していない場合でもHTTPレスポンスが200(成功)を返す可能性があるためである
 
-    /// 末尾の半角スペースを削除
-    /// (現在は使用しない)
-    //if (ThreadTitle.endsWith(" ")) ThreadTitle.chop(1);
+        /// 末尾の半角スペースを削除
+        /// (現在は使用しない)
+        //if (ThreadTitle.endsWith(" ")) ThreadTitle.chop(1);
 
-    /// 正規表現を定義（スペースを含む [ と ] の間に任意の文字列があるパターン）
-    /// (現在は使用しない)
-    //static const QRegularExpression RegEx(" \\[.*\\]$");
+        /// 正規表現を定義（スペースを含む [ と ] の間に任意の文字列があるパターン）
+        /// (現在は使用しない)
+        //static const QRegularExpression RegEx(" \\[.*\\]$");
 
-    /// 文字列からパターンに一致する部分を削除
-    /// (現在は使用しない)
-    //ThreadTitle = ThreadTitle.remove(RegEx);
+        /// 文字列からパターンに一致する部分を削除
+        /// (現在は使用しない)
+        //ThreadTitle = ThreadTitle.remove(RegEx);
+
+        if (ThreadTitle.compare(title, Qt::CaseSensitive) == 0) {
+            // スレッドのタイトルが変更されていない場合
+            // !chttコマンドが失敗している場合
+            onCompared(1);
+            return;
+        }
 
-    if (ThreadTitle.compare(title, Qt::CaseSensitive) == 0) {
-        // スレッドのタイトルが変更されていない場合
-        // !chttコマンドが失敗している場合
-        return 1;
-    }
-    else {
         // スレッドのタイトルが変更されている場合は、抽出したスレッドのタイトルを使用する
         // この抽出したタイトル名は、ログファイルの各JSONオブジェクトにある"title"キーへ保存する
         m_ThreadInfo.subject = ThreadTitle;
-    }
 
-    return 0;
+        onCompared(0);
+    });
 }
 
 
-// 書き込むスレッドのレス数が上限に達しているかどうかを確認
-int Worker::CheckLastThreadNum()
+// スレッドのURLからdatファイルのURLを取得する
+// スレッドのURLの形式 : <スキーム>://<ホスト名>/<ディレクトリ名>/test/read.cgi/<BBS名>/<スレッド番号>/
+// datファイルのURLの形式 : <スキーム>://<ホスト名>/<ディレクトリ名>/<BBS名>/dat/<スレッド番号>.dat
+// スレッドのURLの形式が異なる場合は、空のURLを返す
+QUrl Worker::DatURL(const QString &threadURL)
 {
-    HtmlFetcher fetcher(this);
-    if (fetcher.fetchLastThreadNum(QUrl(m_InfoLog.ThreadURL), false, m_CommonData.ThreadNumXPath, XML_TEXT_NODE)) {
-        /// 最後尾のレス番号の取得に失敗した場合
-        return -1;
-    }
-    auto element = fetcher.GetElement();
+    static const QRegularExpression RegEx("^(.*)/test/read\\.cgi/([^/]+)/(\\d+)");
 
-    bool ok;
-    auto max = element.toInt(&ok);
-    if (!ok) {
-        return -1;
-    }
+    QUrl url(threadURL);
+    auto match = RegEx.match(url.path());
+    if (!match.hasMatch()) return {};
 
-    // スレッドのレス数が上限に達したかどうかを確認
-    if (max >= m_CommonData.MaxThreadNum) {
-        // 上限に達している場合
-        return 1;
-    }
+    url.setPath(QString("%1/%2/dat/%3.dat").arg(match.captured(1), match.captured(2), match.captured(3)));
+    url.setQuery(QString());
+    url.setFragment(QString());
 
-    return 0;
+    return url;
 }
 
 
-// ログファイルから生存していないスレッド情報を削除する
-int Worker::DeleteObject(const QString &hypo) const
+// 書き込むスレッドのレス数が上限に近いかどうかを確認
+// datファイルのうち、前回の取得以降に追加された部分のみを取得して、行数 (レス数) を数える
+// 最大レス数に達する前 (ReplyMargin以内) に新規スレッドを作成するため、上限に近い場合は1を返す
+// 1  : 上限に近い場合
+// 0  : 上限に達していない場合 (または、レス数を確認しない場合)
+// -1 : レス数の取得に失敗した場合
+void Worker::CheckLastThreadNum(const Callback &onChecked)
 {
-    // ログファイルを開く
-    QFile File(m_CommonData.LogFile);
-    if (!File.open(QIODevice::ReadOnly)) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
-        return -1;
+    if (m_CommonData.MaxThreadNum <= 0) {
+        onChecked(0);
+        return;
     }
 
-    // ログファイルの読み込み
-    QJsonDocument document;
-    try {
-        document = QJsonDocument::fromJson(File.readAll());
-        File.close();
+    if (m_bCancelled) {
+        onChecked(-1);
+        return;
     }
-    catch (QException &ex) {
-        std::cerr << QString("エラー : 地震情報のログファイルの読み込みに失敗しました %1").arg(ex.what()).toStdString() << std::endl;
-        if (File.isOpen()) File.close();
 
-        return -1;
-    }
+    auto datURL = DatURL(m_InfoLog.ThreadURL);
+    if (datURL.isEmpty()) {
+        // datファイルのURLが不明の場合は、スレッドのHTMLから最後尾のレス番号を取得する
+        if (m_CommonData.ThreadNumXPath.isEmpty()) {
+            onChecked(-1);
+            return;
+        }
 
-    if (!document.isArray()) {
-        std::cerr << QString("エラー : 地震情報のログファイルの値が不正です").toStdString() << std::endl;
-        return -1;
-    }
+        // レスポンスの受信後に破棄する
+        auto pFetcher = new HtmlFetcher(this);
+        pFetcher->fetchLastThreadNum(QUrl(m_InfoLog.ThreadURL), false, m_CommonData.ThreadNumXPath, XML_TEXT_NODE, m_Deadline.timeout(RequestTimeout),
+                                     [this, pFetcher, onChecked](int iRet) {
+            pFetcher->deleteLater();
 
-    QJsonArray jsonInArray = document.array();
-    QJsonArray jsonOutArray = {};
+            if (iRet) {
+                /// 最後尾のレス番号の取得に失敗した場合
+                onChecked(-1);
+                return;
+            }
+            auto element = pFetcher->GetElement();
 
-    // 生存していないスレッド情報を削除
-    for (const auto &value : jsonInArray) {
-        auto obj = value.toObject();
-        if (obj["hypocentre"].toString().compare(hypo, Qt::CaseSensitive) != 0) {
-            jsonOutArray.append(obj);
-        }
-    }
+            bool ok;
+            auto replies = element.toInt(&ok);
+            if (!ok) {
+                onChecked(-1);
+                return;
+            }
 
-    QJsonDocument outputDoc(jsonOutArray);
+            onChecked(CheckReplyLimit(replies));
+        });
 
-    // ログファイルを開く
-    if (!File.open(QIODevice::WriteOnly)) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
-        return -1;
+        return;
     }
 
-    // ログファイルの更新
-    try {
-        File.write(outputDoc.toJson());
-        File.close();
-    }
-    catch (QException &ex) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルの更新に失敗").toStdString() << std::endl;
-        if (File.isOpen()) File.close();
+    // 前回の末尾の1バイト (改行) から取得して、datファイルが書き換えられていないかどうかを確認する
+    // 書き換えられた場合 (あぼーん等)、または、datファイルが短くなった場合は、全体を取得し直す
+    const auto threadURL = m_InfoLog.ThreadURL;
+    const auto offset    = m_DatStates.value(threadURL).Offset;
+
+    auto pFetcher = new HtmlFetcher(this);
+    pFetcher->fetchDat(datURL, offset > 0 ? offset - 1 : 0, m_Deadline.timeout(RequestTimeout), [this, pFetcher, datURL, threadURL, onChecked](int iRet, const QByteArray &data) {
+        if ((iRet == 0 && !data.startsWith('\n')) || iRet == 2) {
+            if (m_bCancelled) {
+                pFetcher->deleteLater();
+                onChecked(-1);
+                return;
+            }
 
-        return -1;
-    }
+            m_DatStates[threadURL] = DATSTATE();
+            pFetcher->fetchDat(datURL, 0, m_Deadline.timeout(RequestTimeout), [this, pFetcher, threadURL, onChecked](int iRet, const QByteArray &data) {
+                pFetcher->deleteLater();
 
-    return 0;
+                auto replies = CountDatReplies(threadURL, iRet, data);
+                onChecked(replies < 0 ? -1 : CheckReplyLimit(replies));
+            });
+
+            return;
+        }
+
+        pFetcher->deleteLater();
+
+        auto replies = CountDatReplies(threadURL, iRet, data);
+        onChecked(replies < 0 ? -1 : CheckReplyLimit(replies));
+    });
 }
 
 
-// ログファイルから生存していないスレッド情報を削除する
-int Worker::DeleteObject(const QStringList &prefs) const
+// 取得したdatファイルの行数 (レス数) を数えて、スレッドのdatファイルの取得位置を更新する
+// 取得に失敗した場合は-1を返す
+int Worker::CountDatReplies(const QString &threadURL, int iRet, const QByteArray &data)
 {
-    // ログファイルを開く
-    QFile File(m_CommonData.LogFile);
-    if (!File.open(QIODevice::ReadOnly)) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
+    if (iRet == -1) {
+        // datファイルの取得に失敗した場合
+        m_DatStates.remove(threadURL);
         return -1;
     }
 
-    // ログファイルの読み込み
-    QJsonDocument document;
-    try {
-        document = QJsonDocument::fromJson(File.readAll());
-        File.close();
-    }
-    catch (QException &ex) {
-        std::cerr << QString("エラー : 地震情報のログファイルの読み込みに失敗しました %1").arg(ex.what()).toStdString() << std::endl;
-        if (File.isOpen()) File.close();
+    auto &state = m_DatStates[threadURL];
 
-        return -1;
+    // 書き込み途中の行 (末尾に改行が無い行) は、次回に数える
+    const auto complete = data.lastIndexOf('\n') + 1;
+    if (iRet == 0) {
+        // 追加された部分のみを取得した場合 (先頭の1バイトは前回の末尾の改行)
+        state.Offset  += complete - 1;
+        state.Replies += static_cast<int>(data.left(complete).count('\n')) - 1;
     }
-
-    if (!document.isArray()) {
-        std::cerr << QString("エラー : 地震情報のログファイルの値が不正です").toStdString() << std::endl;
-        return -1;
+    else {
+        // 全体を取得した場合
+        state.Offset   = complete;
+        state.Replies  = static_cast<int>(data.left(complete).count('\n'));
     }
 
-    QJsonArray jsonInArray = document.array();
-    QJsonArray jsonOutArray = {};
+    return state.Replies;
+}
 
-    // 生存していないスレッド情報を削除
-    for (const auto &value : jsonInArray) {
-        auto obj = value.toObject();
 
-        // ログファイルから最も震度の大きい都道府県名を取得
-        auto        strPrefs           = obj["prefs"].toString("");
-        QStringList LogMaxIntPrefs  = {};
-        if (!strPrefs.isEmpty()) {
-            LogMaxIntPrefs = strPrefs.split(",");
-
-            bool bExist = false;
-            for (auto &LogMaxIntPref : LogMaxIntPrefs) {
-                // 同じ都道府県かどうかを確認
-                if (prefs.contains(LogMaxIntPref)) {
-                    bExist = true;
-                    break;
-                }
-            }
+// スレッドのレス数が上限に近いかどうかを確認
+// 1  : 上限に近い場合
+// 0  : 上限に達していない場合
+int Worker::CheckReplyLimit(int replies)
+{
+    if (replies + ReplyMargin >= m_CommonData.MaxThreadNum) {
+        // 上限に近い場合
+        std::cout << QString("スレッドのレス数が上限に近いため (%1 レス)、新規スレッドを作成します").arg(replies).toStdString() << std::endl;
+        m_DatStates.remove(m_InfoLog.ThreadURL);
 
-            if (!bExist) jsonOutArray.append(obj);
-        }
-        else {
-            jsonOutArray.append(obj);
-        }
+        return 1;
     }
 
-    QJsonDocument outputDoc(jsonOutArray);
+    return 0;
+}
+
 
-    // ログファイルを開く
-    if (!File.open(QIODevice::WriteOnly)) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
+// ログファイルから生存していないスレッド情報を削除する
+int Worker::DeleteObject(const QString &hypo) const
+{
+    if (EventStore::open(m_CommonData.LogFile)->removeByHypocentre(hypo, LockTimeout)) {
+        std::cerr << QString("エラー : 発生した地震情報のログファイルの更新に失敗").toStdString() << std::endl;
         return -1;
     }
 
-    // ログファイルの更新
-    try {
-        File.write(outputDoc.toJson());
-        File.close();
-    }
-    catch (QException &ex) {
-        std::cerr << QString("エラー : 発生した地震情報のログファイルの更新に失敗").toStdString() << std::endl;
-        if (File.isOpen()) File.close();
+    return 0;
+}
+
 
+// ログファイルから生存していないスレッド情報を削除する
+// 最も震度の大きい都道府県のいずれかが一致するオブジェクトを削除する
+int Worker::DeleteObject(const QStringList &prefs) const
+{
+    if (EventStore::open(m_CommonData.LogFile)->removeByPrefs(prefs, LockTimeout)) {
+        std::cerr << QString("エラー : 発生した地震情報のログファイルの更新に失敗").toStdString() << std::endl;
         return -1;
     }
 
@@ -2544,6 +4715,7 @@ EarthQuakeAlert::EarthQuakeAlert(const EarthQuakeAlert &obj) noexcept
     // 共通のデータ
     this->m_Code        = obj.m_Code;
     this->m_ID          = obj.m_ID;
+    this->m_Headline    = obj.m_Headline;
     this->m_Name        = obj.m_Name;
     this->m_Depth       = obj.m_Depth;
     this->m_Magnitude   = obj.m_Magnitude;
@@ -2551,9 +4723,14 @@ EarthQuakeAlert::EarthQuakeAlert(const EarthQuakeAlert &obj) noexcept
     this->m_Longitude   = obj.m_Longitude;
 
     // 緊急地震速報(警報)のデータ
-    this->m_OriginTime   = obj.m_OriginTime;
-    this->m_ArrivalTime  = obj.m_ArrivalTime;
-    this->m_Areas        = obj.m_Areas;
+    this->m_OriginTime      = obj.m_OriginTime;
+    this->m_ArrivalTime     = obj.m_ArrivalTime;
+    this->m_ReportDateTime  = obj.m_ReportDateTime;
+    this->m_Areas           = obj.m_Areas;
+    this->m_Text            = obj.m_Text;
+    this->m_VarComment      = obj.m_VarComment;
+    this->m_FreeFormComment = obj.m_FreeFormComment;
+    this->m_URL             = obj.m_URL;
 }
 
 
@@ -2566,6 +4743,7 @@ EarthQuakeAlert& EarthQuakeAlert::operator=(const EarthQuakeAlert &obj)
         // 緊急地震速報(警報)のデータ
         this->m_Code            = obj.m_Code;
         this->m_ID              = obj.m_ID;
+        this->m_Headline        = obj.m_Headline;
         this->m_Name            = obj.m_Name;
         this->m_Depth           = obj.m_Depth;
         this->m_Magnitude       = obj.m_Magnitude;
@@ -2573,7 +4751,12 @@ EarthQuakeAlert& EarthQuakeAlert::operator=(const EarthQuakeAlert &obj)
         this->m_Longitude       = obj.m_Longitude;
         this->m_OriginTime      = obj.m_OriginTime;
         this->m_ArrivalTime     = obj.m_ArrivalTime;
+        this->m_ReportDateTime  = obj.m_ReportDateTime;
         this->m_Areas           = obj.m_Areas;
+        this->m_Text            = obj.m_Text;
+        this->m_VarComment      = obj.m_VarComment;
+        this->m_FreeFormComment = obj.m_FreeFormComment;
+        this->m_URL             = obj.m_URL;
     }
 
     // このオブジェクトの参照を返す
@@ -2582,74 +4765,27 @@ EarthQuakeAlert& EarthQuakeAlert::operator=(const EarthQuakeAlert &obj)
 
 
 // 緊急地震速報(警報)のログファイルに地震情報を追加する
+// メモリ上のインデックスにも追加するため、以降の検索ではログファイルを読み込まない
 int EarthQuakeAlert::AddLog(const QString &fileName, ALERTLOG &alertLog)
 {
-    QFileInfo alertLogFileInfo(fileName);
-    QString   lockFilePath = alertLogFileInfo.dir().filePath(alertLogFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
+    // 新しい地震オブジェクトを作成
+    QJsonObject newObj;
+    newObj["id"]             = m_ID;                // 地震ID
+    newObj["reportdatetime"] = m_ReportDateTime;    // 緊急地震速報の報告時刻
+    newObj["url"]            = m_URL;               // 緊急地震速報(警報)のURL
+    newObj["threadtitle"]    = alertLog.Title;      // スレッドのタイトル
+    newObj["threadkey"]      = alertLog.ThreadNum;  // スレッドのキー
+    newObj["threadurl"]      = alertLog.ThreadURL;  // スレッドのURL
+
+    // 書き込めなかった場合は、書き込みの結果を付加する
+    if (!alertLog.Result.isEmpty()) newObj["result"] = alertLog.Result;
 
     // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内にログファイルのロックの取得に失敗しました").toStdString() << std::endl;
-        return -1;
-    }
-
-    // ロックの解除とファイルの削除を保証 (RAIIパターンを使用)
-    LockFileGuard guard(lockFile);
-
-    // 緊急地震速報(警報)の情報を追加
-    try {
-        // 緊急地震速報(警報)のログファイルを開く
-        QFile File(fileName);
-        if (!File.open(QIODevice::ReadWrite)) {
-            throw QString("エラー : 緊急地震速報(警報)のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString();
-        }
-
-        // 緊急地震速報(警報)のログファイルを読み込む
-        QByteArray jsonData = File.readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(jsonData);
-
-        if (!doc.isArray()) {
-            throw std::runtime_error("緊急地震速報(警報)のログファイルがJSON配列ではありません");
-        }
-
-        QJsonArray jsonArray = doc.array();
-
-        // 新しい地震オブジェクトを作成
-        QJsonObject newObj;
-        newObj["id"]             = m_ID;                // 地震ID
-        newObj["reportdatetime"] = m_ReportDateTime;    // 緊急地震速報の報告時刻
-        newObj["url"]            = m_URL;               // 緊急地震速報(警報)のURL
-        newObj["threadtitle"]    = alertLog.Title;      // スレッドのタイトル
-        newObj["threadkey"]      = alertLog.ThreadNum;  // スレッドのキー
-        newObj["threadurl"]      = alertLog.ThreadURL;  // スレッドのURL
-
-        // 新しいオブジェクトをJSONデータに追加
-        jsonArray.append(newObj);
-        doc.setArray(jsonArray);
-
-        // 更新したJSONデータを緊急地震速報(警報)のログファイルに書き込む
-        File.seek(0);    // ファイルの先頭に移動
-        File.resize(0);  // ファイルをクリア
-
-        if (File.write(doc.toJson()) == -1) {
-            throw std::runtime_error("緊急地震速報(警報)のログファイルの書き込みに失敗しました");
-        }
-
-        // ファイルを閉じる
-        File.close();
-    }
-    catch (const std::runtime_error &ex) {
-        std::cerr << QString("エラー : 緊急地震速報(警報)のログファイルの更新に失敗しました %1").arg(ex.what()).toStdString() << std::endl;
-        return -1;
-    }
-    catch (const std::exception &ex) {
-        std::cerr << QString("エラー : 予期せぬエラーが発生しました %1").arg(ex.what()).toStdString() << std::endl;
+    if (EventStore::open(fileName)->append(newObj, 30000)) {
+        std::cerr << QString("エラー : 緊急地震速報(警報)のログファイルの更新に失敗しました").toStdString() << std::endl;
         return -1;
     }
 
-    // guardのデストラクタが呼ばれてロックが解除される
-    // 可能であればロックファイルが削除される
     return 0;
 }
 
@@ -2682,6 +4818,7 @@ EarthQuakeInfo::EarthQuakeInfo(const EarthQuakeInfo &obj) noexcept
     // 共通のデータ
     this->m_Code        = obj.m_Code;
     this->m_ID          = obj.m_ID;
+    this->m_Headline    = obj.m_Headline;
     this->m_Name        = obj.m_Name;
     this->m_Depth       = obj.m_Depth;
     this->m_Magnitude   = obj.m_Magnitude;
@@ -2694,6 +4831,13 @@ EarthQuakeInfo::EarthQuakeInfo(const EarthQuakeInfo &obj) noexcept
     this->m_DomesticTsunami = obj.m_DomesticTsunami;
     this->m_ForeignTsunami  = obj.m_ForeignTsunami;
     this->m_Points          = obj.m_Points;
+    this->m_Text            = obj.m_Text;
+    this->m_VarComment      = obj.m_VarComment;
+    this->m_FreeFormComment = obj.m_FreeFormComment;
+    this->m_ReportDateTime  = obj.m_ReportDateTime;
+    this->m_ImageSiteURL    = obj.m_ImageSiteURL;
+    this->m_ImageURL        = obj.m_ImageURL;
+    this->m_MaxIntPrefs     = obj.m_MaxIntPrefs;
 }
 
 
@@ -2706,6 +4850,7 @@ EarthQuakeInfo& EarthQuakeInfo::operator=(const EarthQuakeInfo &obj)
         // 発生した地震情報のデータ
         this->m_Code            = obj.m_Code;
         this->m_ID              = obj.m_ID;
+        this->m_Headline        = obj.m_Headline;
         this->m_Name            = obj.m_Name;
         this->m_Depth           = obj.m_Depth;
         this->m_Magnitude       = obj.m_Magnitude;
@@ -2716,6 +4861,13 @@ EarthQuakeInfo& EarthQuakeInfo::operator=(const EarthQuakeInfo &obj)
         this->m_DomesticTsunami = obj.m_DomesticTsunami;
         this->m_ForeignTsunami  = obj.m_ForeignTsunami;
         this->m_Points          = obj.m_Points;
+        this->m_Text            = obj.m_Text;
+        this->m_VarComment      = obj.m_VarComment;
+        this->m_FreeFormComment = obj.m_FreeFormComment;
+        this->m_ReportDateTime  = obj.m_ReportDateTime;
+        this->m_ImageSiteURL    = obj.m_ImageSiteURL;
+        this->m_ImageURL        = obj.m_ImageURL;
+        this->m_MaxIntPrefs     = obj.m_MaxIntPrefs;
     }
 
     // このオブジェクトの参照を返す
@@ -2726,75 +4878,23 @@ EarthQuakeInfo& EarthQuakeInfo::operator=(const EarthQuakeInfo &obj)
 // 発生した地震情報のログファイルに地震情報を追加する
 int EarthQuakeInfo::AddInfo(const QString &fileName, const QString &title, const QString &url, const QString &thread, int GetInfo)
 {
-    QFileInfo alertLogFileInfo(fileName);
-    QString   lockFilePath = alertLogFileInfo.dir().filePath(alertLogFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
+    // 新しいJSONオブジェクトを作成する
+    QJsonObject newObject;
+    newObject["id"]         = QJsonArray({m_ID});       // 発生した地震情報の地震ID
+    newObject["hypocentre"] = m_Name;                   // 発生した地震情報の震源地
+    newObject["prefs"]      = m_MaxIntPrefs.join(",");  // 発生した地震情報の最も震度の大きい都道府県
+    newObject["title"]      = title;                    // 新規作成したスレッドのタイトル
+    newObject["url"]        = url;                      // 新規作成したスレッドのURL
+    newObject["thread"]     = thread;                   // 新規作成したスレッド番号
+    newObject["date"]       = m_Time;                   // 発生した地震情報の日時
+    newObject["reportdatetime"] = m_ReportDateTime;     // 地震情報の報告日時 (JMA専用)
 
     // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内にログファイルのロックの取得に失敗しました").toStdString() << std::endl;
-        return -1;
-    }
-
-    // ロックの解除とファイルの削除を保証 (RAIIパターンを使用)
-    LockFileGuard guard(lockFile);
-
-    // 地震情報の更新
-    QFile File(fileName);
-    if (!File.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        std::cerr << QString("エラー : 地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
-        return -1;
-    }
-
-    try {
-        // ログファイルの読み込み
-        auto byaryJson = File.readAll();
-        File.close();
-
-        // qEQAlert.jsonファイルの設定を取得
-        auto JsonDocument = QJsonDocument::fromJson(byaryJson);
-        if (!JsonDocument.isArray()) {
-            JsonDocument.array() = QJsonArray();
-        }
-        auto jsonArray = JsonDocument.array();
-
-        // 新しいJSONオブジェクトを作成する
-        QJsonObject newObject;
-        newObject["id"]         = QJsonArray({m_ID});       // 発生した地震情報の地震ID
-        newObject["hypocentre"] = m_Name;                   // 発生した地震情報の震源地
-        newObject["prefs"]      = m_MaxIntPrefs.join(",");  // 発生した地震情報の最も震度の大きい都道府県
-        newObject["title"]      = title;                    // 新規作成したスレッドのタイトル
-        newObject["url"]        = url;                      // 新規作成したスレッドのURL
-        newObject["thread"]     = thread;                   // 新規作成したスレッド番号
-        newObject["date"]       = m_Time;                   // 発生した地震情報の日時
-        newObject["reportdatetime"] = m_ReportDateTime;     // 地震情報の報告日時 (JMA専用)
-
-        // 新しいオブジェクトを配列に追加する
-        jsonArray.append(newObject);
-
-        // 更新されたJSON配列をファイルに書き込む
-        JsonDocument.setArray(jsonArray);
-
-        if (!File.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            std::cerr << QString("エラー : 地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
-            return -1;
-        }
-
-        // ログファイルへ書き込み
-        File.write(JsonDocument.toJson());
-
-        // ログファイルを閉じる
-        File.close();
-    }
-    catch (QException &ex) {
-        std::cerr << QString("エラー : 地震情報の追加に失敗 %1").arg(ex.what()).toStdString() << std::endl;
-        if (File.isOpen()) File.close();
-
+    if (EventStore::open(fileName)->append(newObject, 30000)) {
+        std::cerr << QString("エラー : 地震情報の追加に失敗").toStdString() << std::endl;
         return -1;
     }
 
-    // guardのデストラクタが呼ばれてロックが解除される
-    // 可能であればロックファイルが削除される
     return 0;
 }
 
@@ -2804,137 +4904,68 @@ int EarthQuakeInfo::AddInfo(const QString &fileName, const QString &title, const
 // !chttコマンドを使用しない場合 : 発生日時、地震IDを更新
 int EarthQuakeInfo::UpdateInfo(const QString &fileName, bool bChangeTitle, const QString &title, int GetInfo)
 {
-    QFileInfo infoLogFileInfo(fileName);
-    QString   lockFilePath = infoLogFileInfo.dir().filePath(infoLogFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
+    auto pStore = EventStore::open(fileName);
 
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内に緊急地震速報のログファイルのロックの取得に失敗しました").toStdString() << std::endl;
-        return -1;
-    }
+#if (QEQALERT_VERSION_MAJOR == 0 && QEQALERT_VERSION_MINOR == 1 && QEQALERT_VERSION_PATCH <= 2)
+    // 震源地("hypocentre"キーの値)が存在するかどうかを確認する
+    // 同じ震源地の場合は、ログファイルの該当オブジェクト("id"キー、"date"キー)を更新する
+    auto ret = pStore->updateByHypocentre(m_Name, [this](QJsonObject &obj) {
+        // 地震発生日時("date"キー)を更新
+        obj["date"] = m_Time;
+
+        // 地震ID("id"キー配列)を追加
+        QJsonArray idArray = obj["id"].toArray();
+        idArray.append(m_ID);
+        obj["id"] = idArray;
+    }, 30000);
+#else
+    // 最も震度の大きい都道府県のいずれかが同じオブジェクトを更新する
+    auto ret = pStore->updateByPrefs(m_MaxIntPrefs, [this, bChangeTitle, &title, GetInfo](QJsonObject &obj) {
+        // スレッドタイトル名を更新
+        if (bChangeTitle) obj["title"] = title;
 
-    // ロックの解除とファイルの削除を保証 (RAIIパターンを使用)
-    LockFileGuard guard(lockFile);
+        // 震源地("hypocentre"キー)を更新
+        obj["hypocentre"] = m_Name;
 
-    // 発生した地震情報のログファイルを更新
-    QFile File(fileName);
-    if (!File.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        std::cerr << QString("エラー : 地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
-        return -1;
-    }
+        // 発生した地震情報の最も震度の大きい都道府県群("prefs"キー)を更新
+        obj["prefs"]      = m_MaxIntPrefs.join(",");
 
-    try {
-        // ログファイルの読み込み
-        auto byaryJson = File.readAll();
-        File.close();
-
-        // qEQAlert.jsonファイルの設定を取得
-        auto JsonDocument = QJsonDocument::fromJson(byaryJson);
-        if (JsonDocument.isNull()) {
-            std::cerr << QString("エラー : 地震情報のログファイルに異常があります").toStdString() << std::endl;
-            return -1;
-        }
+        // 地震発生日時("date"キー)を更新
+        obj["date"]       = m_Time;
 
-        auto jsonArray = JsonDocument.array();
-        for (auto &&i : jsonArray) {
-            QJsonObject obj = i.toObject();
+        // JMA (気象庁) からデータを取得する場合、地震情報の報告日時("reportdatetime"キー)を更新
+        if (GetInfo == 0) {
+            obj["reportdatetime"] = m_ReportDateTime;
+        }
 
-#if (QEQALERT_VERSION_MAJOR == 0 && QEQALERT_VERSION_MINOR == 1 && QEQALERT_VERSION_PATCH <= 2)
-            // 震源地("hypocentre"キーの値)が存在するかどうかを確認する
-            // 同じ震源地の場合は、ログファイルの該当オブジェクト("id"キー、"date"キー)を更新する
-            if (obj["hypocentre"].toString() == m_Name) {
-                // 地震発生日時("date"キー)を更新
-                obj["date"] = m_Time;
-
-                // 地震ID("id"キー配列)を追加
-                QJsonArray idArray = obj["id"].toArray();
-                idArray.append(m_ID);
-                obj["id"] = idArray;
+        // JMAからデータを取得する場合、同じ地震ID("id"キー配列)が存在するかどうかを確認して、存在しなければ追加
+        // P2P地震情報からデータを取得する場合、地震ID("id"キー配列)を追加
+        if (GetInfo == 0) {
+            QJsonArray idArray = obj["id"].toArray();
 
-                // 更新されたオブジェクトを配列に戻す
-                i = obj;
+            QStringList ids = {};
+            for (const auto &value : idArray) {
+                if (value.isString()) ids.append(value.toString());
             }
-#else
-            // ログファイルから最も震度の大きい都道府県名を取得
-            auto        prefs           = obj["prefs"].toString("");
-            QStringList LogMaxIntPrefs  = {};
-            if (!prefs.isEmpty()) {
-                LogMaxIntPrefs = prefs.split(",");
-
-                for (auto &LogMaxIntPref : LogMaxIntPrefs) {
-                    // 同じ都道府県かどうかを確認
-                    if (m_MaxIntPrefs.contains(LogMaxIntPref)) {
-                        // 同じ都道府県が存在する場合
-                        // スレッドタイトル名を更新
-                        if (bChangeTitle) obj["title"] = title;
-
-                        // 震源地("hypocentre"キー)を更新
-                        obj["hypocentre"] = m_Name;
-
-                        // 発生した地震情報の最も震度の大きい都道府県群("prefs"キー)を更新
-                        obj["prefs"]      = m_MaxIntPrefs.join(",");
-
-                        // 地震発生日時("date"キー)を更新
-                        obj["date"]       = m_Time;
-
-                        // JMA (気象庁) からデータを取得する場合、地震情報の報告日時("reportdatetime"キー)を更新
-                        if (GetInfo == 0) {
-                            obj["reportdatetime"] = m_ReportDateTime;
-                        }
-
-                        // JMAからデータを取得する場合、同じ地震ID("id"キー配列)が存在するかどうかを確認して、存在しなければ追加
-                        // P2P地震情報からデータを取得する場合、地震ID("id"キー配列)を追加
-                        if (GetInfo == 0) {
-                            QJsonArray idArray = obj["id"].toArray();
-
-                            QStringList ids = {};
-                            for (const auto &value : idArray) {
-                                if (value.isString()) ids.append(value.toString());
-                            }
 
-                            if (!ids.contains(m_ID)) {
-                                idArray.append(m_ID);
-                                obj["id"] = idArray;
-                            }
-                        }
-                        else if (GetInfo == 1) {
-                            QJsonArray idArray = obj["id"].toArray();
-                            idArray.append(m_ID);
-                            obj["id"] = idArray;
-                        }
-
-                        // 更新されたオブジェクトを配列に戻す
-                        i = obj;
-                    }
-                }
+            if (!ids.contains(m_ID)) {
+                idArray.append(m_ID);
+                obj["id"] = idArray;
             }
-#endif
         }
-
-        // 更新したJSONオブジェクトの配列をセット
-        JsonDocument.setArray(jsonArray);
-
-        if (!File.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            std::cerr << QString("エラー : 地震情報のログファイルのオープンに失敗 %1").arg(File.errorString()).toStdString() << std::endl;
-            return -1;
+        else if (GetInfo == 1) {
+            QJsonArray idArray = obj["id"].toArray();
+            idArray.append(m_ID);
+            obj["id"] = idArray;
         }
+    }, 30000);
+#endif
 
-        // 更新したJSONオブジェクトの配列をログファイルに書き込む
-        File.write(JsonDocument.toJson());
-
-        // ログファイルを閉じる
-        File.close();
-    }
-    catch (QException &ex) {
-        std::cerr << QString("エラー : 地震情報の更新に失敗 %1").arg(ex.what()).toStdString() << std::endl;
-        if (File.isOpen()) File.close();
-
+    if (ret != 0) {
+        std::cerr << QString("エラー : 地震情報の更新に失敗").toStdString() << std::endl;
         return -1;
     }
 
-    // guardのデストラクタが呼ばれてロックが解除される
-    // 可能であればロックファイルが削除される
     return 0;
 }
 
@@ -13,9 +13,23 @@
 #include <QTextStream>
 #include <QObject>
 #include <QException>
+#include <QDateTime>
+#include <QXmlStreamReader>
+#include <QSet>
+#include <QQueue>
+#include <QPointer>
+#include <QThread>
+#include <QMutex>
+#include <QTimer>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <vector>
 #include "Image.h"
 #include "Poster.h"
+#include "Deadline.h"
+#include "FeedFetcher.h"
+#include "Outbox.h"
 
 
 // 緊急地震速報(警報)のログファイル
@@ -26,6 +40,7 @@ struct ALERTLOG {
                 ThreadNum,      // スレッド番号
                 ReportDateTime, // 緊急地震速報(警報)の報告時刻
                 Url;            // 緊急地震速報(警報)のURL
+    QString     Result;         // 書き込みの結果 (空の場合は書き込み済み、"expired" : 期限切れのため書き込めなかった)
 };
 
 
@@ -192,6 +207,7 @@ struct COMMONDATA {
     int             iGetInfo;       // 地震情報を取得するWebサイト
                                     // 0 : JMA (気象庁)
                                     // 1 : P2P地震情報
+                                    // P2P地震情報のWebSocket APIから受信する場合も、データの形式が同じであるため1を指定する
     int             AlertScale,     // 設定ファイルにある緊急地震速報(警報)の震度の閾値
                     InfoScale;      // 設定ファイルにある発生した地震情報の震度の閾値
     QString         EQInfoURL,      // JMAまたはP2P地震情報のURL
@@ -202,8 +218,26 @@ struct COMMONDATA {
     QString         ExpiredXPath,   // スレッドの生存を判断するときに使用するXPath
                                     // デフォルトは、"/html/head/title"タグを取得する
                     ThreadNumXPath; // スレッドの最後尾のレス番号を取得するXPath
-    int             MaxThreadNum;   // スレッドの最大書き込み数
+    int             MaxThreadNum;   // スレッドの最大書き込み数 (0の場合はレス数を確認しない)
     QString         TestFile;       // テストファイルを使用する場合のファイルのパス (XMLまたはJSON)
+    bool            bStreamParser;  // JMAのXMLをストリーム形式 (QXmlStreamReader) で解析するかどうか
+                                    // falseの場合、または、ストリーム形式での解析に失敗した場合は、DOM形式 (QDomDocument) で解析する
+    int             DeadlineBudget; // 地震情報を検出してから書き込みを完了するまでの期限 (予算) [mS]
+                                    // 0の場合は期限を設けない (緊急地震速報(警報)のみ使用する)
+    QString         BoardName;      // 処理の期限の表示に付加する掲示板の名前 (BBS名)
+                                    // 1つの掲示板のみに書き込む場合は空
+};
+
+
+// 地震情報を書き込む掲示板の設定
+// 設定ファイルの"thread"キーを配列にした場合は、配列の要素 (掲示板) ごとに作成する
+struct BOARDCONFIG {
+    QString         RequestURL;             // POSTデータを送信する掲示板のURL
+    THREAD_INFO     ThreadInfo;             // 名前欄、メール欄、BBS名、Shift-JISの有効 / 無効
+    QString         AlertFile,              // 緊急地震速報(警報)のログファイルのパス
+                    InfoFile;               // 発生した地震情報のログファイルのパス
+    bool            bChangeTitle = false;   // 発生した地震情報のスレッドのタイトルを変更するかどうか (!chttコマンド)
+    int             MaxReplies   = 1000;    // スレッドの最大レス数 (0の場合はレス数を確認しない)
 };
 
 
@@ -219,13 +253,102 @@ struct INFOLOG {
 };
 
 
+// 条件付きGETリクエスト (If-None-Match / If-Modified-Since) に使用する検証子
+struct FEEDVALIDATOR {
+    QByteArray      ETag,           // 前回のレスポンスにあるETagヘッダの値
+                    LastModified;   // 前回のレスポンスにあるLast-Modifiedヘッダの値
+    quint64         Version = 0;    // 取得を共有している場合、前回処理したレスポンスの番号 (同じ番号の場合は更新されていない)
+};
+
+
+// 条件付きGETリクエストおよびXMLの解析の統計
+struct FEEDSTATS {
+    qint64          NotModified  = 0,   // 304 (Not Modified) のレスポンス数 (ダウンロードおよびパースを省略した回数)
+                    Modified     = 0;   // 200 (OK) のレスポンス数
+    qint64          StreamParsed = 0,   // ストリーム形式 (QXmlStreamReader) で解析したXMLの数
+                    DomParsed    = 0,   // DOM形式 (QDomDocument) で解析したXMLの数
+                    Fallbacks    = 0,   // ストリーム形式での解析に失敗して、DOM形式で再解析した回数
+                    StreamNsecs  = 0,   // ストリーム形式での解析に要した時間の合計 [nS]
+                    DomNsecs     = 0;   // DOM形式での解析に要した時間の合計 [nS]
+    qint64          Posts        = 0,   // 送信したPOSTデータの数
+                    PostNsecs    = 0,   // 地震情報を検出してからPOSTデータを送信するまでの時間の合計 [nS]
+                    MaxPostNsecs = 0,   // 地震情報を検出してからPOSTデータを送信するまでの時間の最大値 [nS]
+                    CookieReuses = 0,   // 保持しているクッキーを再利用した回数
+                    CookieFetches = 0,  // クッキーを取得した回数 (バックグラウンドでの取得を含む)
+                    DeadlineMisses = 0; // 期限切れにより書き込みを中止した回数
+};
+
+
+// JMAのAtomフィードの処理位置 (カーソル)
+struct FEEDCURSOR {
+    QDateTime       Updated;        // 処理済みのエントリにおける最新の<updated>タグの日時
+    QSet<QString>   IDs;            // 上記の日時と同じ日時を持つ処理済みのエントリの<id>タグの値
+                                    // 同じ日時のエントリが複数存在する場合に、未処理のエントリを判別するために使用する
+};
+
+
+// スレッドのdatファイルの取得位置
+// 前回の取得以降に追加された部分のみを取得して、レス数を数えるために使用する
+struct DATSTATE {
+    qint64          Offset  = 0;    // 取得済みのdatファイルのサイズ [Byte] (次回はこの位置以降のみを取得する)
+    int             Replies = 0;    // 取得済みのレス数 (datファイルの行数)
+};
+
+
+// タイトルの確認待ちの新規作成したスレッド
+// ログファイルには送信したタイトルを保存して、書き込みの終了後に実際のタイトルを確認する
+struct PENDINGTITLE {
+    QString         ThreadURL,      // 新規作成したスレッドのURL
+                    Title,          // POSTデータで送信したスレッドのタイトル (ログファイルに保存したタイトル)
+                    Hypocenter;     // ログファイルのオブジェクトを検索するための震源地 (version 0.1.2以前)
+    QStringList     MaxIntPrefs;    // ログファイルのオブジェクトを検索するための最も震度の大きい都道府県
+};
+
+
+// JMAのAtomフィードから取得した地震情報のエントリ
+struct FEEDENTRY {
+    QString         ID;             // <id>タグの値 (地震情報のURL)
+    QDateTime       Updated;        // <updated>タグの日時
+};
+
+
+// 他の掲示板へ配信する地震情報
+// 地震情報の取得および解析は先頭の掲示板のオブジェクトのみで行い、整形した地震情報を他の掲示板のオブジェクトへ配信する
+struct BOARDEVENT {
+    quint64                                 Sequence = 0;   // 配信した地震情報の通し番号 (書き込みの結果を照合するために使用する)
+    bool                                    bAlert   = false;   // 地震情報の種類 (true : 緊急地震速報(警報)、false : 発生した地震情報)
+    EarthQuakeAlert                         Alert;          // 整形した緊急地震速報(警報)のデータ
+    EarthQuakeInfo                          Info;           // 整形した発生した地震情報のデータ
+    THREAD_INFO                             ThreadInfo;     // 整形したスレッドのタイトルおよび本文 (名前欄、BBS名等は配信先の掲示板の値を使用する)
+    std::chrono::steady_clock::time_point   DetectedTime;   // 地震情報を検出した時刻 (処理の期限の起点)
+};
+
+
+// 他の掲示板へ配信した地震情報の書き込みの状態
+// 他の掲示板の書き込みの終了を待機しないため、配信した地震情報ごとに書き込みの結果の通知を集計する
+struct BOARDDISPATCH {
+    FEEDENTRY                               Entry;          // 配信した地震情報のエントリ (JMAのみ、再試行時に処理位置を戻すために使用する)
+    int                                     Pending = 0;    // 書き込みの結果が通知されていない掲示板の数
+    std::chrono::steady_clock::time_point   Dispatched;     // 配信した時刻
+};
+
+
 // 地震情報とスレッド情報を管理するクラス
 class Worker : public QObject
 {
     Q_OBJECT
 
+    // JMAのXMLの解析 (ストリーム形式およびDOM形式) を直接計測するベンチマーク (Benchmarks/JmaParserBenchmark.cpp)
+    friend class JmaParserBenchmark;
+
+private:    // Types
+    // 非同期の処理 (書き込み、スレッドの確認等) の終了時に呼び出す継続処理
+    // 処理は入れ子のイベントループを使用せずに、各レスポンスのfinishedシグナルから次の段階へ進む
+    using Callback      = std::function<void(int)>;                     // 処理結果を渡す
+    using TitleCallback = std::function<void(int, const QString&)>;     // 処理結果およびスレッドのタイトルを渡す
+
 private:    // Variables
-    std::unique_ptr<QNetworkAccessManager>  m_pEQManager;       // 緊急地震速報(警報)および発生した地震情報と通信するネットワークオブジェクト
+    std::unique_ptr<Poster>                 m_pPoster;          // 掲示板に書き込むオブジェクト (接続を再利用するため、書き込みごとに生成しない)
     QByteArray                              m_ReplyData;        // 緊急地震速報(警報)のデータおよび発生した地震情報のデータを保存するオブジェクト
     COMMONDATA                              m_CommonData;       // ログファイルの情報と共用するための構造体
     EarthQuakeAlert                         m_Alert;            // 緊急地震速報(警報)のデータ
@@ -233,31 +356,163 @@ private:    // Variables
     EarthQuakeInfo                          m_Info;             // 発生した地震情報のデータ
     INFOLOG                                 m_InfoLog;          // 発生した地震情報のログファイルのデータ
     THREAD_INFO                             m_ThreadInfo;       // スレッドの新規作成あるいは既存のスレッドに書き込みするための情報
+    QHash<QString, FEEDVALIDATOR>           m_FeedValidators;   // フィードのURLごとの検証子 (ETag / Last-Modified)
+                                                                // initialize()メソッドでは初期化しない
+    FEEDSTATS                               m_FeedStats;        // 条件付きGETリクエストの統計
+    FEEDCURSOR                              m_FeedCursor,       // JMAのAtomフィードの処理位置 (initialize()メソッドでは初期化しない)
+                                            m_FeedHead;         // 取得したJMAのAtomフィードの先頭 (最新) の位置
+    QList<FEEDENTRY>                        m_FeedEntries;      // 処理位置より新しい地震情報のエントリ (古い順)
+    QHash<QString, DATSTATE>                m_DatStates;        // スレッドのURLごとのdatファイルの取得位置 (initialize()メソッドでは初期化しない)
+    QList<PENDINGTITLE>                     m_PendingTitles;    // タイトルの確認待ちの新規作成したスレッド (initialize()メソッドでは初期化しない)
+    QTimer                                  m_OutboxTimer;      // 送信待ちの書き込みを再送するタイマ
+    bool                                    m_bRetryEvent = false;  // 処理中のエントリで再試行が必要なエラーが発生したかどうか
+    QByteArray                              m_PushedData;       // P2P地震情報のWebSocket APIから受信した地震情報のデータ
+                                                                // 空ではない場合は、JSON APIから取得せずにこのデータを使用する
+
+    QPointer<QNetworkReply>                 m_pReply;           // 非同期で送信中のリクエスト (キャンセルする場合に中断する)
+    quint64                                 m_FetchSequence = 0;    // 取得を共有する場合の最後の要求の通し番号
+    bool                                    m_bWaitingFeed  = false;    // 取得を共有する場合に、レスポンスを待機しているかどうか
+    bool                                    m_bRunning   = false,   // 地震情報の処理中かどうか
+                                            m_bCancelled = false,   // 地震情報の処理がキャンセルされたかどうか
+                                            m_bAlert     = false,   // 処理中の地震情報の種類 (true : 緊急地震速報(警報)、false : 発生した地震情報)
+                                            m_bReplay    = false;   // 送信待ちの書き込みを再送中かどうか
+    int                                     m_EntryIndex = 0,       // 処理中のエントリの位置 (m_FeedEntries変数のインデックス)
+                                            m_Result     = -1;      // 処理結果 (1件以上の地震情報を書き込んだ場合は0)
+    EQIMAGEINFO                             m_EQImageInfo {};   // 震度画像を取得するための設定オブジェクト (発生した地震情報のみ、処理ごとに複製を受け取る)
+    QQueue<QByteArray>                      m_PendingPushes;    // 処理中にP2P地震情報のWebSocket APIから受信した地震情報のデータ
+    std::chrono::steady_clock::time_point   m_DetectedTime;     // 地震情報を検出した時刻 (地震情報のレスポンスを受信した時刻)
+    FEEDSTATS                               m_FeedStatsSnapshot;    // 処理の終了時に保存した統計 (他のスレッドから取得するため)
+    mutable QMutex                          m_StatsMutex;           // 上記の統計を保護するミューテックス
+    Deadline                                m_Deadline;         // 地震情報を検出した時刻を起点とする処理の期限 (地震情報ごとに開始する)
+    QList<Worker*>                          m_Boards;           // 地震情報を配信する他の掲示板のオブジェクト (先頭の掲示板のオブジェクトのみ)
+                                                                // 各オブジェクトは、このオブジェクトのスレッドを終了した後に破棄される
+    QStringList                             m_BoardLogFiles;    // 他の掲示板のログファイルのパス (地震情報が未処理かどうかの確認に使用する)
+    QQueue<BOARDEVENT>                      m_PendingEvents;    // 処理中に配信された地震情報 (2つ目以降の掲示板のオブジェクトのみ)
+    quint64                                 m_EventSequence = 0;    // 最後に配信した地震情報の通し番号
+    QHash<quint64, BOARDDISPATCH>           m_Dispatches;       // 書き込みの終了が通知されていない配信済みの地震情報 (通し番号ごと)
+    QList<FEEDENTRY>                        m_RetryEntries;     // 他の掲示板で再試行が必要なエントリ (次回の取得時に処理位置を戻す)
+
+    static constexpr int                    StreamParseError = -2;  // ストリーム形式でのXMLの解析に失敗したことを表す戻り値 (DOM形式で再解析する)
+    static constexpr int                    PostError        = -2;  // 書き込みに失敗したことを表す戻り値 (送信待ちの書き込みに追加して再送する)
+    static constexpr int                    RequestTimeout   = 3000;    // 地震情報を取得する場合のタイムアウト [mS]
+    static constexpr int                    CookieTimeout    = 10000;   // 処理の期限が無効の場合におけるクッキーの取得のタイムアウト [mS]
+    static constexpr int                    LockTimeout      = 30000;   // ログファイルのロックを取得する場合の待機時間の最大値 [mS]
+    static constexpr int                    TitleCheckDelay  = 5000;    // 新規作成したスレッドのタイトルを確認するまでの待機時間 [mS]
+    static constexpr int                    ReplyMargin      = 10;      // スレッドの最大レス数に達する前に新規スレッドを作成するレス数の余裕
+    static constexpr int                    AlertOutboxAge   = 60000;   // 処理の期限が無効の場合における緊急地震速報(警報)の再送の期限 [mS]
+    static constexpr int                    InfoOutboxAge    = 3600000; // 発生した地震情報の再送の期限 [mS]
+    static constexpr int                    ReplayTimeout    = 30000;   // 送信待ちの書き込みを再送する場合の処理の期限 [mS]
+    static constexpr int                    OutboxBusyDelay  = 1000;    // 地震情報の処理中に再送を延期する時間 [mS]
+    static constexpr int                    BoardTimeout     = 60000;   // 他の掲示板の書き込みの結果の通知を待つ時間の最大値 [mS]
 
 public:     // Variables
 
 private:    // Methods
-    int         onEQDownloaded_for_JMA(bool bAlert);                            // JMAから発生した地震情報のURLを取得する
-    int         DownloadContents(const QUrl &url);                              // JMAから取得した地震情報のデータを取得する
-    int         onEQDownloaded_for_P2P();                                       // 緊急地震速報(警報)および発生した地震情報のデータを取得する
+    void        StartPipeline();                                                // 地震情報の処理を開始する (レスポンスを待機しない)
+    void        FinishPipeline(int result);                                     // 地震情報の処理を終了して、finishedシグナルを送信する
+    void        ProcessPendingPushes();                                         // 処理中に受信した地震情報が存在する場合は、次のイベントループで処理する
+    void        ScheduleTitleCheck();                                           // 新規作成したスレッドのタイトルの確認を予約する
+    void        VerifyThreadTitles();                                           // 新規作成したスレッドのタイトルを確認して、異なる場合はログファイルを更新する
+    void        VerifyNextTitle(QList<PENDINGTITLE> pendingTitles);             // タイトルの確認待ちのスレッドを1件ずつ確認する
+    void        SendRequest(const QUrl &url, bool bConditional,                 // GETリクエストを非同期で送信して、レスポンスの受信時に指定したメソッドを実行する
+                            void (Worker::*onReplied)(const FEEDRESPONSE&),
+                            int timeout = RequestTimeout);
+    void        onFeedReplied(const FEEDRESPONSE &response);                    // JMAのAtomフィードのレスポンスを受信した場合
+    void        onContentsReplied(const FEEDRESPONSE &response);                // JMAから取得した地震情報のレスポンスを受信した場合
+    void        onP2PReplied(const FEEDRESPONSE &response);                     // P2P地震情報のレスポンスを受信した場合
+    void        ProcessNextEntry();                                             // 処理位置より新しいエントリを古い順に1件ずつ処理する
+    void        onEntryProcessed(const FEEDENTRY &entry, int result);           // 1件のエントリの処理 (整形および書き込み) が終了した場合
+    void        ProcessEvent(const Callback &onProcessed);                      // 取得した1件の地震情報を整形およびスレッド情報へ変換後、書き込む
+    int         ReadTestFile();                                                 // テストファイルのデータを読み込む
+    int         ScanFeed(bool bAlert);                                          // JMAから処理位置より新しい地震情報のURLを取得する
+    int         ScanFeed_Stream(bool bAlert, bool bFirstPoll);                  // QXmlStreamReaderクラスを使用して、処理位置より新しいエントリを取得する
+    int         ScanFeed_DOM(bool bAlert, bool bFirstPoll);                     // QDomDocumentクラスを使用して、処理位置より新しいエントリを取得する
+    bool        AddFeedEntry(const QString &id, const QDateTime &updated,       // 処理位置より新しい地震情報のエントリを追加する
+                             bool bAlert, bool bFirstPoll);                     // 処理位置より古いエントリに到達した場合はfalseを返す
+    void        AdvanceFeedCursor(const FEEDENTRY &entry);                      // 処理位置を指定したエントリまで進める
+    void        RequestRetry();                                                 // 再試行が必要なエラーが発生したことを記録する
+    void        ProcessAlertEvent(const Callback &onProcessed);                 // 取得した1件の緊急地震速報(警報)を処理する
+    void        ProcessInfoEvent(EQIMAGEINFO &EQImageInfo,                      // 取得した1件の発生した地震情報を処理する
+                                 const Callback &onProcessed);
+    void        DeliverAlertEvent(const Callback &onDelivered);                 // 整形した緊急地震速報(警報)で、この掲示板にスレッドを新規作成する
+    int         FinishAlertEvent(int postResult);                               // 緊急地震速報(警報)の書き込みの結果を記録する
+    void        ExpireAlertEvent(const QString &result);                        // 期限切れのため書き込めなかった緊急地震速報(警報)を、失敗としてログファイルに記録する
+    void        DeliverInfoEvent(const Callback &onDelivered);                  // 整形した発生した地震情報を、この掲示板に書き込む
+    void        PostInfoEvent(const Callback &onPosted);                        // 発生した地震情報を既存のスレッドに書き込み、または、スレッドを新規作成して、ログファイルを更新する
+                                                                                // 書き込みに失敗した場合はPostErrorを渡す
+    void        WriteInfoThread(const Callback &onPosted);                      // 発生した地震情報を既存のスレッドに書き込み、ログファイルを更新する
+    void        CreateInfoThread(bool bDeleteObject, const Callback &onPosted); // 発生した地震情報でスレッドを新規作成して、ログファイルに保存する
+    void        DispatchEvent();                                                // 整形した地震情報を他の掲示板のオブジェクトへ配信する
+    void        FinishBoard(quint64 sequence, bool bRetry);                     // 他の掲示板の書き込みの終了を記録する
+    void        RewindFeedCursor();                                             // 他の掲示板で再試行が必要なエントリが存在する場合は、処理位置を戻す
+    void        PrepareBoards();                                                // 他の掲示板の書き込みの準備を開始する
+    [[nodiscard]] bool  IsLogged() const;                                       // 処理中の地震情報がこの掲示板のログファイルに存在するかどうかを確認する
+    void        SaveFeedStats();                                                // 他のスレッドから取得できるように統計を保存する
+    bool        EnqueuePost(int attempts = 1);                                  // 処理中の地震情報の書き込みを送信待ちの書き込みに追加する (使用しない場合はfalseを返す)
+    void        ScheduleOutbox(qint64 msecs);                                   // 指定した時間 [mS] の経過後に、送信待ちの書き込みの再送を予約する
+    void        ProcessOutbox();                                                // 送信待ちの書き込みを1件再送する
+    [[nodiscard]] QString       OutboxKey() const;                              // 処理中の地震情報の識別子 (送信待ちの書き込みの重複の確認に使用する) を取得する
+    [[nodiscard]] QString       BoardName() const;                              // 書き込み先の掲示板の名前 (書き込み用URLおよびBBS名) を取得する
+    [[nodiscard]] QJsonObject   SaveEvent() const;                              // ログファイルに保存する地震情報をJSONオブジェクトへ変換する
+    void        RestoreEvent(const QJsonObject &event);                         // JSONオブジェクトからログファイルに保存する地震情報を復元する
+    void        SetConditionalHeaders(QNetworkRequest &request) const;          // 前回の検証子を使用して条件付きGETリクエストのヘッダを設定する
+    bool        IsNotModified(const FEEDRESPONSE &response);                    // レスポンスが304 (Not Modified) かどうかを確認して、検証子を更新する
+    void        ResetValidator(const QString &url);                             // 検証子を破棄して、次回は必ずフィード全体を取得する
     int         FormattingData_for_JMA(bool bAlert);                            // JMAから取得した地震情報を整形する
+    int         FormattingData_for_JMA_Stream(bool bAlert);                     // QXmlStreamReaderクラスを使用して、JMAから取得した地震情報を整形する
+    int         FormattingData_for_JMA_DOM(bool bAlert);                        // QDomDocumentクラスを使用して、JMAから取得した地震情報を整形する
+    int         ReadAlertReport_Stream(QXmlStreamReader &reader);               // 緊急地震速報(警報)のReport要素を解析する
+    void        ReadAlertEarthquake_Stream(QXmlStreamReader &reader);           // 緊急地震速報(警報)のEarthquake要素を解析する
+    void        ReadAlertForecast_Stream(QXmlStreamReader &reader);             // 緊急地震速報(警報)のForecast要素を解析する
+    int         ReadInfoReport_Stream(QXmlStreamReader &reader);                // 発生した地震情報のReport要素を解析する
+    void        ReadInfoEarthquake_Stream(QXmlStreamReader &reader,             // 発生した地震情報のEarthquake要素を解析する
+                                          const QString &targetDateTime);
+    int         ReadInfoObservation_Stream(QXmlStreamReader &reader);           // 発生した地震情報のObservation要素を解析する
+    void        ReadInfoArea_Stream(QXmlStreamReader &reader,                   // 発生した地震情報のArea要素を解析する
+                                    QList<POINT> &points);
+    void        ReadInfoComments_Stream(QXmlStreamReader &reader);              // 発生した地震情報のComments要素を解析する
+    static void ReadHypocenter_Stream(QXmlStreamReader &reader,                 // Hypocenter要素から震源地および緯度・経度・震源の深さを取得する
+                                      QString &name, QString &coordinate);
+    static void ParseCoordinate(QString coordinate, QString &latitude,          // jmx_eb:Coordinate要素の値から緯度・経度・震源の深さを取得する
+                                QString &longitude, QString &depth);
+    [[nodiscard]] static qint64 GetElapsedSeconds(const QString &reportDateTime);   // JMAの地震情報の報告時刻からの経過時間 [秒] を取得する
     bool        GetElementText(const QDomElement &parent,
                                const QString &tagName,
                                QString &result);
+    bool        GetElementText(QXmlStreamReader &reader,                        // 現在の要素の子要素のうち、指定した名前を持つ最初の要素の値を取得する
+                               const QString &tagName,
+                               QString &result);
+    static QString      ReadElementText(QXmlStreamReader &reader);              // 現在の要素の値を取得する (子要素の値も含む)
     int         FormattingData_for_P2P();                                       // P2P地震情報から取得した地震情報を整形する
     int         FormattingThreadInfo();                                         // 整形した地震情報のデータをスレッド情報へ整形する
-    int         AddEQInfoImage(EQIMAGEINFO &EQImageInfo);                       // Yahoo天気・災害の地震情報一覧にアクセスして、震度分布の画像を検索・追記する
-    int         Post(int EQCode, bool bCreateThread = true);                    // スレッドを新規作成する
+    void        AddEQInfoImage(EQIMAGEINFO &EQImageInfo,                        // Yahoo天気・災害の地震情報一覧にアクセスして、震度分布の画像を検索・追記する
+                               const Callback &onAdded);
+    void        Post(int EQCode, bool bCreateThread, const Callback &onPosted); // スレッドを新規作成する、または、既存のスレッドに書き込む
+    void        SendPost(int EQCode, bool bCreateThread,                        // クッキーの取得後に、POSTデータを送信する
+                         const Callback &onPosted);
+    void        RecordPostLatency();                                            // 地震情報を検出してからPOSTデータを送信するまでの時間を記録する
+    void        StartDeadline();                                                // 地震情報を検出した時刻を起点として処理の期限を開始する
+    void        ReportDeadline(const QString &result);                          // 各段階が使用した処理の期限 (予算) を表示する
+    [[nodiscard]] int   GetLockTimeout() const;                                 // 処理の期限に制限したログファイルのロックの待機時間 [mS] を取得する
     [[nodiscard]] bool  SearchAlertEQID(const QString &searchValue) const;      // 緊急地震速報(警報)のログファイルから地震情報を検索する
     [[nodiscard]] bool  SearchInfoEQID(const QString &ID) const;                // 地震情報のログファイルから同じ地震IDが存在するかどうかを確認する
     [[nodiscard]] bool  SearchInfoEQID(const QString &ID,                       // 地震情報のログファイルから同じ地震IDの"ReportDateTime"キーの日時が存在するかどうかを確認する
                                        const QString &reportDateTime) const;
     bool        GetExistObject(const QString &hypo);                            // 地震情報のログファイルから同じ震源地のオブジェクトを取得する
     bool        GetExistObject();                                               // 地震情報のログファイルから最も震度の大きい都道府県名のオブジェクトを取得する
-    bool        isExistThread(const QUrl &url, const QString &title);           // 過去に作成したスレッドが生存しているかどうかを確認する
-    int         CompareThreadTitle(const QUrl &url, const QString &title);      // !chttコマンドでスレッドのタイトルが正常に変更されているかどうかを判断する
-                                                                                // !chttコマンドは、防弾嫌儲系のみ使用可能
-    int         CheckLastThreadNum();                                           // 書き込むスレッドのレス数が上限に達しているかどうかを確認する
+    void        FetchThreadTitle(const QUrl &url, bool bUseCache,               // スレッドのタイトルを取得する (スレッド一覧のキャッシュが使用できる場合は使用する)
+                                 const TitleCallback &onFetched);
+    void        FetchThreadHtmlTitle(const QUrl &url,                           // スレッドのHTMLからタイトルを取得する
+                                     const TitleCallback &onFetched);
+    void        isExistThread(const QUrl &url, const QString &title,            // 過去に作成したスレッドが生存しているかどうかを確認する (生存している場合は1を渡す)
+                              const Callback &onChecked);
+    void        CompareThreadTitle(const QUrl &url, const QString &title,       // !chttコマンドでスレッドのタイトルが正常に変更されているかどうかを判断する
+                                   const Callback &onCompared);                 // !chttコマンドは、防弾嫌儲系のみ使用可能
+    void        CheckLastThreadNum(const Callback &onChecked);                  // 書き込むスレッドのレス数が上限に近いかどうかを確認する
+    int         CountDatReplies(const QString &threadURL, int iRet,             // 取得したdatファイルの行数 (レス数) を数える
+                                const QByteArray &data);
+    int         CheckReplyLimit(int replies);                                   // スレッドのレス数が上限に近いかどうかを判断する
+    static QUrl DatURL(const QString &threadURL);                               // スレッドのURLからdatファイルのURLを取得する
     int         DeleteObject(const QString &hypo) const;                        // ログファイルから生存していないスレッドの地震情報を削除する
     int         DeleteObject(const QStringList &prefs) const;                   // ログファイルから生存していないスレッドの地震情報を削除する
     static QString      AddChttCommand(QString &Subject, QString &Message);     // 既存スレッドに書き込む場合、スレッド本文の先頭に!chttコマンドを挿入する
@@ -279,14 +534,28 @@ public:     // Methods
     explicit Worker(QObject *parent = nullptr);                                 // コンストラクタ
     Worker(COMMONDATA CommonData, THREAD_INFO threadInfo,                       // コンストラクタ
            QObject *parent = nullptr);
+    ~Worker() override;                                                         // デストラクタ
     void        initialize();                                                   // 各メンバ変数を初期化する
+    void        WarmUp();                                                       // 掲示板との接続を事前に確立して、クッキーをバックグラウンドで取得する
+    void        SetPushedData(const QByteArray &data);                          // P2P地震情報のWebSocket APIから受信した地震情報のデータを設定する
+    void        EnqueuePushedData(const QByteArray &data);                      // 処理中に受信した地震情報のデータを、処理の終了後に処理するように保存する
+    void        AddBoard(Worker *pBoard);                                       // 地震情報を配信する他の掲示板のオブジェクトを追加する
+    void        PrepareBoard();                                                 // 書き込みの準備 (掲示板との接続およびクッキーの取得) を開始する
+    void        DeliverEvent(const BOARDEVENT &event);                          // 配信された地震情報をこの掲示板に書き込む (処理中の場合は処理の終了後に書き込む)
+    void        cancel();                                                       // 処理中の地震情報の処理をキャンセルする
+    [[nodiscard]] bool IsRunning() const;                                       // 地震情報の処理中かどうかを確認する
+    [[nodiscard]] FEEDSTATS GetFeedStats() const;                               // 条件付きGETリクエストおよびXMLの解析の統計を取得する
 
 signals:
+    void        finished(int result);                                           // 地震情報の処理が終了した場合 (1件以上の地震情報を書き込んだ場合は0)
+    void        delivered(quint64 sequence, int result, bool bRetry);           // 配信された地震情報の書き込みが終了した場合 (再試行が必要な場合はbRetryがtrue)
 
 public slots:
     int         ProcessEQAlert();                                               // 取得したデータを整形およびスレッド情報へ変換後、新規スレッドを作成する (緊急地震速報用)
-    int         ProcessEQInfo(EQIMAGEINFO &EQImageInfo);                        // 取得したデータを整形およびスレッド情報へ変換後、
+                                                                                // 処理を開始した場合は0、既に処理中の場合は-1を返す (処理の終了はfinishedシグナルで通知する)
+    int         ProcessEQInfo(const EQIMAGEINFO &EQImageInfo);                  // 取得したデータを整形およびスレッド情報へ変換後、
                                                                                 // 既存スレッドに書き込み、または、新規スレッドを作成する (発生した地震情報用)
+                                                                                // 処理を開始した場合は0、既に処理中の場合は-1を返す (処理の終了はfinishedシグナルで通知する)
 };
 
 
@@ -300,28 +569,45 @@ private:    // Variables
                                             m_EQInfoURL;        // 発生した地震情報を取得するURL
     bool                                    m_bEQAlert,         // 緊急地震速報(警報)の有効 / 無効
                                             m_bEQInfo;          // 地震情報の有効 / 無効
-    QString                                 m_AlertFile,        // 緊急地震速報(警報)のIDを保存するファイルパス
-                                            m_InfoFile;         // 発生した地震情報のIDを保存するファイルパス
     COMMONDATA                              m_CommonData;       // 各ログファイルの情報と共用するための構造体
-    THREAD_INFO                             m_ThreadInfo;       // スレッドを立てるための情報オブジェクト
+    QList<BOARDCONFIG>                      m_Boards;           // 地震情報を書き込む掲示板の設定 (先頭の掲示板のオブジェクトが地震情報を取得する)
     EQIMAGEINFO                             m_EQImageInfo;      // 震度画像を取得するための設定オブジェクト
-    std::unique_ptr<Worker>                 m_pEQAlertWorker;   // 緊急地震速報(警報)オブジェクト
-    std::unique_ptr<Worker>                 m_pEQInfoWorker;    // 発生した地震情報オブジェクト
+    std::vector<std::unique_ptr<Worker>>    m_EQAlertWorkers;   // 緊急地震速報(警報)オブジェクト (掲示板ごと)
+    std::vector<std::unique_ptr<Worker>>    m_EQInfoWorkers;    // 発生した地震情報オブジェクト (掲示板ごと)
+    std::vector<std::unique_ptr<QThread>>   m_EQAlertThreads;   // 緊急地震速報(警報)オブジェクトを実行するスレッド (掲示板ごと)
+    std::vector<std::unique_ptr<QThread>>   m_EQInfoThreads;    // 発生した地震情報オブジェクトを実行するスレッド (掲示板ごと)
 
 public:     // Variables
 
 private:    // Methods
+    void    CreateWorkers(COMMONDATA data, bool bAlert,                     // 掲示板ごとに地震情報オブジェクトを生成して、それぞれ専用のスレッドで実行する
+                          std::vector<std::unique_ptr<Worker>> &workers,
+                          std::vector<std::unique_ptr<QThread>> &threads,
+                          const QString &name);
+    std::unique_ptr<Worker> CreateWorker(const COMMONDATA &data,            // 地震情報オブジェクトを生成して、専用のスレッドで実行する
+                                         const THREAD_INFO &threadInfo,
+                                         std::unique_ptr<QThread> &pThread,
+                                         const QString &name);
+    static void StopWorkers(std::vector<std::unique_ptr<Worker>> &workers,  // 地震情報オブジェクトの処理をキャンセルして、スレッドを終了する
+                            std::vector<std::unique_ptr<QThread>> &threads);
 
 public:     // Methods
-    explicit EarthQuake(COMMONDATA CommonData, THREAD_INFO ThreadInfo, EQIMAGEINFO &EQImageInfo,
-                        bool bEQAlert, QString EQAlertURL, QString AlertFile,
-                        bool bEQInfo,  QString EQInfoURL,  QString InfoFile,
+    explicit EarthQuake(COMMONDATA CommonData, QList<BOARDCONFIG> Boards, EQIMAGEINFO &EQImageInfo,
+                        bool bEQAlert, QString EQAlertURL,
+                        bool bEQInfo,  QString EQInfoURL,
                         QObject *parent = nullptr);
     ~EarthQuake() override;             // デストラクタ
-    int     EQProcessAlert();           // 緊急地震速報(警報)を取得して新規スレッドを作成する
-    int     EQProcessInfo();            // 発生した地震情報を取得して新規スレッドを作成または既存のスレッドに書き込みする
+    int     EQProcessAlert(const QByteArray &pushedData = QByteArray());    // 緊急地震速報(警報)を取得して新規スレッドを作成する
+    int     EQProcessInfo(const QByteArray &pushedData = QByteArray());     // 発生した地震情報を取得して新規スレッドを作成または既存のスレッドに書き込みする
+                                                                            // pushedDataには、P2P地震情報のWebSocket APIから受信したデータを指定する (空の場合はJSON APIから取得する)
+                                                                            // 処理は地震情報オブジェクトのスレッドで実行されるため、直ちに0を返す (処理の終了はfinishedシグナルで通知する)
+                                                                            // 処理中の場合、pushedDataは処理の終了後に処理される
+                                                                            // 無効の場合は-1を返す
+    void    cancel();                                                       // 処理中の地震情報の処理をキャンセルする
+    [[nodiscard]] FEEDSTATS GetFeedStats() const;   // 条件付きGETリクエストおよびXMLの解析の統計を取得する
 
 signals:
+    void    finished(int result);                                           // 地震情報の処理が終了した場合
 
 public slots:
 
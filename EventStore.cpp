@@ -0,0 +1,208 @@
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <iostream>
+#include "EventStore.h"
+#include "JsonEventStore.h"
+
+#ifdef QEQALERT_SQLITE
+    #include "SqliteEventStore.h"
+#endif
+
+
+QMutex                                      EventStore::s_Mutex;
+QHash<QString, std::shared_ptr<EventStore>> EventStore::s_Stores;
+EventStore::Backend                         EventStore::s_Backend = EventStore::Backend::Json;
+RETENTIONCONFIG                             EventStore::s_Retention;
+
+
+EventStore::~EventStore() = default;
+
+
+// ログファイルの保存形式を判別する
+// ファイルが存在する場合はファイルの先頭、存在しない場合は拡張子 (.db、.sqlite、.sqlite3) で判別する
+static EventStore::Backend backendOf(const QString &fileName)
+{
+    QFile File(fileName);
+    if (File.open(QIODevice::ReadOnly)) {
+        const auto header = File.read(16);
+        File.close();
+
+        return header == QByteArray("SQLite format 3\0", 16) ? EventStore::Backend::Sqlite : EventStore::Backend::Json;
+    }
+
+    const auto suffix = QFileInfo(fileName).suffix().toLower();
+
+    return (suffix == "db" || suffix == "sqlite" || suffix == "sqlite3") ? EventStore::Backend::Sqlite : EventStore::Backend::Json;
+}
+
+
+// ログファイルのオブジェクトを取得する
+// 同じログファイルに対しては、全てのスレッドで同じオブジェクトを使用する
+std::shared_ptr<EventStore> EventStore::open(const QString &fileName)
+{
+    return open(fileName, s_Backend);
+}
+
+
+// 保存形式を指定して、ログファイルのオブジェクトを取得する
+// 指定した保存形式が使用できない場合は、JSON形式を使用する
+std::shared_ptr<EventStore> EventStore::open(const QString &fileName, Backend backend)
+{
+    QMutexLocker locker(&s_Mutex);
+
+    auto it = s_Stores.find(fileName);
+    if (it == s_Stores.end()) {
+#ifdef QEQALERT_SQLITE
+        if (backend == Backend::Sqlite) {
+            it = s_Stores.insert(fileName, std::shared_ptr<EventStore>(new SqliteEventStore(fileName)));
+            return it.value();
+        }
+#else
+        Q_UNUSED(backend)
+#endif
+
+        it = s_Stores.insert(fileName, std::shared_ptr<EventStore>(new JsonEventStore(fileName)));
+    }
+
+    return it.value();
+}
+
+
+// 保存形式が使用できるかどうかを確認する
+// SQLite形式は、CMakeの-DSQLITE=ONオプションを付加してビルドした場合のみ使用できる
+bool EventStore::isAvailable(Backend backend)
+{
+#ifdef QEQALERT_SQLITE
+    Q_UNUSED(backend)
+    return true;
+#else
+    return backend == Backend::Json;
+#endif
+}
+
+
+// ログファイルの保存形式を変更する
+// 設定ファイルの読み込み時 (各スレッドの開始前) に呼び出すこと
+void EventStore::setBackend(Backend backend)
+{
+    s_Backend = backend;
+}
+
+
+// ログファイルの保存形式を取得する
+EventStore::Backend EventStore::backend()
+{
+    return s_Backend;
+}
+
+
+// ログファイルの保持期間を変更する
+// 設定ファイルの読み込み時 (各スレッドの開始前) に呼び出すこと
+void EventStore::setRetention(const RETENTIONCONFIG &config)
+{
+    s_Retention = config;
+}
+
+
+// 全てのログファイルのオブジェクトを破棄する
+// コンパクションが実行中の場合は、終了を待機した後 (スレッドプールの終了後) に呼び出すこと
+void EventStore::cleanup()
+{
+#ifdef QEQALERT_SQLITE
+    // 現在のスレッド (メインスレッド) のデータベースの接続は、ここで破棄する
+    SqliteEventStore::cleanup();
+#endif
+
+    QMutexLocker locker(&s_Mutex);
+    s_Stores.clear();
+}
+
+
+// ログファイルを別の保存形式へ変換する (--convert-logオプション)
+// JSON形式からSQLite形式、または、SQLite形式からJSON形式へ変換する
+// 変換先のログファイルが存在する場合は、空の場合のみ変換する (同じ地震情報が重複しないようにする)
+int EventStore::convert(const QString &source, const QString &destination)
+{
+    if (!QFile::exists(source)) {
+        std::cerr << QString("エラー : 変換元のログファイルが存在しません %1").arg(source).toStdString() << std::endl;
+        return -1;
+    }
+
+    const auto sourceBackend      = backendOf(source);
+    const auto destinationBackend = backendOf(destination);
+
+    if (sourceBackend == destinationBackend) {
+        std::cerr << QString("エラー : 変換元と変換先のログファイルの保存形式が同じです").toStdString() << std::endl;
+        std::cerr << QString("        SQLite形式の変換先には、拡張子 (.db、.sqlite、.sqlite3) を指定してください").toStdString() << std::endl;
+        return -1;
+    }
+
+    if (!isAvailable(Backend::Sqlite)) {
+        std::cerr << QString("エラー : SQLite形式を使用するには、CMakeの-DSQLITE=ONオプションを付加してビルドしてください").toStdString() << std::endl;
+        return -1;
+    }
+
+    // JSON形式の変換先が存在しない場合は、空のJSON配列を作成する
+    if (destinationBackend == Backend::Json && !QFile::exists(destination)) {
+        QFile File(destination);
+        if (!File.open(QIODevice::WriteOnly) || File.write("[]\n") != 3) {
+            std::cerr << QString("エラー : 変換先のログファイルの作成に失敗しました %1").arg(File.errorString()).toStdString() << std::endl;
+            return -1;
+        }
+
+        File.close();
+    }
+
+    // 変換時は保持期間を適用しない (変換元の全てのオブジェクトを変換する)
+    // 変換の終了後 (失敗した場合を含む) は、変換前の保持期間に戻す
+    const auto retention = s_Retention;
+    setRetention(RETENTIONCONFIG{0, 0});
+
+    const auto ret = Copy(source, sourceBackend, destination, destinationBackend);
+
+    // 変換中に予約されたコンパクションも保持期間を適用せずに実行されるように、終了を待機してから戻す
+    QThreadPool::globalInstance()->waitForDone();
+#ifdef QEQALERT_SQLITE
+    SqliteEventStore::waitForCompaction();
+#endif
+
+    setRetention(retention);
+
+    return ret;
+}
+
+
+// 変換元のログファイルの全てのオブジェクトを、空の変換先のログファイルへ追加する
+int EventStore::Copy(const QString &source, Backend sourceBackend, const QString &destination, Backend destinationBackend)
+{
+    auto pSource      = open(source, sourceBackend);
+    auto pDestination = open(destination, destinationBackend);
+
+    QList<QJsonObject> objects;
+    if (pSource->exportObjects(objects, 30000) != 0) {
+        std::cerr << QString("エラー : 変換元のログファイルの読み込みに失敗しました %1").arg(source).toStdString() << std::endl;
+        return -1;
+    }
+
+    QList<QJsonObject> existing;
+    if (pDestination->exportObjects(existing, 30000) != 0) {
+        std::cerr << QString("エラー : 変換先のログファイルの読み込みに失敗しました %1").arg(destination).toStdString() << std::endl;
+        return -1;
+    }
+
+    if (!existing.isEmpty()) {
+        std::cerr << QString("エラー : 変換先のログファイルが空ではありません %1").arg(destination).toStdString() << std::endl;
+        return -1;
+    }
+
+    if (pDestination->importObjects(objects, 30000) != 0 || pDestination->compact(30000) != 0) {
+        std::cerr << QString("エラー : 変換先のログファイルの書き込みに失敗しました %1").arg(destination).toStdString() << std::endl;
+        return -1;
+    }
+
+    std::cout << QString("ログファイルを変換しました %1 -> %2 (%3 件)").arg(source, destination).arg(objects.size()).toStdString() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#ifndef EVENTSTORE_H
+#define EVENTSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <functional>
+#include <memory>
+
+
+// ログファイルの保持期間の設定
+// 各値が0の場合は制限しない
+struct RETENTIONCONFIG {
+    int             Days    = 90;       // オブジェクトを保持する日数 (最後に追加または変更した日時から)
+    int             Entries = 1000;     // ログファイルごとに保持する最大のオブジェクト数 (超えた場合は古いオブジェクトから削除する)
+};
+
+
+// ログファイルの統計
+struct EVENTSTORESTATS {
+    bool            bLoaded         = false;    // ログファイルを読み込み済みかどうか
+    qint64          Entries         = 0,        // 現在のオブジェクト数
+                    InitialEntries  = 0,        // 最初に読み込んだ時点のオブジェクト数
+                    Bytes           = 0,        // 現在のログファイルのサイズ (ジャーナルファイル等を含む) [Byte]
+                    InitialBytes    = 0,        // 最初に読み込んだ時点のログファイルのサイズ (ジャーナルファイル等を含む) [Byte]
+                    Expired         = 0,        // 保持期間または最大数により削除したオブジェクト数
+                    Compactions     = 0;        // コンパクションの回数
+};
+
+
+// ログファイル (緊急地震速報(警報)および発生した地震情報) を操作するクラスの基底クラス
+// 保存形式ごとの派生クラスは、以下の通り
+//   JsonEventStore   : JSON配列のスナップショットおよびジャーナルファイル (デフォルト)
+//   SqliteEventStore : SQLiteのデータベース (WALモード、CMakeの-DSQLITE=ONオプションが必要)
+//
+// 各オブジェクトの"logged"キーには、最後に追加または変更した日時 (UTC、ISO 8601形式) を記録する
+// 保持期間を過ぎたオブジェクトおよび最大数を超えたオブジェクトは、コンパクション時に削除する
+class EventStore
+{
+public:     // Variables
+    enum class Backend {
+        Json,                                   // JSON配列のスナップショットおよびジャーナルファイル
+        Sqlite                                  // SQLiteのデータベース
+    };
+
+protected:  // Variables
+    static RETENTIONCONFIG                          s_Retention;            // ログファイルの保持期間の設定 (設定ファイルの読み込み時のみ変更する)
+
+private:    // Variables
+    static QMutex                                   s_Mutex;                // 以下のメンバ変数を保護するミューテックス
+    static QHash<QString, std::shared_ptr<EventStore>> s_Stores;            // ログファイルのパスごとのオブジェクト
+    static Backend                                  s_Backend;              // ログファイルの保存形式 (設定ファイルの読み込み時のみ変更する)
+
+private:    // Methods
+    static int  Copy(const QString &source, Backend sourceBackend,                  // 変換元の全てのオブジェクトを、空の変換先へ追加する
+                     const QString &destination, Backend destinationBackend);
+
+public:     // Methods
+    EventStore() = default;
+    virtual ~EventStore();
+    EventStore(const EventStore&)            = delete;
+    EventStore& operator=(const EventStore&) = delete;
+
+    static std::shared_ptr<EventStore> open(const QString &fileName);                   // ログファイルのオブジェクトを取得する (存在しない場合は作成する)
+    static std::shared_ptr<EventStore> open(const QString &fileName, Backend backend);  // 保存形式を指定して、ログファイルのオブジェクトを取得する
+    static bool isAvailable(Backend backend);                                       // 保存形式が使用できるかどうかを確認する (ビルド時のオプションに依存する)
+    static void setBackend(Backend backend);                                        // ログファイルの保存形式を変更する
+    static Backend backend();                                                       // ログファイルの保存形式を取得する
+    static void setRetention(const RETENTIONCONFIG &config);                        // ログファイルの保持期間を変更する
+    static int  convert(const QString &source, const QString &destination);        // ログファイルを別の保存形式へ変換する (JSON <-> SQLite)
+    static void cleanup();                                                          // 全てのログファイルのオブジェクトを破棄する (アプリケーションの終了時に呼び出す)
+    [[nodiscard]] virtual EVENTSTORESTATS GetStats() const = 0;                     // ログファイルの統計を取得する
+
+    // 検索 (1 : 存在する, 0 : 存在しない, -1 : ログファイルの読み込みに失敗)
+    virtual int containsID(const QString &id, int lockTimeout) = 0;                 // 同じ地震IDが存在するかどうかを確認する
+    virtual int containsURL(const QString &url, int lockTimeout) = 0;               // 同じURLが存在するかどうかを確認する
+    virtual int containsReport(const QString &id, const QString &reportDateTime,    // 同じ地震IDかつ同じ報告日時が存在するかどうかを確認する
+                               int lockTimeout) = 0;
+    virtual int findByHypocentre(const QString &hypo, QJsonObject &object,          // 同じ震源地のオブジェクトを取得する
+                                 int lockTimeout) = 0;
+    virtual int findByPrefs(const QStringList &prefs, QJsonObject &object,          // 同じ都道府県 (最大震度) を含む最初のオブジェクトを取得する
+                            int lockTimeout) = 0;
+
+    // 変更 (0 : 成功, -1 : 失敗)
+    virtual int append(const QJsonObject &object, int lockTimeout) = 0;             // オブジェクトを追加する
+    virtual int updateByHypocentre(const QString &hypo,                             // 同じ震源地の全てのオブジェクトを変更する
+                                   const std::function<void(QJsonObject&)> &update, int lockTimeout) = 0;
+    virtual int updateByPrefs(const QStringList &prefs,                             // 同じ都道府県 (最大震度) を含む全てのオブジェクトを変更する
+                              const std::function<void(QJsonObject&)> &update, int lockTimeout) = 0;
+    virtual int removeByHypocentre(const QString &hypo, int lockTimeout) = 0;       // 同じ震源地の全てのオブジェクトを削除する
+    virtual int removeByPrefs(const QStringList &prefs, int lockTimeout) = 0;       // 同じ都道府県 (最大震度) を含む全てのオブジェクトを削除する
+    virtual int compact(int lockTimeout) = 0;                                       // コンパクション (保持期間を過ぎたオブジェクトの削除を含む) を行う
+
+    // 変換 (0 : 成功, -1 : 失敗)
+    virtual int exportObjects(QList<QJsonObject> &objects, int lockTimeout) = 0;        // 全てのオブジェクトを取得する (ログファイルの順序)
+    virtual int importObjects(const QList<QJsonObject> &objects, int lockTimeout) = 0;  // オブジェクトをまとめて追加する ("logged"キーは保持する)
+};
+
+
+#endif // EVENTSTORE_H
@@ -0,0 +1,216 @@
+#include <QMutexLocker>
+#include <QNetworkRequest>
+#include "FeedFetcher.h"
+#include "NetworkAccess.h"
+
+
+QMutex                      FeedFetcher::s_Mutex;
+QHash<QString, SHAREDFEED>  FeedFetcher::s_Feeds;
+quint64                     FeedFetcher::s_Version = 0;
+bool                        FeedFetcher::s_bEnabled = false;
+std::atomic<qint64>         FeedFetcher::s_Fetches(0);
+std::atomic<qint64>         FeedFetcher::s_Shared(0);
+std::atomic<qint64>         FeedFetcher::s_NotModified(0);
+
+
+// 取得を共有するかどうかを変更する
+// 設定ファイルの読み込み時 (各スレッドの開始前) に呼び出すこと
+void FeedFetcher::setEnabled(bool bEnabled)
+{
+    s_bEnabled = bEnabled;
+}
+
+
+// 取得を共有するかどうかを確認する
+bool FeedFetcher::isEnabled()
+{
+    return s_bEnabled;
+}
+
+
+// 有効期間内に取得したレスポンスが存在する場合は、ネットワークにアクセスせずにコールバックへ渡す
+// 他のオブジェクトが同じURLを取得中の場合は、取得の完了を待機する
+// それ以外の場合は、前回の検証子を使用して条件付きGETリクエストを送信する (304 (Not Modified) の場合は、前回のレスポンスを渡す)
+//
+// リクエストは、このメソッドを呼び出したスレッドのHTTPクライアントで送信する
+void FeedFetcher::fetch(const QUrl &url, int ttl, int timeout, QObject *pContext, const std::function<void(const FEEDRESPONSE&)> &callback)
+{
+    const auto key = url.toString();
+
+    QMutexLocker locker(&s_Mutex);
+
+    Prune();
+
+    auto &feed = s_Feeds[key];
+
+    if (feed.Response.Version != 0 && std::chrono::steady_clock::now() - feed.Fetched < std::chrono::milliseconds(ttl)) {
+        s_Shared++;
+        Deliver(pContext, callback, feed.Response);
+
+        return;
+    }
+
+    feed.Waiters.append({pContext, callback});
+
+    if (feed.bInFlight) {
+        s_Shared++;
+        return;
+    }
+
+    feed.bInFlight = true;
+    feed.Timeout   = timeout;
+
+    auto request = NetworkAccess::createRequest(url, timeout);
+    if (feed.Response.Version != 0) {
+        if (!feed.Response.ETag.isEmpty())         request.setRawHeader("If-None-Match",     feed.Response.ETag);
+        if (!feed.Response.LastModified.isEmpty()) request.setRawHeader("If-Modified-Since", feed.Response.LastModified);
+    }
+
+    s_Fetches++;
+
+    // 他のオブジェクトもレスポンスを待機しているため、このスレッドの処理をキャンセルした場合でも中断しない
+    auto pReply = NetworkAccess::manager()->get(request);
+    NetworkAccess::setShared(pReply);
+    feed.pReply = pReply;
+
+    // レスポンスの待機中はミューテックスを保持しない
+    locker.unlock();
+
+    QObject::connect(pReply, &QNetworkReply::finished, pReply, [key, pReply]() {
+        Finish(key, pReply);
+        pReply->deleteLater();
+    });
+
+    // このスレッドが終了した場合は、完了前にリクエストが破棄される
+    QObject::connect(pReply, &QObject::destroyed, [key, pReply]() {
+        Abandon(key, pReply);
+    });
+}
+
+
+// 取得の完了時に、待機している全てのオブジェクトへレスポンスを渡す
+// 取得に失敗した場合は、レスポンスを保存せずにエラーを渡す (次回の要求時に再取得する)
+void FeedFetcher::Finish(const QString &key, QNetworkReply *pReply)
+{
+    auto response = toResponse(pReply);
+
+    QMutexLocker locker(&s_Mutex);
+
+    auto &feed     = s_Feeds[key];
+    feed.bInFlight = false;
+    feed.pReply    = nullptr;
+
+    if (response.StatusCode == 304 && feed.Response.Version != 0) {
+        s_NotModified++;
+
+        feed.Fetched = std::chrono::steady_clock::now();
+        response     = feed.Response;
+    }
+    else if (response.Error == QNetworkReply::NoError) {
+        response.Version = ++s_Version;
+
+        feed.Response = response;
+        feed.Fetched  = std::chrono::steady_clock::now();
+    }
+
+    const auto waiters = feed.Waiters;
+    feed.Waiters.clear();
+
+    for (const auto &[pContext, callback] : waiters) {
+        Deliver(pContext, callback, response);
+    }
+}
+
+
+// 取得の完了前にリクエストが破棄された場合 (リクエストを送信したスレッドが終了した場合)、待機している先頭のオブジェクトへ取得を引き継ぐ
+// 引き継いだオブジェクトのスレッドで再取得して、残りのオブジェクトはその取得の完了を待機する
+// 取得が完了した後に破棄された場合は、何も行わない
+void FeedFetcher::Abandon(const QString &key, const QNetworkReply *pReply)
+{
+    QMutexLocker locker(&s_Mutex);
+
+    auto it = s_Feeds.find(key);
+    if (it == s_Feeds.end() || !it->bInFlight || it->pReply != pReply) return;
+
+    it->bInFlight = false;
+    it->pReply    = nullptr;
+
+    if (it->Waiters.isEmpty()) return;
+
+    const auto waiter  = it->Waiters.takeFirst();
+    const auto timeout = it->Timeout;
+    const QUrl url(key);
+
+    // 有効期間を0にして、保存しているレスポンスを使用せずに再取得する
+    QMetaObject::invokeMethod(waiter.first, [url, timeout, waiter]() {
+        fetch(url, 0, timeout, waiter.first, waiter.second);
+    }, Qt::QueuedConnection);
+}
+
+
+// 要求したオブジェクトのスレッドでコールバックを実行する
+// オブジェクトの破棄と競合しないように、ミューテックスを保持したまま呼び出す
+void FeedFetcher::Deliver(QObject *pContext, const std::function<void(const FEEDRESPONSE&)> &callback, const FEEDRESPONSE &response)
+{
+    QMetaObject::invokeMethod(pContext, [callback, response]() { callback(response); }, Qt::QueuedConnection);
+}
+
+
+// 有効期間の最大値を過ぎたレスポンスを破棄する
+// 取得中または待機しているオブジェクトが存在するURLは破棄しない
+void FeedFetcher::Prune()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    for (auto it = s_Feeds.begin(); it != s_Feeds.end();) {
+        if (!it->bInFlight && it->Waiters.isEmpty() && now - it->Fetched >= std::chrono::milliseconds(ContentsTTL)) {
+            it = s_Feeds.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+
+// オブジェクトの待機を解除する
+// 地震情報オブジェクトの破棄前に呼び出して、破棄したオブジェクトへレスポンスを渡さないようにする
+void FeedFetcher::cancel(QObject *pContext)
+{
+    QMutexLocker locker(&s_Mutex);
+
+    for (auto &feed : s_Feeds) {
+        for (qsizetype i = feed.Waiters.size() - 1; i >= 0; i--) {
+            if (feed.Waiters.at(i).first == pContext) feed.Waiters.removeAt(i);
+        }
+    }
+}
+
+
+// レスポンスの内容 (ステータスコード、エラー、ボディ、検証子) を取得する
+FEEDRESPONSE FeedFetcher::toResponse(QNetworkReply *pReply)
+{
+    FEEDRESPONSE response;
+    response.Url          = pReply->url();
+    response.StatusCode   = pReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    response.Error        = pReply->error();
+    response.ErrorString  = pReply->errorString();
+    response.ETag         = pReply->rawHeader("ETag");
+    response.LastModified = pReply->rawHeader("Last-Modified");
+
+    if (response.Error == QNetworkReply::NoError) response.Data = pReply->readAll();
+
+    return response;
+}
+
+
+// 地震情報の取得の共有の統計を取得する
+FEEDFETCHERSTATS FeedFetcher::GetStats()
+{
+    FEEDFETCHERSTATS stats;
+    stats.Fetches     = s_Fetches.load();
+    stats.Shared      = s_Shared.load();
+    stats.NotModified = s_NotModified.load();
+
+    return stats;
+}
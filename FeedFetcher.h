@@ -0,0 +1,94 @@
+#ifndef FEEDFETCHER_H
+#define FEEDFETCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QUrl>
+#include <QMutex>
+#include <QNetworkReply>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+
+// 地震情報のGETリクエストのレスポンス
+struct FEEDRESPONSE {
+    QUrl                            Url;                            // リクエストしたURL
+    int                             StatusCode = 0;                 // HTTPステータスコード
+    QNetworkReply::NetworkError     Error = QNetworkReply::NoError; // エラーの種類
+    QString                         ErrorString;                    // エラーの内容
+    QByteArray                      Data,                           // レスポンスのボディ
+                                    ETag,                           // ETagヘッダの値
+                                    LastModified;                   // Last-Modifiedヘッダの値
+    quint64                         Version = 0;                    // 取得を共有した場合、内容が更新されるごとに変わる番号 (0の場合は共有していない)
+};
+
+
+// 取得を共有しているURLごとのレスポンス
+struct SHAREDFEED {
+    FEEDRESPONSE                            Response;           // 最後に取得に成功したレスポンス (Versionが0の場合は未取得)
+    std::chrono::steady_clock::time_point   Fetched;            // 最後に取得した時刻 (304 (Not Modified) の場合を含む)
+    bool                                    bInFlight = false;  // 取得中かどうか
+    const QNetworkReply                    *pReply    = nullptr;    // 取得中のリクエスト (完了前に破棄されたかどうかの確認のみに使用する)
+    int                                     Timeout   = 0;      // 取得中のリクエストのタイムアウト [mS] (引き継ぐ場合に使用する)
+    QList<std::pair<QObject*, std::function<void(const FEEDRESPONSE&)>>> Waiters;   // 取得の完了を待機しているオブジェクトおよびコールバック
+};
+
+
+// 地震情報の取得の共有の統計
+struct FEEDFETCHERSTATS {
+    qint64          Fetches     = 0,    // ネットワークから取得した回数
+                    Shared      = 0,    // 他の設定ファイルの取得を共有した回数 (ネットワークにアクセスしなかった回数)
+                    NotModified = 0;    // ネットワークから取得して、304 (Not Modified) だった回数
+};
+
+
+// 複数の設定ファイル (デーモンモード) における地震情報の取得の共有
+// 同じURL (JMAのAtomフィード、各地震情報のXML、P2P地震情報のJSON API) は、有効期間内に1度のみ取得して、全ての設定ファイルの地震情報オブジェクトへ渡す
+// 取得中に同じURLを要求された場合は、新たにリクエストを送信せずに取得の完了を待機する
+// 取得したスレッドが終了してリクエストが破棄された場合は、待機しているオブジェクトのスレッドで再取得する
+//
+// 地震情報の解析 (震度の閾値の判定等) は、各設定ファイルの地震情報オブジェクトで行う
+// 各地震情報オブジェクトは別のスレッドで実行されるため、全てのメソッドはスレッドセーフである
+// コールバックは、要求したオブジェクトのスレッドで実行される
+class FeedFetcher
+{
+public:     // Variables
+    static constexpr int                        FeedTTL     = 2000;     // フィードの有効期間 [mS] (取得の間隔の最小値 (5[秒]) より短くする)
+    static constexpr int                        ContentsTTL = 600000;   // 各地震情報のXMLの有効期間 [mS] (内容は変更されないため、同じ周期の全ての取得で共有する)
+
+private:    // Variables
+    static QMutex                               s_Mutex;        // 以下のメンバ変数を保護するミューテックス
+    static QHash<QString, SHAREDFEED>           s_Feeds;        // URLごとのレスポンス
+    static quint64                              s_Version;      // 最後に割り当てたレスポンスの番号
+    static bool                                 s_bEnabled;     // 取得を共有するかどうか (設定ファイルの読み込み時のみ変更する)
+    static std::atomic<qint64>                  s_Fetches,      // ネットワークから取得した回数
+                                                s_Shared,       // 他の設定ファイルの取得を共有した回数
+                                                s_NotModified;  // ネットワークから取得して、304 (Not Modified) だった回数
+
+private:    // Methods
+    static void     Finish(const QString &key, QNetworkReply *pReply);     // 取得の完了時に、待機している全てのオブジェクトへレスポンスを渡す
+    static void     Abandon(const QString &key, const QNetworkReply *pReply);   // 取得の完了前にリクエストが破棄された場合、待機しているオブジェクトへ取得を引き継ぐ
+    static void     Deliver(QObject *pContext,                              // 要求したオブジェクトのスレッドでコールバックを実行する (ミューテックスの取得後に呼び出す)
+                            const std::function<void(const FEEDRESPONSE&)> &callback, const FEEDRESPONSE &response);
+    static void     Prune();                                                // 有効期間を過ぎたレスポンスを破棄する (ミューテックスの取得後に呼び出す)
+
+public:     // Methods
+    FeedFetcher()                               = delete;
+    FeedFetcher(const FeedFetcher&)             = delete;
+    FeedFetcher& operator=(const FeedFetcher&)  = delete;
+
+    static void     setEnabled(bool bEnabled);                              // 取得を共有するかどうかを変更する
+    [[nodiscard]] static bool   isEnabled();                                // 取得を共有するかどうかを確認する
+    static void     fetch(const QUrl &url, int ttl, int timeout,            // 有効期間内のレスポンスが存在しない場合のみ取得して、コールバックへ渡す
+                          QObject *pContext, const std::function<void(const FEEDRESPONSE&)> &callback);
+    static void     cancel(QObject *pContext);                              // オブジェクトの待機を解除する (オブジェクトの破棄前に呼び出す)
+    [[nodiscard]] static FEEDRESPONSE toResponse(QNetworkReply *pReply);    // レスポンスの内容を取得する
+    [[nodiscard]] static FEEDFETCHERSTATS GetStats();                       // 地震情報の取得の共有の統計を取得する
+};
+
+
+#endif // FEEDFETCHER_H
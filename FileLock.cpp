@@ -0,0 +1,150 @@
+#include <QFile>
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "FileLock.h"
+
+
+// 待機中のflock関数を中断するシグナルのハンドラ (何もしない)
+// SA_RESTARTを指定せずに登録するため、flock関数はEINTRで終了する
+extern "C" void FileLockWakeHandler(int)
+{
+}
+
+
+// ロックファイルを開いてロックを取得する
+// ロックファイルが存在しない場合は作成する
+FileLock::FileLock(const QString &fileName, Mode mode, int timeout)
+{
+    m_Fd = ::open(QFile::encodeName(fileName).constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_Fd == -1) {
+        m_ErrorString = QString("ロックファイルのオープンに失敗しました %1").arg(std::strerror(errno));
+        return;
+    }
+
+    m_bLocked = Lock(mode, timeout);
+}
+
+
+// ロックを解除する
+// ロックファイルは、他のプロセスが待機している可能性があるため削除しない
+FileLock::~FileLock()
+{
+    if (m_Fd == -1) return;
+
+    if (m_bLocked) ::flock(m_Fd, LOCK_UN);
+
+    ::close(m_Fd);
+}
+
+
+// ロックを取得する
+// 他のプロセス (スレッド) がロックを保持していない場合は、待機せずに取得する
+// 保持している場合は、カーネルがロックの解除を通知するまでflock関数で待機する (ロックが解除された時点で直ちに取得する)
+// 待機時間を指定する場合は、期限切れの時点で待機用のスレッドがシグナルを送信して、flock関数の待機を中断する
+bool FileLock::Lock(Mode mode, int timeout)
+{
+    const int operation = mode == Mode::Exclusive ? LOCK_EX : LOCK_SH;
+
+    // 競合していない場合 (大半の場合) は、待機せずに取得する
+    if (::flock(m_Fd, operation | LOCK_NB) == 0) return true;
+
+    if (errno != EWOULDBLOCK) {
+        m_ErrorString = QString(std::strerror(errno));
+        return false;
+    }
+
+    if (timeout == 0) {
+        m_ErrorString = QString("ロックの待機時間を超えました");
+        return false;
+    }
+
+    // 無期限に待機する場合は、カーネルがロックの解除を待機する
+    if (timeout < 0) {
+        while (::flock(m_Fd, operation) != 0) {
+            if (errno != EINTR) {
+                m_ErrorString = QString(std::strerror(errno));
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // 待機時間を指定する場合
+    static std::once_flag installed;
+    std::call_once(installed, []() {
+        struct sigaction action {};
+        action.sa_handler = FileLockWakeHandler;
+        sigemptyset(&action.sa_mask);
+        ::sigaction(WakeSignal, &action, nullptr);
+    });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    const auto caller   = ::pthread_self();
+
+    std::mutex              mutex;
+    std::condition_variable finished;
+    bool                    bFinished = false;
+
+    // 期限切れの時点でロックを取得していない場合は、取得を終了するまでシグナルを送信する
+    // flock関数の呼び出し直前にシグナルを受信した場合は中断できないため、WakeInterval[mS]ごとに再送する
+    std::thread waker([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (finished.wait_until(lock, deadline, [&bFinished]() { return bFinished; })) return;
+
+        do {
+            ::pthread_kill(caller, WakeSignal);
+        } while (!finished.wait_for(lock, std::chrono::milliseconds(WakeInterval), [&bFinished]() { return bFinished; }));
+    });
+
+    bool bLocked = false;
+    while (true) {
+        if (::flock(m_Fd, operation) == 0) {
+            bLocked = true;
+            break;
+        }
+
+        if (errno != EINTR) {
+            m_ErrorString = QString(std::strerror(errno));
+            break;
+        }
+
+        // 期限切れ以外のシグナルで中断された場合は、待機を続ける
+        if (std::chrono::steady_clock::now() >= deadline) {
+            m_ErrorString = QString("ロックの待機時間を超えました");
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bFinished = true;
+    }
+    finished.notify_one();
+    waker.join();
+
+    return bLocked;
+}
+
+
+// ロックを取得しているかどうか
+bool FileLock::isLocked() const
+{
+    return m_bLocked;
+}
+
+
+// ロックの取得に失敗した場合のエラー内容
+QString FileLock::errorString() const
+{
+    return m_ErrorString;
+}
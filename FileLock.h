@@ -0,0 +1,48 @@
+#ifndef FILELOCK_H
+#define FILELOCK_H
+
+
+#include <QString>
+#include <csignal>
+
+
+// カーネルのアドバイザリロック (flock関数) を使用したファイルのロック
+// コンストラクタでロックを取得して、デストラクタでロックを解除する (RAIIパターン)
+//
+// 読み込みのみの場合は共有ロック、書き込む場合は排他ロックを取得するため、読み込み同士は互いに待機しない
+// 競合している場合は、ロックが解除されるまでflock関数で待機して、待機時間を超えた場合はシグナルで待機を中断する
+// (待機中に再試行しないため、ロックが解除された時点で直ちに取得する)
+// ロックはファイルディスクリプタごとに管理されるため、同じプロセスの別のスレッドとの間でも排他される
+//
+// プロセスが異常終了した場合もカーネルがロックを解除するため、ロックファイルは削除せずに再利用する
+class FileLock
+{
+public:     // Variables
+    enum class Mode {
+        Shared,                                 // 共有ロック (読み込みのみ)
+        Exclusive                               // 排他ロック (書き込み)
+    };
+
+private:    // Variables
+    int         m_Fd      = -1;                     // ロックファイルのファイルディスクリプタ
+    bool        m_bLocked = false;                  // ロックを取得しているかどうか
+    QString     m_ErrorString;                      // ロックの取得に失敗した場合のエラー内容
+
+    static constexpr int    WakeSignal   = SIGURG;  // 待機時間を超えた場合にflock関数の待機を中断するシグナル (既定の動作は無視)
+    static constexpr int    WakeInterval = 1;       // 待機を中断するまでシグナルを再送する間隔 [mS]
+
+private:    // Methods
+    FileLock(const FileLock&)             = delete;
+    FileLock& operator=(const FileLock&)  = delete;
+    bool        Lock(Mode mode, int timeout);       // ロックを取得する
+
+public:     // Methods
+    FileLock(const QString &fileName, Mode mode, int timeout);  // ロックファイルを開いてロックを取得する (timeout[mS]が負の値の場合は無期限に待機する)
+    ~FileLock();                                                // ロックを解除する
+
+    [[nodiscard]] bool      isLocked() const;                   // ロックを取得しているかどうか
+    [[nodiscard]] QString   errorString() const;                // ロックの取得に失敗した場合のエラー内容
+};
+
+
+#endif // FILELOCK_H
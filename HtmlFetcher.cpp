@@ -1,16 +1,17 @@
-#include <QtGlobal>
-
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    #include <QStringEncoder>
-#else
-    #include <QTextCodec>
-#endif
-
 #include <iostream>
+#include <algorithm>
 #include "HtmlFetcher.h"
+#include "HtmlParser.h"
+#include "NetworkAccess.h"
+#include "XPathCache.h"
+
+
+std::atomic<qint64>     HtmlFetcher::s_TitleFetches(0);
+std::atomic<qint64>     HtmlFetcher::s_TitleAborts(0);
+std::atomic<qint64>     HtmlFetcher::s_TitleBytes(0);
 
 
-HtmlFetcher::HtmlFetcher(QObject *parent) : m_pManager(std::make_unique<QNetworkAccessManager>(this)) , QObject{parent}
+HtmlFetcher::HtmlFetcher(QObject *parent) : QObject{parent}
 {
 }
 
@@ -19,29 +20,77 @@ HtmlFetcher::~HtmlFetcher() = default;
 
 
 // Webページにアクセスして、特定の属性を取得する
-int HtmlFetcher::fetch(const QUrl &url, bool redirect, const QString &_xpath, bool bShiftJIS)
+// レスポンスの受信時に、結果 (0 : 取得した場合、1 : 404 (スレッドが落ちている) の場合、-1 : 失敗した場合) をcallbackへ渡す
+void HtmlFetcher::fetch(const QUrl &url, bool redirect, const QString &_xpath, bool bShiftJIS, int timeout, const std::function<void(int)> &callback)
 {
     // リダイレクトを自動的にフォロー
-    QNetworkRequest request(url);
+    // 共用のHTTPクライアントを使用して、掲示板との接続を再利用する
+    auto request = NetworkAccess::createRequest(url, timeout);
 
     if (redirect) {
         request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
     }
 
-    auto pReply = m_pManager->get(request);
+    auto pReply = NetworkAccess::manager()->get(request);
+
+    // <title>タグのみを取得する場合は、レスポンスの本文を受信しながら</title>タグを検索する
+    // </title>タグを受信した時点で転送を中断して、受信済みの先頭部分のみをパースする (スレッドの全てのレスを受信しない)
+    // その他のXPath式の場合は、従来通り本文の全てを受信してからパースする
+    if (_xpath != QStringLiteral("/html/head/title")) {
+        QObject::connect(pReply, &QNetworkReply::finished, this, [this, pReply, _xpath, bShiftJIS, callback]() {
+            // 本文の一部を取得
+            callback(fetchElement(pReply, _xpath, bShiftJIS));
+        });
+
+        return;
+    }
+
+    // 受信済みの本文の先頭部分、および、</title>タグを受信したかどうか (readyReadシグナルとfinishedシグナルで共有する)
+    const auto pHead          = std::make_shared<QByteArray>();
+    const auto pTitleReceived = std::make_shared<bool>(false);
+
+    QObject::connect(pReply, &QNetworkReply::readyRead, this, [pReply, pHead, pTitleReceived]() {
+        // 404等のエラーページのタイトルを使用しないように、成功 (2xx) のレスポンスのみ検索する
+        auto statusCode = pReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (*pTitleReceived || statusCode < 200 || statusCode >= 300) return;
+
+        // 前回の受信分の末尾に</title>タグの一部が含まれている可能性があるため、その位置から検索する
+        const auto from = std::max<qsizetype>(0, pHead->size() - 7);
+        *pHead += pReply->readAll();
+
+        if (pHead->mid(from).toLower().contains("</title>")) {
+            *pTitleReceived = true;
+            pReply->abort();
+        }
+    });
+
+    QObject::connect(pReply, &QNetworkReply::finished, this, [this, pReply, _xpath, bShiftJIS, pHead, pTitleReceived, callback]() {
+        s_TitleFetches++;
+
+        if (!*pTitleReceived) {
+            // </title>タグを受信する前に転送が終了した場合は、受信済みの本文と残りの本文から取得する
+            // 処理のキャンセル (NetworkAccess::abortAll()メソッド) により中断した場合は、エラーとなる
+            if (pReply->error() == QNetworkReply::NoError) *pHead += pReply->readAll();
+            s_TitleBytes += pHead->size();
+
+            callback(fetchElement(pReply, _xpath, bShiftJIS, pHead.get()));
+            return;
+        }
+
+        // 転送を中断した場合 (OperationCanceledError) は、受信済みの先頭部分から<title>タグを取得する
+        s_TitleAborts++;
+        s_TitleBytes += pHead->size();
 
-    // レスポンス待機
-    QEventLoop loop;
-    QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
+        pReply->deleteLater();
 
-    // 本文の一部を取得
-    return fetchElement(pReply, _xpath, bShiftJIS);
+        callback(ExtractElement(*pHead, _xpath, bShiftJIS));
+    });
 }
 
 
 // ダウンロードしたHTMLの内容から特定の属性の値を取得する
-int HtmlFetcher::fetchElement(QNetworkReply *reply, const QString &_xpath, bool bShiftJIS)
+// htmlContentを指定した場合は、レスポンスの本文の代わりに使用する (受信済みの本文)
+int HtmlFetcher::fetchElement(QNetworkReply *reply, const QString &_xpath, bool bShiftJIS, const QByteArray *htmlContent)
 {
     if (reply->error() != QNetworkReply::NoError) {
         // ステータスコードの確認
@@ -58,44 +107,31 @@ int HtmlFetcher::fetchElement(QNetworkReply *reply, const QString &_xpath, bool
         return -1;
     }
 
-    QString htmlContent;
-    if (bShiftJIS) {
-        // Shift-JISからUTF-8へデコード
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        QByteArray SJISData = reply->readAll();
-
-        QStringDecoder decoder("Shift-JIS");
-        htmlContent         = decoder.decode(SJISData);
-#else
-        auto codec  = QTextCodec::codecForName("Shift-JIS");
-        htmlContent = codec->toUnicode(reply->readAll());
-#endif
-    }
-    else {
-         htmlContent = reply->readAll();
-    }
+    // レスポンスの本文 (バイト列) を変換せずにパースする
+    auto iRet = ExtractElement(htmlContent != nullptr ? *htmlContent : reply->readAll(), _xpath, bShiftJIS);
+
+    reply->deleteLater();
 
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
+    return iRet;
+}
 
-    // 文字列からHTMLドキュメントをパース
-    // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+
+// HTMLのバイト列をパースして、XPathで特定の要素の値を取得する
+// 途中までのHTML (転送を中断した場合) も、libxml2のリカバリモードによりパースできる
+int HtmlFetcher::ExtractElement(const QByteArray &htmlContent, const QString &_xpath, bool bShiftJIS)
+{
+    // HTMLドキュメントをパース
+    xmlDocPtr doc = HtmlParser::parse(htmlContent, bShiftJIS);
     if (doc == nullptr) {
         std::cerr << QString("エラー: スレッドURLからHTMLのパースに失敗しました").toStdString() << std::endl;
-        reply->deleteLater();
-
         return -1;
     }
 
-    // XPathで特定の要素を検索
-    auto *xpath = xmlStrdup((const xmlChar*)_xpath.toUtf8().constData());
-    xmlXPathObjectPtr result = getNodeset(doc, xpath);
+    // XPathで特定の要素を検索 (コンパイル済みのXPath式を使用する)
+    xmlXPathObjectPtr result = getNodeset(doc, _xpath);
     if (result == nullptr) {
         std::cerr << QString("エラー: スレッドURLからノードの取得に失敗しました").toStdString() << std::endl;
         xmlFreeDoc(doc);
-        reply->deleteLater();
 
         return -1;
     }
@@ -108,8 +144,8 @@ int HtmlFetcher::fetchElement(QNetworkReply *reply, const QString &_xpath, bool
         xmlNodePtr cur = nodeset->nodeTab[i]->xmlChildrenNode;
         while (cur != nullptr) {
             if (cur->type == XML_TEXT_NODE) {
-                auto buffer = QString(((const char*)cur->content));
-                content.append(buffer);
+                // 取得したノードのテキストのみをデコードする
+                content.append(QString::fromUtf8(reinterpret_cast<const char*>(cur->content)));
             }
             cur = cur->next;
         }
@@ -120,15 +156,14 @@ int HtmlFetcher::fetchElement(QNetworkReply *reply, const QString &_xpath, bool
 
     xmlXPathFreeObject(result);
     xmlFreeDoc(doc);
-    xmlCleanupParser();
-
-    reply->deleteLater();
 
     return 0;
 }
 
 
-xmlXPathObjectPtr HtmlFetcher::getNodeset(xmlDocPtr doc, const xmlChar *xpath)
+// ダウンロードしたHTMLの内容から特定の属性の値を取得する
+// XPath式は、キャッシュに登録されたコンパイル済みのXPath式を使用する
+xmlXPathObjectPtr HtmlFetcher::getNodeset(xmlDocPtr doc, const QString &xpath)
 {
     xmlXPathContextPtr context = xmlXPathNewContext(doc);
     if (context == nullptr) {
@@ -138,7 +173,7 @@ xmlXPathObjectPtr HtmlFetcher::getNodeset(xmlDocPtr doc, const xmlChar *xpath)
         return nullptr;
     }
 
-    xmlXPathObjectPtr result = xmlXPathEvalExpression(xpath, context);
+    xmlXPathObjectPtr result = XPathCache::eval(xpath, context);
     xmlXPathFreeContext(context);
     if (result == nullptr) {
         std::cerr << QString("エラー: XPath式の評価に失敗しました").toStdString() << std::endl;
@@ -147,7 +182,7 @@ xmlXPathObjectPtr HtmlFetcher::getNodeset(xmlDocPtr doc, const xmlChar *xpath)
         std::cerr << QString("  1. XPath式の構文が正しいかどうかを確認する").toStdString() << std::endl;
         std::cerr << QString("  2. 式で参照している要素やノードがXMLドキュメント内に存在するかどうかを確認する").toStdString() << std::endl;
         std::cerr << QString("  3. 名前空間が適切に定義されているかどうかを確認する (名前空間を使用している場合)").toStdString() << std::endl;
-        std::cerr << QString("XPath式: %1").arg(QString::fromUtf8(reinterpret_cast<const char*>(xpath))).toStdString() << std::endl;
+        std::cerr << QString("XPath式: %1").arg(xpath).toStdString() << std::endl;
         return nullptr;
     }
 
@@ -162,16 +197,17 @@ xmlXPathObjectPtr HtmlFetcher::getNodeset(xmlDocPtr doc, const xmlChar *xpath)
 
 
 // 新規作成および書き込みしたスレッドからスレッドのパスおよびスレッド番号を取得する
-int HtmlFetcher::extractThreadPath(const QString &htmlContent, const QString &bbs)
+int HtmlFetcher::extractThreadPath(const QByteArray &htmlContent, bool bShiftJIS, const QString &bbs)
 {
     // HTMLコンテンツをパース
-    htmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    htmlDocPtr doc = HtmlParser::parse(htmlContent, bShiftJIS);
+    if (doc == nullptr) return -1;
 
     // XPathコンテキストを作成
     xmlXPathContextPtr context = xmlXPathNewContext(doc);
 
     // http-equivが"Refresh"であるmetaタグを見つけるXPathクエリ
-    xmlXPathObjectPtr result = xmlXPathEvalExpression((xmlChar*)"//meta[@http-equiv='Refresh']", context);
+    xmlXPathObjectPtr result = XPathCache::eval("//meta[@http-equiv='Refresh']", context);
 
     if(result != nullptr && result->nodesetval != nullptr) {
         for(int i = 0; i < result->nodesetval->nodeNr; i++) {
@@ -179,13 +215,14 @@ int HtmlFetcher::extractThreadPath(const QString &htmlContent, const QString &bb
 
             // content属性を取得
             xmlChar* content = xmlGetProp(node, (xmlChar*)"content");
-            std::string contentStr((char*)content);
+            if (content == nullptr) continue;
+
+            QString url = QString::fromUtf8(reinterpret_cast<const char*>(content));
             xmlFree(content);
 
             // URLからスレッドパスを抽出
             /// まず、URLの部分を抽出
             /// <数値>;URL=/<ディレクトリ名  例. /path/to/test/read.cgi>/<BBS名>/<スレッド番号  例.  15891277>/<その他スレッドの情報  例. l10#bottom>
-            QString url(contentStr.c_str());
             static QRegularExpression re1("URL=(.*)");
             QRegularExpressionMatch urlMatch = re1.match(url);
             if (urlMatch.hasMatch()) {
@@ -244,22 +281,29 @@ int HtmlFetcher::extractThreadPath(const QString &htmlContent, const QString &bb
 
 
 // 書き込むスレッドの最後尾のレス番号を取得する
-int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QString &_xpath, int elementType)
+// レスポンスの受信時に、結果 (0 : 取得した場合、-1 : 失敗した場合) をcallbackへ渡す
+void HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QString &_xpath, int elementType, int timeout,
+                                     const std::function<void(int)> &callback)
 {
     // リダイレクトを自動的にフォロー
-    QNetworkRequest request(url);
+    // 共用のHTTPクライアントを使用して、掲示板との接続を再利用する
+    auto request = NetworkAccess::createRequest(url, timeout);
 
     if (redirect) {
         request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
     }
 
-    auto pReply = m_pManager->get(request);
+    auto pReply = NetworkAccess::manager()->get(request);
+
+    QObject::connect(pReply, &QNetworkReply::finished, this, [this, pReply, _xpath, elementType, callback]() {
+        callback(replyLastThreadNumFinished(pReply, _xpath, elementType));
+    });
+}
 
-    // レスポンス待機
-    QEventLoop loop;
-    QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
 
+// 書き込むスレッドのレスポンスから最後尾のレス番号を取得する
+int HtmlFetcher::replyLastThreadNumFinished(QNetworkReply *pReply, const QString &_xpath, int elementType)
+{
     // レスポンスの取得
     if (pReply->error() != QNetworkReply::NoError) {
         std::cerr << QString("エラー : %1").arg(pReply->errorString()).toStdString() << std::endl;
@@ -268,15 +312,11 @@ int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QStrin
         return -1;
     }
 
-    QString htmlContent = pReply->readAll();
-
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
+    // レスポンスの本文 (バイト列) を変換せずにパースする
+    const auto htmlContent = pReply->readAll();
 
-    // 文字列からHTMLドキュメントをパース
-    // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    // HTMLドキュメントをパース
+    xmlDocPtr doc = HtmlParser::parse(htmlContent, false);
     if (doc == nullptr) {
         std::cerr << QString("エラー : HTMLドキュメントのパースに失敗").toStdString() << std::endl;
         pReply->deleteLater();
@@ -284,9 +324,8 @@ int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QStrin
         return -1;
     }
 
-    // XPathで特定の要素を検索
-    auto *xpath = xmlStrdup((const xmlChar*)_xpath.toUtf8().constData());
-    xmlXPathObjectPtr result = getNodeset(doc, xpath);
+    // XPathで特定の要素を検索 (コンパイル済みのXPath式を使用する)
+    xmlXPathObjectPtr result = getNodeset(doc, _xpath);
     if (result == nullptr) {
         std::cerr << QString("エラー : ノードの取得に失敗").toStdString() << std::endl;
         xmlFreeDoc(doc);
@@ -302,15 +341,13 @@ int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QStrin
     /// 最後尾のノードセットを取得する
     xmlNodePtr cur = nodeset->nodeTab[nodeset->nodeNr - 1]->xmlChildrenNode;
     if (cur->type == elementType) {
-        auto buffer = QString(((const char*)cur->content));
-        m_Element.append(buffer);
+        m_Element.append(QString::fromUtf8(reinterpret_cast<const char*>(cur->content)));
     }
     else {
         /// XPathで取得したノードセットが最後尾に1つ多く取得される場合があるため、最後尾から1つ前のノードセットを取得する
         cur = nodeset->nodeTab[nodeset->nodeNr - 2]->xmlChildrenNode;
         if (cur->type == elementType) {
-            auto buffer = QString(((const char*)cur->content));
-            m_Element.append(buffer);
+            m_Element.append(QString::fromUtf8(reinterpret_cast<const char*>(cur->content)));
         }
     }
 
@@ -318,15 +355,62 @@ int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QStrin
     xmlXPathFreeObject(result);
     xmlFreeDoc(doc);
 
-    // libxml2のクリーンアップ
-    xmlCleanupParser();
-
     pReply->deleteLater();
 
     return 0;
 }
 
 
+// スレッドのdatファイルのうち、指定した位置 [Byte] 以降の部分のみを取得する
+// Rangeヘッダを使用するため、前回の取得以降に追加されたレスのみを受信する
+// 0  : 指定した位置以降の部分を取得した場合 (206 Partial Content)
+// 1  : datファイルの全体を取得した場合 (offsetが0の場合、または、サーバがRangeヘッダに対応していない場合)
+// 2  : 指定した位置以降に追加された部分が存在しない場合 (416 Range Not Satisfiable)
+// -1 : datファイルの取得に失敗した場合 (スレッドが落ちている場合を含む)
+// レスポンスの受信時に、上記の結果および取得した部分をcallbackへ渡す
+void HtmlFetcher::fetchDat(const QUrl &url, qint64 offset, int timeout, const std::function<void(int, const QByteArray&)> &callback)
+{
+    auto request = NetworkAccess::createRequest(url, timeout);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
+
+    // 圧縮された場合はバイト単位の位置が一致しないため、圧縮しないように要求する
+    request.setRawHeader("Accept-Encoding", "identity");
+    if (offset > 0) request.setRawHeader("Range", QString("bytes=%1-").arg(offset).toUtf8());
+
+    auto pReply = NetworkAccess::manager()->get(request);
+
+    QObject::connect(pReply, &QNetworkReply::finished, this, [pReply, offset, callback]() {
+        QByteArray data;
+        auto iRet = replyDatFinished(pReply, offset, data);
+
+        callback(iRet, data);
+    });
+}
+
+
+// datファイルのレスポンスを確認して、本文を取得する
+int HtmlFetcher::replyDatFinished(QNetworkReply *pReply, qint64 offset, QByteArray &data)
+{
+    auto statusCode = pReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (statusCode == 416) {
+        pReply->deleteLater();
+        return 2;
+    }
+
+    if (pReply->error() != QNetworkReply::NoError) {
+        std::cerr << QString("エラー : datファイルの取得に失敗 %1").arg(pReply->errorString()).toStdString() << std::endl;
+        pReply->deleteLater();
+
+        return -1;
+    }
+
+    data = pReply->readAll();
+    pReply->deleteLater();
+
+    return (offset > 0 && statusCode == 206) ? 0 : 1;
+}
+
+
 // スレッドのパスを取得する
 QString HtmlFetcher::GetThreadPath() const
 {
@@ -346,3 +430,16 @@ QString HtmlFetcher::GetElement() const
 {
     return m_Element;
 }
+
+
+// スレッドのタイトルの取得に関する統計を取得する
+// 全てのスレッドの合計値を返す
+HTMLFETCHSTATS HtmlFetcher::GetStats()
+{
+    HTMLFETCHSTATS stats;
+    stats.TitleFetches = s_TitleFetches.load();
+    stats.TitleAborts  = s_TitleAborts.load();
+    stats.TitleBytes   = s_TitleBytes.load();
+
+    return stats;
+}
@@ -8,36 +8,65 @@
 #include <QRegularExpression>
 #include <libxml/HTMLparser.h>
 #include <libxml/xpath.h>
+#include <atomic>
+#include <functional>
 #include <memory>
 
 
+// スレッドのタイトルの取得に関する統計
+struct HTMLFETCHSTATS {
+    qint64          TitleFetches = 0,   // <title>タグのみを取得した回数
+                    TitleAborts  = 0,   // </title>タグの受信後に転送を中断した回数
+                    TitleBytes   = 0;   // <title>タグを取得するために受信したバイト数の合計 [Byte]
+};
+
+
 class HtmlFetcher : public QObject
 {
     Q_OBJECT
 
 private:  // Variables
-    std::unique_ptr<QNetworkAccessManager>  m_pManager;                             // スレッドのURLにアクセスするネットワークオブジェクト
     QString                                 m_ThreadPath,                           // スレッドのパス
                                             m_ThreadNum;                            // スレッド番号
     QString                                 m_Element;                              // XPathを使用して取得するエレメント
 
+    static std::atomic<qint64>              s_TitleFetches,                         // 全てのスレッドにおける<title>タグのみを取得した回数
+                                            s_TitleAborts,                          // 全てのスレッドにおける転送を中断した回数
+                                            s_TitleBytes;                           // 全てのスレッドにおける<title>タグを取得するために受信したバイト数
+
 private:  // Methods
     int fetchElement(QNetworkReply *reply, const QString &_xpath,                   // Webページにアクセスして、特定の属性を取得する
-                     bool bShiftJIS = false);
-    xmlXPathObjectPtr getNodeset(xmlDocPtr doc, const xmlChar *xpath);              // ダウンロードしたHTMLの内容から特定の属性の値を取得する
+                     bool bShiftJIS = false, const QByteArray *htmlContent = nullptr);
+    int ExtractElement(const QByteArray &htmlContent, const QString &_xpath,        // HTMLのバイト列をパースして、特定の属性を取得する
+                       bool bShiftJIS);
+    int replyLastThreadNumFinished(QNetworkReply *reply, const QString &_xpath,     // 書き込むスレッドのレスポンスから最後尾のレス番号を取得する
+                                   int elementType);
+    static int replyDatFinished(QNetworkReply *reply, qint64 offset,                // datファイルのレスポンスを確認して、本文を取得する
+                                QByteArray &data);
+    xmlXPathObjectPtr getNodeset(xmlDocPtr doc, const QString &xpath);              // ダウンロードしたHTMLの内容から特定の属性の値を取得する
 
 public:   // Methods
     explicit HtmlFetcher(QObject *parent = nullptr);
     ~HtmlFetcher() override;
-    int     fetch(const QUrl &url, bool redirect, const QString &_xpath,            // Webページにアクセスして、特定の属性を取得する
-                  bool bShiftJIS = false);
-    int     extractThreadPath(const QString &htmlContent, const QString &bbs);      // 新規作成したスレッドからスレッドのパスおよびスレッド番号を抽出する
-    int     fetchLastThreadNum(const QUrl &url, bool redirect,                      // 書き込むスレッドの最後尾のレス番号を取得する
-                               const QString &_xpath, int elementType);
+
+    // fetch、fetchLastThreadNum、fetchDatメソッドはレスポンスを待機せずに終了して、レスポンスの受信時に結果をcallbackへ渡す
+    // リクエストは共用のHTTPクライアントで送信するため、NetworkAccess::abortAll()メソッドで中断できる (中断した場合は失敗となる)
+    // このオブジェクトを破棄した場合は、callbackを呼び出さない
+    void    fetch(const QUrl &url, bool redirect, const QString &_xpath,            // Webページにアクセスして、特定の属性を取得する
+                  bool bShiftJIS, int timeout,                                      // timeoutが0の場合はタイムアウトしない
+                  const std::function<void(int)> &callback);
+    int     extractThreadPath(const QByteArray &htmlContent, bool bShiftJIS,        // 新規作成したスレッドからスレッドのパスおよびスレッド番号を抽出する
+                              const QString &bbs);
+    void    fetchLastThreadNum(const QUrl &url, bool redirect,                      // 書き込むスレッドの最後尾のレス番号を取得する
+                               const QString &_xpath, int elementType, int timeout,
+                               const std::function<void(int)> &callback);
+    void    fetchDat(const QUrl &url, qint64 offset, int timeout,                   // スレッドのdatファイルのうち、指定した位置以降の部分のみを取得する
+                     const std::function<void(int, const QByteArray&)> &callback);
 
     [[nodiscard]] QString GetThreadPath() const;                                    // スレッドのパスを取得する
     [[nodiscard]] QString GetThreadNum() const;                                     // スレッド番号を取得する
     [[nodiscard]] QString GetElement() const;                                       // 要素を取得する
+    [[nodiscard]] static HTMLFETCHSTATS GetStats();                                 // スレッドのタイトルの取得に関する統計を取得する
 
 signals:
 
@@ -0,0 +1,74 @@
+#include <libxml/parser.h>
+#include "HtmlParser.h"
+
+
+QThreadStorage<HtmlParser*>  HtmlParser::s_Instances;
+
+
+HtmlParser::HtmlParser() : m_pContext(htmlNewParserCtxt())
+{
+}
+
+
+HtmlParser::~HtmlParser()
+{
+    if (m_pContext) htmlFreeParserCtxt(m_pContext);
+}
+
+
+// 現在のスレッドのHTMLパーサを取得する
+// 存在しない場合は作成する (スレッドの終了時に自動的に破棄される)
+HtmlParser& HtmlParser::instance()
+{
+    if (!s_Instances.hasLocalData()) {
+        s_Instances.setLocalData(new HtmlParser());
+    }
+
+    return *s_Instances.localData();
+}
+
+
+// libxml2を初期化する
+// 設定ファイルのXPath式をコンパイルする前 (Runnerクラスの生成前) に呼び出すこと
+void HtmlParser::initialize()
+{
+    // 使用するlibxml2のバージョンと、コンパイル時のバージョンの互換性を確認する
+    LIBXML_TEST_VERSION
+
+    xmlInitParser();
+}
+
+
+// libxml2を破棄する
+// 全てのワーカスレッドが終了した後 (各スレッドのパーサコンテキストが破棄された後) に呼び出すこと
+void HtmlParser::cleanup()
+{
+    // 現在のスレッド (メインスレッド) のパーサコンテキストは、ここで破棄する
+    if (s_Instances.hasLocalData()) {
+        s_Instances.setLocalData(nullptr);
+    }
+
+    xmlCleanupParser();
+}
+
+
+// ダウンロードしたHTMLのバイト列をパースする
+// QStringおよびstd::stringへの変換 (全体のコピー) を行わずに、バイト列をそのままlibxml2へ渡す
+// Shift-JISの場合は、libxml2がパースしながらUTF-8へ変換する (パース後の各ノードのテキストはUTF-8となる)
+// libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
+xmlDocPtr HtmlParser::parse(const QByteArray &htmlContent, bool bShiftJIS)
+{
+    constexpr int options = HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING;
+    const char *encoding  = bShiftJIS ? "Shift_JIS" : "UTF-8";
+
+    auto &parser = instance();
+    if (parser.m_pContext == nullptr) {
+        // パーサコンテキストの作成に失敗している場合は、パースごとにコンテキストを作成する
+        return htmlReadMemory(htmlContent.constData(), static_cast<int>(htmlContent.size()), nullptr, encoding, options);
+    }
+
+    // 前回のパースの状態をリセットしてから再利用する
+    htmlCtxtReset(parser.m_pContext);
+
+    return htmlCtxtReadMemory(parser.m_pContext, htmlContent.constData(), static_cast<int>(htmlContent.size()), nullptr, encoding, options);
+}
@@ -0,0 +1,36 @@
+#ifndef HTMLPARSER_H
+#define HTMLPARSER_H
+
+#include <QByteArray>
+#include <QThreadStorage>
+#include <libxml/HTMLparser.h>
+
+
+// 本ソフトウェアの全てのクラスで共用するHTMLパーサ
+// libxml2のグローバルな状態は、アプリケーションの開始時に1度だけ初期化して、終了時に1度だけ破棄する
+// (各処理でxmlInitParser関数およびxmlCleanupParser関数を呼び出すと、他のスレッドが使用中の状態を破棄する可能性がある)
+//
+// パーサコンテキストはスレッド間で共有できないため、スレッドごとに1つのオブジェクトを保持して、
+// パースするごとにリセットして再利用する
+class HtmlParser
+{
+private:    // Variables
+    htmlParserCtxtPtr                       m_pContext;         // このスレッドで再利用するパーサコンテキスト
+
+    static QThreadStorage<HtmlParser*>      s_Instances;        // スレッドごとのHTMLパーサ
+
+private:    // Methods
+    HtmlParser();                                                           // コンストラクタ
+    static HtmlParser&              instance();                             // 現在のスレッドのHTMLパーサを取得する
+
+public:     // Methods
+    ~HtmlParser();                                                          // デストラクタ
+    HtmlParser(const HtmlParser&)            = delete;
+    HtmlParser& operator=(const HtmlParser&) = delete;
+
+    static void                     initialize();                                       // libxml2を初期化する (アプリケーションの開始時に1度だけ呼び出す)
+    static void                     cleanup();                                          // libxml2を破棄する (アプリケーションの終了時に1度だけ呼び出す)
+    static xmlDocPtr                parse(const QByteArray &htmlContent, bool bShiftJIS);   // ダウンロードしたHTMLのバイト列をパースする
+};
+
+#endif // HTMLPARSER_H
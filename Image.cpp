@@ -1,18 +1,12 @@
-#include <QtGlobal>
-
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    #include <QStringEncoder>
-#else
-    #include <QTextCodec>
-#endif
-
 #include <iostream>
 #include "Image.h"
+#include "HtmlParser.h"
+#include "NetworkAccess.h"
+#include "XPathCache.h"
 
 
 Image::Image(EQIMAGEINFO &EQImageInfo, QObject *parent) :
     m_EQImageInfo(EQImageInfo),                                 // 地震情報の震度画像を取得するためのオブジェクトを初期化
-    m_pManager(std::make_unique<QNetworkAccessManager>(this)),  // URLにアクセスするネットワークオブジェクトを初期化
     QObject{parent}
 {
 }
@@ -42,13 +36,12 @@ void Image::CleanupXPathObject(xmlXPathObjectPtr result)
 
 
 // 該当する地震情報の震度画像が存在するURLを取得する
-int Image::FetchUrl(bool redirect, bool bShiftJIS)
+void Image::FetchUrl(bool redirect, bool bShiftJIS, const std::function<void(int)> &callback)
 {
     // リダイレクトを自動的にフォロー
-    QNetworkRequest request(m_EQImageInfo.Url);
-
+    // 共用のHTTPクライアントを使用して、接続を再利用する
     // タイムアウトを3[秒]に設定
-    request.setTransferTimeout(3000);
+    auto request = NetworkAccess::createRequest(m_EQImageInfo.Url, 3000);
 
     // リダイレクトの設定
     if (redirect) {
@@ -56,13 +49,17 @@ int Image::FetchUrl(bool redirect, bool bShiftJIS)
     }
 
     // Webページの取得
-    auto pReply = m_pManager->get(request);
+    auto pReply = NetworkAccess::manager()->get(request);
+
+    QObject::connect(pReply, &QNetworkReply::finished, this, [this, pReply, bShiftJIS, callback]() {
+        callback(replyUrlFinished(pReply, bShiftJIS));
+    });
+}
 
-    // レスポンス待機
-    QEventLoop loop;
-    QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
 
+// 地震情報一覧のレスポンスから、該当する地震情報の震度画像が存在するURLを取得する
+int Image::replyUrlFinished(QNetworkReply *pReply, bool bShiftJIS)
+{
     // ダウンロードしたHTMLの内容から特定の属性の値を取得する
     if (pReply->error() != QNetworkReply::NoError) {
         // ステータスコードの確認
@@ -79,33 +76,14 @@ int Image::FetchUrl(bool redirect, bool bShiftJIS)
         return -1;
     }
 
-    QString htmlContent;
-    if (bShiftJIS) {
-        // Shift-JISからUTF-8へデコード
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        QByteArray SJISData = pReply->readAll();
-
-        QStringDecoder decoder("Shift-JIS");
-        htmlContent         = decoder.decode(SJISData);
-#else
-        auto codec  = QTextCodec::codecForName("Shift-JIS");
-        htmlContent = codec->toUnicode(pReply->readAll());
-#endif
-
-    }
-    else {
-        htmlContent = pReply->readAll();
-    }
-
-    // libxml2の初期化
-    xmlInitParser();
+    // レスポンスの本文 (バイト列) を変換せずにパースする
+    const auto htmlContent = pReply->readAll();
+    pReply->deleteLater();
 
-    // 文字列からHTMLドキュメントをパース
-    // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    // HTMLドキュメントをパース
+    xmlDocPtr doc = HtmlParser::parse(htmlContent, bShiftJIS);
     if (doc == nullptr) {
         std::cerr << QString("エラー : HTMLのパースに失敗しました").toStdString() << std::endl;
-        xmlCleanupParser();
         return -1;
     }
 
@@ -114,18 +92,16 @@ int Image::FetchUrl(bool redirect, bool bShiftJIS)
     if (context == nullptr) {
         std::cerr << QString("エラー : XPathコンテキストの生成に失敗しました").toStdString() << std::endl;
         xmlFreeDoc(doc);
-        xmlCleanupParser();
 
         return -1;
     }
 
-    // 各地震情報のリストを取得するXPath式
-    xmlXPathObjectPtr result = xmlXPathEvalExpression((xmlChar*)m_EQImageInfo.ListXPath.toStdString().data(), context);
+    // 各地震情報のリストを取得するXPath式 (コンパイル済みのXPath式を使用する)
+    xmlXPathObjectPtr result = XPathCache::eval(m_EQImageInfo.ListXPath, context);
     if (result == nullptr) {
         std::cerr << QString("エラー : XPath式の評価に失敗しました").toStdString() << std::endl;
         CleanupXPathContext(context);
         xmlFreeDoc(doc);
-        xmlCleanupParser();
 
         return -1;
     }
@@ -135,7 +111,6 @@ int Image::FetchUrl(bool redirect, bool bShiftJIS)
         CleanupXPathObject(result);
         CleanupXPathContext(context);
         xmlFreeDoc(doc);
-        xmlCleanupParser();
 
         return -1;
     }
@@ -147,11 +122,12 @@ int Image::FetchUrl(bool redirect, bool bShiftJIS)
     QByteArray dateUtf8      = formattedDate.toUtf8();
 
     // 取得した各地震情報のリストに対して処理を行う
+    // テーブル内の要素およびaタグのhref要素のXPath式は、全ての行で同じコンパイル済みのXPath式を使用する
     for (int i = 0; i < result->nodesetval->nodeNr; i++) {
         xmlNodePtr trNode = result->nodesetval->nodeTab[i];
 
         // 各地震情報の詳細 (tdタグ) を取得
-        xmlXPathObjectPtr tdResult = xmlXPathNodeEval(trNode, (xmlChar*)m_EQImageInfo.DetailXPath.toUtf8().constData(), context);
+        xmlXPathObjectPtr tdResult = XPathCache::eval(m_EQImageInfo.DetailXPath, context, trNode);
         if (tdResult && !xmlXPathNodeSetIsEmpty(tdResult->nodesetval)) {
             for (int j = 0; j < tdResult->nodesetval->nodeNr; j++) {
                 xmlNodePtr tdNode = tdResult->nodesetval->nodeTab[j];
@@ -159,7 +135,7 @@ int Image::FetchUrl(bool redirect, bool bShiftJIS)
 
                 if (xmlStrEqual(content, (xmlChar*)dateUtf8.constData())) {
                     // 震度に関する画像が存在するURLを取得
-                    xmlXPathObjectPtr aResult = xmlXPathNodeEval(tdNode, (xmlChar*)m_EQImageInfo.UrlXPath.toUtf8().constData(), context);
+                    xmlXPathObjectPtr aResult = XPathCache::eval(m_EQImageInfo.UrlXPath, context, tdNode);
                     if (aResult && !xmlXPathNodeSetIsEmpty(aResult->nodesetval)) {
                         xmlChar *href = xmlNodeGetContent(aResult->nodesetval->nodeTab[0]);
                         m_Url         = QString::fromUtf8(reinterpret_cast<const char*>(href));
@@ -178,7 +154,6 @@ int Image::FetchUrl(bool redirect, bool bShiftJIS)
                         CleanupXPathObject(result);
                         CleanupXPathContext(context);
                         xmlFreeDoc(doc);
-                        xmlCleanupParser();
 
                         return 0;
                     }
@@ -201,7 +176,6 @@ int Image::FetchUrl(bool redirect, bool bShiftJIS)
     CleanupXPathObject(result);
     CleanupXPathContext(context);
     xmlFreeDoc(doc);
-    xmlCleanupParser();
 
     return -1;
 }
@@ -215,13 +189,12 @@ QString Image::GetUrl() const
 
 
 // 該当する地震情報の震度画像のURLを取得する
-int Image::FetchImageUrl(const QUrl &url, bool redirect, bool bShiftJIS)
+void Image::FetchImageUrl(const QUrl &url, bool redirect, bool bShiftJIS, const std::function<void(int)> &callback)
 {
     // リダイレクトを自動的にフォロー
-    QNetworkRequest request(url);
-
+    // 共用のHTTPクライアントを使用して、接続を再利用する
     // タイムアウトを3[秒]に設定
-    request.setTransferTimeout(3000);
+    auto request = NetworkAccess::createRequest(url, 3000);
 
     // リダイレクトの設定
     if (redirect) {
@@ -229,13 +202,17 @@ int Image::FetchImageUrl(const QUrl &url, bool redirect, bool bShiftJIS)
     }
 
     // Webページの取得
-    auto pReply = m_pManager->get(request);
+    auto pReply = NetworkAccess::manager()->get(request);
+
+    QObject::connect(pReply, &QNetworkReply::finished, this, [this, pReply, bShiftJIS, callback]() {
+        callback(replyImageUrlFinished(pReply, bShiftJIS));
+    });
+}
 
-    // レスポンス待機
-    QEventLoop loop;
-    QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
 
+// 該当する地震情報のレスポンスから、震度画像のURLを取得する
+int Image::replyImageUrlFinished(QNetworkReply *pReply, bool bShiftJIS)
+{
     if (pReply->error() != QNetworkReply::NoError) {
         // 該当する震度画像があるWebページの取得に失敗した場合
         std::cerr << QString("エラー : %1").arg(pReply->errorString()).toStdString() << std::endl;
@@ -244,34 +221,12 @@ int Image::FetchImageUrl(const QUrl &url, bool redirect, bool bShiftJIS)
         return -1;
     }
 
-    QString htmlContent;
-    if (bShiftJIS) {
-        // Shift-JISからUTF-8へデコード
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        QByteArray SJISData = pReply->readAll();
-
-        QStringDecoder decoder("Shift-JIS");
-        htmlContent         = decoder.decode(SJISData);
-#else
-        auto codec  = QTextCodec::codecForName("Shift-JIS");
-        htmlContent = codec->toUnicode(pReply->readAll());
-#endif
-    }
-    else {
-        htmlContent = pReply->readAll();
-    }
-
+    // レスポンスの本文 (バイト列) を変換せずにパースする
+    const auto htmlContent = pReply->readAll();
     pReply->deleteLater();
 
-    // libxml2の初期化
-    xmlInitParser();
-
-    // 文字列からHTMLドキュメントをパース
-    // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(),
-                                nullptr,
-                                "UTF-8",
-                                HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    // HTMLドキュメントをパース
+    xmlDocPtr doc = HtmlParser::parse(htmlContent, bShiftJIS);
     if (doc == nullptr) {
         std::cerr << QString("エラー: 震度画像が存在するURLのHTMLのパースに失敗しました").toStdString() << std::endl;
         return -1;
@@ -279,13 +234,13 @@ int Image::FetchImageUrl(const QUrl &url, bool redirect, bool bShiftJIS)
 
     // XPathで特定の要素を検索
     xmlXPathContextPtr context = xmlXPathNewContext(doc);
-    xmlXPathObjectPtr  xpathObj = xmlXPathEvalExpression(reinterpret_cast<const xmlChar*>(m_EQImageInfo.ImgXPath.toUtf8().constData()), context);
+    xmlXPathObjectPtr  xpathObj = XPathCache::eval(m_EQImageInfo.ImgXPath, context);
 
     QString content;
     if (xpathObj && xpathObj->nodesetval && xpathObj->nodesetval->nodeNr > 0) {
         xmlNodePtr node = xpathObj->nodesetval->nodeTab[0];
         if (node->type == XML_ATTRIBUTE_NODE) {
-            content = QString(reinterpret_cast<const char*>(node->children->content));
+            content = QString::fromUtf8(reinterpret_cast<const char*>(node->children->content));
         }
     }
     else {
@@ -6,6 +6,7 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QUrl>
+#include <functional>
 #include <memory>
 #include <libxml/HTMLparser.h>
 #include <libxml/xpath.h>
@@ -31,7 +32,6 @@ class Image : public QObject
     Q_OBJECT
 
 private:    // Variables
-    std::unique_ptr<QNetworkAccessManager>  m_pManager;                             // URLにアクセスするネットワークオブジェクト
     EQIMAGEINFO m_EQImageInfo;
     QString     m_Url,
                 m_ImageUrl;
@@ -42,14 +42,18 @@ public:     // Variables
 private:    // Methods
     void              CleanupXPathObject(xmlXPathObjectPtr result);
     void              CleanupXPathContext(xmlXPathContextPtr context);
+    int               replyUrlFinished(QNetworkReply *pReply, bool bShiftJIS);        // 地震情報一覧のレスポンスから、該当する地震情報のURLを取得する
+    int               replyImageUrlFinished(QNetworkReply *pReply, bool bShiftJIS);   // 該当する地震情報のレスポンスから、震度画像のURLを取得する
 
 public:     // Methods
     explicit Image(EQIMAGEINFO &EQImageInfo, QObject *parent = nullptr);
     virtual ~Image();
 
-    int     FetchUrl(bool redirect, bool bShiftJIS = false);
+    // FetchUrl、FetchImageUrlメソッドはレスポンスを待機せずに終了して、レスポンスの受信時に結果 (0 : 取得した場合) をcallbackへ渡す
+    // リクエストは共用のHTTPクライアントで送信するため、NetworkAccess::abortAll()メソッドで中断できる (中断した場合は失敗となる)
+    void    FetchUrl(bool redirect, bool bShiftJIS, const std::function<void(int)> &callback);
     QString GetUrl() const;
-    int     FetchImageUrl(const QUrl &url, bool redirect, bool bShiftJIS = false);
+    void    FetchImageUrl(const QUrl &url, bool redirect, bool bShiftJIS, const std::function<void(int)> &callback);
     QString GetImageUrl() const;
 
 signals:
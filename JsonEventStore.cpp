@@ -0,0 +1,838 @@
+#include <QtGlobal>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QThreadPool>
+#include <QMutexLocker>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <iostream>
+#include <utility>
+
+#ifdef Q_OS_UNIX
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include "JsonEventStore.h"
+#include "FileLock.h"
+
+
+JsonEventStore::JsonEventStore(QString fileName) : m_FileName(std::move(fileName))
+{
+    m_JournalName = m_FileName + ".journal";
+
+    // ロックファイルは、従来のバージョンと同じパス (<ログファイルのベース名>.lock) を使用する
+    const QFileInfo fileInfo(m_FileName);
+    m_LockName = fileInfo.dir().filePath(fileInfo.baseName() + ".lock");
+}
+
+
+JsonEventStore::~JsonEventStore() = default;
+
+
+// ログファイルの統計を取得する
+EVENTSTORESTATS JsonEventStore::GetStats() const
+{
+    QMutexLocker locker(&m_Mutex);
+
+    EVENTSTORESTATS stats;
+    stats.bLoaded        = m_InitialEntries >= 0;
+    stats.Entries        = m_Entries.size();
+    stats.InitialEntries = std::max<qint64>(m_InitialEntries, 0);
+    stats.Bytes          = std::max<qint64>(m_Size, 0) + m_JournalSize;
+    stats.InitialBytes   = m_InitialBytes;
+    stats.Expired        = m_Expired;
+    stats.Compactions    = m_Compactions;
+
+    return stats;
+}
+
+
+// ログファイルが読み込んだ後に変更されたかどうかを確認する
+// ログファイルの内容は読み込まずに、スナップショットおよびジャーナルファイルの更新日時とサイズのみを確認する
+bool JsonEventStore::IsChanged() const
+{
+    if (m_Size < 0) return true;
+
+    QFileInfo fileInfo(m_FileName);
+    if (fileInfo.size() != m_Size || fileInfo.lastModified() != m_Modified) return true;
+
+    QFileInfo journalInfo(m_JournalName);
+
+    return journalInfo.size() != m_JournalSize || journalInfo.lastModified() != m_JournalModified;
+}
+
+
+// ログファイルおよびジャーナルファイルの更新日時とサイズを保存する
+// 自身の変更では、ログファイルを再度読み込まないようにする
+void JsonEventStore::SaveFileState()
+{
+    QFileInfo fileInfo(m_FileName);
+    m_Modified        = fileInfo.lastModified();
+    m_Size            = fileInfo.size();
+
+    QFileInfo journalInfo(m_JournalName);
+    m_JournalModified = journalInfo.lastModified();
+    m_JournalSize     = journalInfo.size();
+}
+
+
+// ログファイルが変更されている場合は再度読み込む
+// 変更されていない場合は、ロックの取得およびログファイルの読み込みを行わない
+// 読み込みのみのため共有ロックを取得する (他のプロセスの読み込みを待機させない)
+// ジャーナルファイルの修復が必要な場合のみ、排他ロックを取得して再度読み込む
+int JsonEventStore::Refresh(int lockTimeout)
+{
+    {
+        QMutexLocker locker(&m_Mutex);
+        if (!IsChanged()) return 0;
+    }
+
+    for (auto mode : {FileLock::Mode::Shared, FileLock::Mode::Exclusive}) {
+        // ロックの解除を保証 (RAIIパターンを使用)
+        FileLock lock(m_LockName, mode, lockTimeout);
+        if (!lock.isLocked()) {
+            std::cerr << QString("エラー: %1[mS]以内にログファイルのロックの取得に失敗しました %2").arg(lockTimeout).arg(lock.errorString()).toStdString() << std::endl;
+            return -1;
+        }
+
+        QMutexLocker locker(&m_Mutex);
+
+        // ロックの待機中に他のスレッドが読み込んでいる場合
+        if (!IsChanged()) return 0;
+
+        const auto ret = Load(mode == FileLock::Mode::Exclusive);
+        if (ret != 1) return ret;
+    }
+
+    return -1;
+}
+
+
+// ログファイルを読み込んで、インデックスを作成する
+// スナップショットを読み込んだ後に、ジャーナルファイルのレコードを反映する
+// 読み込みに失敗した場合は、前回読み込んだ内容を保持する
+// bExclusiveがfalse (共有ロック) の場合、ジャーナルファイルの修復が必要な時は1を返す
+int JsonEventStore::Load(bool bExclusive)
+{
+    QFile File(m_FileName);
+    if (!File.open(QIODevice::ReadOnly)) {
+        std::cerr << QString("エラー : ログファイルのオープンに失敗しました %1").arg(File.errorString()).toStdString() << std::endl;
+        return -1;
+    }
+
+    const auto snapshot = File.readAll();
+
+    // ファイルを閉じる
+    File.close();
+
+    QJsonParseError parseError;
+    const auto document = QJsonDocument::fromJson(snapshot, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        std::cerr << QString("エラー : ログファイルの読み込みに失敗しました %1").arg(parseError.errorString()).toStdString() << std::endl;
+        return -1;
+    }
+
+    if (!document.isArray()) {
+        std::cerr << QString("エラー : ログファイルの値が不正です %1").arg(m_FileName).toStdString() << std::endl;
+        return -1;
+    }
+
+    const auto jsonArray = document.array();
+
+    m_Entries.clear();
+    m_Entries.reserve(jsonArray.size());
+    for (const auto &value : jsonArray) {
+        m_Entries.append(value.toObject());
+    }
+
+    m_SnapshotHash = QCryptographicHash::hash(snapshot, QCryptographicHash::Sha1).toHex();
+
+    // ジャーナルファイルのレコードを反映する
+    // 異常終了等によりジャーナルファイルの末尾が不完全な場合は、反映できたレコードまでをスナップショットへ反映する
+    // (不完全なレコードの後に追記すると、以降のレコードが読み込めなくなるため)
+    const auto ret = ReplayJournal();
+    if (ret == 1 && !bExclusive) {
+        // 共有ロックではジャーナルファイルを修復できないため、排他ロックを取得して再度読み込む
+        // (それまでの間も検索できるように、反映できたレコードまでのインデックスを作成する)
+        BuildIndex();
+        m_Size = -1;
+
+        return 1;
+    }
+
+    if (ret == -1 || (ret == 1 && ((m_bOrphanedJournal && SetAsideJournal() != 0) || Compact() != 0))) {
+        m_Size = -1;
+        return -1;
+    }
+
+    BuildIndex();
+    SaveFileState();
+
+    // 統計のために、最初に読み込んだ時点のオブジェクト数およびサイズを保存する
+    if (m_InitialEntries < 0) {
+        m_InitialEntries = m_Entries.size();
+        m_InitialBytes   = m_Size + m_JournalSize;
+    }
+
+    // 保持期間を過ぎたオブジェクトが存在する場合は、書き込みを待たずに削除する
+    ScheduleCompaction();
+
+    return 0;
+}
+
+
+// ジャーナルファイルのレコードを反映する
+// 0  : ジャーナルファイルが存在しない場合、または、全てのレコードを反映できた場合
+// 1  : ジャーナルファイルが不完全なため、コンパクションが必要な場合
+// -1 : ジャーナルファイルの読み込みに失敗した場合
+int JsonEventStore::ReplayJournal()
+{
+    m_JournalRecords   = 0;
+    m_bOrphanedJournal = false;
+
+    QFile Journal(m_JournalName);
+    if (!Journal.exists()) return 0;
+
+    if (!Journal.open(QIODevice::ReadOnly)) {
+        std::cerr << QString("エラー : ジャーナルファイルのオープンに失敗しました %1").arg(Journal.errorString()).toStdString() << std::endl;
+        return -1;
+    }
+
+    // 空のジャーナルファイル
+    if (Journal.atEnd()) return 0;
+
+    // 1行目は、ジャーナルファイルの起点となるスナップショットのハッシュ値
+    // ハッシュ値が一致しない場合は、コンパクションの途中で異常終了した (全てのレコードがスナップショットへ反映済みである) か、
+    // スナップショットが他の方法で置き換えられている (レコードが反映されていない) ため、再生せずに退避する
+    const auto header = QJsonDocument::fromJson(Journal.readLine()).object();
+    if (header.value("snapshot").toString().toLatin1() != m_SnapshotHash) {
+        m_bOrphanedJournal = true;
+        return 1;
+    }
+
+    while (!Journal.atEnd()) {
+        const auto line = Journal.readLine();
+
+        // 末尾に改行が存在しない行は、書き込みの途中で異常終了したレコードのため破棄する
+        if (!line.endsWith('\n')) {
+            std::cerr << QString("警告 : ジャーナルファイルの末尾のレコードが不完全なため破棄します %1").arg(m_JournalName).toStdString() << std::endl;
+            return 1;
+        }
+
+        QJsonParseError parseError;
+        const auto record = QJsonDocument::fromJson(line, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !ApplyRecord(record.object())) {
+            std::cerr << QString("警告 : ジャーナルファイルのレコードが不正なため、以降のレコードを破棄します %1").arg(m_JournalName).toStdString() << std::endl;
+            return 1;
+        }
+
+        m_JournalRecords++;
+    }
+
+    return 0;
+}
+
+
+// ジャーナルファイルの1レコードを反映する
+// レコードの形式 :
+//   {"op":"append",  "object":{...}}           : オブジェクトを末尾に追加する
+//   {"op":"replace", "row":N, "object":{...}}  : N番目のオブジェクトを置き換える
+//   {"op":"remove",  "rows":[N, ...]}          : 各位置のオブジェクトを削除する (降順)
+bool JsonEventStore::ApplyRecord(const QJsonObject &record)
+{
+    const auto op = record.value("op").toString();
+
+    if (op == "append") {
+        m_Entries.append(record.value("object").toObject());
+    }
+    else if (op == "replace") {
+        const auto row = record.value("row").toInt(-1);
+        if (row < 0 || row >= m_Entries.size()) return false;
+
+        m_Entries[row] = record.value("object").toObject();
+    }
+    else if (op == "remove") {
+        for (const auto &value : record.value("rows").toArray()) {
+            const auto row = value.toInt(-1);
+            if (row < 0 || row >= m_Entries.size()) return false;
+
+            m_Entries.removeAt(row);
+        }
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+
+// 起点となるスナップショットが一致しないジャーナルファイルを退避する
+// ジャーナルファイルを削除せずに、<ジャーナルファイル>.<日時>.orphanedへ名前を変更する (手動で確認および復旧できるようにする)
+int JsonEventStore::SetAsideJournal()
+{
+    const auto orphanedName = QString("%1.%2.orphaned").arg(m_JournalName, QDateTime::currentDateTime().toString("yyyyMMddhhmmss"));
+
+    std::cerr << QString("エラー : ジャーナルファイルの起点となるスナップショットがログファイルと一致しないため、ジャーナルファイルを再生せずに退避します %1 -> %2")
+                 .arg(m_JournalName, orphanedName).toStdString() << std::endl;
+
+    if (!QFile::rename(m_JournalName, orphanedName)) {
+        std::cerr << QString("エラー : ジャーナルファイルの退避に失敗しました %1").arg(m_JournalName).toStdString() << std::endl;
+        return -1;
+    }
+
+    m_bOrphanedJournal = false;
+
+    return 0;
+}
+
+
+// ジャーナルファイルにレコードをまとめて追記する
+// 1回の変更で発生した全てのレコードを1回で書き込む
+// ディスクへの同期は、ロックを解除した後にSync()メソッドで行う (他のスレッドの書き込みとまとめて同期する)
+// 書き込みに失敗した場合は、メモリ上の変更を破棄するため、次回の検索時にログファイルを再度読み込む
+int JsonEventStore::Commit(const QList<QJsonObject> &records)
+{
+    QFile Journal(m_JournalName);
+    if (!Journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        std::cerr << QString("エラー : ジャーナルファイルのオープンに失敗しました %1").arg(Journal.errorString()).toStdString() << std::endl;
+        m_Size = -1;
+
+        return -1;
+    }
+
+    QByteArray data;
+
+    // 空のジャーナルファイルの場合は、起点となるスナップショットのハッシュ値を先頭に書き込む
+    if (Journal.size() == 0) {
+        data.append(QJsonDocument(QJsonObject{{"snapshot", QString::fromLatin1(m_SnapshotHash)}}).toJson(QJsonDocument::Compact));
+        data.append('\n');
+    }
+
+    for (const auto &record : records) {
+        data.append(QJsonDocument(record).toJson(QJsonDocument::Compact));
+        data.append('\n');
+    }
+
+    if (Journal.write(data) != data.size() || !Journal.flush()) {
+        std::cerr << QString("エラー : ジャーナルファイルの書き込みに失敗しました %1").arg(Journal.errorString()).toStdString() << std::endl;
+        Journal.close();
+        m_Size = -1;
+
+        return -1;
+    }
+
+    Journal.close();
+
+    m_JournalRecords += static_cast<int>(records.size());
+    m_WriteSequence++;
+    SaveFileState();
+
+    return 0;
+}
+
+
+// 指定した通し番号までにジャーナルファイルへ追記したレコードを、ディスクへ同期する (グループコミット)
+// 他のスレッドが同期中の場合は、その同期の終了を待機して、自身のレコードが同期済みの場合はfsync関数を呼び出さない
+// そのため、同時に書き込んだ複数のスレッドのレコードは、1回のfsync関数でまとめて同期される
+//
+// 同期の前にコンパクションによりジャーナルファイルが置き換えられた場合も、レコードは同期済みのスナップショット (QSaveFileクラス) に含まれる
+void JsonEventStore::Sync(quint64 sequence)
+{
+    QMutexLocker locker(&m_SyncMutex);
+
+    // 他のスレッドの同期に含まれていた場合
+    if (m_SyncedSequence >= sequence) return;
+
+    // この時点までに追記された全てのレコードを同期する
+    const auto target = m_WriteSequence.load();
+
+#ifdef Q_OS_UNIX
+    // 電源断等の場合でも書き込んだレコードを失わないように、ディスクへ同期する
+    const auto fd = ::open(QFile::encodeName(m_JournalName).constData(), O_WRONLY | O_CLOEXEC);
+    if (fd == -1 || ::fdatasync(fd) != 0) {
+        std::cerr << QString("エラー : ジャーナルファイルのディスクへの同期に失敗しました %1").arg(m_JournalName).toStdString() << std::endl;
+    }
+
+    if (fd != -1) ::close(fd);
+#endif
+
+    m_SyncedSequence = target;
+}
+
+
+// ジャーナルファイルの内容をスナップショットへ反映して、ジャーナルファイルを空にする
+// スナップショットおよびジャーナルファイルは、一時ファイルに書き込んだ後に置き換える
+// スナップショットを置き換えた後に異常終了した場合、ジャーナルファイルのハッシュ値が一致しないため、ジャーナルファイルは再生されない
+// スナップショットへ反映する前に、保持期間または最大数を超えたオブジェクトを削除する
+int JsonEventStore::Compact()
+{
+    if (ApplyRetention() > 0) BuildIndex();
+
+    QJsonArray jsonArray;
+    for (const auto &object : std::as_const(m_Entries)) {
+        jsonArray.append(object);
+    }
+
+    const auto snapshot = QJsonDocument(jsonArray).toJson();
+
+    QSaveFile File(m_FileName);
+    if (!File.open(QIODevice::WriteOnly) || File.write(snapshot) != snapshot.size() || !File.commit()) {
+        std::cerr << QString("エラー : ログファイルのコンパクションに失敗しました %1").arg(File.errorString()).toStdString() << std::endl;
+        m_Size = -1;
+
+        return -1;
+    }
+
+    m_SnapshotHash = QCryptographicHash::hash(snapshot, QCryptographicHash::Sha1).toHex();
+
+    QSaveFile Journal(m_JournalName);
+    auto header = QJsonDocument(QJsonObject{{"snapshot", QString::fromLatin1(m_SnapshotHash)}}).toJson(QJsonDocument::Compact);
+    header.append('\n');
+
+    if (!Journal.open(QIODevice::WriteOnly) || Journal.write(header) != header.size() || !Journal.commit()) {
+        std::cerr << QString("エラー : ジャーナルファイルの初期化に失敗しました %1").arg(Journal.errorString()).toStdString() << std::endl;
+        m_Size = -1;
+
+        return -1;
+    }
+
+    m_JournalRecords = 0;
+    m_Compactions++;
+    SaveFileState();
+
+    return 0;
+}
+
+
+// ジャーナルファイルのレコード数またはサイズが閾値を超えた場合は、スレッドプールでコンパクションを行う
+// コンパクションは書き込みの処理 (緊急地震速報(警報)の書き込み等) を待機させない
+void JsonEventStore::ScheduleCompaction()
+{
+    if (m_bCompacting) return;
+    if (m_JournalRecords < CompactRecords && m_JournalSize < CompactBytes && !IsExpired()) return;
+
+    m_bCompacting = true;
+
+    auto pStore = shared_from_this();
+    QThreadPool::globalInstance()->start([pStore]() {
+        pStore->compact(30000);
+    });
+}
+
+
+// 保持期間または最大数を超えたオブジェクトが存在するかどうかを確認する
+// "logged"キーが存在しないオブジェクト (従来の形式) は、保持期間の対象外とする
+bool JsonEventStore::IsExpired() const
+{
+    if (s_Retention.Entries > 0 && m_Entries.size() > s_Retention.Entries) return true;
+    if (s_Retention.Days <= 0) return false;
+
+    const auto limit = QDateTime::currentDateTimeUtc().addDays(-s_Retention.Days);
+
+    return std::any_of(m_Entries.cbegin(), m_Entries.cend(), [&limit](const QJsonObject &object) {
+        const auto logged = QDateTime::fromString(object.value("logged").toString(), Qt::ISODate);
+        return logged.isValid() && logged < limit;
+    });
+}
+
+
+// 保持期間または最大数を超えたオブジェクトを削除する
+// 最大数を超えた場合は、最後に追加または変更した日時が古いオブジェクトから削除する (残りのオブジェクトの順序は変更しない)
+// "logged"キーが存在しないオブジェクト (従来の形式) は、現在の日時を記録して、以降は保持期間の対象とする
+// 戻り値は、削除したオブジェクト数
+int JsonEventStore::ApplyRetention()
+{
+    const auto now    = QDateTime::currentDateTimeUtc();
+    const auto before = m_Entries.size();
+
+    for (auto &object : m_Entries) {
+        if (!object.contains("logged")) object["logged"] = now.toString(Qt::ISODate);
+    }
+
+    // 保持期間
+    if (s_Retention.Days > 0) {
+        const auto limit = now.addDays(-s_Retention.Days);
+
+        m_Entries.erase(std::remove_if(m_Entries.begin(), m_Entries.end(), [&limit](const QJsonObject &object) {
+            const auto logged = QDateTime::fromString(object.value("logged").toString(), Qt::ISODate);
+            return logged.isValid() && logged < limit;
+        }), m_Entries.end());
+    }
+
+    // 最大数
+    if (s_Retention.Entries > 0 && m_Entries.size() > s_Retention.Entries) {
+        std::vector<int> rows(static_cast<size_t>(m_Entries.size()));
+        std::iota(rows.begin(), rows.end(), 0);
+
+        // ISO 8601形式 (UTC) の日時は、文字列の比較で前後関係を判断できる
+        std::stable_sort(rows.begin(), rows.end(), [this](int lhs, int rhs) {
+            return m_Entries.at(lhs).value("logged").toString() < m_Entries.at(rhs).value("logged").toString();
+        });
+
+        std::vector<bool> removed(rows.size(), false);
+        const auto count = static_cast<size_t>(m_Entries.size() - s_Retention.Entries);
+        for (size_t i = 0; i < count; i++) {
+            removed[static_cast<size_t>(rows[i])] = true;
+        }
+
+        QList<QJsonObject> entries;
+        entries.reserve(s_Retention.Entries);
+        for (auto row = 0; row < m_Entries.size(); row++) {
+            if (!removed[static_cast<size_t>(row)]) entries.append(m_Entries.at(row));
+        }
+
+        m_Entries = std::move(entries);
+    }
+
+    const auto expired = static_cast<int>(before - m_Entries.size());
+    m_Expired += expired;
+
+    return expired;
+}
+
+
+// 全てのオブジェクトのインデックスを作成する
+void JsonEventStore::BuildIndex()
+{
+    m_IDIndex.clear();
+    m_URLIndex.clear();
+    m_HypoIndex.clear();
+    m_PrefIndex.clear();
+
+    for (auto row = 0; row < m_Entries.size(); row++) {
+        AddIndex(row);
+    }
+}
+
+
+// 指定した位置のオブジェクトをインデックスに追加する
+// 緊急地震速報(警報)のログファイルの"id"キーは文字列、発生した地震情報のログファイルの"id"キーは配列である
+void JsonEventStore::AddIndex(int row)
+{
+    const auto &object = m_Entries.at(row);
+
+    const auto id = object.value("id");
+    if (id.isArray()) {
+        for (const auto &value : id.toArray()) {
+            if (value.isString()) m_IDIndex[value.toString()].append(row);
+        }
+    }
+    else if (id.isString()) {
+        m_IDIndex[id.toString()].append(row);
+    }
+
+    const auto url = object.value("url").toString();
+    if (!url.isEmpty()) m_URLIndex[url].append(row);
+
+    const auto hypo = object.value("hypocentre").toString();
+    if (!hypo.isEmpty()) m_HypoIndex[hypo].append(row);
+
+    const auto prefs = object.value("prefs").toString("");
+    if (!prefs.isEmpty()) {
+        for (const auto &pref : prefs.split(",")) {
+            auto &rows = m_PrefIndex[pref];
+            if (rows.isEmpty() || rows.last() != row) rows.append(row);
+        }
+    }
+}
+
+
+// 指定した都道府県のいずれかを含むオブジェクトの位置を取得する
+// 位置はログファイルの順序 (昇順) で、重複しない
+QList<int> JsonEventStore::FindRows(const QStringList &prefs) const
+{
+    QList<int> rows;
+    for (const auto &pref : prefs) {
+        rows.append(m_PrefIndex.value(pref));
+    }
+
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    return rows;
+}
+
+
+// ロックを取得して、オブジェクトを変更後にジャーナルファイルへ追記する
+// functionは、オブジェクトを変更した場合に変更内容をレコードとして追加する (レコードが無い場合は書き込まない)
+template <typename Function>
+int JsonEventStore::Modify(int lockTimeout, Function function)
+{
+    quint64 sequence = 0;
+    {
+        // 書き込むため排他ロックを取得する
+        // ロックの解除を保証 (RAIIパターンを使用)
+        FileLock lock(m_LockName, FileLock::Mode::Exclusive, lockTimeout);
+        if (!lock.isLocked()) {
+            std::cerr << QString("エラー: %1[mS]以内にログファイルのロックの取得に失敗しました %2").arg(lockTimeout).arg(lock.errorString()).toStdString() << std::endl;
+            return -1;
+        }
+
+        QMutexLocker locker(&m_Mutex);
+
+        // 他のプロセスがログファイルを変更している場合は、変更する前に再度読み込む
+        if (IsChanged() && Load(true) != 0) return -1;
+
+        QList<QJsonObject> records;
+        function(records);
+        if (records.isEmpty()) return 0;
+
+        if (Commit(records) != 0) return -1;
+        sequence = m_WriteSequence.load();
+
+        ScheduleCompaction();
+
+        // lockのデストラクタが呼ばれてロックが解除される
+    }
+
+    // ロックを解除した後にディスクへ同期して、同期中も他のスレッドおよびプロセスの書き込みを待機させない
+    // 同期が終了するまで戻らないため、呼び出し元には従来と同じくディスクへ同期済みの状態で戻る
+    Sync(sequence);
+
+    return 0;
+}
+
+
+// 同じ地震IDが存在するかどうかを確認する
+int JsonEventStore::containsID(const QString &id, int lockTimeout)
+{
+    if (Refresh(lockTimeout) != 0) return -1;
+
+    QMutexLocker locker(&m_Mutex);
+
+    return m_IDIndex.contains(id) ? 1 : 0;
+}
+
+
+// 同じURLが存在するかどうかを確認する
+int JsonEventStore::containsURL(const QString &url, int lockTimeout)
+{
+    if (Refresh(lockTimeout) != 0) return -1;
+
+    QMutexLocker locker(&m_Mutex);
+
+    return m_URLIndex.contains(url) ? 1 : 0;
+}
+
+
+// 同じ地震IDかつ同じ報告日時 ("reportdatetime"キー) が存在するかどうかを確認する
+int JsonEventStore::containsReport(const QString &id, const QString &reportDateTime, int lockTimeout)
+{
+    if (Refresh(lockTimeout) != 0) return -1;
+
+    QMutexLocker locker(&m_Mutex);
+
+    const auto rows = m_IDIndex.value(id);
+
+    return std::any_of(rows.cbegin(), rows.cend(), [this, &reportDateTime](int row) {
+        return m_Entries.at(row).value("reportdatetime").toString() == reportDateTime;
+    }) ? 1 : 0;
+}
+
+
+// 同じ震源地のオブジェクトを取得する
+// 複数存在する場合は、ログファイルの先頭に近いオブジェクトを取得する
+int JsonEventStore::findByHypocentre(const QString &hypo, QJsonObject &object, int lockTimeout)
+{
+    if (Refresh(lockTimeout) != 0) return -1;
+
+    QMutexLocker locker(&m_Mutex);
+
+    const auto it = m_HypoIndex.constFind(hypo);
+    if (it == m_HypoIndex.constEnd() || it.value().isEmpty()) return 0;
+
+    object = m_Entries.at(it.value().first());
+
+    return 1;
+}
+
+
+// 同じ都道府県 (最大震度) を含む最初のオブジェクトを取得する
+// 各都道府県のインデックスの位置は昇順であるため、各都道府県の先頭の位置のうち最小の位置が最初のオブジェクトとなる
+// (全ての位置を集めてソートしないため、オブジェクト数に依存しない)
+int JsonEventStore::findByPrefs(const QStringList &prefs, QJsonObject &object, int lockTimeout)
+{
+    if (Refresh(lockTimeout) != 0) return -1;
+
+    QMutexLocker locker(&m_Mutex);
+
+    int first = -1;
+    for (const auto &pref : prefs) {
+        const auto it = m_PrefIndex.constFind(pref);
+        if (it == m_PrefIndex.constEnd() || it.value().isEmpty()) continue;
+
+        if (first < 0 || it.value().first() < first) first = it.value().first();
+    }
+
+    if (first < 0) return 0;
+
+    object = m_Entries.at(first);
+
+    return 1;
+}
+
+
+// オブジェクトを追加する
+int JsonEventStore::append(const QJsonObject &object, int lockTimeout)
+{
+    return Modify(lockTimeout, [this, &object](QList<QJsonObject> &records) {
+        auto newObject = object;
+        newObject["logged"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+        m_Entries.append(newObject);
+        AddIndex(static_cast<int>(m_Entries.size() - 1));
+
+        records.append(QJsonObject{{"op", "append"}, {"object", newObject}});
+    });
+}
+
+
+// 同じ震源地の全てのオブジェクトを変更する
+int JsonEventStore::updateByHypocentre(const QString &hypo, const std::function<void(QJsonObject&)> &update, int lockTimeout)
+{
+    return Modify(lockTimeout, [this, &hypo, &update](QList<QJsonObject> &records) {
+        const auto rows = m_HypoIndex.value(hypo);
+        if (rows.isEmpty()) return;
+
+        for (auto row : rows) {
+            update(m_Entries[row]);
+            m_Entries[row]["logged"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+            records.append(QJsonObject{{"op", "replace"}, {"row", row}, {"object", m_Entries.at(row)}});
+        }
+
+        // 変更したキーのインデックスを更新
+        BuildIndex();
+    });
+}
+
+
+// 同じ都道府県 (最大震度) を含む全てのオブジェクトを変更する
+// 各オブジェクトは、含まれる都道府県の数に関係なく1度だけ変更する
+int JsonEventStore::updateByPrefs(const QStringList &prefs, const std::function<void(QJsonObject&)> &update, int lockTimeout)
+{
+    return Modify(lockTimeout, [this, &prefs, &update](QList<QJsonObject> &records) {
+        const auto rows = FindRows(prefs);
+        if (rows.isEmpty()) return;
+
+        for (auto row : rows) {
+            update(m_Entries[row]);
+            m_Entries[row]["logged"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+            records.append(QJsonObject{{"op", "replace"}, {"row", row}, {"object", m_Entries.at(row)}});
+        }
+
+        // 変更したキーのインデックスを更新
+        BuildIndex();
+    });
+}
+
+
+// 同じ震源地の全てのオブジェクトを削除する
+int JsonEventStore::removeByHypocentre(const QString &hypo, int lockTimeout)
+{
+    return Modify(lockTimeout, [this, &hypo](QList<QJsonObject> &records) {
+        auto rows = m_HypoIndex.value(hypo);
+        if (rows.isEmpty()) return;
+
+        // 後方から削除する
+        std::sort(rows.begin(), rows.end(), std::greater<>());
+
+        QJsonArray removed;
+        for (auto row : std::as_const(rows)) {
+            m_Entries.removeAt(row);
+            removed.append(row);
+        }
+
+        BuildIndex();
+
+        records.append(QJsonObject{{"op", "remove"}, {"rows", removed}});
+    });
+}
+
+
+// 同じ都道府県 (最大震度) を含む全てのオブジェクトを削除する
+int JsonEventStore::removeByPrefs(const QStringList &prefs, int lockTimeout)
+{
+    return Modify(lockTimeout, [this, &prefs](QList<QJsonObject> &records) {
+        const auto rows = FindRows(prefs);
+        if (rows.isEmpty()) return;
+
+        // 後方から削除する
+        QJsonArray removed;
+        for (auto it = rows.crbegin(); it != rows.crend(); ++it) {
+            m_Entries.removeAt(*it);
+            removed.append(*it);
+        }
+
+        BuildIndex();
+
+        records.append(QJsonObject{{"op", "remove"}, {"rows", removed}});
+    });
+}
+
+
+// ジャーナルファイルの内容をスナップショットへ反映する
+// 通常はスレッドプールから呼び出される
+int JsonEventStore::compact(int lockTimeout)
+{
+    // ロックの解除を保証 (RAIIパターンを使用)
+    FileLock lock(m_LockName, FileLock::Mode::Exclusive, lockTimeout);
+    if (!lock.isLocked()) {
+        std::cerr << QString("エラー: %1[mS]以内にログファイルのロックの取得に失敗しました %2").arg(lockTimeout).arg(lock.errorString()).toStdString() << std::endl;
+
+        QMutexLocker locker(&m_Mutex);
+        m_bCompacting = false;
+
+        return -1;
+    }
+
+    QMutexLocker locker(&m_Mutex);
+    m_bCompacting = false;
+
+    // 他のプロセスがログファイルを変更している場合は、再度読み込んでからスナップショットへ反映する
+    if (IsChanged() && Load(true) != 0) return -1;
+
+    if (m_JournalRecords == 0 && !IsExpired()) return 0;
+
+    return Compact();
+}
+
+
+// 全てのオブジェクトを取得する
+// ログファイルの変換 (--convert-logオプション) に使用する
+int JsonEventStore::exportObjects(QList<QJsonObject> &objects, int lockTimeout)
+{
+    if (Refresh(lockTimeout) != 0) return -1;
+
+    QMutexLocker locker(&m_Mutex);
+
+    objects = m_Entries;
+
+    return 0;
+}
+
+
+// オブジェクトをまとめて追加する
+// 変換元の"logged"キー (最後に追加または変更した日時) を保持するため、保持期間は変換前から継続する
+int JsonEventStore::importObjects(const QList<QJsonObject> &objects, int lockTimeout)
+{
+    return Modify(lockTimeout, [this, &objects](QList<QJsonObject> &records) {
+        const auto now = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+        for (auto newObject : objects) {
+            if (!newObject.contains("logged")) newObject["logged"] = now;
+
+            m_Entries.append(newObject);
+            AddIndex(static_cast<int>(m_Entries.size() - 1));
+
+            records.append(QJsonObject{{"op", "append"}, {"object", newObject}});
+        }
+    });
+}
@@ -0,0 +1,120 @@
+#ifndef JSONEVENTSTORE_H
+#define JSONEVENTSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QByteArray>
+#include <QMutex>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "EventStore.h"
+
+
+// ログファイル (緊急地震速報(警報)および発生した地震情報) の内容をメモリ上に保持するクラス (JSON形式)
+// ログファイルは最初の検索時に1度だけ読み込み、地震ID、URL、震源地、最も震度の大きい都道府県をキーとするインデックスを作成する
+// 以降の検索はメモリ上のインデックスのみを使用するため、ログファイルの件数に依存しない
+//
+// ログファイルへの変更は、ログファイル自体 (スナップショット、JSON配列) を書き換えずに、
+// ジャーナルファイル (<ログファイル>.journal、JSON Lines形式) の末尾に1行ずつ追記する
+// 1回の変更で複数のレコードが発生する場合は、まとめて1回で書き込む
+// ディスクへの同期はロックを解除した後に行い、同時に追記した複数のスレッドのレコードは1回の同期にまとめる (グループコミット)
+//
+// ジャーナルファイルのレコード数またはサイズが閾値を超えた場合は、スレッドプールでコンパクション
+// (ジャーナルファイルの内容をスナップショットへ反映して、ジャーナルファイルを空にする) を行う
+// ジャーナルファイルの1行目には、ジャーナルファイルの起点となるスナップショットのハッシュ値を記録する
+// 読み込み時は、スナップショットのハッシュ値が一致する場合のみジャーナルファイルを再生するため、
+// コンパクションの途中で異常終了した場合でも、同じ変更を2回反映しない
+// ハッシュ値が一致しないジャーナルファイルは、削除せずに<ジャーナルファイル>.<日時>.orphanedへ退避する
+//
+// 従来の形式 (JSON配列のみ) のログファイルは、ジャーナルファイルが存在しないスナップショットとしてそのまま読み込む
+//
+// コンパクション時は、保持期間を過ぎたオブジェクトおよび最大数を超えたオブジェクトを削除する
+class JsonEventStore : public EventStore, public std::enable_shared_from_this<JsonEventStore>
+{
+private:    // Variables
+    QString                                         m_FileName;             // ログファイル (スナップショット) のパス
+    QString                                         m_JournalName;          // ジャーナルファイルのパス
+    QString                                         m_LockName;             // ロックファイルのパス (カーネルのアドバイザリロックを使用する)
+    mutable QMutex                                  m_Mutex;                // 以下のメンバ変数を保護するミューテックス
+    QList<QJsonObject>                              m_Entries;              // ログファイルの各オブジェクト (ログファイルの順序)
+    QHash<QString, QList<int>>                      m_IDIndex,              // 地震IDから各オブジェクトの位置を検索するインデックス
+                                                    m_URLIndex,             // URLから各オブジェクトの位置を検索するインデックス
+                                                    m_HypoIndex,            // 震源地から各オブジェクトの位置を検索するインデックス
+                                                    m_PrefIndex;            // 最も震度の大きい都道府県から各オブジェクトの位置を検索するインデックス
+    QDateTime                                       m_Modified,             // 読み込んだ時点のスナップショットの更新日時
+                                                    m_JournalModified;      // 読み込んだ時点のジャーナルファイルの更新日時
+    qint64                                          m_Size        = -1,     // 読み込んだ時点のスナップショットのサイズ (-1の場合は未読み込み)
+                                                    m_JournalSize = 0;      // 読み込んだ時点のジャーナルファイルのサイズ
+    QByteArray                                      m_SnapshotHash;         // スナップショットのハッシュ値 (ジャーナルファイルの起点)
+    int                                             m_JournalRecords = 0;   // ジャーナルファイルのレコード数
+    bool                                            m_bCompacting = false,  // コンパクションを予約済みかどうか
+                                                    m_bOrphanedJournal = false; // 起点となるスナップショットが一致しないジャーナルファイルを検出したかどうか
+    std::atomic<quint64>                            m_WriteSequence{0};     // ジャーナルファイルへ追記した回数 (追記ごとの通し番号)
+    QMutex                                          m_SyncMutex;            // ディスクへの同期を直列化するミューテックス (m_Mutexとは独立して取得する)
+    quint64                                         m_SyncedSequence = 0;   // ディスクへ同期済みの追記の通し番号 (m_SyncMutexで保護する)
+    qint64                                          m_InitialEntries = -1,  // 最初に読み込んだ時点のオブジェクト数 (-1の場合は未読み込み)
+                                                    m_InitialBytes   = 0,   // 最初に読み込んだ時点のスナップショットおよびジャーナルファイルのサイズ
+                                                    m_Expired        = 0,   // 保持期間または最大数により削除したオブジェクト数
+                                                    m_Compactions    = 0;   // コンパクションの回数
+
+    static constexpr int                            CompactRecords = 256;               // コンパクションを行うジャーナルファイルのレコード数
+    static constexpr qint64                         CompactBytes   = 1024 * 1024;       // コンパクションを行うジャーナルファイルのサイズ [Byte]
+
+private:    // Methods
+    [[nodiscard]] bool  IsChanged() const;                                          // ログファイルが読み込んだ後に変更されたかどうかを確認する
+    void                SaveFileState();                                            // ログファイルおよびジャーナルファイルの更新日時とサイズを保存する
+    int                 Refresh(int lockTimeout);                                   // ログファイルが変更されている場合は再度読み込む
+    int                 Load(bool bExclusive);                                      // ログファイルを読み込んで、インデックスを作成する (ロックの取得後に呼び出す)
+    int                 ReplayJournal();                                            // ジャーナルファイルのレコードを反映する (ロックの取得後に呼び出す)
+    bool                ApplyRecord(const QJsonObject &record);                     // ジャーナルファイルの1レコードを反映する
+    int                 SetAsideJournal();                                          // 起点となるスナップショットが一致しないジャーナルファイルを退避する (排他ロックの取得後に呼び出す)
+    int                 Commit(const QList<QJsonObject> &records);                  // ジャーナルファイルにレコードをまとめて追記する (ロックの取得後に呼び出す)
+    void                Sync(quint64 sequence);                                     // 指定した追記までのレコードをディスクへ同期する (他のスレッドの追記とまとめて同期する)
+    int                 Compact();                                                  // ジャーナルファイルの内容をスナップショットへ反映する (ロックの取得後に呼び出す)
+    void                ScheduleCompaction();                                       // 必要な場合は、スレッドプールでコンパクションを行う
+    [[nodiscard]] bool  IsExpired() const;                                          // 保持期間または最大数を超えたオブジェクトが存在するかどうかを確認する
+    int                 ApplyRetention();                                           // 保持期間または最大数を超えたオブジェクトを削除する
+    void                BuildIndex();                                               // 全てのオブジェクトのインデックスを作成する
+    void                AddIndex(int row);                                          // 指定した位置のオブジェクトをインデックスに追加する
+    [[nodiscard]] QList<int> FindRows(const QStringList &prefs) const;              // 指定した都道府県のいずれかを含むオブジェクトの位置を取得する (昇順)
+    template <typename Function>
+    int                 Modify(int lockTimeout, Function function);                 // ロックを取得して、オブジェクトを変更後にジャーナルファイルへ追記する
+
+public:     // Methods
+    explicit JsonEventStore(QString fileName);
+    ~JsonEventStore() override;
+
+    [[nodiscard]] EVENTSTORESTATS GetStats() const override;                        // ログファイルの統計を取得する
+
+    // 検索 (1 : 存在する, 0 : 存在しない, -1 : ログファイルの読み込みに失敗)
+    int     containsID(const QString &id, int lockTimeout) override;                // 同じ地震IDが存在するかどうかを確認する
+    int     containsURL(const QString &url, int lockTimeout) override;              // 同じURLが存在するかどうかを確認する
+    int     containsReport(const QString &id, const QString &reportDateTime,        // 同じ地震IDかつ同じ報告日時が存在するかどうかを確認する
+                           int lockTimeout) override;
+    int     findByHypocentre(const QString &hypo, QJsonObject &object,              // 同じ震源地のオブジェクトを取得する
+                             int lockTimeout) override;
+    int     findByPrefs(const QStringList &prefs, QJsonObject &object,              // 同じ都道府県 (最大震度) を含む最初のオブジェクトを取得する
+                        int lockTimeout) override;
+
+    // 変更 (0 : 成功, -1 : 失敗)
+    int     append(const QJsonObject &object, int lockTimeout) override;            // オブジェクトを追加する
+    int     updateByHypocentre(const QString &hypo,                                 // 同じ震源地の全てのオブジェクトを変更する
+                               const std::function<void(QJsonObject&)> &update, int lockTimeout) override;
+    int     updateByPrefs(const QStringList &prefs,                                 // 同じ都道府県 (最大震度) を含む全てのオブジェクトを変更する
+                          const std::function<void(QJsonObject&)> &update, int lockTimeout) override;
+    int     removeByHypocentre(const QString &hypo, int lockTimeout) override;      // 同じ震源地の全てのオブジェクトを削除する
+    int     removeByPrefs(const QStringList &prefs, int lockTimeout) override;      // 同じ都道府県 (最大震度) を含む全てのオブジェクトを削除する
+    int     compact(int lockTimeout) override;                                      // ジャーナルファイルの内容をスナップショットへ反映する
+
+    // 変換 (0 : 成功, -1 : 失敗)
+    int     exportObjects(QList<QJsonObject> &objects, int lockTimeout) override;       // 全てのオブジェクトを取得する (ログファイルの順序)
+    int     importObjects(const QList<QJsonObject> &objects, int lockTimeout) override; // オブジェクトをまとめて追加する ("logged"キーは保持する)
+};
+
+
+#endif // JSONEVENTSTORE_H
@@ -0,0 +1,119 @@
+#include <QtGlobal>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+    #include <QHttp1Configuration>
+#endif
+
+#include "NetworkAccess.h"
+
+
+QThreadStorage<NetworkAccess*>  NetworkAccess::s_Instances;
+NETWORKCONFIG                   NetworkAccess::s_Config;
+std::atomic<qint64>             NetworkAccess::s_Requests(0);
+std::atomic<qint64>             NetworkAccess::s_Handshakes(0);
+std::atomic<qint64>             NetworkAccess::s_Errors(0);
+
+
+NetworkAccess::NetworkAccess() : m_pManager(std::make_unique<QNetworkAccessManager>())
+{
+    // 全てのレスポンスを集計する
+    QObject::connect(m_pManager.get(), &QNetworkAccessManager::finished, m_pManager.get(), [](QNetworkReply *reply) {
+        s_Requests++;
+        if (reply->error() != QNetworkReply::NoError) s_Errors++;
+    });
+
+#if QT_CONFIG(ssl)
+    // TLSハンドシェイクは新規接続の場合のみ発生するため、接続が再利用されている場合は増加しない
+    QObject::connect(m_pManager.get(), &QNetworkAccessManager::encrypted, m_pManager.get(), [](QNetworkReply *) {
+        s_Handshakes++;
+    });
+#endif
+}
+
+
+NetworkAccess::~NetworkAccess() = default;
+
+
+// 現在のスレッドのHTTPクライアントを取得する
+// 存在しない場合は作成する (スレッドの終了時に自動的に破棄される)
+NetworkAccess& NetworkAccess::instance()
+{
+    if (!s_Instances.hasLocalData()) {
+        s_Instances.setLocalData(new NetworkAccess());
+    }
+
+    return *s_Instances.localData();
+}
+
+
+// HTTPクライアントの設定を変更する
+void NetworkAccess::setConfig(const NETWORKCONFIG &config)
+{
+    s_Config = config;
+}
+
+
+// 現在のスレッドで共用するネットワークオブジェクトを取得する
+// 各クラスは、このオブジェクトの所有権を持たない
+QNetworkAccessManager* NetworkAccess::manager()
+{
+    return instance().m_pManager.get();
+}
+
+
+// 共通の属性を設定したリクエストを作成する
+QNetworkRequest NetworkAccess::createRequest(const QUrl &url, int timeout)
+{
+    QNetworkRequest request(url);
+
+    // タイムアウトの設定 (0以下の場合はタイムアウトしない)
+    if (timeout > 0) request.setTransferTimeout(timeout);
+
+    // サーバが対応している場合はHTTP/2を使用する (Qt 5.15ではデフォルトで無効のため明示的に指定する)
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, s_Config.bHttp2);
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+    // HTTP/1.1の場合、ホストごとの最大接続数を設定
+    QHttp1Configuration http1Config;
+    http1Config.setNumberOfConnectionsPerHost(static_cast<qsizetype>(s_Config.MaxConnections));
+    request.setHttp1Configuration(http1Config);
+#endif
+
+    return request;
+}
+
+
+// 複数のオブジェクトで共有するリクエストとして登録する
+// 共有するリクエスト (デーモンモードにおける地震情報の取得) は、送信したスレッドの処理をキャンセルした場合でも中断しない
+void NetworkAccess::setShared(QNetworkReply *pReply)
+{
+    pReply->setProperty(SharedProperty, true);
+}
+
+
+// 現在のスレッドで送信中の全てのリクエストを中断する
+// レスポンスを待機している各処理には、finishedシグナル (OperationCanceledError) が送信される
+// ただし、他のスレッドのオブジェクトもレスポンスを待機している共有するリクエストは中断しない
+void NetworkAccess::abortAll()
+{
+    if (!s_Instances.hasLocalData()) return;
+
+    // QNetworkReplyオブジェクトは、ネットワークオブジェクトの子オブジェクトとして作成される
+    const auto replies = s_Instances.localData()->m_pManager->findChildren<QNetworkReply*>();
+    for (auto *pReply : replies) {
+        if (pReply->isRunning() && !pReply->property(SharedProperty).toBool()) pReply->abort();
+    }
+}
+
+
+// HTTPクライアントの統計を取得する
+// 全てのスレッドの合計値を返す
+NETWORKSTATS NetworkAccess::GetStats()
+{
+    NETWORKSTATS stats;
+    stats.Requests   = s_Requests.load();
+    stats.Handshakes = s_Handshakes.load();
+    stats.Errors     = s_Errors.load();
+
+    return stats;
+}
@@ -0,0 +1,61 @@
+#ifndef NETWORKACCESS_H
+#define NETWORKACCESS_H
+
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QThreadStorage>
+#include <QUrl>
+#include <atomic>
+#include <memory>
+
+
+// HTTPクライアントの設定
+struct NETWORKCONFIG {
+    bool            bHttp2             = true;  // HTTP/2を使用するかどうか (サーバが対応している場合のみ)
+    int             MaxConnections     = 6;     // ホストごとの最大接続数 (HTTP/1.1のみ、Qt 6.5以降で有効)
+};
+
+
+// HTTPクライアントの統計
+struct NETWORKSTATS {
+    qint64          Requests   = 0,     // 送信したリクエスト数
+                    Handshakes = 0,     // TLSハンドシェイクの回数 (新規接続の回数)
+                    Errors     = 0;     // エラーとなったリクエスト数
+};
+
+
+// 本ソフトウェアの全てのクラスで共用するHTTPクライアント
+// QNetworkAccessManagerクラスは生成したスレッドでのみ使用できるため、スレッドごとに1つのオブジェクトを保持する
+// 同じオブジェクトを使い続けることにより、Keep-Alive接続およびTLSセッションが再利用される
+class NetworkAccess
+{
+private:    // Variables
+    std::unique_ptr<QNetworkAccessManager>  m_pManager;         // このスレッドで共用するネットワークオブジェクト
+
+    static constexpr char                   SharedProperty[] = "qEQAlertShared";    // 共有するリクエストに設定するプロパティ名
+
+    static QThreadStorage<NetworkAccess*>   s_Instances;        // スレッドごとのHTTPクライアント
+    static NETWORKCONFIG                    s_Config;           // HTTPクライアントの設定 (設定ファイルの読み込み時のみ変更する)
+    static std::atomic<qint64>              s_Requests,         // 全てのスレッドにおける送信したリクエスト数
+                                            s_Handshakes,       // 全てのスレッドにおけるTLSハンドシェイクの回数
+                                            s_Errors;           // 全てのスレッドにおけるエラーとなったリクエスト数
+
+private:    // Methods
+    NetworkAccess();                                                        // コンストラクタ
+    static NetworkAccess&           instance();                             // 現在のスレッドのHTTPクライアントを取得する
+
+public:     // Methods
+    ~NetworkAccess();                                                       // デストラクタ
+    NetworkAccess(const NetworkAccess&)            = delete;
+    NetworkAccess& operator=(const NetworkAccess&) = delete;
+
+    static void                     setConfig(const NETWORKCONFIG &config);             // HTTPクライアントの設定を変更する
+    static QNetworkAccessManager*   manager();                                          // 現在のスレッドで共用するネットワークオブジェクトを取得する
+    static QNetworkRequest          createRequest(const QUrl &url, int timeout = 3000); // 共通の属性を設定したリクエストを作成する
+    static void                     setShared(QNetworkReply *pReply);                   // 複数のオブジェクトで共有するリクエストとして登録する (abortAll()メソッドで中断しない)
+    static void                     abortAll();                                         // 現在のスレッドで送信中のリクエスト (共有するリクエストを除く) を中断する
+    [[nodiscard]] static NETWORKSTATS GetStats();                                       // HTTPクライアントの統計を取得する
+};
+
+#endif // NETWORKACCESS_H
@@ -0,0 +1,335 @@
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QUuid>
+#include <algorithm>
+#include <iostream>
+#include "Outbox.h"
+
+
+QMutex                                                  Outbox::s_Mutex;
+QList<OUTBOXENTRY>                                      Outbox::s_Entries;
+QHash<QString, std::chrono::steady_clock::time_point>   Outbox::s_LastPosts;
+OUTBOXCONFIG                                            Outbox::s_Config;
+std::atomic<qint64>                                     Outbox::s_Enqueued(0);
+std::atomic<qint64>                                     Outbox::s_Recovered(0);
+std::atomic<qint64>                                     Outbox::s_Retries(0);
+std::atomic<qint64>                                     Outbox::s_Delivered(0);
+std::atomic<qint64>                                     Outbox::s_Dropped(0);
+
+
+// 送信待ちの書き込みの設定を変更する
+// 設定ファイルの読み込み時 (各スレッドの開始前) に呼び出すこと
+void Outbox::setConfig(const OUTBOXCONFIG &config)
+{
+    s_Config = config;
+}
+
+
+// 送信待ちの書き込みを使用するかどうかを確認する
+// 使用しない場合は、従来通り次回の地震情報の取得時に同じ地震情報を再処理する
+bool Outbox::isEnabled()
+{
+    return s_Config.Retries > 0 && !s_Config.FileName.isEmpty();
+}
+
+
+// ファイルから送信待ちの書き込みを読み込む
+// 前回の終了時 (異常終了を含む) に送信できなかった書き込みは、各地震情報オブジェクトの開始後に再送する
+int Outbox::load()
+{
+    if (!isEnabled()) return 0;
+
+    QFile File(s_Config.FileName);
+    if (!File.exists()) return 0;
+
+    if (!File.open(QIODevice::ReadOnly)) {
+        std::cerr << QString("エラー : 送信待ちの書き込みのファイルを開けません %1").arg(File.errorString()).toStdString() << std::endl;
+        return -1;
+    }
+
+    QJsonParseError error;
+    const auto      document = QJsonDocument::fromJson(File.readAll(), &error);
+    File.close();
+
+    if (error.error != QJsonParseError::NoError || !document.isArray()) {
+        std::cerr << QString("エラー : 送信待ちの書き込みのファイルが不正です %1").arg(error.errorString()).toStdString() << std::endl;
+        return -1;
+    }
+
+    QMutexLocker locker(&s_Mutex);
+
+    s_Entries.clear();
+
+    const auto array = document.array();
+    for (const auto &value : array) {
+        auto entry = FromJson(value.toObject());
+        if (entry.ID.isEmpty() || entry.Owner.isEmpty()) continue;
+
+        // 再起動後は直ちに再送する (期限を過ぎた書き込みは、再送する前に破棄する)
+        entry.NextAttempt = QDateTime::currentDateTimeUtc();
+        Insert(entry);
+    }
+
+    s_Recovered += s_Entries.size();
+
+    if (!s_Entries.isEmpty()) {
+        std::cout << QString("送信待ちの書き込みを読み込みました (%1 件)").arg(s_Entries.size()).toStdString() << std::endl;
+    }
+
+    return 0;
+}
+
+
+// 送信待ちの書き込みに追加して、再送までの待機時間 [mS] を返す
+// 書き込みに失敗した回数が0の場合 (先に追加した書き込みの再送を待つ場合) は、直ちに再送できる
+qint64 Outbox::enqueue(OUTBOXENTRY entry)
+{
+    const auto now = QDateTime::currentDateTimeUtc();
+
+    entry.ID          = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    entry.NextAttempt = entry.Attempts > 0 ? now.addMSecs(Backoff(entry)) : now;
+
+    QMutexLocker locker(&s_Mutex);
+
+    Insert(entry);
+    Save();
+
+    s_Enqueued++;
+
+    return std::max<qint64>(now.msecsTo(entry.NextAttempt), 0);
+}
+
+
+// 再送する書き込みを取得する
+// 同じ地震情報オブジェクトの書き込みは、追加した順に1件ずつ再送する (発生した地震情報において、スレッドの新規作成と書き込みの順序を保つため)
+// 同じ掲示板に、他の地震情報オブジェクトの優先度の高い書き込みが存在する場合は、その再送を待機する
+//
+// 取得した書き込みは、finishメソッドを呼び出すまでファイルに残す (再送中に異常終了した場合も再起動後に再送する)
+qint64 Outbox::takeDue(const QString &owner, OUTBOXENTRY &entry)
+{
+    const auto now = QDateTime::currentDateTimeUtc();
+
+    QMutexLocker locker(&s_Mutex);
+
+    // 期限を過ぎた書き込みを破棄する
+    auto bRemoved = false;
+    for (auto it = s_Entries.begin(); it != s_Entries.end();) {
+        if (!it->Expires.isValid() || it->Expires > now) {
+            ++it;
+            continue;
+        }
+
+        std::cerr << QString("エラー : 送信待ちの書き込みが期限を過ぎたため破棄します (%1回失敗) : %2").arg(it->Attempts).arg(it->ThreadInfo.subject).toStdString() << std::endl;
+
+        it       = s_Entries.erase(it);
+        bRemoved = true;
+        s_Dropped++;
+    }
+
+    if (bRemoved) Save();
+
+    auto head = std::find_if(s_Entries.cbegin(), s_Entries.cend(), [&owner](const OUTBOXENTRY &e) { return e.Owner == owner; });
+    if (head == s_Entries.cend()) return -1;
+
+    // 同じ掲示板の優先度の高い書き込みが再送可能な場合は、先に再送させる
+    for (auto it = s_Entries.cbegin(); it != head; ++it) {
+        if (it->Board == head->Board && it->Priority < head->Priority && it->NextAttempt <= now) return YieldDelay;
+    }
+
+    auto wait = std::max(now.msecsTo(head->NextAttempt), RateLimit(head->Board));
+    if (wait > 0) return wait;
+
+    entry = *head;
+    s_Retries++;
+
+    return 0;
+}
+
+
+// 再送の結果を記録する
+// 失敗した場合は、再送の最大回数を超えるまで次回の再送を予約する
+void Outbox::finish(const OUTBOXENTRY &entry, bool bDelivered)
+{
+    QMutexLocker locker(&s_Mutex);
+
+    auto it = std::find_if(s_Entries.begin(), s_Entries.end(), [&entry](const OUTBOXENTRY &e) { return e.ID == entry.ID; });
+    if (it == s_Entries.end()) return;
+
+    if (bDelivered) {
+        s_Entries.erase(it);
+        s_Delivered++;
+    }
+    else if (++it->Attempts > s_Config.Retries) {
+        std::cerr << QString("エラー : 再送の最大回数を超えたため、送信待ちの書き込みを破棄します (%1回失敗) : %2").arg(it->Attempts).arg(it->ThreadInfo.subject).toStdString() << std::endl;
+
+        s_Entries.erase(it);
+        s_Dropped++;
+    }
+    else {
+        it->NextAttempt = QDateTime::currentDateTimeUtc().addMSecs(Backoff(*it));
+    }
+
+    Save();
+}
+
+
+// 掲示板に書き込んだ時刻を記録する
+// 最初の書き込みは待機しないが、以降の再送は設定した間隔以上空ける
+void Outbox::recordPost(const QString &board)
+{
+    QMutexLocker locker(&s_Mutex);
+
+    s_LastPosts.insert(board, std::chrono::steady_clock::now());
+}
+
+
+// 送信待ちの書き込みが存在するかどうかを確認する
+bool Outbox::hasPending(const QString &owner)
+{
+    QMutexLocker locker(&s_Mutex);
+
+    return std::any_of(s_Entries.cbegin(), s_Entries.cend(), [&owner](const OUTBOXENTRY &e) { return e.Owner == owner; });
+}
+
+
+// 同じ地震情報が送信待ちの書き込みに存在するかどうかを確認する
+// 再起動後の最初の取得時に、送信待ちの地震情報を重複して書き込まないようにする
+bool Outbox::contains(const QString &owner, const QString &key)
+{
+    if (key.isEmpty()) return false;
+
+    QMutexLocker locker(&s_Mutex);
+
+    return std::any_of(s_Entries.cbegin(), s_Entries.cend(), [&owner, &key](const OUTBOXENTRY &e) { return e.Owner == owner && e.Key == key; });
+}
+
+
+// 送信待ちの書き込みの統計を取得する
+OUTBOXSTATS Outbox::GetStats()
+{
+    OUTBOXSTATS stats;
+    stats.Enqueued  = s_Enqueued.load();
+    stats.Recovered = s_Recovered.load();
+    stats.Retries   = s_Retries.load();
+    stats.Delivered = s_Delivered.load();
+    stats.Dropped   = s_Dropped.load();
+
+    QMutexLocker locker(&s_Mutex);
+    stats.Pending   = s_Entries.size();
+
+    return stats;
+}
+
+
+// 送信待ちの書き込みをファイルに保存する
+// 保存に失敗した場合も、メモリ上の送信待ちの書き込みは再送する
+void Outbox::Save()
+{
+    QJsonArray array;
+    for (const auto &entry : std::as_const(s_Entries)) {
+        array.append(ToJson(entry));
+    }
+
+    const auto data = QJsonDocument(array).toJson();
+
+    QSaveFile File(s_Config.FileName);
+    if (!File.open(QIODevice::WriteOnly) || File.write(data) != data.size() || !File.commit()) {
+        std::cerr << QString("警告 : 送信待ちの書き込みの保存に失敗しました %1").arg(File.errorString()).toStdString() << std::endl;
+    }
+}
+
+
+// 優先度順を保つ位置に追加する
+// 同じ優先度の書き込みは、追加した順に並べる
+void Outbox::Insert(const OUTBOXENTRY &entry)
+{
+    auto it = std::find_if(s_Entries.begin(), s_Entries.end(), [&entry](const OUTBOXENTRY &e) { return e.Priority > entry.Priority; });
+    s_Entries.insert(it, entry);
+}
+
+
+// 失敗した回数に応じた再送までの待機時間 [mS] を取得する
+// 待機時間は失敗するごとに2倍 (最大60[秒]) にして、最大で25[%]ずらす
+int Outbox::Backoff(const OUTBOXENTRY &entry)
+{
+    qint64 delay = entry.Priority == 0 ? AlertRetryDelay : InfoRetryDelay;
+    for (auto i = 1; i < entry.Attempts && delay < MaxRetryDelay; i++) {
+        delay *= 2;
+    }
+
+    delay = std::min<qint64>(delay, MaxRetryDelay);
+
+    return static_cast<int>(delay + QRandomGenerator::global()->bounded(delay / 4 + 1));
+}
+
+
+// 同じ掲示板へ書き込めるまでの待機時間 [mS] を取得する
+qint64 Outbox::RateLimit(const QString &board)
+{
+    auto it = s_LastPosts.constFind(board);
+    if (it == s_LastPosts.constEnd()) return 0;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - it.value()).count();
+
+    return std::max<qint64>(s_Config.Interval - static_cast<qint64>(elapsed), 0);
+}
+
+
+// 送信待ちの書き込みをJSONオブジェクトへ変換する
+// 送信時刻 (エポックタイム) は、再送時に更新するため保存しない
+QJsonObject Outbox::ToJson(const OUTBOXENTRY &entry)
+{
+    QJsonObject thread;
+    thread["subject"]  = entry.ThreadInfo.subject;
+    thread["from"]     = entry.ThreadInfo.from;
+    thread["mail"]     = entry.ThreadInfo.mail;
+    thread["message"]  = entry.ThreadInfo.message;
+    thread["bbs"]      = entry.ThreadInfo.bbs;
+    thread["key"]      = entry.ThreadInfo.key;
+    thread["shiftjis"] = entry.ThreadInfo.shiftjis;
+
+    QJsonObject object;
+    object["id"]          = entry.ID;
+    object["owner"]       = entry.Owner;
+    object["key"]         = entry.Key;
+    object["board"]       = entry.Board;
+    object["priority"]    = entry.Priority;
+    object["thread"]      = thread;
+    object["event"]       = entry.Event;
+    object["attempts"]    = entry.Attempts;
+    object["nextattempt"] = entry.NextAttempt.toString(Qt::ISODateWithMs);
+    object["expires"]     = entry.Expires.toString(Qt::ISODateWithMs);
+
+    return object;
+}
+
+
+// JSONオブジェクトから送信待ちの書き込みを作成する
+OUTBOXENTRY Outbox::FromJson(const QJsonObject &object)
+{
+    const auto thread = object["thread"].toObject();
+
+    OUTBOXENTRY entry;
+    entry.ID                  = object["id"].toString();
+    entry.Owner               = object["owner"].toString();
+    entry.Key                 = object["key"].toString();
+    entry.Board               = object["board"].toString();
+    entry.Priority            = object["priority"].toInt(1);
+    entry.ThreadInfo.subject  = thread["subject"].toString();
+    entry.ThreadInfo.from     = thread["from"].toString();
+    entry.ThreadInfo.mail     = thread["mail"].toString();
+    entry.ThreadInfo.message  = thread["message"].toString();
+    entry.ThreadInfo.bbs      = thread["bbs"].toString();
+    entry.ThreadInfo.key      = thread["key"].toString();
+    entry.ThreadInfo.shiftjis = thread["shiftjis"].toBool(true);
+    entry.Event               = object["event"].toObject();
+    entry.Attempts            = object["attempts"].toInt(0);
+    entry.NextAttempt         = QDateTime::fromString(object["nextattempt"].toString(), Qt::ISODateWithMs);
+    entry.Expires             = QDateTime::fromString(object["expires"].toString(), Qt::ISODateWithMs);
+
+    return entry;
+}
@@ -0,0 +1,102 @@
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QMutex>
+#include <atomic>
+#include <chrono>
+#include "Poster.h"
+
+
+// 送信待ちの書き込みの設定
+struct OUTBOXCONFIG {
+    QString         FileName;           // 送信待ちの書き込みを保存するファイルのパス
+    int             Retries  = 5,       // 再送の最大回数 (0の場合は送信待ちの書き込みを使用しない)
+                    Interval = 3000;    // 同じ掲示板へ書き込む間隔の最小値 [mS]
+};
+
+
+// 送信待ちの書き込み
+// 書き込みに失敗した地震情報は、スレッド情報および地震情報をファイルに保存して、書き込みに成功するまで再送する
+struct OUTBOXENTRY {
+    QString         ID,                 // 書き込みの識別子
+                    Owner,              // 再送する地震情報オブジェクト (ログファイルのパス)
+                    Key,                // 地震情報の識別子 (同じ地震情報を重複して追加しないために使用する)
+                    Board;              // 書き込み先の掲示板 (書き込み用URLおよびBBS名)
+    int             Priority = 1;       // 優先度 (0 : 緊急地震速報(警報), 1 : 発生した地震情報)
+    THREAD_INFO     ThreadInfo;         // 送信するスレッド情報
+    QJsonObject     Event;              // 書き込みの成功後にログファイルへ保存する地震情報
+    int             Attempts = 0;       // 書き込みに失敗した回数
+    QDateTime       NextAttempt,        // 次回の再送の日時 (UTC)
+                    Expires;            // 再送の期限 (UTC) (期限を過ぎた場合は破棄する)
+};
+
+
+// 送信待ちの書き込みの統計
+struct OUTBOXSTATS {
+    qint64          Enqueued  = 0,      // 送信待ちの書き込みに追加した回数
+                    Recovered = 0,      // 起動時に読み込んだ送信待ちの書き込みの数
+                    Retries   = 0,      // 再送した回数
+                    Delivered = 0,      // 再送により書き込みに成功した回数
+                    Dropped   = 0,      // 再送の最大回数または期限を超えたため破棄した回数
+                    Pending   = 0;      // 現在の送信待ちの書き込みの数
+};
+
+
+// 送信待ちの書き込み (アウトボックス)
+// 書き込みに失敗した場合 (タイムアウト、サーバエラー、クッキーの拒否等) は、地震情報を破棄せずに送信待ちの書き込みに追加する
+// 送信待ちの書き込みはファイルに保存するため、再起動後も再送する
+//
+// 再送の間隔は失敗するごとに2倍 (最大60[秒]) にして、同時に再送しないように最大で25[%]ずらす
+// 同じ掲示板への書き込みは設定した間隔以上空けて、緊急地震速報(警報)を発生した地震情報より優先して再送する
+// 緊急地震速報(警報)のオブジェクトと発生した地震情報のオブジェクトは別のスレッドで実行されるため、全てのメソッドはスレッドセーフである
+class Outbox
+{
+private:    // Variables
+    static QMutex                                               s_Mutex;        // 送信待ちの書き込みを保護するミューテックス
+    static QList<OUTBOXENTRY>                                   s_Entries;      // 送信待ちの書き込み (優先度順、同じ優先度の場合は追加した順)
+    static QHash<QString, std::chrono::steady_clock::time_point> s_LastPosts;   // 掲示板ごとの最後に書き込んだ時刻
+    static OUTBOXCONFIG                                         s_Config;       // 送信待ちの書き込みの設定 (設定ファイルの読み込み時のみ変更する)
+    static std::atomic<qint64>                                  s_Enqueued,     // 送信待ちの書き込みに追加した回数
+                                                                s_Recovered,    // 起動時に読み込んだ送信待ちの書き込みの数
+                                                                s_Retries,      // 再送した回数
+                                                                s_Delivered,    // 再送により書き込みに成功した回数
+                                                                s_Dropped;      // 再送の最大回数または期限を超えたため破棄した回数
+
+    static constexpr int                                        AlertRetryDelay = 1000;     // 緊急地震速報(警報)の最初の再送までの待機時間 [mS]
+    static constexpr int                                        InfoRetryDelay  = 5000;     // 発生した地震情報の最初の再送までの待機時間 [mS]
+    static constexpr int                                        MaxRetryDelay   = 60000;    // 再送までの待機時間の最大値 [mS]
+    static constexpr int                                        YieldDelay      = 500;      // 優先度の高い書き込みを待機する時間 [mS]
+
+private:    // Methods
+    static void         Save();                                                 // 送信待ちの書き込みをファイルに保存する (ミューテックスの取得後に呼び出す)
+    static void         Insert(const OUTBOXENTRY &entry);                       // 優先度順を保つ位置に追加する (ミューテックスの取得後に呼び出す)
+    static int          Backoff(const OUTBOXENTRY &entry);                      // 失敗した回数に応じた再送までの待機時間 [mS] を取得する
+    static qint64       RateLimit(const QString &board);                        // 同じ掲示板へ書き込めるまでの待機時間 [mS] を取得する (ミューテックスの取得後に呼び出す)
+    static QJsonObject  ToJson(const OUTBOXENTRY &entry);                       // 送信待ちの書き込みをJSONオブジェクトへ変換する
+    static OUTBOXENTRY  FromJson(const QJsonObject &object);                    // JSONオブジェクトから送信待ちの書き込みを作成する
+
+public:     // Methods
+    Outbox()                            = delete;
+    Outbox(const Outbox&)               = delete;
+    Outbox& operator=(const Outbox&)    = delete;
+
+    static void     setConfig(const OUTBOXCONFIG &config);                      // 送信待ちの書き込みの設定を変更する
+    [[nodiscard]] static bool   isEnabled();                                    // 送信待ちの書き込みを使用するかどうかを確認する
+    static int      load();                                                     // ファイルから送信待ちの書き込みを読み込む (起動時に呼び出す)
+    static qint64   enqueue(OUTBOXENTRY entry);                                 // 送信待ちの書き込みに追加して、再送までの待機時間 [mS] を返す
+    static qint64   takeDue(const QString &owner, OUTBOXENTRY &entry);          // 再送する書き込みを取得する
+                                                                                // 0 : 取得した, 0より大きい値 : 再送までの待機時間 [mS], -1 : 送信待ちの書き込みが無い
+    static void     finish(const OUTBOXENTRY &entry, bool bDelivered);          // 再送の結果を記録する (失敗した場合は次回の再送を予約する)
+    static void     recordPost(const QString &board);                           // 掲示板に書き込んだ時刻を記録する (全ての書き込みで呼び出す)
+    [[nodiscard]] static bool   hasPending(const QString &owner);               // 送信待ちの書き込みが存在するかどうかを確認する
+    [[nodiscard]] static bool   contains(const QString &owner, const QString &key); // 同じ地震情報が送信待ちの書き込みに存在するかどうかを確認する
+    [[nodiscard]] static OUTBOXSTATS GetStats();                                // 送信待ちの書き込みの統計を取得する
+};
+
+
+#endif // OUTBOX_H
@@ -0,0 +1,233 @@
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QRandomGenerator>
+#include <iostream>
+#include <algorithm>
+#include <utility>
+#include "P2PWebSocket.h"
+
+
+P2PWebSocket::P2PWebSocket(QUrl url, QObject *parent) : m_pSocket(std::make_unique<QWebSocket>()), m_Url(std::move(url)),
+    m_Backoff(MinBackoff), m_bStopped(true), m_bConnectedOnce(false), m_bPongReceived(true),
+    m_Received(0), m_Duplicates(0), m_Reconnects(0), QObject{parent}
+{
+    connect(m_pSocket.get(), &QWebSocket::connected,           this, &P2PWebSocket::onConnected);
+    connect(m_pSocket.get(), &QWebSocket::disconnected,        this, &P2PWebSocket::onDisconnected);
+    connect(m_pSocket.get(), &QWebSocket::textMessageReceived, this, &P2PWebSocket::onTextMessageReceived);
+    connect(m_pSocket.get(), &QWebSocket::pong,                this, &P2PWebSocket::onPong);
+
+    // 接続に失敗した場合はdisconnectedシグナルが送信されないため、エラーの発生時にも再接続する
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+    connect(m_pSocket.get(), &QWebSocket::errorOccurred,       this, &P2PWebSocket::onError);
+#else
+    connect(m_pSocket.get(), QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::error), this, &P2PWebSocket::onError);
+#endif
+
+    m_ReconnectTimer.setSingleShot(true);
+    connect(&m_ReconnectTimer, &QTimer::timeout, this, [this]() {
+        if (!m_bStopped) m_pSocket->open(m_Url);
+    });
+
+    m_PingTimer.setInterval(PingInterval);
+    connect(&m_PingTimer, &QTimer::timeout, this, &P2PWebSocket::onPingTimeout);
+}
+
+
+P2PWebSocket::~P2PWebSocket()
+{
+    stop();
+}
+
+
+// WebSocket APIへの接続を開始する
+void P2PWebSocket::start()
+{
+    m_bStopped = false;
+    m_Backoff  = MinBackoff;
+
+    m_pSocket->open(m_Url);
+}
+
+
+// WebSocket APIとの接続を終了する (再接続も行わない)
+void P2PWebSocket::stop()
+{
+    m_bStopped = true;
+
+    m_ReconnectTimer.stop();
+    m_PingTimer.stop();
+
+    m_pSocket->close();
+}
+
+
+// 接続した場合
+void P2PWebSocket::onConnected()
+{
+#ifdef _DEBUG
+    std::cout << QString("P2P地震情報のWebSocket APIに接続しました : %1").arg(m_Url.toString()).toStdString() << std::endl;
+#endif
+
+    // 再接続の待機時間を初期化
+    m_Backoff       = MinBackoff;
+    m_bPongReceived = true;
+    m_PingTimer.start();
+
+    // 切断中に配信された地震情報は再配信されないため、再接続した場合は通知する
+    if (m_bConnectedOnce) {
+        m_Reconnects++;
+        emit reconnected();
+    }
+
+    m_bConnectedOnce = true;
+}
+
+
+// 切断された場合
+void P2PWebSocket::onDisconnected()
+{
+    m_PingTimer.stop();
+
+    if (m_bStopped) return;
+
+    std::cerr << QString("警告 : P2P地震情報のWebSocket APIから切断されました %1").arg(m_pSocket->errorString()).toStdString() << std::endl;
+
+    ScheduleReconnect();
+}
+
+
+// エラーが発生した場合
+void P2PWebSocket::onError([[maybe_unused]] QAbstractSocket::SocketError error)
+{
+    if (m_bStopped) return;
+
+    // 接続中の場合は、disconnectedシグナルで再接続する
+    if (m_pSocket->state() != QAbstractSocket::UnconnectedState) return;
+
+    std::cerr << QString("警告 : P2P地震情報のWebSocket APIへの接続に失敗しました %1").arg(m_pSocket->errorString()).toStdString() << std::endl;
+
+    ScheduleReconnect();
+}
+
+
+// 待機時間の経過後に再接続する
+// 待機時間は、切断されるごとに2倍 (最大60[秒]) にする
+// また、複数の受信プログラムが同時に再接続しないように、待機時間を最大で25[%]ずらす
+void P2PWebSocket::ScheduleReconnect()
+{
+    if (m_ReconnectTimer.isActive()) return;
+
+    auto jitter = static_cast<int>(QRandomGenerator::global()->bounded(m_Backoff / 4 + 1));
+    m_ReconnectTimer.start(m_Backoff + jitter);
+
+    std::cerr << QString("%1[mS]後に再接続します").arg(m_Backoff + jitter).toStdString() << std::endl;
+
+    m_Backoff = std::min(m_Backoff * 2, MaxBackoff);
+}
+
+
+// 接続の生存を確認する
+// 前回のPingに対してPongを受信していない場合は、接続が失われたと判断して切断する (切断後に再接続する)
+void P2PWebSocket::onPingTimeout()
+{
+    if (!m_bPongReceived) {
+        std::cerr << QString("警告 : P2P地震情報のWebSocket APIから応答がありません").toStdString() << std::endl;
+        m_pSocket->abort();
+
+        return;
+    }
+
+    m_bPongReceived = false;
+    m_pSocket->ping();
+}
+
+
+void P2PWebSocket::onPong([[maybe_unused]] quint64 elapsedTime, [[maybe_unused]] const QByteArray &payload)
+{
+    m_bPongReceived = true;
+}
+
+
+// 地震情報を受信した場合
+void P2PWebSocket::onTextMessageReceived(const QString &message)
+{
+    QJsonParseError parseError;
+    auto doc = QJsonDocument::fromJson(message.toUtf8(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        std::cerr << QString("エラー : P2P地震情報のWebSocket APIから受信したデータに異常があります %1").arg(parseError.errorString()).toStdString() << std::endl;
+        return;
+    }
+
+    auto obj = doc.object();
+
+    // "code"キーを確認
+    // 556 : 緊急地震速報(警報)
+    // 551 : 発生した地震情報
+    // それ以外の情報 (津波予報、緊急地震速報の発表検出等) は無視する
+    auto code = obj["code"].toInt();
+    if (code != 556 && code != 551) return;
+
+    // WebSocket APIでは、地震情報のIDのキーが"_id"キーとなっているため、JSON APIと同じ"id"キーに変換する
+    if (!obj.contains("id")) obj["id"] = obj["_id"];
+
+    auto id = obj["id"].toString();
+    if (id.isEmpty()) return;
+
+    // 同じ地震情報が複数回配信された場合は無視する
+    if (IsDuplicate(id)) {
+        m_Duplicates++;
+
+#ifdef _DEBUG
+        std::cout << QString("重複した地震情報を破棄しました : %1").arg(id).toStdString() << std::endl;
+#endif
+
+        return;
+    }
+
+    m_Received++;
+
+    // JSON APIと同じ形式 (1件のみの配列) に変換して通知する
+    QJsonArray array;
+    array.append(obj);
+
+    emit messageReceived(code, QJsonDocument(array).toJson(QJsonDocument::Compact));
+}
+
+
+// 既に受信した地震情報かどうかを確認する
+// 保持するIDの数には上限があり、上限を超えた場合は古いIDから破棄する
+bool P2PWebSocket::IsDuplicate(const QString &id)
+{
+    if (m_ReceivedIDs.contains(id)) return true;
+
+    m_ReceivedIDs.insert(id);
+    m_ReceivedOrder.enqueue(id);
+
+    while (m_ReceivedOrder.size() > MaxReceivedIDs) {
+        m_ReceivedIDs.remove(m_ReceivedOrder.dequeue());
+    }
+
+    return false;
+}
+
+
+// 受信した地震情報の数を取得する
+qint64 P2PWebSocket::GetReceived() const
+{
+    return m_Received;
+}
+
+
+// 重複により破棄した地震情報の数を取得する
+qint64 P2PWebSocket::GetDuplicates() const
+{
+    return m_Duplicates;
+}
+
+
+// 再接続の回数を取得する
+qint64 P2PWebSocket::GetReconnects() const
+{
+    return m_Reconnects;
+}
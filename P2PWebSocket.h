@@ -0,0 +1,70 @@
+#ifndef P2PWEBSOCKET_H
+#define P2PWEBSOCKET_H
+
+#include <QObject>
+#include <QWebSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QSet>
+#include <QQueue>
+#include <memory>
+
+
+// P2P地震情報のWebSocket APIから地震情報を受信するクラス
+// JSON APIのポーリング (約1000[ms]の遅延) とは異なり、配信された地震情報を約70[ms]で受信できる
+//
+// サーバや受信プログラムの障害時は切断されるため、指数関数的に待機時間を延ばしながら再接続する
+// また、同じ地震情報が複数回配信される場合があるため、受信した地震情報のIDで重複を除去する
+class P2PWebSocket : public QObject
+{
+    Q_OBJECT
+
+private:    // Variables
+    std::unique_ptr<QWebSocket>     m_pSocket;              // WebSocketオブジェクト
+    QUrl                            m_Url;                  // P2P地震情報のWebSocket APIのURL
+    QTimer                          m_ReconnectTimer,       // 再接続を行うためのタイマ
+                                    m_PingTimer;            // 接続の生存を確認するためのタイマ
+    int                             m_Backoff;              // 次回の再接続までの待機時間 [mS]
+    bool                            m_bStopped,             // 受信を停止したかどうか
+                                    m_bConnectedOnce,       // 1度でも接続に成功したかどうか
+                                    m_bPongReceived;        // 前回のPingに対してPongを受信したかどうか
+    QSet<QString>                   m_ReceivedIDs;          // 受信した地震情報のID (重複除去用)
+    QQueue<QString>                 m_ReceivedOrder;        // 受信した地震情報のIDの受信順 (古いIDから破棄する)
+    qint64                          m_Received,             // 受信した地震情報の数
+                                    m_Duplicates,           // 重複により破棄した地震情報の数
+                                    m_Reconnects;           // 再接続の回数
+
+    static constexpr int            MinBackoff      = 1000;     // 再接続の待機時間の最小値 [mS]
+    static constexpr int            MaxBackoff      = 60000;    // 再接続の待機時間の最大値 [mS]
+    static constexpr int            PingInterval    = 30000;    // 接続の生存を確認する間隔 [mS]
+    static constexpr int            MaxReceivedIDs  = 256;      // 重複除去のために保持する地震情報のIDの最大数
+
+private:    // Methods
+    bool        IsDuplicate(const QString &id);             // 既に受信した地震情報かどうかを確認する
+    void        ScheduleReconnect();                        // 待機時間の経過後に再接続する
+
+public:     // Methods
+    explicit P2PWebSocket(QUrl url, QObject *parent = nullptr);
+    ~P2PWebSocket() override;
+    void        start();                                    // WebSocket APIへの接続を開始する
+    void        stop();                                     // WebSocket APIとの接続を終了する (再接続も行わない)
+    [[nodiscard]] qint64  GetReceived() const;              // 受信した地震情報の数を取得する
+    [[nodiscard]] qint64  GetDuplicates() const;            // 重複により破棄した地震情報の数を取得する
+    [[nodiscard]] qint64  GetReconnects() const;            // 再接続の回数を取得する
+
+signals:
+    void        messageReceived(int code, const QByteArray &data);  // 緊急地震速報(警報)または発生した地震情報を受信した場合
+                                                                    // dataは、JSON APIと同じ形式 (1件のみの配列) に変換される
+    void        reconnected();                                      // 切断後に再接続した場合
+                                                                    // 切断中に配信された地震情報は再配信されないため、JSON APIで取得し直す
+
+private slots:
+    void        onConnected();                                      // 接続した場合
+    void        onDisconnected();                                   // 切断された場合
+    void        onError(QAbstractSocket::SocketError error);        // エラーが発生した場合
+    void        onTextMessageReceived(const QString &message);      // 地震情報を受信した場合
+    void        onPong(quint64 elapsedTime, const QByteArray &payload);
+    void        onPingTimeout();                                    // 接続の生存を確認する
+};
+
+#endif // P2PWEBSOCKET_H
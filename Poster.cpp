@@ -6,45 +6,248 @@
     #include <QTextCodec>
 #endif
 
+#include <QDeadlineTimer>
 #include <iostream>
+#include <algorithm>
 #include "Poster.h"
 #include "HtmlFetcher.h"
+#include "NetworkAccess.h"
 
 
-Poster::Poster(QObject *parent) : m_pManager(std::make_unique<QNetworkAccessManager>(this)), QObject{parent}
+// タイマは、スレッドへ移動する場合に共に移動するため、このオブジェクトの子オブジェクトとして生成する
+Poster::Poster(QObject *parent) : QObject{parent}, m_RefreshTimer(this), m_CookieReuses(0), m_CookieFetches(0)
 {
+    m_RefreshTimer.setInterval(RefreshInterval);
+    connect(&m_RefreshTimer, &QTimer::timeout, this, &Poster::onRefreshTimeout);
+}
+
+
+// 掲示板との接続を維持して、クッキーをバックグラウンドで更新する
+// 書き込み時にクッキーの取得 (GETリクエスト) および接続の確立 (DNS、TCP、TLS) を待機しないようにする
+void Poster::startKeepWarm(const QUrl &url)
+{
+    if (!url.isValid() || url.host().isEmpty()) return;
 
+    m_URL = url;
+
+    refreshCookies();
+    m_RefreshTimer.start();
 }
 
 
-// 掲示板のクッキーを取得する
-int Poster::fetchCookies(const QUrl &url)
+// 掲示板との接続の維持およびクッキーの更新を停止する
+void Poster::stopKeepWarm()
+{
+    m_RefreshTimer.stop();
+
+    if (m_pCookieReply) m_pCookieReply->abort();
+}
+
+
+// 書き込みの準備 (クッキーの取得および接続の確立) をバックグラウンドで開始する
+// 地震情報を検出した時 (ダウンロードおよび解析の前) に呼び出して、書き込み時にクッキーの取得および接続の確立を待機しないようにする
+// 有効期限内のクッキーを保持している場合は、接続の確立のみを行う (接続済みの場合は再利用される)
+bool Poster::prepare(const QUrl &url)
+{
+    if (!url.isValid() || url.host().isEmpty()) return false;
+
+    if (HasValidCookies(url)) {
+        preconnect();
+        return false;
+    }
+
+    // クッキーの取得により、接続も確立される
+    m_URL = url;
+    refreshCookies();
+
+    return m_pCookieReply && m_pCookieReply->isRunning();
+}
+
+
+// 掲示板との接続を維持して、有効期限が近いクッキーを更新する
+void Poster::onRefreshTimeout()
+{
+    if (!HasValidCookies(m_URL)) {
+        // クッキーの取得により、接続も確立される
+        refreshCookies();
+    }
+    else {
+        preconnect();
+    }
+}
+
+
+// バックグラウンドでクッキーを取得する (レスポンスを待機しない)
+void Poster::refreshCookies()
+{
+    // 既に取得中の場合
+    if (m_pCookieReply && m_pCookieReply->isRunning()) return;
+
+    auto request   = NetworkAccess::createRequest(m_URL, RefreshTimeout);
+    m_pCookieReply = NetworkAccess::manager()->get(request);
+
+    connect(m_pCookieReply, &QNetworkReply::finished, this, [this, pReply = m_pCookieReply.data()]() {
+        auto bSuccess = pReply->error() == QNetworkReply::NoError && StoreCookies(pReply);
+        if (!bSuccess) {
+            // 書き込み時に再度取得するため、エラーとはしない
+            std::cerr << QString("警告 : クッキーの更新に失敗 %1").arg(pReply->errorString()).toStdString() << std::endl;
+        }
+
+        pReply->deleteLater();
+
+        emit cookiesRefreshed(bSuccess);
+    });
+}
+
+
+// 掲示板との接続を事前に確立する (接続済みの場合は再利用される)
+void Poster::preconnect()
+{
+#if QT_CONFIG(ssl)
+    if (m_URL.scheme() == "https") {
+        NetworkAccess::manager()->connectToHostEncrypted(m_URL.host(), static_cast<quint16>(m_URL.port(443)));
+        return;
+    }
+#endif
+
+    NetworkAccess::manager()->connectToHost(m_URL.host(), static_cast<quint16>(m_URL.port(80)));
+}
+
+
+// 有効期限内のクッキーを保持している場合は再利用して、保持していない場合は取得する
+// timeoutが0より大きい場合、バックグラウンドでの取得の待機およびクッキーの取得を合わせてtimeout[mS]以内に制限する
+// バックグラウンドでの取得の完了は、入れ子のイベントループを使用せずに、レスポンスのfinishedシグナルで待機する
+void Poster::PrepareCookies(const QUrl &url, int timeout, const std::function<void(int)> &callback)
+{
+    // バックグラウンドでクッキーを取得中でない場合は、直ちに確認する
+    if (!m_pCookieReply || !m_pCookieReply->isRunning()) {
+        ReuseOrFetchCookies(url, timeout, callback);
+        return;
+    }
+
+    // バックグラウンドでクッキーを取得中の場合は、そのレスポンスを待機する
+    // レスポンスの受信、または、期限切れのいずれか早い方で待機を終了する (もう一方の通知は無視する)
+    const QDeadlineTimer    deadline(timeout > 0 ? timeout : -1);
+    const auto              pWaited = std::make_shared<bool>(false);
+    QPointer<QNetworkReply> pReply  = m_pCookieReply;
+
+    auto onWaited = [this, url, timeout, deadline, pWaited, pReply, callback]() {
+        if (*pWaited) return;
+        *pWaited = true;
+
+        // 期限内に取得できなかった場合
+        if (pReply && pReply->isRunning()) {
+            std::cerr << QString("エラー : %1[mS]以内にクッキーを取得できませんでした").arg(timeout).toStdString() << std::endl;
+            callback(-1);
+            return;
+        }
+
+        // 取得が中断された場合 (処理のキャンセル等) は、再取得しない
+        if (pReply && pReply->error() == QNetworkReply::OperationCanceledError) {
+            std::cerr << QString("エラー : クッキーの取得が中断されました").toStdString() << std::endl;
+            callback(-1);
+            return;
+        }
+
+        // 待機に使用した時間を除いた残り時間以内に取得する
+        ReuseOrFetchCookies(url, timeout > 0 ? static_cast<int>(std::max<qint64>(deadline.remainingTime(), 1)) : 0, callback);
+    };
+
+    // クッキーの保存 (refreshCookies()メソッドで接続したスロット) の後に実行される
+    connect(m_pCookieReply, &QNetworkReply::finished, this, onWaited);
+    if (timeout > 0) QTimer::singleShot(timeout, this, onWaited);
+}
+
+
+// 有効期限内のクッキーを保持している場合は再利用して、保持していない場合は取得する
+void Poster::ReuseOrFetchCookies(const QUrl &url, int timeout, const std::function<void(int)> &callback)
+{
+    if (HasValidCookies(url)) {
+        m_CookieReuses++;
+        callback(0);
+
+        return;
+    }
+
+    fetchCookies(url, timeout, callback);
+}
+
+
+// 有効期限内のクッキーを保持しているかどうかを確認する
+// 有効期限の直前に書き込む場合に期限切れとならないように、有効期限のExpiryMargin[秒]前から無効とみなす
+bool Poster::HasValidCookies(const QUrl &url) const
+{
+    if (m_Cookies.isEmpty() || url != m_URL) return false;
+
+    return QDateTime::currentDateTimeUtc().addSecs(ExpiryMargin) < m_CookieExpiry;
+}
+
+
+// レスポンスからクッキーを取得して、有効期限を計算する
+// 有効期限は、各クッキーの有効期限のうち最も早い日時とする (有効期限の無いクッキーの場合は、取得時刻からCookieLifetime[秒]後)
+bool Poster::StoreCookies(QNetworkReply *reply)
 {
-    // レスポンス待機の設定
-    QEventLoop loop;
-    connect(m_pManager.get(), &QNetworkAccessManager::finished, &loop, &QEventLoop::quit);
+    QList<QNetworkCookie> receivedCookies = QNetworkCookie::parseCookies(reply->rawHeader("Set-Cookie"));
+    if (receivedCookies.isEmpty()) return false;
+
+    auto expiry = QDateTime::currentDateTimeUtc().addSecs(CookieLifetime);
+    for (const auto &cookie : receivedCookies) {
+        if (!cookie.isSessionCookie() && cookie.expirationDate().toUTC() < expiry) {
+            expiry = cookie.expirationDate().toUTC();
+        }
+    }
 
+    m_Cookies      = receivedCookies;
+    m_CookieExpiry = expiry;
+    m_URL          = reply->request().url();
+    m_CookieFetches++;
+
+    return true;
+}
+
+
+// 掲示板のクッキーを取得する
+// timeoutが0より大きい場合、レスポンスの待機をtimeout[mS]以内に制限する
+// 転送のタイムアウトは無通信の時間のみを制限するため、少しずつ応答する掲示板の場合も期限内に待機を終了するように、待機自体も制限する
+void Poster::fetchCookies(const QUrl &url, int timeout, const std::function<void(int)> &callback)
+{
     // クッキーの取得
-    QNetworkRequest request(url);
-    auto pReply = m_pManager->get(request);
+    // 共用のHTTPクライアントを使用して、掲示板との接続を再利用する
+    auto request = NetworkAccess::createRequest(url, timeout);
+    auto pReply  = NetworkAccess::manager()->get(request);
+
+    // 期限内に取得できなかった場合は、リクエストを中断する (中断した場合もfinishedシグナルが送信される)
+    const auto pTimedOut = std::make_shared<bool>(false);
+    if (timeout > 0) {
+        QTimer::singleShot(timeout, pReply, [pReply, pTimedOut]() {
+            if (!pReply->isRunning()) return;
+
+            *pTimedOut = true;
+            pReply->abort();
+        });
+    }
 
-    // レスポンス待機
-    loop.exec();
+    // レスポンスを受信した場合
+    connect(pReply, &QNetworkReply::finished, this, [this, pReply, timeout, pTimedOut, callback]() {
+        if (*pTimedOut) {
+            pReply->deleteLater();
 
-    return replyCookieFinished(pReply);
+            std::cerr << QString("エラー : %1[mS]以内にクッキーを取得できませんでした").arg(timeout).toStdString() << std::endl;
+            callback(-1);
+
+            return;
+        }
+
+        callback(replyCookieFinished(pReply));
+    });
 }
 
 
 // GETデータ(クッキー)を確認する
 int Poster::replyCookieFinished(QNetworkReply *reply)
 {
-    // レスポンスからクッキーを取得
-    QList<QNetworkCookie> receivedCookies = QNetworkCookie::parseCookies(reply->rawHeader("Set-Cookie"));
-    if (!receivedCookies.isEmpty()) {
-        // クッキーを保存
-        m_Cookies = receivedCookies;
-    }
-    else {
+    // レスポンスからクッキーを取得して保存
+    if (!StoreCookies(reply)) {
         // クッキーの取得に失敗した場合
         std::cerr << QString("エラー : クッキーの取得に失敗").toStdString() << std::endl;
         reply->deleteLater();
@@ -59,10 +262,10 @@ int Poster::replyCookieFinished(QNetworkReply *reply)
 
 
 // 新規スレッドを作成する
-int Poster::PostforCreateThread(const QUrl &url, THREAD_INFO &ThreadInfo)
+void Poster::PostforCreateThread(const QUrl &url, const THREAD_INFO &ThreadInfo, int timeout, const std::function<void(int)> &callback)
 {
-    // リクエストの作成
-    QNetworkRequest request(url);
+    // リクエストの作成 (timeoutが0の場合はタイムアウトしない)
+    auto request = NetworkAccess::createRequest(url, timeout);
 
     // POSTデータの生成 (<form>タグの<input>要素に基づいてデータを設定)
     // 新規スレッドを作成する場合は、<input>要素のname属性の値"key"を除去する必要がある
@@ -113,26 +316,26 @@ int Poster::PostforCreateThread(const QUrl &url, THREAD_INFO &ThreadInfo)
     var.setValue(m_Cookies);
     request.setHeader(QNetworkRequest::CookieHeader, var);
 
-    // レスポンス待機の設定
-    QEventLoop loop;
-    connect(m_pManager.get(), &QNetworkAccessManager::finished, &loop, &QEventLoop::quit);
-
     // HTTPリクエストの送信
-    auto pReply = m_pManager->post(request, encodedPostData);
+    auto pReply    = NetworkAccess::manager()->post(request, encodedPostData);
+    m_PostSentTime = std::chrono::steady_clock::now();
 
-    // レスポンス待機
-    loop.exec();
+    // レスポンスを受信した場合は、レスポンス情報を取得して結果を渡す
+    // 書き込みに失敗した場合は、クッキーが無効になっている可能性があるため、次回の書き込み時に再取得する
+    connect(pReply, &QNetworkReply::finished, this, [this, pReply, url, ThreadInfo, callback]() {
+        auto ret = replyPostFinished(pReply, url, ThreadInfo);
+        if (ret != 0) m_CookieExpiry = QDateTime();
 
-    // レスポンス情報の取得
-    return replyPostFinished(pReply, url, ThreadInfo);
+        callback(ret);
+    });
 }
 
 
 // 特定のスレッドに書き込む
-int Poster::PostforWriteThread(const QUrl &url, THREAD_INFO &ThreadInfo)
+void Poster::PostforWriteThread(const QUrl &url, const THREAD_INFO &ThreadInfo, int timeout, const std::function<void(int)> &callback)
 {
-    // リクエストの作成
-    QNetworkRequest request(url);
+    // リクエストの作成 (timeoutが0の場合はタイムアウトしない)
+    auto request = NetworkAccess::createRequest(url, timeout);
 
     // POSTデータの生成 (<form>タグの<input>要素に基づいてデータを設定)
     // 既存のスレッドに書き込む場合は、<input>要素のname属性の値"key"にスレッド番号を指定する必要がある
@@ -185,18 +388,18 @@ int Poster::PostforWriteThread(const QUrl &url, THREAD_INFO &ThreadInfo)
     var.setValue(m_Cookies);
     request.setHeader(QNetworkRequest::CookieHeader, var);
 
-    // レスポンス待機の設定
-    QEventLoop loop;
-    connect(m_pManager.get(), &QNetworkAccessManager::finished, &loop, &QEventLoop::quit);
-
     // HTTPリクエストの送信
-    auto pReply = m_pManager->post(request, encodedPostData);
+    auto pReply    = NetworkAccess::manager()->post(request, encodedPostData);
+    m_PostSentTime = std::chrono::steady_clock::now();
 
-    // レスポンス待機
-    loop.exec();
+    // レスポンスを受信した場合は、レスポンス情報を取得して結果を渡す
+    // 書き込みに失敗した場合は、クッキーが無効になっている可能性があるため、次回の書き込み時に再取得する
+    connect(pReply, &QNetworkReply::finished, this, [this, pReply, ThreadInfo, callback]() {
+        auto ret = replyPostFinished(pReply, ThreadInfo);
+        if (ret != 0) m_CookieExpiry = QDateTime();
 
-    // レスポンス情報の取得
-    return replyPostFinished(pReply, ThreadInfo);
+        callback(ret);
+    });
 }
 
 
@@ -210,32 +413,27 @@ int Poster::replyPostFinished(QNetworkReply *reply, const THREAD_INFO &ThreadInf
         return -1;
     }
     else {
-        QString replyData;
+        // レスポンスの本文 (バイト列) は、デコードせずにそのままパースする
+        const auto replyData = reply->readAll();
 
+#ifdef _DEBUG
         if (ThreadInfo.shiftjis) {
-            // Shift-JISからUTF-8へデコード
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-            QByteArray SJISData = reply->readAll();
-
+            // Shift-JISからUTF-8へデコード (デバッグ出力のみ)
+    #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
             QStringDecoder decoder("Shift-JIS");
-            replyData           = decoder(SJISData);
-#else
-            QTextCodec *codec;  // Shift-JIS用エンコードオブジェクト
-            codec     = QTextCodec::codecForName("Shift-JIS");
-            replyData = codec->toUnicode(reply->readAll());
-#endif
+            std::cout << QString(decoder(replyData)).toStdString() << std::endl;
+    #else
+            std::cout << QTextCodec::codecForName("Shift-JIS")->toUnicode(replyData).toStdString() << std::endl;
+    #endif
         }
         else {
-            replyData = reply->readAll();
+            std::cout << replyData.toStdString() << std::endl;
         }
-
-#ifdef _DEBUG
-        std::cout << replyData.toStdString() << std::endl;
 #endif
 
         // 書き込みした既存のスレッドのURLのパスを取得
         HtmlFetcher fetcher(nullptr);
-        if (fetcher.extractThreadPath(replyData, ThreadInfo.bbs)) {
+        if (fetcher.extractThreadPath(replyData, ThreadInfo.shiftjis, ThreadInfo.bbs)) {
             std::cerr << QString("エラー : 書き込みした既存のスレッドのURLとスレッド番号の取得に失敗").toStdString() << std::endl;
             std::cerr << QString("スレッドの書き込みに失敗した可能性があります").toStdString() << std::endl;
             reply->deleteLater();
@@ -268,32 +466,27 @@ int Poster::replyPostFinished(QNetworkReply *reply, const QUrl &url, const THREA
         return -1;
     }
     else {
-        QString replyData;
+        // レスポンスの本文 (バイト列) は、デコードせずにそのままパースする
+        const auto replyData = reply->readAll();
 
+#ifdef _DEBUG
         if (ThreadInfo.shiftjis) {
-            // Shift-JISからUTF-8へデコード
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-            QByteArray SJISData = reply->readAll();
-
+            // Shift-JISからUTF-8へデコード (デバッグ出力のみ)
+    #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
             QStringDecoder decoder("Shift-JIS");
-            replyData           = decoder(SJISData);
-#else
-            QTextCodec *codec;  // Shift-JIS用エンコードオブジェクト
-            codec     = QTextCodec::codecForName("Shift-JIS");
-            replyData = codec->toUnicode(reply->readAll());
-#endif
+            std::cout << QString(decoder(replyData)).toStdString() << std::endl;
+    #else
+            std::cout << QTextCodec::codecForName("Shift-JIS")->toUnicode(replyData).toStdString() << std::endl;
+    #endif
         }
         else {
-            replyData = reply->readAll();
+            std::cout << replyData.toStdString() << std::endl;
         }
-
-#ifdef _DEBUG
-        std::cout << replyData.toStdString() << std::endl;
 #endif
 
         // 新規作成したスレッドのURLのパスを取得
         HtmlFetcher fetcher(nullptr);
-        if (fetcher.extractThreadPath(replyData, ThreadInfo.bbs)) {
+        if (fetcher.extractThreadPath(replyData, ThreadInfo.shiftjis, ThreadInfo.bbs)) {
             std::cerr << QString("エラー : 新規作成したスレッドのURLとスレッド番号の取得に失敗").toStdString() << std::endl;
             std::cerr << QString("スレッドの新規作成に失敗した可能性があります").toStdString() << std::endl;
             reply->deleteLater();
@@ -339,6 +532,27 @@ QString Poster::GetNewThreadNum() const
 }
 
 
+// 最後にPOSTデータを送信した時刻を取得する
+std::chrono::steady_clock::time_point Poster::GetPostSentTime() const
+{
+    return m_PostSentTime;
+}
+
+
+// 保持しているクッキーを再利用した回数を取得する
+qint64 Poster::GetCookieReuses() const
+{
+    return m_CookieReuses;
+}
+
+
+// クッキーを取得した回数を取得する
+qint64 Poster::GetCookieFetches() const
+{
+    return m_CookieFetches;
+}
+
+
 // 文字列をShift-JISにエンコードする
 [[maybe_unused]] QByteArray Poster::encodeStringToShiftJIS(const QString &str)
 {
@@ -10,6 +10,11 @@
 #include <QUrl>
 #include <QUrlQuery>
 #include <QObject>
+#include <QTimer>
+#include <QDateTime>
+#include <QPointer>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <utility>
 
@@ -39,14 +44,31 @@ class Poster : public QObject
     Q_OBJECT
 
 private:
-    std::unique_ptr<QNetworkAccessManager> m_pManager;      // 掲示板にアクセスするためのネットワークオブジェクト
     QList<QNetworkCookie>                  m_Cookies;       // 掲示板のクッキー
-    QUrl                                   m_URL;           // 書き込み用URL
+    QDateTime                              m_CookieExpiry;  // 掲示板のクッキーの有効期限 (UTC)
+    QUrl                                   m_URL;           // 書き込み用URL (クッキーを取得したURL)
     QString                                m_NewThreadURL,  // 新規作成したスレッドのURL
                                            m_NewThreadNum;  // 新規作成したスレッド番号
+    QTimer                                 m_RefreshTimer;  // 掲示板との接続の維持およびクッキーの有効期限を確認するためのタイマ
+    QPointer<QNetworkReply>                m_pCookieReply;  // バックグラウンドで取得中のクッキーのリクエスト
+    std::chrono::steady_clock::time_point  m_PostSentTime;  // 最後にPOSTデータを送信した時刻
+    qint64                                 m_CookieReuses,  // 保持しているクッキーを再利用した回数
+                                           m_CookieFetches; // クッキーを取得した回数 (バックグラウンドでの取得を含む)
+
+    static constexpr int                   RefreshInterval = 30 * 1000;    // 掲示板との接続の維持およびクッキーの有効期限を確認する間隔 [mS]
+    static constexpr int                   RefreshTimeout  = 10 * 1000;    // バックグラウンドでクッキーを取得する場合のタイムアウト [mS]
+    static constexpr int                   CookieLifetime  = 10 * 60;      // 有効期限の無いクッキーを再利用する期間 [秒]
+    static constexpr int                   ExpiryMargin    = 60;           // クッキーの有効期限の何秒前に再取得するか [秒]
 
 private:
     int         replyCookieFinished(QNetworkReply *reply);                      // GETデータ(クッキー)を確認する
+    void        ReuseOrFetchCookies(const QUrl &url, int timeout,               // 有効期限内のクッキーを保持している場合は再利用して、保持していない場合は取得する
+                                    const std::function<void(int)> &callback);
+    bool        StoreCookies(QNetworkReply *reply);                             // レスポンスからクッキーを取得して、有効期限を計算する
+    [[nodiscard]] bool  HasValidCookies(const QUrl &url) const;                 // 有効期限内のクッキーを保持しているかどうかを確認する
+    void        refreshCookies();                                               // バックグラウンドでクッキーを取得する (レスポンスを待機しない)
+    void        preconnect();                                                   // 掲示板との接続を事前に確立する (接続済みの場合は再利用される)
+    void        onRefreshTimeout();                                             // 掲示板との接続を維持して、有効期限が近いクッキーを更新する
     int         replyPostFinished(QNetworkReply *reply,                         // POSTデータ送信後のレスポンスを確認する
                                   const THREAD_INFO &ThreadInfo);
     int         replyPostFinished(QNetworkReply *reply, const QUrl &url,        // POSTデータ送信後のレスポンスを確認する
@@ -58,14 +80,29 @@ private:
 public:
     explicit    Poster(QObject *parent = nullptr);
     ~Poster() override = default;
-    int         fetchCookies(const QUrl &url);                                  // 掲示板のクッキーを取得する
-    int         PostforWriteThread(const QUrl &url, THREAD_INFO &threadInfo);   // 特定のスレッドに書き込む
-    int         PostforCreateThread(const QUrl &url, THREAD_INFO &threadInfo);  // スレッドを新規作成する
+
+    // 以下のメソッドはレスポンスを待機せずに終了して、処理の終了時に結果 (0 : 成功、-1 : 失敗) をcallbackへ渡す
+    // リクエストは共用のHTTPクライアントで送信するため、NetworkAccess::abortAll()メソッドで中断できる (中断した場合は失敗となる)
+    void        fetchCookies(const QUrl &url, int timeout,                      // 掲示板のクッキーを取得する (timeoutが0の場合はタイムアウトしない)
+                             const std::function<void(int)> &callback);
+    void        PrepareCookies(const QUrl &url, int timeout,                    // 有効期限内のクッキーを保持している場合は再利用して、保持していない場合は取得する
+                               const std::function<void(int)> &callback);
+    void        startKeepWarm(const QUrl &url);                                 // 掲示板との接続を維持して、クッキーをバックグラウンドで更新する
+    void        stopKeepWarm();                                                 // 掲示板との接続の維持およびクッキーの更新を停止する
+    bool        prepare(const QUrl &url);                                       // 書き込みの準備 (クッキーの取得および接続の確立) をバックグラウンドで開始する
+                                                                                // true : クッキーを取得中 (完了時にcookiesRefreshedシグナルを送信する), false : 接続の確立のみ
+    void        PostforWriteThread(const QUrl &url, const THREAD_INFO &threadInfo,  // 特定のスレッドに書き込む
+                                   int timeout, const std::function<void(int)> &callback);
+    void        PostforCreateThread(const QUrl &url, const THREAD_INFO &threadInfo, // スレッドを新規作成する
+                                    int timeout, const std::function<void(int)> &callback);
     [[nodiscard]] QString     GetNewThreadURL() const;                          // 新規作成したスレッドのURLを取得する
     [[nodiscard]] QString     GetNewThreadNum() const;                          // 新規作成したスレッド番号を取得する
+    [[nodiscard]] std::chrono::steady_clock::time_point GetPostSentTime() const;    // 最後にPOSTデータを送信した時刻を取得する
+    [[nodiscard]] qint64      GetCookieReuses() const;                          // 保持しているクッキーを再利用した回数を取得する
+    [[nodiscard]] qint64      GetCookieFetches() const;                         // クッキーを取得した回数を取得する
 
 signals:
-
+    void        cookiesRefreshed(bool bSuccess);                                // バックグラウンドでのクッキーの取得が完了した場合
 };
 
 #endif // POSTER_H
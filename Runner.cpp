@@ -8,17 +8,25 @@
 #include <QJsonArray>
 #include <QException>
 #include <iostream>
+#include <algorithm>
 #include <utility>
 #include <set>
 #include <stdexcept>
 #include "Runner.h"
 #include "CommandLineParser.h"
+#include "NetworkAccess.h"
+#include "XPathCache.h"
+#include "EventStore.h"
+#include "ThreadCache.h"
+#include "HtmlFetcher.h"
+#include "Outbox.h"
+#include "FeedFetcher.h"
 
 
 #ifdef Q_OS_LINUX
 Runner::Runner(QCoreApplication &app, QStringList _args, QObject *parent) : m_App(app), m_args(std::move(_args)),
-    m_SysConfFile(""), m_EQAlertInterval(10 * 1000), m_EQInfoInterval(30 * 1000),
-    m_pNotifier(std::make_unique<QSocketNotifier>(fileno(stdin), QSocketNotifier::Read, this)), m_stopRequested(false),
+    m_SysConfFile(""), m_bTenant(false), m_bProcessWide(true), m_bOneShot(false), m_bPolling(true), m_EQAlertInterval(10 * 1000), m_EQInfoInterval(30 * 1000),
+    m_pNotifier(std::make_unique<QSocketNotifier>(fileno(stdin), QSocketNotifier::Read, this)), m_stopRequested(false), m_bAlertRunning(false), m_bInfoRunning(false),
     QObject{parent}
 {
     connect(&m_EQAlertTimer, &QTimer::timeout, this, &Runner::fetchAlert);
@@ -29,8 +37,8 @@ Runner::Runner(QCoreApplication &app, QStringList _args, QObject *parent) : m_Ap
 #elif Q_OS_WIN
 
 Runner::Runner(QCoreApplication &app, QStringList _args, QObject *parent) : m_App(app), m_args(std::move(_args)),
-    m_SysConfFile(""), m_EQAlertInterval(10 * 1000), m_EQInfoInterval(30 * 1000),
-    m_pNotifier(std::make_unique<QWinEventNotifier>(fileno(stdin), QWinEventNotifier::Read, this)), m_stopRequested(false),
+    m_SysConfFile(""), m_bTenant(false), m_bProcessWide(true), m_bOneShot(false), m_bPolling(true), m_EQAlertInterval(10 * 1000), m_EQInfoInterval(30 * 1000),
+    m_pNotifier(std::make_unique<QWinEventNotifier>(fileno(stdin), QWinEventNotifier::Read, this)), m_stopRequested(false), m_bAlertRunning(false), m_bInfoRunning(false),
     QObject{parent}
 {
     connect(&m_EQAlertTimer, &QTimer::timeout, this, &Runner::fetchAlert);
@@ -40,6 +48,16 @@ Runner::Runner(QCoreApplication &app, QStringList _args, QObject *parent) : m_Ap
 #endif
 
 
+// デーモンモードにおける設定ファイルごとのランナー
+// キーボードシーケンス、タイマおよびソフトウェアの終了は、デーモンのランナーが管理する
+Runner::Runner(QCoreApplication &app, bool bProcessWide, QObject *parent) : m_App(app),
+    m_SysConfFile(""), m_bTenant(true), m_bProcessWide(bProcessWide), m_bOneShot(false), m_bPolling(true), m_EQAlertInterval(10 * 1000), m_EQInfoInterval(30 * 1000),
+    m_stopRequested(false), m_bAlertRunning(false), m_bInfoRunning(false),
+    QObject{parent}
+{
+}
+
+
 void Runner::run()
 {
     // メイン処理
@@ -61,6 +79,18 @@ void Runner::run()
                                      "testFilePath");
     parser.addOption(testfileOption);
 
+    // --convert-log オプションを追加
+    QCommandLineOption convertlogOption(QStringList() << "convert-log",
+                                        "ログファイルの保存形式を変換します (JSON <-> SQLite)",
+                                        "sourceFilePath,destinationFilePath");
+    parser.addOption(convertlogOption);
+
+    // --confdir オプションを追加
+    QCommandLineOption confdirOption(QStringList() << "confdir",
+                                     "設定ファイル(.json)を格納したディレクトリのパスを指定します (デーモンモード)",
+                                     "confDirPath");
+    parser.addOption(confdirOption);
+
     // --version / -v オプションを追加
     QCommandLineOption versionOption(QStringList() << "version" << "v", "バージョン情報を表示します");
     parser.addOption(versionOption);
@@ -102,6 +132,16 @@ void Runner::run()
         specifiedOption = "sysconf";
     }
 
+    if (parser.isConvertLogSet()) {
+        optionCount++;
+        specifiedOption = "convertlog";
+    }
+
+    if (parser.isConfDirSet()) {
+        optionCount++;
+        specifiedOption = "confdir";
+    }
+
     if (parser.isTestFileSet()) {
         optionCount++;
         specifiedTestFileOption  = "testfile";
@@ -143,12 +183,37 @@ void Runner::run()
         // --help / -h オプション
         auto help = QString("使用法 : qEQAlert [オプション]\n\n")
                     + QString("  --sysconf=<qEQAlert.jsonファイルのパス>\t\t設定ファイルのパスを指定する\n")
+                    + QString("  --confdir=<ディレクトリのパス>        \t\tディレクトリ内の全ての設定ファイルを読み込んで、1つのプロセスで実行する\n")
+                    + QString("  --convert-log=<変換元のパス>,<変換先のパス>\tログファイルをJSON形式とSQLite形式の間で変換する\n")
                     + QString("  -v, -V, --version                    \t\tバージョン情報を表示する\n\n");
         std::cout << help.toStdString() << std::endl;
 
         QCoreApplication::exit();
         return;
     }
+    else if (parser.isSet(convertlogOption)) {
+        // --convert-logオプション
+        // 変換元および変換先の保存形式は、ファイルの先頭または拡張子 (.db、.sqlite、.sqlite3の場合はSQLite形式) で判別する
+        auto option = parser.value(convertlogOption);
+
+        // 先頭と末尾にクォーテーションが存在する場合は取り除く
+        if ((option.startsWith('\"') && option.endsWith('\"')) || (option.startsWith('\'') && option.endsWith('\''))) {
+            option = option.mid(1, option.length() - 2);
+        }
+
+        const auto files = option.split(",");
+        if (files.size() != 2 || files.at(0).isEmpty() || files.at(1).isEmpty()) {
+            std::cerr << QString("エラー : 変換元および変換先のログファイルのパスを , で区切って指定してください").toStdString() << std::endl;
+
+            QCoreApplication::exit();
+            return;
+        }
+
+        EventStore::convert(files.at(0), files.at(1));
+
+        QCoreApplication::exit();
+        return;
+    }
     else if (parser.isSet(sysconfOption)) {
         // --sysconfオプションの値を取得
         auto option = parser.value(sysconfOption);
@@ -190,6 +255,33 @@ void Runner::run()
             m_TestFile = option;
         }
     }
+    else if (parser.isSet(confdirOption)) {
+        // --confdirオプション (デーモンモード)
+        // ディレクトリ内の全ての設定ファイルを読み込んで、同じ地震情報の取得を共有する
+        auto option = parser.value(confdirOption);
+
+        // 先頭と末尾にクォーテーションが存在する場合は取り除く
+        if ((option.startsWith('\"') && option.endsWith('\"')) || (option.startsWith('\'') && option.endsWith('\''))) {
+            option = option.mid(1, option.length() - 2);
+        }
+
+        if (option.isEmpty()) {
+            std::cerr << QString("エラー : 設定ファイルを格納したディレクトリのパスが不明です").toStdString() << std::endl;
+
+            QCoreApplication::exit();
+            return;
+        }
+
+        m_ConfDir = option;
+
+        if (loadTenants(m_ConfDir)) {
+            QCoreApplication::exit();
+            return;
+        }
+
+        startTenants();
+        return;
+    }
     else {
         std::cerr << QString("エラー : 不明なオプションです - %1").arg(parser.isSet(specifiedOption)).toStdString() << std::endl;
 
@@ -207,6 +299,19 @@ void Runner::run()
 
     // 緊急地震速報(警報)および発生した地震情報を取得するかどうかを確認
     // いずれかが有効の場合、かつ、ワンショット機能が無効の場合は、緊急地震速報(警報)および発生した地震情報のタイマ割り込みを有効化
+#ifdef QEQALERT_WEBSOCKET
+    if (!m_bPolling && !m_bOneShot) {
+        // P2P地震情報のWebSocket APIを使用する場合は、タイマ割り込みを使用せずに受信した地震情報を処理する
+        disconnect(&m_EQAlertTimer, &QTimer::timeout, this, &Runner::fetchAlert);
+        disconnect(&m_EQInfoTimer,  &QTimer::timeout, this, &Runner::fetchInfo);
+
+        m_pWebSocket = std::make_unique<P2PWebSocket>(QUrl(m_EQWebSocketURL), this);
+        connect(m_pWebSocket.get(), &P2PWebSocket::messageReceived, this, &Runner::onPushed);
+        connect(m_pWebSocket.get(), &P2PWebSocket::reconnected,     this, &Runner::onReconnected);
+        m_pWebSocket->start();
+    }
+    else
+#endif
     if (m_bOneShot) {
         // 自動的に地震情報を取得しない場合、タイマのシグナル / スロットを無効にする
         disconnect(&m_EQAlertTimer, &QTimer::timeout, this, &Runner::fetchAlert);
@@ -266,11 +371,19 @@ void Runner::run()
     // Cronを使用する場合、または、ワンショットで動作させる場合の処理
     if (m_bOneShot) {
         // 既に[q]キーまたは[Q]キーが押下されている場合は再度終了処理を行わない
-        if (!m_stopRequested.load()) {
-            // ソフトウェアを終了する
-            QCoreApplication::exit();
-            return;
-        }
+        // 地震情報の処理中の場合は、全ての処理が終了した後にソフトウェアを終了する
+        exitIfIdle();
+    }
+}
+
+
+// ワンショット機能が有効の場合、全ての地震情報の処理が終了していればソフトウェアを終了する
+void Runner::exitIfIdle()
+{
+    if (m_stopRequested.load()) return;
+
+    if (!m_bAlertRunning && !m_bInfoRunning) {
+        QCoreApplication::exit();
     }
 }
 
@@ -280,16 +393,32 @@ void Runner::fetchAlert()
 {
     if (m_stopRequested.load()) return;
 
-    if (!m_bOneShot) {
+    // WebSocket APIを使用する場合、および、デーモンモードにおける設定ファイルごとのランナーの場合は、タイマを使用しない
+    if (!m_bTenant && !m_bOneShot && m_bPolling) {
         // 地震情報の取得タイマを一時停止
         QMetaObject::invokeMethod(&m_EQAlertTimer, "stop", Qt::QueuedConnection);
     }
 
 #ifdef _DEBUG
     // 処理開始時刻
-    auto start = std::chrono::high_resolution_clock::now();
+    m_AlertStart = std::chrono::high_resolution_clock::now();
 #endif
 
+    // デーモンモードの場合は、タイマで取得する各設定ファイルのランナーで取得する
+    // 同じURLの取得は共有されるため、各地震情報の取得は設定ファイルの数に関わらず1度のみとなる
+    if (!m_Tenants.empty()) {
+        auto bRunning = m_bAlertRunning;
+        m_bAlertRunning  = true;
+
+        for (const auto &pTenant : m_Tenants) {
+            if (pTenant->isPolling() && pTenant->m_bEQAlert) pTenant->fetchAlert();
+        }
+
+        // 処理を開始した設定ファイルが無い場合は、alertFinishedシグナルが送信されないため終了処理を行う
+        if (!bRunning) QMetaObject::invokeMethod(this, &Runner::onTenantAlertFinished, Qt::QueuedConnection);
+        return;
+    }
+
     // 緊急地震速報(警報)および発生した地震情報を取得
     // デフォルト
     // 緊急地震速報(警報) : 30[秒]以内の最新情報 (1件のみ)
@@ -326,45 +455,79 @@ void Runner::fetchAlert()
 
     if (!m_pEarthQuake) {
         COMMONDATA data = {
-            .iGetInfo       = m_iGetInfo,       // JMAあるいはP2P地震情報から取得
+            .iGetInfo       = (m_iGetInfo == 2) ? 1 : m_iGetInfo,   // JMAあるいはP2P地震情報から取得 (WebSocket APIの場合もP2P地震情報の形式)
             .AlertScale     = m_AlertScale,     // 震度の閾値
             .InfoScale      = 0,                // 緊急地震速報(警報)のため不要
             .EQInfoURL      = "",               // 緊急地震速報(警報)のため不要
-            .RequestURL     = m_RequestURL,     // スレッドに書き込むためのURL
+            .RequestURL     = "",               // 掲示板ごとに設定する
             .LogFile        = "",
             .bSubjectTime   = m_EQsubTime,      // 地震発現(到達)時刻をスレッドのタイトルに記載するかどうか
-            .bChangeTitle   = m_EQchangeTitle,  // (現在は未使用)
+            .bChangeTitle   = false,            // (現在は未使用)
             .ExpiredXPath   = m_ExpiredXPath,   // 既存のスレッド情報を取得するためのXPath式
             .ThreadNumXPath = "",               // (現在は未使用)
             .MaxThreadNum   = 1000,             // (現在は未使用)
-            .TestFile       = m_TestFile        // テストファイルを使用する場合は、ファイルのパスが指定される
+            .TestFile       = m_TestFile,       // テストファイルを使用する場合は、ファイルのパスが指定される
+            .bStreamParser  = m_bStreamParser,  // JMAのXMLをストリーム形式で解析するかどうか
+            .DeadlineBudget = m_AlertDeadline   // 地震情報を検出してから書き込みを完了するまでの期限 [mS]
         };
 
-        m_pEarthQuake = std::make_unique<EarthQuake>(data,       m_ThreadInfo, m_EQImageInfo,
-                                                     m_bEQAlert, m_EQAlertURL, m_AlertFile,
-                                                     false,      "",           "",
+        m_pEarthQuake = std::make_unique<EarthQuake>(data,       m_Boards,     m_EQImageInfo,
+                                                     m_bEQAlert, m_EQAlertURL,
+                                                     false,      "",
                                                      this);
+
+        connect(m_pEarthQuake.get(), &EarthQuake::finished, this, &Runner::onAlertFinished);
     }
 
     // 実行
-    [[maybe_unused]] auto ret = m_pEarthQuake->EQProcessAlert();
+    // 地震情報の取得は非同期で行うため、処理の終了はonAlertFinished()メソッドで受け取る
+    // 既に処理中の場合、WebSocket APIから受信したデータは処理中の処理の終了後に処理される
+    auto bRunning = m_bAlertRunning;
+    m_bAlertRunning  = true;
+
+#ifdef QEQALERT_WEBSOCKET
+    auto ret = m_pEarthQuake->EQProcessAlert(m_PushedData);
+#else
+    auto ret = m_pEarthQuake->EQProcessAlert();
+#endif
+
+    // 処理を開始しなかった場合 (無効の場合等) は、finishedシグナルが送信されないため直ちに終了処理を行う
+    if (ret != 0 && !bRunning) onAlertFinished(-1);
+}
+
+
+// 緊急地震速報(警報)の処理が終了した場合のスロット
+void Runner::onAlertFinished([[maybe_unused]] int result)
+{
+    m_bAlertRunning = false;
+
+    // デーモンモードにおける設定ファイルごとのランナーの場合は、タイマの再開および終了処理をデーモンのランナーで行う
+    if (m_bTenant) {
+        emit alertFinished();
+        return;
+    }
 
 #ifdef _DEBUG
     // 処理終了時刻
     // 経過時間を計算 (ミリ秒単位)
     auto end = std::chrono::high_resolution_clock::now();
-    auto duration = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+    auto duration = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - m_AlertStart).count());
     std::cout << QString("地震情報の処理に掛かった時間 : %1 [mS]").arg(duration).toStdString() << std::endl;
+
+    printStatistics();
 #endif
 
-    if (!m_bOneShot) {
+    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されているかどうかを確認
+    if (m_stopRequested.load()) return;
+
+    if (!m_bOneShot && m_bPolling) {
         // 地震情報の取得タイマを再開
         m_EQAlertTimer.setInterval(m_EQAlertInterval);
         QMetaObject::invokeMethod(&m_EQAlertTimer, "start", Qt::QueuedConnection);
     }
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されているかどうかを確認
-    if (m_stopRequested.load()) return;
+    // ワンショット機能が有効の場合、全ての地震情報の処理が終了した後にソフトウェアを終了する
+    if (m_bOneShot) QMetaObject::invokeMethod(this, [this]() { exitIfIdle(); }, Qt::QueuedConnection);
 }
 
 
@@ -373,16 +536,32 @@ void Runner::fetchInfo()
 {
     if (m_stopRequested.load()) return;
 
-    if (!m_bOneShot) {
+    // WebSocket APIを使用する場合、および、デーモンモードにおける設定ファイルごとのランナーの場合は、タイマを使用しない
+    if (!m_bTenant && !m_bOneShot && m_bPolling) {
         // 地震情報の取得タイマを一時停止
         QMetaObject::invokeMethod(&m_EQInfoTimer, "stop", Qt::QueuedConnection);
     }
 
 #ifdef _DEBUG
     // 処理開始時刻
-    auto start = std::chrono::high_resolution_clock::now();
+    m_InfoStart = std::chrono::high_resolution_clock::now();
 #endif
 
+    // デーモンモードの場合は、タイマで取得する各設定ファイルのランナーで取得する
+    // 同じURLの取得は共有されるため、各地震情報の取得は設定ファイルの数に関わらず1度のみとなる
+    if (!m_Tenants.empty()) {
+        auto bRunning = m_bInfoRunning;
+        m_bInfoRunning  = true;
+
+        for (const auto &pTenant : m_Tenants) {
+            if (pTenant->isPolling() && pTenant->m_bEQInfo) pTenant->fetchInfo();
+        }
+
+        // 処理を開始した設定ファイルが無い場合は、infoFinishedシグナルが送信されないため終了処理を行う
+        if (!bRunning) QMetaObject::invokeMethod(this, &Runner::onTenantInfoFinished, Qt::QueuedConnection);
+        return;
+    }
+
     // 発生した地震情報を取得
     // デフォルト
     // 発生した地震情報 : 10[分]以内の最新情報 (1件のみ)
@@ -412,45 +591,79 @@ void Runner::fetchInfo()
 
     if (!m_pEarthQuakeInfo) {
         COMMONDATA data = {
-            .iGetInfo       = m_iGetInfo,       // JMAあるいはP2P地震情報から取得
+            .iGetInfo       = (m_iGetInfo == 2) ? 1 : m_iGetInfo,   // JMAあるいはP2P地震情報から取得 (WebSocket APIの場合もP2P地震情報の形式)
             .AlertScale     = 0,                // 発生した地震情報のため不要
             .InfoScale      = m_InfoScale,      // 震度の閾値
             .EQInfoURL      = m_EQInfoURL,      // 発生した地震情報のため不要
-            .RequestURL     = m_RequestURL,     // スレッドに書き込むためのURL
+            .RequestURL     = "",               // 掲示板ごとに設定する
             .LogFile        = "",
             .bSubjectTime   = false,            // 発生した地震情報のため不要
-            .bChangeTitle   = m_EQchangeTitle,  // !chttコマンドを使用するかどうか
+            .bChangeTitle   = false,            // !chttコマンドを使用するかどうか (掲示板ごとに設定する)
             .ExpiredXPath   = m_ExpiredXPath,   // 既存のスレッド情報を取得するためのXPath式
-            .ThreadNumXPath = "",               // (現在は未使用)
-            .MaxThreadNum   = 1000,             // スレッドの最大レス数
-            .TestFile       = m_TestFile        // テストファイルを使用する場合は、ファイルのパスが指定される
+            .ThreadNumXPath = "",               // datファイルのURLが不明の場合のみ使用する (現在は未使用)
+            .MaxThreadNum   = 1000,             // スレッドの最大レス数 (掲示板ごとに設定する)
+            .TestFile       = m_TestFile,       // テストファイルを使用する場合は、ファイルのパスが指定される
+            .bStreamParser  = m_bStreamParser,  // JMAのXMLをストリーム形式で解析するかどうか
+            .DeadlineBudget = 0                 // 発生した地震情報のため不要
         };
 
-        m_pEarthQuakeInfo = std::make_unique<EarthQuake>(data,       m_ThreadInfo, m_EQImageInfo,
-                                                         false,      "",           "",
-                                                         m_bEQInfo,  m_EQInfoURL,  m_InfoFile,
+        m_pEarthQuakeInfo = std::make_unique<EarthQuake>(data,       m_Boards,     m_EQImageInfo,
+                                                         false,      "",
+                                                         m_bEQInfo,  m_EQInfoURL,
                                                          this);
+
+        connect(m_pEarthQuakeInfo.get(), &EarthQuake::finished, this, &Runner::onInfoFinished);
     }
 
     // 実行
-    [[maybe_unused]] auto ret = m_pEarthQuakeInfo->EQProcessInfo();
+    // 地震情報の取得は非同期で行うため、処理の終了はonInfoFinished()メソッドで受け取る
+    // 既に処理中の場合、WebSocket APIから受信したデータは処理中の処理の終了後に処理される
+    auto bRunning = m_bInfoRunning;
+    m_bInfoRunning  = true;
+
+#ifdef QEQALERT_WEBSOCKET
+    auto ret = m_pEarthQuakeInfo->EQProcessInfo(m_PushedData);
+#else
+    auto ret = m_pEarthQuakeInfo->EQProcessInfo();
+#endif
+
+    // 処理を開始しなかった場合 (無効の場合等) は、finishedシグナルが送信されないため直ちに終了処理を行う
+    if (ret != 0 && !bRunning) onInfoFinished(-1);
+}
+
+
+// 発生した地震情報の処理が終了した場合のスロット
+void Runner::onInfoFinished([[maybe_unused]] int result)
+{
+    m_bInfoRunning = false;
+
+    // デーモンモードにおける設定ファイルごとのランナーの場合は、タイマの再開および終了処理をデーモンのランナーで行う
+    if (m_bTenant) {
+        emit infoFinished();
+        return;
+    }
 
 #ifdef _DEBUG
     // 処理終了時刻
     // 経過時間を計算 (ミリ秒単位)
     auto end = std::chrono::high_resolution_clock::now();
-    auto duration = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+    auto duration = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - m_InfoStart).count());
     std::cout << QString("地震情報の処理に掛かった時間 : %1 [mS]").arg(duration).toStdString() << std::endl;
+
+    printStatistics();
 #endif
 
-    if (!m_bOneShot) {
+    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されているかどうかを確認
+    if (m_stopRequested.load()) return;
+
+    if (!m_bOneShot && m_bPolling) {
         // 地震情報の取得タイマを再開
         m_EQInfoTimer.setInterval(m_EQInfoInterval);
         QMetaObject::invokeMethod(&m_EQInfoTimer, "start", Qt::QueuedConnection);
     }
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されているかどうかを確認
-    if (m_stopRequested.load()) return;
+    // ワンショット機能が有効の場合、全ての地震情報の処理が終了した後にソフトウェアを終了する
+    if (m_bOneShot) QMetaObject::invokeMethod(this, [this]() { exitIfIdle(); }, Qt::QueuedConnection);
 }
 
 
@@ -493,18 +706,32 @@ int Runner::getConfiguration(QString &filepath)
         QJsonObject earthquakeObj = JsonObject.value("earthquake").toObject();
 
         // 地震情報を取得するWebサイトを選択
-        // 0 : JMA (気象庁), 1 : P2P地震情報
+        // 0 : JMA (気象庁), 1 : P2P地震情報, 2 : P2P地震情報 (WebSocket API)
         m_iGetInfo = earthquakeObj.value("get").toInt();
-        if (m_iGetInfo != 0 && m_iGetInfo != 1) {
+#ifdef QEQALERT_WEBSOCKET
+        if (m_iGetInfo != 0 && m_iGetInfo != 1 && m_iGetInfo != 2) {
+            std::cerr << QString("\"get\"キーの値が不正です\n0、1または2を指定してください").toStdString() << std::endl;
+            return -1;
+        }
+#else
+        if (m_iGetInfo == 2) {
+            std::cerr << QString("\"get\"キーの値が2の場合は、WEBSOCKETオプションを有効にしてビルドする必要があります").toStdString() << std::endl;
+            return -1;
+        }
+        else if (m_iGetInfo != 0 && m_iGetInfo != 1) {
             std::cerr << QString("\"get\"キーの値が不正です\n0または1を指定してください").toStdString() << std::endl;
             return -1;
         }
+#endif
+
+        // WebSocket APIを使用する場合は、タイマで地震情報を取得しない
+        m_bPolling = m_iGetInfo != 2;
 
         // 緊急地震速報(警報)を取得するURL
         // 現在の仕様では、緊急地震速報(警報)はP2P地震情報から取得する
         QJsonObject alertURLObj = earthquakeObj.value("alerturl").toObject();
         if (m_iGetInfo == 0)      m_EQAlertURL = alertURLObj.value("jma").toString("");
-        else if (m_iGetInfo == 1) m_EQAlertURL = alertURLObj.value("p2p").toString("");
+        else                      m_EQAlertURL = alertURLObj.value("p2p").toString("");
 
         if (m_EQAlertURL.isEmpty()) {
             std::cerr << QString("\"alerturl\"キーの値が空欄です\n緊急地震速報(警報)を取得するURLを指定してください").toStdString() << std::endl;
@@ -514,105 +741,108 @@ int Runner::getConfiguration(QString &filepath)
         // 発生した地震情報を取得するURL
         QJsonObject infoURLObj = earthquakeObj.value("infourl").toObject();
         if (m_iGetInfo == 0)      m_EQInfoURL = infoURLObj.value("jma").toString("");
-        else if (m_iGetInfo == 1) m_EQInfoURL = infoURLObj.value("p2p").toString("");
+        else                      m_EQInfoURL = infoURLObj.value("p2p").toString("");
 
         if (m_EQInfoURL.isEmpty()) {
             std::cerr << QString("\"infourl\"キーの値が空欄です\n発生した地震情報を取得するURLを指定してください").toStdString() << std::endl;
             return -1;
         }
 
-        // 緊急地震速報(警報)の有効 / 無効
-        m_bEQAlert = earthquakeObj.value("alert").toBool(false);
-        if (m_bEQAlert) {
-            m_AlertFile = earthquakeObj.value("alertlog").toString("/tmp/eqalert.log");
-            if (m_AlertFile.isEmpty()) {
-                m_AlertFile = QString("/tmp/eqalert.log");
-            }
+        // JMAのXMLの解析方式
+        // "stream" : ストリーム形式 (QXmlStreamReader)、解析に失敗した場合はDOM形式で再解析する
+        // "dom"    : DOM形式 (QDomDocument)
+        auto xmlParser = earthquakeObj.value("xmlparser").toString("stream");
+        if (xmlParser.compare("stream", Qt::CaseInsensitive) != 0 && xmlParser.compare("dom", Qt::CaseInsensitive) != 0) {
+            std::cout << QString("警告 : \"xmlparser\"キーの値が不正です - 設定値 : %1").arg(xmlParser).toStdString() << std::endl;
+            std::cout << QString("強制的にstreamに設定されます").toStdString() << std::endl;
 
-            /// 緊急地震速報(警報)向けのログファイルが存在しない場合は空のログファイルを作成
-            QFile EQAlertFile(m_AlertFile);
-            if (!EQAlertFile.exists()) {
-                std::cout << QString("緊急地震速報(警報)のログファイルが存在しないため作成します %1").arg(m_AlertFile).toStdString() << std::endl;
+            xmlParser = "stream";
+        }
 
-                if (EQAlertFile.open(QIODevice::WriteOnly)) {
-                    try {
-                        // 空のJSON配列を作成
-                        QJsonArray jsonArray;
+        m_bStreamParser = xmlParser.compare("dom", Qt::CaseInsensitive) != 0;
 
-                        // 配列を使用してJSONドキュメントを作成
-                        QJsonDocument jsonDoc(jsonArray);
+        // 緊急地震速報(警報)を検出してから書き込みを完了するまでの期限 [mS]
+        // 0の場合は期限を設けない
+        m_AlertDeadline = earthquakeObj.value("alertdeadline").toInt(20000);
+        if (m_AlertDeadline != 0 && (m_AlertDeadline < 1000 || m_AlertDeadline > 120000)) {
+            std::cout << QString("警告 : 緊急地震速報(警報)の処理の期限が不正です - 設定値 : %1").arg(m_AlertDeadline).toStdString() << std::endl;
+            std::cout << QString("強制的に20000[mS]に設定されます").toStdString() << std::endl;
 
-                        // 空のJSONドキュメントをログファイルに書き込む
-                        EQAlertFile.write(jsonDoc.toJson());
+            m_AlertDeadline = 20000;
+        }
 
-                        EQAlertFile.close();
-                    }
-                    catch (QException &ex) {
-                        std::cerr << QString("エラー : 発生した地震情報のログファイルの作成に失敗 %1").arg(ex.what()).toStdString() << std::endl;
-                        return -1;
-                    }
-                }
-                else {
-                    std::cerr << QString("エラー : 緊急地震速報(警報)のログファイルの作成に失敗 %1").arg(EQAlertFile.errorString()).toStdString() << std::endl;
-                    return -1;
-                }
+#ifdef QEQALERT_WEBSOCKET
+        // P2P地震情報のWebSocket APIのURL
+        // WebSocket APIを使用する場合も、起動時および再接続時の取得にはJSON API ("alerturl"キーおよび"infourl"キーのURL) を使用する
+        if (m_iGetInfo == 2) {
+            m_EQWebSocketURL = earthquakeObj.value("wsurl").toString("wss://api.p2pquake.net/v2/ws");
+            if (m_EQWebSocketURL.isEmpty()) {
+                std::cerr << QString("\"wsurl\"キーの値が空欄です\nP2P地震情報のWebSocket APIのURLを指定してください").toStdString() << std::endl;
+                return -1;
             }
-            else {
-                QFileInfo EQFileInfo(m_AlertFile);
+        }
+#endif
 
-                /// 緊急地震速報(警報)向けのログファイルの権限を確認
-                if (!EQFileInfo.permission(QFile::ReadUser | QFile::WriteUser)) return -1;
+        // ログファイルの保持期間
+        // コンパクション時に、保持期間を過ぎたオブジェクトおよび最大数を超えたオブジェクトを削除する (0の場合は制限しない)
+        RETENTIONCONFIG retentionConfig;
 
-                /// 緊急地震速報(警報)向けのログファイルの構造を確認
-                if (!validateAndResetJsonFile(m_AlertFile))                     return -1;
-            }
+        retentionConfig.Days = earthquakeObj.value("retentiondays").toInt(90);
+        if (retentionConfig.Days < 0 || retentionConfig.Days > 3650) {
+            std::cout << QString("警告 : ログファイルの保持期間が不正です - 設定値 : %1").arg(retentionConfig.Days).toStdString() << std::endl;
+            std::cout << QString("強制的に90[日]に設定されます").toStdString() << std::endl;
+
+            retentionConfig.Days = 90;
         }
 
-        // 発生した地震情報の有効 / 無効
-        m_bEQInfo = earthquakeObj.value("info").toBool(false);
-        if (m_bEQInfo) {
-            m_InfoFile = earthquakeObj.value("infolog").toString("/tmp/eqinfo.log");
-            if (m_InfoFile.isEmpty()) {
-                m_InfoFile = QString("/tmp/eqinfo.log");
-            }
+        retentionConfig.Entries = earthquakeObj.value("retentionentries").toInt(1000);
+        if (retentionConfig.Entries != 0 && (retentionConfig.Entries < 10 || retentionConfig.Entries > 100000)) {
+            std::cout << QString("警告 : ログファイルの最大件数が不正です - 設定値 : %1").arg(retentionConfig.Entries).toStdString() << std::endl;
+            std::cout << QString("強制的に1000[件]に設定されます").toStdString() << std::endl;
 
-            /// 発生した地震情報向けのログファイルの存在を確認
-            QFile EQInfoFile(m_InfoFile);
-            if (!EQInfoFile.exists()) {
-                std::cout << QString("発生した地震情報のログファイルが存在しないため作成します %1").arg(m_InfoFile).toStdString() << std::endl;
+            retentionConfig.Entries = 1000;
+        }
 
-                try {
-                    if (EQInfoFile.open(QIODevice::WriteOnly)) {
-                        // 空のJSON配列を作成
-                        QJsonArray jsonArray;
+        m_ProcessWide.Retention = retentionConfig;
+        if (m_bProcessWide) EventStore::setRetention(retentionConfig);
 
-                        // 配列を使用してJSONドキュメントを作成
-                        QJsonDocument jsonDoc(jsonArray);
+        // ログファイルの保存形式
+        // "json"   : JSON配列のログファイルおよびジャーナルファイル
+        // "sqlite" : SQLiteのデータベース (CMakeの-DSQLITE=ONオプションが必要)
+        auto logBackendName = earthquakeObj.value("logbackend").toString("json");
+        if (logBackendName.compare("json", Qt::CaseInsensitive) != 0 && logBackendName.compare("sqlite", Qt::CaseInsensitive) != 0) {
+            std::cout << QString("警告 : \"logbackend\"キーの値が不正です - 設定値 : %1").arg(logBackendName).toStdString() << std::endl;
+            std::cout << QString("強制的にjsonに設定されます").toStdString() << std::endl;
 
-                        // 空のJSONドキュメントをログファイルに書き込む
-                        EQInfoFile.write(jsonDoc.toJson());
+            logBackendName = "json";
+        }
 
-                        EQInfoFile.close();
-                    }
-                    else {
-                        std::cerr << QString("エラー : 発生した地震情報のログファイルの作成に失敗 %1").arg(EQInfoFile.errorString()).toStdString() << std::endl;
-                        return -1;
-                    }
-                }
-                catch (QException &ex) {
-                    std::cerr << QString("エラー : 発生した地震情報のログファイルの作成に失敗 %1").arg(ex.what()).toStdString() << std::endl;
-                    return -1;
-                }
-            }
-            else {
-                QFileInfo EQFileInfo(m_InfoFile);
+        auto logBackend = logBackendName.compare("sqlite", Qt::CaseInsensitive) == 0 ? EventStore::Backend::Sqlite : EventStore::Backend::Json;
+        if (!EventStore::isAvailable(logBackend)) {
+            std::cout << QString("警告 : SQLite形式のログファイルは、CMakeの-DSQLITE=ONオプションを付加してビルドした場合のみ使用できます").toStdString() << std::endl;
+            std::cout << QString("強制的にjsonに設定されます").toStdString() << std::endl;
 
-                /// 発生した地震情報向けのログファイルの権限を確認
-                if (!EQFileInfo.permission(QFile::ReadUser | QFile::WriteUser)) return -1;
+            logBackend = EventStore::Backend::Json;
+        }
 
-                /// 発生した地震情報向けのログファイルの構造を確認
-                if (!validateAndResetJsonFile(m_InfoFile))                      return -1;
-            }
+        // デーモンモードの場合は、先頭の設定ファイルの保存形式を全ての設定ファイルで使用する
+        m_ProcessWide.LogBackend = logBackend;
+        if (m_bProcessWide) EventStore::setBackend(logBackend);
+        else                logBackend = EventStore::backend();
+
+        // 緊急地震速報(警報)の有効 / 無効
+        // ログファイルは、スレッド情報の設定 (書き込む掲示板) の取得後に作成する
+        m_bEQAlert  = earthquakeObj.value("alert").toBool(false);
+        m_AlertFile = earthquakeObj.value("alertlog").toString("/tmp/eqalert.log");
+        if (m_AlertFile.isEmpty()) {
+            m_AlertFile = QString("/tmp/eqalert.log");
+        }
+
+        // 発生した地震情報の有効 / 無効
+        m_bEQInfo  = earthquakeObj.value("info").toBool(false);
+        m_InfoFile = earthquakeObj.value("infolog").toString("/tmp/eqinfo.log");
+        if (m_InfoFile.isEmpty()) {
+            m_InfoFile = QString("/tmp/eqinfo.log");
         }
 
         // 震度の閾値
@@ -661,8 +891,40 @@ int Runner::getConfiguration(QString &filepath)
 
             /// 該当する地震情報の震度画像を取得するためのXPath式
             m_EQImageInfo.ImgXPath = imageObj.value("imgxpath").toString("");
+
+            /// 各XPath式を事前にコンパイルする
+            /// 1つでも不正なXPath式が存在する場合は、震度画像の取得機能を無効にする
+            for (const auto &xpath : {m_EQImageInfo.ListXPath, m_EQImageInfo.DetailXPath, m_EQImageInfo.UrlXPath, m_EQImageInfo.ImgXPath}) {
+                if (!XPathCache::compile(xpath)) {
+                    std::cout << QString("警告 : 震度画像を取得するためのXPath式が不正です - 設定値 : %1").arg(xpath).toStdString() << std::endl;
+                    std::cout << QString("震度画像の取得機能は強制的に無効に設定されます").toStdString() << std::endl;
+
+                    m_EQImageInfo.bEnable = false;
+                    break;
+                }
+            }
+        }
+
+        // HTTPクライアントの設定
+        // 全ての通信 (地震情報の取得、震度画像の取得、掲示板への書き込み) で共用する
+        QJsonObject networkObj = JsonObject.value("network").toObject();
+        NETWORKCONFIG networkConfig;
+
+        /// HTTP/2の有効 / 無効 (サーバが対応している場合のみ使用される)
+        networkConfig.bHttp2         = networkObj.value("http2").toBool(true);
+
+        /// ホストごとの最大接続数 (HTTP/1.1のみ、Qt 6.5以降で有効)
+        networkConfig.MaxConnections = networkObj.value("maxconnections").toInt(6);
+        if (networkConfig.MaxConnections < 1 || networkConfig.MaxConnections > 16) {
+            std::cout << QString("警告 : ホストごとの最大接続数が不正です - 設定値 : %1").arg(networkConfig.MaxConnections).toStdString() << std::endl;
+            std::cout << QString("強制的に6に設定されます").toStdString() << std::endl;
+
+            networkConfig.MaxConnections = 6;
         }
 
+        m_ProcessWide.Network = networkConfig;
+        if (m_bProcessWide) NetworkAccess::setConfig(networkConfig);
+
         // メンバ変数m_EQIntervalの値を使用して自動的に地震情報を取得するかどうか
         // ワンショット機能の有効 / 無効
         m_bOneShot = JsonObject.value("oneshot").toBool(false);
@@ -693,22 +955,18 @@ int Runner::getConfiguration(QString &filepath)
         }
 
         // スレッド情報の設定
-        QJsonObject threadObj = JsonObject.value("thread").toObject();
-
-        /// POSTデータを送信するURL
-        m_RequestURL          = threadObj.value("requesturl").toString("");
-
-        /// 地震情報で新規スレッドを作成するための名前欄
-        m_ThreadInfo.from     = threadObj.value("from").toString("佐藤");
-
-        /// スレッドに入力するメール欄
-        m_ThreadInfo.mail     = threadObj.value("mail").toString("");
-
-        /// BBS名
-        m_ThreadInfo.bbs      = threadObj.value("bbs").toString("");
+        // 複数の掲示板に書き込む場合は、"thread"キーを配列にして、掲示板ごとの設定を記述する
+        // 掲示板ごとに異なる設定 (POSTデータを送信するURL、BBS名等) 以外は、配列の先頭の要素の設定を全ての掲示板で使用する
+        QJsonArray threadArray;
+        if (JsonObject.value("thread").isArray()) threadArray = JsonObject.value("thread").toArray();
+        else                                      threadArray.append(JsonObject.value("thread").toObject());
+
+        if (threadArray.isEmpty()) {
+            std::cerr << QString("エラー : \"thread\"キーの配列に掲示板が設定されていません").toStdString() << std::endl;
+            return -1;
+        }
 
-        /// Shift-JISの有効 / 無効
-        m_ThreadInfo.shiftjis = threadObj.value("shiftjis").toBool(true);
+        QJsonObject threadObj = threadArray.at(0).toObject();
 
         /// 緊急地震地震速報で新規スレッドを作成する場合、スレッドタイトルに地震発現(到達)時刻を記載するかどうか
         /// trueの場合、スレッドタイトルに"発現時刻 hh:mm:ss"という文字列が付加される
@@ -718,9 +976,126 @@ int Runner::getConfiguration(QString &filepath)
         /// デフォルトは、"/html/head/title"タグを取得する
         m_ExpiredXPath      = threadObj.value("expiredxpath").toString("/html/head/title");
 
-        /// 発生した地震情報において、既存のスレッドに書き込む場合、スレッドのタイトルを変更するかどうか
-        /// この機能は、防弾嫌儲およびニュース速報(Libre)等のスレッドタイトルが変更できる掲示板で使用可能
-        m_EQchangeTitle     = threadObj.value("chtt").toBool(false);
+        /// XPath式を事前にコンパイルする (不正な場合はデフォルトのXPath式を使用する)
+        if (!XPathCache::compile(m_ExpiredXPath)) {
+            std::cout << QString("警告 : スレッドの生存を判断するXPath式が不正です - 設定値 : %1").arg(m_ExpiredXPath).toStdString() << std::endl;
+            std::cout << QString("強制的に\"/html/head/title\"に設定されます").toStdString() << std::endl;
+
+            m_ExpiredXPath = "/html/head/title";
+            XPathCache::compile(m_ExpiredXPath);
+        }
+
+        /// スレッドの生存確認に使用するスレッド一覧 (subject.txt) の有効期間 [秒]
+        /// 0の場合は、スレッド一覧を使用せずに各スレッドのHTMLを取得して確認する
+        auto threadCacheTTL = threadObj.value("threadcachettl").toInt(60);
+        if (threadCacheTTL < 0 || threadCacheTTL > 3600) {
+            std::cout << QString("警告 : スレッド一覧の有効期間が不正です - 設定値 : %1").arg(threadCacheTTL).toStdString() << std::endl;
+            std::cout << QString("強制的に60[秒]に設定されます").toStdString() << std::endl;
+
+            threadCacheTTL = 60;
+        }
+
+        m_ProcessWide.ThreadCacheTTL = threadCacheTTL;
+        if (m_bProcessWide) ThreadCache::setTTL(threadCacheTTL);
+
+        /// 書き込みに失敗した場合の再送
+        /// 書き込みに失敗した地震情報はファイルに保存して、再起動後も再送する
+        OUTBOXCONFIG outboxConfig;
+        outboxConfig.FileName = threadObj.value("outbox").toString("/tmp/eqoutbox.json");
+
+        outboxConfig.Retries  = threadObj.value("postretries").toInt(5);
+        if (outboxConfig.Retries < 0 || outboxConfig.Retries > 20) {
+            std::cout << QString("警告 : 書き込みの再送の最大回数が不正です - 設定値 : %1").arg(outboxConfig.Retries).toStdString() << std::endl;
+            std::cout << QString("強制的に5[回]に設定されます").toStdString() << std::endl;
+
+            outboxConfig.Retries = 5;
+        }
+
+        outboxConfig.Interval = threadObj.value("postinterval").toInt(3000);
+        if (outboxConfig.Interval < 0 || outboxConfig.Interval > 60000) {
+            std::cout << QString("警告 : 同じ掲示板へ書き込む間隔が不正です - 設定値 : %1").arg(outboxConfig.Interval).toStdString() << std::endl;
+            std::cout << QString("強制的に3000[mS]に設定されます").toStdString() << std::endl;
+
+            outboxConfig.Interval = 3000;
+        }
+
+        /// 前回の終了時に送信できなかった書き込みを読み込む (各地震情報オブジェクトの開始後に再送する)
+        /// 読み込みに失敗した場合は、送信待ちの書き込みが無いものとして起動する
+        /// デーモンモードの場合は、先頭の設定ファイルの送信待ちの書き込みを全ての設定ファイルで共用する
+        m_ProcessWide.Outbox = outboxConfig;
+        if (m_bProcessWide) {
+            Outbox::setConfig(outboxConfig);
+            Outbox::load();
+        }
+
+        /// 掲示板ごとの設定
+        /// 地震情報の取得および解析は1度のみ行い、整形した地震情報を各掲示板へ並行して書き込む
+        m_Boards.clear();
+        QStringList logFiles;
+        for (qsizetype i = 0; i < threadArray.size(); i++) {
+            const auto  boardObj = threadArray.at(i).toObject();
+            BOARDCONFIG board;
+
+            /// POSTデータを送信するURL
+            board.RequestURL          = boardObj.value("requesturl").toString("");
+
+            /// 地震情報で新規スレッドを作成するための名前欄
+            board.ThreadInfo.from     = boardObj.value("from").toString("佐藤");
+
+            /// スレッドに入力するメール欄
+            board.ThreadInfo.mail     = boardObj.value("mail").toString("");
+
+            /// BBS名
+            board.ThreadInfo.bbs      = boardObj.value("bbs").toString("");
+
+            /// Shift-JISの有効 / 無効
+            board.ThreadInfo.shiftjis = boardObj.value("shiftjis").toBool(true);
+
+            /// スレッドの最大レス数
+            /// 既存のスレッドに書き込む前にdatファイルの差分からレス数を数えて、上限に近い場合は新規スレッドを作成する
+            /// 0の場合は、レス数を確認しない
+            board.MaxReplies          = boardObj.value("maxreplies").toInt(1000);
+            if (board.MaxReplies != 0 && (board.MaxReplies < 50 || board.MaxReplies > 10000)) {
+                std::cout << QString("警告 : スレッドの最大レス数が不正です - 設定値 : %1").arg(board.MaxReplies).toStdString() << std::endl;
+                std::cout << QString("強制的に1000に設定されます").toStdString() << std::endl;
+
+                board.MaxReplies = 1000;
+            }
+
+            /// 発生した地震情報において、既存のスレッドに書き込む場合、スレッドのタイトルを変更するかどうか
+            /// この機能は、防弾嫌儲およびニュース速報(Libre)等のスレッドタイトルが変更できる掲示板で使用可能
+            board.bChangeTitle        = boardObj.value("chtt").toBool(false);
+
+            /// 掲示板ごとのログファイル
+            /// 指定しない場合、先頭の掲示板は"earthquake"キーのログファイル、2つ目以降の掲示板はBBS名を付加したログファイルを使用する
+            const auto suffix = board.ThreadInfo.bbs.isEmpty() ? QString::number(i) : board.ThreadInfo.bbs;
+
+            board.AlertFile = boardObj.value("alertlog").toString("");
+            if (board.AlertFile.isEmpty()) board.AlertFile = (i == 0) ? m_AlertFile : boardLogFile(m_AlertFile, suffix);
+
+            board.InfoFile  = boardObj.value("infolog").toString("");
+            if (board.InfoFile.isEmpty())  board.InfoFile  = (i == 0) ? m_InfoFile  : boardLogFile(m_InfoFile,  suffix);
+
+            /// 同じログファイルを複数の掲示板で使用する場合は、書き込み済みかどうかを掲示板ごとに判断できないため、エラーとする
+            for (const auto &logFile : {board.AlertFile, board.InfoFile}) {
+                if (logFiles.contains(logFile)) {
+                    std::cerr << QString("エラー : 同じログファイルが複数の掲示板に設定されています %1").arg(logFile).toStdString() << std::endl;
+                    std::cerr << QString("\"thread\"キーの各要素に、異なる\"alertlog\"キーおよび\"infolog\"キーを設定してください").toStdString() << std::endl;
+                    return -1;
+                }
+            }
+
+            logFiles << board.AlertFile << board.InfoFile;
+
+            m_Boards.append(board);
+        }
+
+        /// 各掲示板のログファイルが存在しない場合は空のログファイルを作成
+        /// SQLite形式の場合は、データベースに接続してテーブルを作成する (データベースが存在しない場合は作成される)
+        for (const auto &board : std::as_const(m_Boards)) {
+            if (m_bEQAlert && prepareLogFile(board.AlertFile, QStringLiteral("緊急地震速報(警報)"), logBackend))  return -1;
+            if (m_bEQInfo  && prepareLogFile(board.InfoFile,  QStringLiteral("発生した地震情報"),   logBackend))  return -1;
+        }
     }
     catch(QException &ex) {
         std::cerr << QString("エラー : %1").arg(ex.what()).toStdString() << std::endl;
@@ -731,6 +1106,269 @@ int Runner::getConfiguration(QString &filepath)
 }
 
 
+// デーモンモードにおいて、ディレクトリ内の全ての設定ファイル (*.json) をファイル名順に読み込む
+// 設定ファイルごとに震度の閾値、書き込む掲示板、ログファイルを持ち、同じ地震情報の取得のみを共有する
+// プロセス全体の設定 (HTTPクライアント、ログファイルの保存形式と保持期間、送信待ちの書き込み、スレッド一覧の有効期間、
+// ワンショット機能、取得の間隔) は、先頭の設定ファイルの設定を使用する
+//
+// 不正な設定ファイルは読み込まずに、残りの設定ファイルで起動する
+int Runner::loadTenants(const QString &dirPath)
+{
+    QDir dir(dirPath);
+    if (!dir.exists()) {
+        std::cerr << QString("エラー : 設定ファイルを格納したディレクトリが存在しません : %1").arg(dirPath).toStdString() << std::endl;
+        return -1;
+    }
+
+    const auto files = dir.entryInfoList(QStringList() << "*.json", QDir::Files | QDir::Readable, QDir::Name);
+    if (files.isEmpty()) {
+        std::cerr << QString("エラー : ディレクトリに設定ファイル (*.json) が存在しません : %1").arg(dirPath).toStdString() << std::endl;
+        return -1;
+    }
+
+    m_Tenants.clear();
+    QStringList logFiles;
+    for (const auto &file : files) {
+        auto filePath = file.absoluteFilePath();
+
+        std::unique_ptr<Runner> pTenant(new Runner(m_App, m_Tenants.empty(), this));
+        pTenant->m_SysConfFile = filePath;
+
+        if (pTenant->getConfiguration(filePath)) {
+            std::cerr << QString("エラー : 設定ファイルの読み込みに失敗したため、この設定ファイルを使用しません : %1").arg(filePath).toStdString() << std::endl;
+            continue;
+        }
+
+        if (!pTenant->m_bEQAlert && !pTenant->m_bEQInfo) {
+            std::cerr << QString("エラー : 緊急地震速報(警報)および発生した地震情報の取得がいずれも無効に設定されています : %1").arg(filePath).toStdString() << std::endl;
+            continue;
+        }
+
+        /// 同じログファイルを複数の設定ファイルで使用する場合は、書き込み済みかどうかを設定ファイルごとに判断できないため、この設定ファイルを使用しない
+        QStringList tenantLogFiles;
+        for (const auto &board : std::as_const(pTenant->m_Boards)) {
+            tenantLogFiles << board.AlertFile << board.InfoFile;
+        }
+
+        auto it = std::find_if(tenantLogFiles.cbegin(), tenantLogFiles.cend(), [&logFiles](const QString &logFile) { return logFiles.contains(logFile); });
+        if (it != tenantLogFiles.cend()) {
+            std::cerr << QString("エラー : 同じログファイルが複数の設定ファイルに設定されています %1 : %2").arg(*it, filePath).toStdString() << std::endl;
+            continue;
+        }
+
+        logFiles << tenantLogFiles;
+
+        if (!m_Tenants.empty()) checkProcessWide(*pTenant);
+
+        connect(pTenant.get(), &Runner::alertFinished, this, &Runner::onTenantAlertFinished, Qt::QueuedConnection);
+        connect(pTenant.get(), &Runner::infoFinished,  this, &Runner::onTenantInfoFinished,  Qt::QueuedConnection);
+
+        std::cout << QString("設定ファイルを読み込みました : %1").arg(filePath).toStdString() << std::endl;
+
+        m_Tenants.push_back(std::move(pTenant));
+    }
+
+    if (m_Tenants.empty()) {
+        std::cerr << QString("エラー : 使用できる設定ファイルがありません : %1").arg(dirPath).toStdString() << std::endl;
+        return -1;
+    }
+
+    // 同じURLの取得を、全ての設定ファイルの地震情報オブジェクトで共有する
+    FeedFetcher::setEnabled(true);
+
+    // ワンショット機能および取得の間隔は、先頭の設定ファイルの設定を使用する
+    const auto &pFirst = m_Tenants.front();
+    m_bOneShot        = pFirst->m_bOneShot;
+    m_EQAlertInterval = pFirst->m_EQAlertInterval;
+    m_EQInfoInterval  = pFirst->m_EQInfoInterval;
+
+    // タイマで取得する設定ファイルが存在する場合のみ、タイマを使用する
+    // 緊急地震速報(警報)および発生した地震情報のタイマは、いずれかの設定ファイルで有効の場合に使用する
+    m_bPolling = false;
+    m_bEQAlert = false;
+    m_bEQInfo  = false;
+    for (const auto &pTenant : m_Tenants) {
+        pTenant->m_bOneShot = m_bOneShot;
+
+        if (!pTenant->isPolling()) continue;
+
+        m_bPolling = true;
+        m_bEQAlert = m_bEQAlert || pTenant->m_bEQAlert;
+        m_bEQInfo  = m_bEQInfo  || pTenant->m_bEQInfo;
+    }
+
+    return 0;
+}
+
+
+// デーモンモードにおいて、2つ目以降の設定ファイルのプロセス全体の設定が、先頭の設定ファイルと異なる場合は警告する
+// プロセス全体の設定は、先頭の設定ファイルの値を使用して、2つ目以降の設定ファイルの値は無視される
+void Runner::checkProcessWide(const Runner &tenant) const
+{
+    const auto &first  = m_Tenants.front()->m_ProcessWide;
+    const auto &config = tenant.m_ProcessWide;
+
+    QStringList keys;
+    if (config.Retention.Days    != first.Retention.Days)       keys << "retentiondays";
+    if (config.Retention.Entries != first.Retention.Entries)    keys << "retentionentries";
+    if (config.LogBackend        != first.LogBackend)           keys << "logbackend";
+    if (config.Network.bHttp2    != first.Network.bHttp2)       keys << "http2";
+    if (config.Network.MaxConnections != first.Network.MaxConnections)  keys << "maxconnections";
+    if (config.ThreadCacheTTL    != first.ThreadCacheTTL)       keys << "threadcachettl";
+    if (config.Outbox.FileName   != first.Outbox.FileName)      keys << "outbox";
+    if (config.Outbox.Retries    != first.Outbox.Retries)       keys << "postretries";
+    if (config.Outbox.Interval   != first.Outbox.Interval)      keys << "postinterval";
+    if (tenant.m_bOneShot        != m_Tenants.front()->m_bOneShot)          keys << "oneshot";
+    if (tenant.m_EQAlertInterval != m_Tenants.front()->m_EQAlertInterval)   keys << "interval.alert";
+    if (tenant.m_EQInfoInterval  != m_Tenants.front()->m_EQInfoInterval)    keys << "interval.info";
+
+    if (keys.isEmpty()) return;
+
+    std::cout << QString("警告 : プロセス全体の設定が先頭の設定ファイルと異なります : %1").arg(tenant.m_SysConfFile).toStdString() << std::endl;
+    std::cout << QString("強制的に先頭の設定ファイル (%1) の値を使用します : %2").arg(m_Tenants.front()->m_SysConfFile, keys.join(", ")).toStdString() << std::endl;
+}
+
+
+// デーモンモードにおいて、地震情報の取得を開始する
+// タイマで取得する設定ファイルはデーモンのタイマで、WebSocket APIを使用する設定ファイルは1つの接続で受信した地震情報を処理する
+void Runner::startTenants()
+{
+#ifdef QEQALERT_WEBSOCKET
+    // WebSocket APIの接続は、先頭のWebSocket APIを使用する設定ファイルのURLを使用する
+    auto itPushed = std::find_if(m_Tenants.cbegin(), m_Tenants.cend(), [](const auto &pTenant) { return !pTenant->isPolling(); });
+    if (itPushed != m_Tenants.cend()) {
+        m_pWebSocket = std::make_unique<P2PWebSocket>(QUrl((*itPushed)->m_EQWebSocketURL), this);
+        connect(m_pWebSocket.get(), &P2PWebSocket::messageReceived, this, &Runner::onPushed);
+        connect(m_pWebSocket.get(), &P2PWebSocket::reconnected,     this, &Runner::onReconnected);
+        m_pWebSocket->start();
+    }
+#endif
+
+    if (m_bOneShot || !m_bPolling) {
+        // 自動的に地震情報を取得しない場合、タイマのシグナル / スロットを無効にする
+        disconnect(&m_EQAlertTimer, &QTimer::timeout, this, &Runner::fetchAlert);
+        disconnect(&m_EQInfoTimer,  &QTimer::timeout, this, &Runner::fetchInfo);
+    }
+    else {
+        if (m_bEQAlert) m_EQAlertTimer.start(static_cast<int>(m_EQAlertInterval));
+        if (m_bEQInfo)  m_EQInfoTimer.start(static_cast<int>(m_EQInfoInterval));
+    }
+
+    // WebSocket APIを使用する設定ファイルは、起動時のみJSON APIから最新の地震情報を取得する
+    for (const auto &pTenant : m_Tenants) {
+        if (pTenant->isPolling()) continue;
+
+        if (pTenant->m_bEQAlert) pTenant->fetchAlert();
+        if (pTenant->m_bEQInfo)  pTenant->fetchInfo();
+    }
+
+    if (m_bEQAlert) fetchAlert();
+    if (m_bEQInfo)  fetchInfo();
+
+    // ワンショット機能が有効の場合は、全ての設定ファイルの処理が終了した後にソフトウェアを終了する
+    if (m_bOneShot) exitIfIdle();
+}
+
+
+// タイマまたはワンショットで地震情報を取得するかどうかを確認する
+// WebSocket APIを使用する場合は、受信した地震情報のみを処理する
+bool Runner::isPolling() const
+{
+    return m_bPolling || m_bOneShot;
+}
+
+
+// デーモンモードにおいて、設定ファイルごとの緊急地震速報(警報)の処理が終了した場合のスロット
+// タイマで取得する全ての設定ファイルの処理が終了した場合に、タイマを再開する
+void Runner::onTenantAlertFinished()
+{
+    // WebSocket APIから受信した地震情報の処理が終了した場合
+    if (!m_bAlertRunning) return;
+
+    for (const auto &pTenant : m_Tenants) {
+        if (pTenant->isPolling() && pTenant->m_bAlertRunning) return;
+    }
+
+    onAlertFinished(0);
+}
+
+
+// デーモンモードにおいて、設定ファイルごとの発生した地震情報の処理が終了した場合のスロット
+// タイマで取得する全ての設定ファイルの処理が終了した場合に、タイマを再開する
+void Runner::onTenantInfoFinished()
+{
+    // WebSocket APIから受信した地震情報の処理が終了した場合
+    if (!m_bInfoRunning) return;
+
+    for (const auto &pTenant : m_Tenants) {
+        if (pTenant->isPolling() && pTenant->m_bInfoRunning) return;
+    }
+
+    onInfoFinished(0);
+}
+
+
+// 地震情報のログファイルが存在しない場合は、空のログファイルを作成する
+// 存在する場合は、ログファイルの権限および構造を確認する
+int Runner::prepareLogFile(const QString &filePath, const QString &kind, EventStore::Backend backend)
+{
+    QFile LogFile(filePath);
+    if (backend == EventStore::Backend::Sqlite) {
+        if (EventStore::open(filePath)->compact(30000) != 0)        return -1;
+    }
+    else if (!LogFile.exists()) {
+        std::cout << QString("%1のログファイルが存在しないため作成します %2").arg(kind, filePath).toStdString() << std::endl;
+
+        try {
+            if (LogFile.open(QIODevice::WriteOnly)) {
+                // 空のJSON配列を作成
+                QJsonArray jsonArray;
+
+                // 配列を使用してJSONドキュメントを作成
+                QJsonDocument jsonDoc(jsonArray);
+
+                // 空のJSONドキュメントをログファイルに書き込む
+                LogFile.write(jsonDoc.toJson());
+
+                LogFile.close();
+            }
+            else {
+                std::cerr << QString("エラー : %1のログファイルの作成に失敗 %2").arg(kind, LogFile.errorString()).toStdString() << std::endl;
+                return -1;
+            }
+        }
+        catch (QException &ex) {
+            std::cerr << QString("エラー : %1のログファイルの作成に失敗 %2").arg(kind, ex.what()).toStdString() << std::endl;
+            return -1;
+        }
+    }
+    else {
+        QFileInfo LogFileInfo(filePath);
+
+        /// ログファイルの権限を確認
+        if (!LogFileInfo.permission(QFile::ReadUser | QFile::WriteUser))  return -1;
+
+        /// ログファイルの構造を確認
+        if (!validateAndResetJsonFile(filePath))                        return -1;
+    }
+
+    return 0;
+}
+
+
+// 2つ目以降の掲示板のログファイルのパスを取得する
+// ログファイルのパスの形式 : <ディレクトリ>/<ファイル名>-<BBS名>.<拡張子>
+QString Runner::boardLogFile(const QString &filePath, const QString &suffix)
+{
+    QFileInfo fileInfo(filePath);
+
+    auto fileName = QString("%1-%2").arg(fileInfo.completeBaseName(), suffix);
+    if (!fileInfo.suffix().isEmpty()) fileName += QString(".%1").arg(fileInfo.suffix());
+
+    return fileInfo.dir().filePath(fileName);
+}
+
+
 bool Runner::validateAndResetJsonFile(const QString &filePath)
 {
     try {
@@ -792,6 +1430,195 @@ bool Runner::validateAndResetJsonFile(const QString &filePath)
 }
 
 
+// 地震情報の取得に関する統計を表示する
+// 条件付きGETリクエストにより、ダウンロードおよびパースを省略した回数 (304) と取得した回数 (200) を表示する
+// また、XMLの解析方式ごとの解析時間、HTTPリクエスト数とTLSハンドシェイクの回数を表示する
+void Runner::printStatistics() const
+{
+    // デーモンモードの場合は、設定ファイルごとに表示する
+    if (m_Tenants.empty()) {
+        printTenantStatistics();
+    }
+    else {
+        for (const auto &pTenant : m_Tenants) {
+            std::cout << QString("設定ファイル %1").arg(pTenant->m_SysConfFile).toStdString() << std::endl;
+            pTenant->printTenantStatistics();
+        }
+
+        // 地震情報の取得の共有の統計
+        // 共有した回数が多い場合は、複数の設定ファイルで同じ地震情報の取得を1度に抑えている
+        auto sharedStats = FeedFetcher::GetStats();
+        if (sharedStats.Fetches + sharedStats.Shared != 0) {
+            std::cout << QString("地震情報の取得の共有 : ネットワークから取得 %1 回 (304 Not Modified : %2 回), 共有 %3 回")
+                         .arg(sharedStats.Fetches)
+                         .arg(sharedStats.NotModified)
+                         .arg(sharedStats.Shared)
+                         .toStdString() << std::endl;
+        }
+    }
+
+    // スレッドの生存確認の統計
+    // スレッド一覧から確認した回数がsubject.txtの取得回数より十分に多い場合は、キャッシュが有効に機能している
+    auto cacheStats = ThreadCache::GetStats();
+    if (cacheStats.Hits + cacheStats.Fetches + cacheStats.Unavailable != 0) {
+        std::cout << QString("スレッドの生存確認 : スレッド一覧から確認 %1 回, subject.txtの取得 %2 回, 個別に確認 %3 回")
+                     .arg(cacheStats.Hits)
+                     .arg(cacheStats.Fetches)
+                     .arg(cacheStats.Unavailable)
+                     .toStdString() << std::endl;
+    }
+
+    // スレッドのタイトルの取得の統計
+    // </title>タグの受信後に転送を中断した場合は、1回あたりの受信バイト数がスレッド全体のサイズより十分に小さくなる
+    auto fetchStats = HtmlFetcher::GetStats();
+    if (fetchStats.TitleFetches != 0) {
+        std::cout << QString("スレッドのタイトルの取得 : %1 回 (転送を中断 : %2 回, 平均受信サイズ : %3 [KB])")
+                     .arg(fetchStats.TitleFetches)
+                     .arg(fetchStats.TitleAborts)
+                     .arg(static_cast<double>(fetchStats.TitleBytes) / 1024.0 / static_cast<double>(fetchStats.TitleFetches), 0, 'f', 1)
+                     .toStdString() << std::endl;
+    }
+
+    // 送信待ちの書き込みの統計
+    // 再送により書き込みに成功した回数が多い場合は、掲示板への書き込みが不安定である
+    auto outboxStats = Outbox::GetStats();
+    if (outboxStats.Enqueued + outboxStats.Recovered != 0) {
+        std::cout << QString("送信待ちの書き込み : 追加 %1 件 (起動時に読み込み : %2 件), 再送 %3 回 (成功 : %4 件), 破棄 %5 件, 送信待ち %6 件")
+                     .arg(outboxStats.Enqueued)
+                     .arg(outboxStats.Recovered)
+                     .arg(outboxStats.Retries)
+                     .arg(outboxStats.Delivered)
+                     .arg(outboxStats.Dropped)
+                     .arg(outboxStats.Pending)
+                     .toStdString() << std::endl;
+    }
+
+#ifdef QEQALERT_WEBSOCKET
+    // P2P地震情報のWebSocket APIの統計
+    if (m_pWebSocket) {
+        std::cout << QString("WebSocket APIから受信した地震情報 : %1 件 (重複により破棄 : %2 件, 再接続 : %3 回)")
+                     .arg(m_pWebSocket->GetReceived())
+                     .arg(m_pWebSocket->GetDuplicates())
+                     .arg(m_pWebSocket->GetReconnects())
+                     .toStdString() << std::endl;
+    }
+#endif
+
+    // 共用のHTTPクライアントの統計
+    // TLSハンドシェイクの回数がリクエスト数より十分に少ない場合は、接続が再利用されている
+    auto netStats = NetworkAccess::GetStats();
+    if (netStats.Requests != 0) {
+        std::cout << QString("HTTPリクエスト数 : %1 回 (TLSハンドシェイク : %2 回, エラー : %3 回)")
+                     .arg(netStats.Requests)
+                     .arg(netStats.Handshakes)
+                     .arg(netStats.Errors)
+                     .toStdString() << std::endl;
+    }
+}
+
+
+// 設定ファイルごとの統計 (地震情報の取得、解析、書き込みおよびログファイル) を表示する
+void Runner::printTenantStatistics() const
+{
+    FEEDSTATS stats;
+    for (const auto *pEarthQuake : {m_pEarthQuake.get(), m_pEarthQuakeInfo.get()}) {
+        if (pEarthQuake == nullptr) continue;
+
+        auto eqStats = pEarthQuake->GetFeedStats();
+        stats.NotModified  += eqStats.NotModified;
+        stats.Modified     += eqStats.Modified;
+        stats.StreamParsed += eqStats.StreamParsed;
+        stats.DomParsed    += eqStats.DomParsed;
+        stats.Fallbacks    += eqStats.Fallbacks;
+        stats.StreamNsecs  += eqStats.StreamNsecs;
+        stats.DomNsecs     += eqStats.DomNsecs;
+        stats.Posts        += eqStats.Posts;
+        stats.PostNsecs    += eqStats.PostNsecs;
+        stats.MaxPostNsecs  = std::max(stats.MaxPostNsecs, eqStats.MaxPostNsecs);
+        stats.CookieReuses += eqStats.CookieReuses;
+        stats.CookieFetches += eqStats.CookieFetches;
+        stats.DeadlineMisses += eqStats.DeadlineMisses;
+    }
+
+    auto total = stats.NotModified + stats.Modified;
+    if (total != 0) {
+        std::cout << QString("地震情報の取得回数 : %1 回 (304 Not Modified : %2 回, 200 OK : %3 回, 省略率 : %4 %)")
+                     .arg(total)
+                     .arg(stats.NotModified)
+                     .arg(stats.Modified)
+                     .arg(static_cast<double>(stats.NotModified) * 100.0 / static_cast<double>(total), 0, 'f', 1)
+                     .toStdString() << std::endl;
+    }
+
+    // JMAのXMLの解析の統計
+    // ストリーム形式とDOM形式の1回あたりの平均解析時間を比較できる ("xmlparser"キーで解析方式を切り替える)
+    if (stats.StreamParsed != 0) {
+        std::cout << QString("XMLの解析 (ストリーム形式) : %1 回 (平均 : %2 [μS], DOM形式で再解析 : %3 回)")
+                     .arg(stats.StreamParsed)
+                     .arg(static_cast<double>(stats.StreamNsecs) / 1000.0 / static_cast<double>(stats.StreamParsed), 0, 'f', 1)
+                     .arg(stats.Fallbacks)
+                     .toStdString() << std::endl;
+    }
+
+    if (stats.DomParsed != 0) {
+        std::cout << QString("XMLの解析 (DOM形式) : %1 回 (平均 : %2 [μS])")
+                     .arg(stats.DomParsed)
+                     .arg(static_cast<double>(stats.DomNsecs) / 1000.0 / static_cast<double>(stats.DomParsed), 0, 'f', 1)
+                     .toStdString() << std::endl;
+    }
+
+    // 地震情報を検出してからPOSTデータを送信するまでの時間
+    // 掲示板との接続の維持およびクッキーの再利用による効果を確認できる
+    if (stats.Posts != 0) {
+        std::cout << QString("地震情報の検出から書き込みまでの時間 : %1 回 (平均 : %2 [mS], 最大 : %3 [mS])")
+                     .arg(stats.Posts)
+                     .arg(static_cast<double>(stats.PostNsecs) / 1000000.0 / static_cast<double>(stats.Posts), 0, 'f', 1)
+                     .arg(static_cast<double>(stats.MaxPostNsecs) / 1000000.0, 0, 'f', 1)
+                     .toStdString() << std::endl;
+    }
+
+    if (stats.CookieReuses + stats.CookieFetches != 0) {
+        std::cout << QString("掲示板のクッキー : 再利用 %1 回, 取得 %2 回")
+                     .arg(stats.CookieReuses)
+                     .arg(stats.CookieFetches)
+                     .toStdString() << std::endl;
+    }
+
+    // 処理の期限 (緊急地震速報(警報)のみ)
+    if (stats.DeadlineMisses != 0) {
+        std::cout << QString("処理の期限 : 期限切れにより中止 %1 回")
+                     .arg(stats.DeadlineMisses)
+                     .toStdString() << std::endl;
+    }
+
+    // ログファイルの統計
+    // 起動時からのオブジェクト数およびファイルサイズの増減により、保持期間の設定が適切かどうかを確認できる
+    // 複数の掲示板に書き込む場合は、掲示板ごとに表示する
+    QList<std::pair<bool, QString>> logFiles;
+    for (const auto &board : m_Boards) {
+        logFiles.append({m_bEQAlert, board.AlertFile});
+        logFiles.append({m_bEQInfo,  board.InfoFile});
+    }
+
+    for (const auto &[bEnable, logFile] : logFiles) {
+        if (!bEnable) continue;
+
+        auto logStats = EventStore::open(logFile)->GetStats();
+        if (!logStats.bLoaded) continue;
+
+        std::cout << QString("ログファイル %1 : %2 件 (起動時から %3 件), %4 [KB] (起動時から %5 [KB]), 保持期間による削除 : %6 件, コンパクション : %7 回")
+                     .arg(logFile)
+                     .arg(logStats.Entries)
+                     .arg(QString::asprintf("%+lld", static_cast<long long>(logStats.Entries - logStats.InitialEntries)))
+                     .arg(static_cast<double>(logStats.Bytes) / 1024.0, 0, 'f', 1)
+                     .arg(QString::asprintf("%+.1f", static_cast<double>(logStats.Bytes - logStats.InitialBytes) / 1024.0))
+                     .arg(logStats.Expired)
+                     .arg(logStats.Compactions)
+                     .toStdString() << std::endl;
+    }
+}
+
+
 // [q]キーまたは[Q]キー ==> [Enter]キーを押下した場合、メインループを抜けて本ソフトウェアを終了する
 void Runner::onReadyRead()
 {
@@ -802,7 +1629,74 @@ void Runner::onReadyRead()
     if (line.compare("q", Qt::CaseInsensitive) == 0) {
         m_stopRequested.store(true);
 
+#ifdef QEQALERT_WEBSOCKET
+        // P2P地震情報のWebSocket APIとの接続を終了
+        if (m_pWebSocket) m_pWebSocket->stop();
+#endif
+
+        // 処理中の地震情報の処理をキャンセルして、各スレッドで送信中のリクエストを中断する
+        if (m_pEarthQuake)      m_pEarthQuake->cancel();
+        if (m_pEarthQuakeInfo)  m_pEarthQuakeInfo->cancel();
+
+        // デーモンモードの場合は、全ての設定ファイルの処理をキャンセルする
+        for (const auto &pTenant : m_Tenants) {
+            pTenant->m_stopRequested.store(true);
+
+            if (pTenant->m_pEarthQuake)      pTenant->m_pEarthQuake->cancel();
+            if (pTenant->m_pEarthQuakeInfo)  pTenant->m_pEarthQuakeInfo->cancel();
+        }
+
+        // 終了前に地震情報の取得に関する統計を表示
+        printStatistics();
+
         QCoreApplication::exit();
         return;
     }
 }
+
+
+#ifdef QEQALERT_WEBSOCKET
+// P2P地震情報のWebSocket APIから地震情報を受信した場合のスロット
+// 556 (緊急地震速報(警報)) および 551 (発生した地震情報) の地震情報を、それぞれの処理へ渡す
+void Runner::onPushed(int code, const QByteArray &data)
+{
+    if (m_stopRequested.load()) return;
+
+    // デーモンモードの場合は、WebSocket APIを使用する全ての設定ファイルへ渡す
+    if (!m_Tenants.empty()) {
+        for (const auto &pTenant : m_Tenants) {
+            if (!pTenant->isPolling()) pTenant->onPushed(code, data);
+        }
+
+        return;
+    }
+
+    m_PushedData = data;
+
+    if (code == 556 && m_bEQAlert)      fetchAlert();
+    else if (code == 551 && m_bEQInfo)  fetchInfo();
+
+    m_PushedData.clear();
+}
+
+
+// P2P地震情報のWebSocket APIに再接続した場合のスロット
+// 切断中に配信された地震情報は再配信されないため、JSON APIから最新の地震情報を取得し直す
+// 既に処理した地震情報は、ログファイルの地震IDで除外される
+void Runner::onReconnected()
+{
+    if (m_stopRequested.load()) return;
+
+    // デーモンモードの場合は、WebSocket APIを使用する全ての設定ファイルで取得し直す
+    if (!m_Tenants.empty()) {
+        for (const auto &pTenant : m_Tenants) {
+            if (!pTenant->isPolling()) pTenant->onReconnected();
+        }
+
+        return;
+    }
+
+    if (m_bEQAlert) fetchAlert();
+    if (m_bEQInfo)  fetchInfo();
+}
+#endif
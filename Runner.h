@@ -13,8 +13,28 @@
 #include <QObject>
 #include <QTimer>
 #include <memory>
+#include <chrono>
+#include <vector>
 #include "EarthQuake.h"
 #include "Image.h"
+#include "EventStore.h"
+#include "NetworkAccess.h"
+#include "Outbox.h"
+
+#ifdef QEQALERT_WEBSOCKET
+    #include "P2PWebSocket.h"
+#endif
+
+
+// プロセス全体で共用する設定
+// デーモンモードの場合は、先頭の設定ファイルの値を全ての設定ファイルで使用する (2つ目以降の設定ファイルの値が異なる場合は警告する)
+struct PROCESSWIDECONFIG {
+    RETENTIONCONFIG         Retention;                                  // ログファイルの保持期間
+    EventStore::Backend     LogBackend     = EventStore::Backend::Json; // ログファイルの保存形式
+    NETWORKCONFIG           Network;                                    // HTTPクライアントの設定
+    int                     ThreadCacheTTL = 60;                        // スレッド一覧の有効期間 [秒]
+    OUTBOXCONFIG            Outbox;                                     // 送信待ちの書き込みの設定
+};
 
 
 class Runner : public QObject
@@ -27,28 +47,37 @@ private:  // Variables
     QStringList                             m_args;         // コマンドラインオプション
     QString                                 m_SysConfFile;  // このソフトウェアの設定ファイルのパス
     QString                                 m_TestFile;     // テストファイルを使用する場合のファイルのパス (XMLまたはJSON)
-    bool                                    m_bOneShot;     // ワンショット機能の有効 / 無効
+    QString                                 m_ConfDir;      // デーモンモードの場合、設定ファイルを格納したディレクトリのパス
+    std::vector<std::unique_ptr<Runner>>    m_Tenants;      // デーモンモードの場合、設定ファイルごとのランナー (ファイル名順)
+    bool                                    m_bTenant,      // デーモンモードにおける設定ファイルごとのランナーかどうか
+                                                            // trueの場合、タイマおよびソフトウェアの終了はデーモンのランナーが管理する
+                                            m_bProcessWide; // プロセス全体の設定 (HTTPクライアント、ログファイルの保存形式、送信待ちの書き込み等) を変更するかどうか
+                                                            // デーモンモードの場合は、先頭の設定ファイルのランナーのみtrue
+    PROCESSWIDECONFIG                       m_ProcessWide;  // 設定ファイルから読み込んだプロセス全体の設定 (プロセス全体の設定を変更しない場合も保存する)
+    bool                                    m_bOneShot,     // ワンショット機能の有効 / 無効
                                                             // メンバ変数m_EQIntervalの値を使用して自動的に地震情報を取得するかどうか
-    QString                                 m_RequestURL;   // 地震情報を書き込むためのPOSTデータを送信するURL
-    THREAD_INFO                             m_ThreadInfo;   // 地震情報を書き込むスレッドの情報
+                                            m_bPolling;     // タイマで地震情報を取得するかどうか (WebSocket APIを使用する場合はfalse)
+                                                            // デーモンモードの場合は、タイマで取得する設定ファイルが1つ以上存在するかどうか
+    QList<BOARDCONFIG>                      m_Boards;       // 地震情報を書き込む掲示板の設定 (POSTデータを送信するURL、スレッドの情報、ログファイル等)
 
     // 地震の情報
     int                                     m_iGetInfo;         // 地震情報を取得するWebサイト
                                                                 // 0 : JMA (気象庁)
                                                                 // 1 : P2P地震情報
+                                                                // 2 : P2P地震情報 (WebSocket API)
+    bool                                    m_bStreamParser;    // JMAのXMLをストリーム形式 (QXmlStreamReader) で解析するかどうか
+    int                                     m_AlertDeadline;    // 緊急地震速報(警報)を検出してから書き込みを完了するまでの期限 [mS] (0の場合は期限を設けない)
     QString                                 m_EQAlertURL,       // 緊急地震速報(警報)を取得するURL
                                             m_EQInfoURL;        // 発生した地震情報を取得するURL
     bool                                    m_bEQAlert,         // 緊急地震速報(警報)の有効 / 無効
                                             m_bEQInfo;          // 発生した地震情報の有効 / 無効
     int                                     m_AlertScale,       // 緊急地震速報(警報)における震度の閾値 (この震度以上の場合は新規スレッドを作成する)
                                             m_InfoScale;        // 発生した地震情報における震度の閾値 (この震度以上の場合は新規スレッドを作成または既存のスレッドに書き込む)
-    QString                                 m_AlertFile,        // 緊急地震速報(警報)の地震情報を保存するファイルパス
-                                            m_InfoFile;         // 発生した地震情報を保存するファイルパス
+    QString                                 m_AlertFile,        // 緊急地震速報(警報)の地震情報を保存するファイルパス (先頭の掲示板のデフォルト)
+                                            m_InfoFile;         // 発生した地震情報を保存するファイルパス (先頭の掲示板のデフォルト)
     bool                                    m_EQsubTime;        // 緊急地震地震速報で新規スレッドを作成する場合、スレッドタイトルに地震発現(到達)時刻を記載するかどうか
     QString                                 m_ExpiredXPath;     // スレッドの生存を判断するときに使用するXPath
                                                                 // デフォルトは、"/html/head/title"タグを取得する
-    bool                                    m_EQchangeTitle;    // 発生した地震情報のスレッドのタイトルを変更するかどうか
-                                                                // 防弾嫌儲およびニュース速報(Libre)等のスレッドのタイトルが変更できる掲示板で使用可能
     QTimer                                  m_EQAlertTimer,     // 緊急地震速報(警報)を取得するためのインターバル時間をトリガとするタイマ
                                             m_EQInfoTimer;      // 発生した地震情報を取得するためのインターバル時間をトリガとするタイマ
     int                                     m_EQAlertInterval,  // 緊急地震速報(警報)の情報を取得する時間間隔 (デフォルト : 10[秒]〜)
@@ -57,6 +86,20 @@ private:  // Variables
     std::unique_ptr<EarthQuake>             m_pEarthQuakeInfo;  // 発生した地震情報を管理するオブジェクト
     EQIMAGEINFO                             m_EQImageInfo;      // 震度画像を取得するための設定オブジェクト
     std::atomic<bool>                       m_stopRequested;    // [q]キーまたは[Q]キーを押下した場合のフラグ
+    bool                                    m_bAlertRunning,    // 緊急地震速報(警報)の処理中かどうか
+                                            m_bInfoRunning;     // 発生した地震情報の処理中かどうか
+#ifdef _DEBUG
+    std::chrono::high_resolution_clock::time_point  m_AlertStart,   // 緊急地震速報(警報)の処理開始時刻
+                                                    m_InfoStart;    // 発生した地震情報の処理開始時刻
+#endif
+
+#ifdef QEQALERT_WEBSOCKET
+    // P2P地震情報のWebSocket API
+    QString                                 m_EQWebSocketURL;   // P2P地震情報のWebSocket APIのURL
+    std::unique_ptr<P2PWebSocket>           m_pWebSocket;       // P2P地震情報のWebSocket APIから地震情報を受信するオブジェクト
+    QByteArray                              m_PushedData;       // WebSocket APIから受信した地震情報のデータ
+                                                                // fetchAlert()メソッドおよびfetchInfo()メソッドの実行中のみ有効
+#endif
 
 #ifdef Q_OS_LINUX
     std::unique_ptr<QSocketNotifier>        m_pNotifier;    // このソフトウェアを終了するためのキーボードシーケンスオブジェクト
@@ -70,18 +113,41 @@ private:    // Methods
     int     getConfiguration(QString &filepath);                    // このソフトウェアの設定ファイルの情報を取得
     bool    validateAndResetJsonFile(const QString &filePath);      // JSONファイルの構造が正常かどうかを確認
                                                                     // 不正な場合は、空のJSONファイルで上書き
+    int     prepareLogFile(const QString &filePath,                 // 地震情報のログファイルが存在しない場合は作成して、存在する場合は構造を確認する
+                           const QString &kind, EventStore::Backend backend);
+    static QString boardLogFile(const QString &filePath,            // 2つ目以降の掲示板のログファイルのパスを取得する
+                                const QString &suffix);
+    int     loadTenants(const QString &dirPath);                    // デーモンモードにおいて、ディレクトリ内の全ての設定ファイルを読み込む
+    void    startTenants();                                         // デーモンモードにおいて、地震情報の取得を開始する
+    void    checkProcessWide(const Runner &tenant) const;           // デーモンモードにおいて、先頭の設定ファイルとプロセス全体の設定が異なる場合は警告する
+    [[nodiscard]] bool  isPolling() const;                          // タイマまたはワンショットで地震情報を取得するかどうか (WebSocket APIを使用しない場合)
+    void    printStatistics() const;                                // 地震情報の取得に関する統計を表示する
+    void    printTenantStatistics() const;                          // 設定ファイルごとの統計 (地震情報の取得およびログファイル) を表示する
+    void    exitIfIdle();                                           // ワンショット機能が有効の場合、全ての処理が終了していればソフトウェアを終了する
+    Runner(QCoreApplication &app, bool bProcessWide, QObject *parent);  // デーモンモードにおける設定ファイルごとのランナーのコンストラクタ
 
 public:  // Methods
     explicit    Runner(QCoreApplication &app, QStringList args, QObject *parent = nullptr);
     ~Runner() override = default;
 
 signals:
+    void alertFinished();   // デーモンモードにおいて、緊急地震速報(警報)の処理が終了した場合のシグナル
+    void infoFinished();    // デーモンモードにおいて、発生した地震情報の処理が終了した場合のシグナル
 
 public slots:
     void run();             // このソフトウェアを最初に実行する時にのみ実行するメイン処理
     void fetchAlert();      // 緊急地震速報(警報)を取得するスロット
     void fetchInfo();       // 発生した地震情報を取得するスロット
+    void onAlertFinished(int result);   // 緊急地震速報(警報)の処理が終了した場合のスロット
+    void onInfoFinished(int result);    // 発生した地震情報の処理が終了した場合のスロット
     void onReadyRead();     // ノンブロッキングでキー入力を受信するスロット
+    void onTenantAlertFinished();   // デーモンモードにおいて、設定ファイルごとの緊急地震速報(警報)の処理が終了した場合のスロット
+    void onTenantInfoFinished();    // デーモンモードにおいて、設定ファイルごとの発生した地震情報の処理が終了した場合のスロット
+
+#ifdef QEQALERT_WEBSOCKET
+    void onPushed(int code, const QByteArray &data);    // P2P地震情報のWebSocket APIから地震情報を受信した場合のスロット
+    void onReconnected();                               // P2P地震情報のWebSocket APIに再接続した場合のスロット
+#endif
 };
 
 #endif // RUNNER_H
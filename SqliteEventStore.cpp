@@ -0,0 +1,744 @@
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QSqlError>
+#include <QMutexLocker>
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <utility>
+#include "SqliteEventStore.h"
+
+
+QThreadStorage<SqliteConnections*>  SqliteEventStore::s_Connections;
+
+
+// コンパクションを実行するスレッドプール
+// データベースの接続はスレッドごとに作成されるため、コンパクションは終了しない1つのスレッドのみで実行して、
+// グローバルなスレッドプールの各スレッドにデータベースの接続を作成しない
+static QThreadPool& compactionPool()
+{
+    static QThreadPool    pool;
+    static std::once_flag once;
+    std::call_once(once, []() {
+        pool.setMaxThreadCount(1);
+        pool.setExpiryTimeout(-1);
+    });
+
+    return pool;
+}
+
+
+// このスレッドの全ての接続を破棄する
+// QSqlDatabase::removeDatabase関数は、接続を参照するオブジェクトが存在しない状態で呼び出す必要がある
+SqliteConnections::~SqliteConnections()
+{
+    for (const auto &name : std::as_const(m_Names)) {
+        {
+            auto db = QSqlDatabase::database(name, false);
+            db.close();
+        }
+
+        QSqlDatabase::removeDatabase(name);
+    }
+}
+
+
+// 空の文字列の場合はNULLとする (NULLの列はインデックスの検索対象にならない)
+static QVariant nullable(const QString &value)
+{
+    return value.isEmpty() ? QVariant() : QVariant(value);
+}
+
+
+// eventsテーブルの各列の値をバインドする
+// 緊急地震速報(警報)と発生した地震情報では、スレッドのタイトル、キー、URLのキー名が異なる
+//   緊急地震速報(警報) : "threadtitle"キー、"threadkey"キー、"threadurl"キー
+//   発生した地震情報   : "title"キー、"thread"キー、"url"キー
+static void bindColumns(QSqlQuery &query, const QJsonObject &object)
+{
+    const auto url = object.value("url").toString();
+
+    query.addBindValue(nullable(object.value("reportdatetime").toString()));
+    query.addBindValue(nullable(url));
+    query.addBindValue(nullable(object.value("hypocentre").toString()));
+    query.addBindValue(nullable(object.value("prefs").toString()));
+    query.addBindValue(nullable(object.value("threadtitle").toString(object.value("title").toString())));
+    query.addBindValue(nullable(object.value("threadkey").toString(object.value("thread").toString())));
+    query.addBindValue(nullable(object.value("threadurl").toString(url)));
+    query.addBindValue(object.value("logged").toString());
+    query.addBindValue(QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact)));
+}
+
+
+SqliteEventStore::SqliteEventStore(QString fileName) : m_FileName(std::move(fileName))
+{
+}
+
+
+SqliteEventStore::~SqliteEventStore() = default;
+
+
+// 現在のスレッドおよびコンパクションを実行するスレッドのデータベースの接続を破棄する
+// メインスレッドの接続は、アプリケーションの終了時に呼び出して破棄する
+// 実行中のコンパクションが存在する場合は、終了を待機する
+void SqliteEventStore::cleanup()
+{
+    compactionPool().start([]() { ReleaseConnections(); });
+    compactionPool().waitForDone();
+
+    ReleaseConnections();
+}
+
+
+// 実行中および予約済みのコンパクションの終了を待機する
+void SqliteEventStore::waitForCompaction()
+{
+    compactionPool().waitForDone();
+}
+
+
+// 現在のスレッドのデータベースの接続を破棄する
+void SqliteEventStore::ReleaseConnections()
+{
+    if (s_Connections.hasLocalData()) {
+        s_Connections.setLocalData(nullptr);
+    }
+}
+
+
+// 現在のスレッドのデータベースの接続を取得する
+// 存在しない場合は、接続してテーブルおよびインデックスを作成する
+// 接続に失敗した場合は、無効なオブジェクト (isOpen関数がfalse) を返す
+QSqlDatabase SqliteEventStore::Database(int lockTimeout)
+{
+    if (!s_Connections.hasLocalData()) {
+        s_Connections.setLocalData(new SqliteConnections());
+    }
+
+    auto *pConnections = s_Connections.localData();
+
+    auto name = pConnections->m_Names.value(m_FileName);
+    if (name.isEmpty()) {
+        name = QString("qEQAlert:%1:%2").arg(m_FileName).arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+
+        auto bOpened = false;
+        {
+            auto db = QSqlDatabase::addDatabase("QSQLITE", name);
+            db.setDatabaseName(m_FileName);
+
+            if (!db.open()) {
+                std::cerr << QString("エラー : データベースのオープンに失敗しました %1").arg(db.lastError().text()).toStdString() << std::endl;
+            }
+            else if (!CreateSchema(db)) {
+                db.close();
+            }
+            else {
+                bOpened = true;
+            }
+        }
+
+        if (!bOpened) {
+            QSqlDatabase::removeDatabase(name);
+            return {};
+        }
+
+        pConnections->m_Names.insert(m_FileName, name);
+    }
+
+    auto db = QSqlDatabase::database(name, false);
+
+    // 他のプロセスが書き込み中の場合は、最大lockTimeout[mS]の間、SQLiteが待機する
+    QSqlQuery query(db);
+    query.exec(QString("PRAGMA busy_timeout = %1").arg(lockTimeout < 0 ? 0x7FFFFFFF : lockTimeout));
+
+    // 統計のために、最初に接続した時点のオブジェクト数およびサイズを保存する
+    // また、保持期間を過ぎたオブジェクトが存在する場合は、書き込みを待たずに削除する
+    // (オブジェクト数の取得およびコンパクションの予約は、ミューテックスを保持せずに行う)
+    {
+        QMutexLocker locker(&m_Mutex);
+        if (m_InitialEntries >= 0) return db;
+    }
+
+    const auto entries = Count(db);
+    const auto bytes   = FileSize();
+    {
+        QMutexLocker locker(&m_Mutex);
+
+        // 他のスレッドが先に保存した場合
+        if (m_InitialEntries >= 0) return db;
+
+        m_Entries        = entries;
+        m_InitialEntries = entries;
+        m_InitialBytes   = bytes;
+    }
+
+    ScheduleCompaction(true);
+
+    return db;
+}
+
+
+// テーブルおよびインデックスを作成する
+// WALモードでは、書き込み中も他の接続は書き込み前の内容を読み込める
+bool SqliteEventStore::CreateSchema(QSqlDatabase &db)
+{
+    const QStringList statements = {
+        "PRAGMA journal_mode = WAL",
+        "PRAGMA synchronous = FULL",
+        "PRAGMA foreign_keys = ON",
+        "CREATE TABLE IF NOT EXISTS events ("
+        "    seq            INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "    reportdatetime TEXT,"
+        "    url            TEXT,"
+        "    hypocentre     TEXT,"
+        "    prefs          TEXT,"
+        "    title          TEXT,"
+        "    threadkey      TEXT,"
+        "    threadurl      TEXT,"
+        "    logged         TEXT NOT NULL,"
+        "    object         TEXT NOT NULL)",
+        "CREATE TABLE IF NOT EXISTS event_ids ("
+        "    seq            INTEGER NOT NULL REFERENCES events(seq) ON DELETE CASCADE,"
+        "    id             TEXT NOT NULL)",
+        "CREATE TABLE IF NOT EXISTS event_prefs ("
+        "    seq            INTEGER NOT NULL REFERENCES events(seq) ON DELETE CASCADE,"
+        "    pref           TEXT NOT NULL)",
+        "CREATE INDEX IF NOT EXISTS events_url        ON events(url)",
+        "CREATE INDEX IF NOT EXISTS events_hypocentre ON events(hypocentre)",
+        "CREATE INDEX IF NOT EXISTS events_logged     ON events(logged)",
+        "CREATE INDEX IF NOT EXISTS event_ids_id      ON event_ids(id)",
+        "CREATE INDEX IF NOT EXISTS event_ids_seq     ON event_ids(seq)",
+        "CREATE INDEX IF NOT EXISTS event_prefs_pref  ON event_prefs(pref)",
+        "CREATE INDEX IF NOT EXISTS event_prefs_seq   ON event_prefs(seq)",
+    };
+
+    for (const auto &statement : statements) {
+        QSqlQuery query(db);
+        if (!query.exec(statement)) {
+            std::cerr << QString("エラー : データベースの初期化に失敗しました %1").arg(query.lastError().text()).toStdString() << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// データベースのサイズ (WALファイルを含む) を取得する
+qint64 SqliteEventStore::FileSize() const
+{
+    return QFileInfo(m_FileName).size() + QFileInfo(m_FileName + "-wal").size();
+}
+
+
+// オブジェクト数を取得する
+qint64 SqliteEventStore::Count(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    if (!query.exec("SELECT COUNT(*) FROM events") || !query.next()) return 0;
+
+    return query.value(0).toLongLong();
+}
+
+
+// 指定した数のプレースホルダ ("?, ?, ...") を作成する
+QString SqliteEventStore::Placeholders(int count)
+{
+    QStringList placeholders;
+    for (auto i = 0; i < count; i++) {
+        placeholders.append("?");
+    }
+
+    return placeholders.join(", ");
+}
+
+
+// SQL文を実行する
+// 失敗した場合はエラーを表示する
+bool SqliteEventStore::Exec(QSqlQuery &query)
+{
+    if (!query.exec()) {
+        std::cerr << QString("エラー : SQL文の実行に失敗しました %1").arg(query.lastError().text()).toStdString() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+// 指定した条件のオブジェクトが存在するかどうかを確認する
+int SqliteEventStore::Exists(const QString &sql, const QVariantList &values, int lockTimeout)
+{
+    auto db = Database(lockTimeout);
+    if (!db.isOpen()) return -1;
+
+    QSqlQuery query(db);
+    query.prepare(sql);
+    for (const auto &value : values) {
+        query.addBindValue(value);
+    }
+
+    if (!Exec(query)) return -1;
+
+    return query.next() ? 1 : 0;
+}
+
+
+// 指定した条件の最初のオブジェクトを取得する
+// SQL文は、オブジェクト (object列) のみを取得すること
+int SqliteEventStore::FindFirst(const QString &sql, const QVariantList &values, QJsonObject &object, int lockTimeout)
+{
+    auto db = Database(lockTimeout);
+    if (!db.isOpen()) return -1;
+
+    QSqlQuery query(db);
+    query.prepare(sql);
+    for (const auto &value : values) {
+        query.addBindValue(value);
+    }
+
+    if (!Exec(query)) return -1;
+    if (!query.next()) return 0;
+
+    object = QJsonDocument::fromJson(query.value(0).toByteArray()).object();
+
+    return 1;
+}
+
+
+// オブジェクトを追加する
+bool SqliteEventStore::Insert(QSqlDatabase &db, const QJsonObject &object)
+{
+    QSqlQuery query(db);
+    query.prepare("INSERT INTO events (reportdatetime, url, hypocentre, prefs, title, threadkey, threadurl, logged, object) "
+                  "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    bindColumns(query, object);
+
+    if (!Exec(query)) return false;
+
+    return InsertKeys(db, query.lastInsertId().toLongLong(), object);
+}
+
+
+// 指定した行のオブジェクトを置き換える
+// 地震IDおよび都道府県の行は、削除してから再度追加する
+bool SqliteEventStore::Replace(QSqlDatabase &db, qint64 row, const QJsonObject &object)
+{
+    QSqlQuery query(db);
+    query.prepare("UPDATE events SET reportdatetime = ?, url = ?, hypocentre = ?, prefs = ?, title = ?, threadkey = ?, threadurl = ?, "
+                  "logged = ?, object = ? WHERE seq = ?");
+    bindColumns(query, object);
+    query.addBindValue(row);
+
+    if (!Exec(query)) return false;
+
+    for (const auto &table : {QString("event_ids"), QString("event_prefs")}) {
+        QSqlQuery deleteQuery(db);
+        deleteQuery.prepare(QString("DELETE FROM %1 WHERE seq = ?").arg(table));
+        deleteQuery.addBindValue(row);
+
+        if (!Exec(deleteQuery)) return false;
+    }
+
+    return InsertKeys(db, row, object);
+}
+
+
+// 地震IDおよび都道府県の行を追加する
+// 緊急地震速報(警報)の"id"キーは文字列、発生した地震情報の"id"キーは配列である
+bool SqliteEventStore::InsertKeys(QSqlDatabase &db, qint64 row, const QJsonObject &object)
+{
+    QStringList ids;
+
+    const auto id = object.value("id");
+    if (id.isArray()) {
+        for (const auto &value : id.toArray()) {
+            if (value.isString()) ids.append(value.toString());
+        }
+    }
+    else if (id.isString()) {
+        ids.append(id.toString());
+    }
+
+    QStringList prefs;
+    const auto prefsValue = object.value("prefs").toString("");
+    if (!prefsValue.isEmpty()) {
+        prefs = prefsValue.split(",");
+        prefs.removeDuplicates();
+    }
+
+    const QList<std::pair<QString, QStringList>> keys = {{"INSERT INTO event_ids (seq, id) VALUES (?, ?)", ids},
+                                                         {"INSERT INTO event_prefs (seq, pref) VALUES (?, ?)", prefs}};
+    for (const auto &[sql, values] : keys) {
+        if (values.isEmpty()) continue;
+
+        QSqlQuery query(db);
+        query.prepare(sql);
+
+        for (const auto &value : values) {
+            query.bindValue(0, row);
+            query.bindValue(1, value);
+
+            if (!Exec(query)) return false;
+        }
+    }
+
+    return true;
+}
+
+
+// 書き込みのトランザクションを開始して、functionが成功した場合はコミットする
+// BEGIN IMMEDIATEにより、トランザクションの開始時に書き込みのロックを取得する (他のプロセスとの競合による失敗を防ぐ)
+template <typename Function>
+bool SqliteEventStore::Transaction(QSqlDatabase &db, Function function)
+{
+    QSqlQuery query(db);
+    if (!query.exec("BEGIN IMMEDIATE")) {
+        std::cerr << QString("エラー : トランザクションの開始に失敗しました %1").arg(query.lastError().text()).toStdString() << std::endl;
+        return false;
+    }
+
+    if (!function()) {
+        query.exec("ROLLBACK");
+        return false;
+    }
+
+    if (!query.exec("COMMIT")) {
+        std::cerr << QString("エラー : トランザクションのコミットに失敗しました %1").arg(query.lastError().text()).toStdString() << std::endl;
+        query.exec("ROLLBACK");
+
+        return false;
+    }
+
+    return true;
+}
+
+
+// 書き込みのトランザクション内でオブジェクトを変更する
+// 変更の回数が閾値を超えた場合は、スレッドプールでコンパクションを行う
+template <typename Function>
+int SqliteEventStore::Modify(int lockTimeout, Function function)
+{
+    auto db = Database(lockTimeout);
+    if (!db.isOpen()) return -1;
+
+    if (!Transaction(db, [&db, &function]() { return function(db); })) return -1;
+
+    const auto entries = Count(db);
+    {
+        QMutexLocker locker(&m_Mutex);
+
+        m_Entries = entries;
+        m_Writes++;
+    }
+
+    ScheduleCompaction();
+
+    return 0;
+}
+
+
+// 指定した条件の全てのオブジェクトを変更する
+// SQL文は、行番号 (seq列) およびオブジェクト (object列) を取得すること
+int SqliteEventStore::Update(const QString &sql, const QVariantList &values, const std::function<void(QJsonObject&)> &update, int lockTimeout)
+{
+    return Modify(lockTimeout, [this, &sql, &values, &update](QSqlDatabase &db) {
+        QSqlQuery query(db);
+        query.prepare(sql);
+        for (const auto &value : values) {
+            query.addBindValue(value);
+        }
+
+        if (!Exec(query)) return false;
+
+        QList<std::pair<qint64, QJsonObject>> rows;
+        while (query.next()) {
+            rows.append({query.value(0).toLongLong(), QJsonDocument::fromJson(query.value(1).toByteArray()).object()});
+        }
+
+        query.finish();
+
+        const auto now = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        for (auto &[row, object] : rows) {
+            update(object);
+            object["logged"] = now;
+
+            if (!Replace(db, row, object)) return false;
+        }
+
+        return true;
+    });
+}
+
+
+// 指定した条件の全てのオブジェクトを削除する
+// 地震IDおよび都道府県の行は、外部キー制約により削除される
+int SqliteEventStore::Remove(const QString &sql, const QVariantList &values, int lockTimeout)
+{
+    return Modify(lockTimeout, [&sql, &values](QSqlDatabase &db) {
+        QSqlQuery query(db);
+        query.prepare(sql);
+        for (const auto &value : values) {
+            query.addBindValue(value);
+        }
+
+        return Exec(query);
+    });
+}
+
+
+// 保持期間または最大数を超えたオブジェクトを削除する
+// 最大数を超えた場合は、最後に追加または変更した日時が古いオブジェクトから削除する
+// 戻り値は、削除したオブジェクト数 (失敗した場合は-1)
+int SqliteEventStore::ApplyRetention(QSqlDatabase &db)
+{
+    auto expired = 0;
+
+    // 保持期間
+    if (s_Retention.Days > 0) {
+        QSqlQuery query(db);
+        query.prepare("DELETE FROM events WHERE logged < ?");
+        query.addBindValue(QDateTime::currentDateTimeUtc().addDays(-s_Retention.Days).toString(Qt::ISODate));
+
+        if (!Exec(query)) return -1;
+
+        expired += query.numRowsAffected();
+    }
+
+    // 最大数
+    if (s_Retention.Entries > 0) {
+        QSqlQuery query(db);
+        // 新しい順に最大数までのオブジェクトを残して、それ以外を削除する
+        query.prepare("DELETE FROM events WHERE seq NOT IN (SELECT seq FROM events ORDER BY logged DESC, seq DESC LIMIT ?)");
+        query.addBindValue(s_Retention.Entries);
+
+        if (!Exec(query)) return -1;
+
+        expired += query.numRowsAffected();
+    }
+
+    return expired;
+}
+
+
+// 変更の回数が閾値を超えた場合、または、bForceがtrueの場合は、コンパクション用のスレッドでコンパクションを行う
+// コンパクションは書き込みの処理 (緊急地震速報(警報)の書き込み等) を待機させない
+void SqliteEventStore::ScheduleCompaction(bool bForce)
+{
+    {
+        QMutexLocker locker(&m_Mutex);
+
+        if (m_bCompacting) return;
+        if (!bForce && m_Writes < CompactWrites) return;
+
+        m_bCompacting = true;
+    }
+
+    auto pStore = shared_from_this();
+    compactionPool().start([pStore]() {
+        pStore->compact(30000);
+    });
+}
+
+
+// ログファイルの統計を取得する
+EVENTSTORESTATS SqliteEventStore::GetStats() const
+{
+    QMutexLocker locker(&m_Mutex);
+
+    EVENTSTORESTATS stats;
+    stats.bLoaded        = m_InitialEntries >= 0;
+    stats.Entries        = m_Entries;
+    stats.InitialEntries = std::max<qint64>(m_InitialEntries, 0);
+    stats.Bytes          = FileSize();
+    stats.InitialBytes   = m_InitialBytes;
+    stats.Expired        = m_Expired;
+    stats.Compactions    = m_Compactions;
+
+    return stats;
+}
+
+
+// 同じ地震IDが存在するかどうかを確認する
+int SqliteEventStore::containsID(const QString &id, int lockTimeout)
+{
+    return Exists("SELECT 1 FROM event_ids WHERE id = ? LIMIT 1", {id}, lockTimeout);
+}
+
+
+// 同じURLが存在するかどうかを確認する
+int SqliteEventStore::containsURL(const QString &url, int lockTimeout)
+{
+    return Exists("SELECT 1 FROM events WHERE url = ? LIMIT 1", {url}, lockTimeout);
+}
+
+
+// 同じ地震IDかつ同じ報告日時 ("reportdatetime"キー) が存在するかどうかを確認する
+int SqliteEventStore::containsReport(const QString &id, const QString &reportDateTime, int lockTimeout)
+{
+    return Exists("SELECT 1 FROM event_ids INNER JOIN events ON events.seq = event_ids.seq "
+                  "WHERE event_ids.id = ? AND events.reportdatetime = ? LIMIT 1", {id, reportDateTime}, lockTimeout);
+}
+
+
+// 同じ震源地のオブジェクトを取得する
+// 複数存在する場合は、最初に追加したオブジェクトを取得する
+int SqliteEventStore::findByHypocentre(const QString &hypo, QJsonObject &object, int lockTimeout)
+{
+    if (hypo.isEmpty()) return 0;
+
+    return FindFirst("SELECT object FROM events WHERE hypocentre = ? ORDER BY seq LIMIT 1", {hypo}, object, lockTimeout);
+}
+
+
+// 同じ都道府県 (最大震度) を含む最初のオブジェクトを取得する
+int SqliteEventStore::findByPrefs(const QStringList &prefs, QJsonObject &object, int lockTimeout)
+{
+    if (prefs.isEmpty()) return 0;
+
+    QVariantList values;
+    for (const auto &pref : prefs) {
+        values.append(pref);
+    }
+
+    return FindFirst(QString("SELECT object FROM events WHERE seq IN (SELECT seq FROM event_prefs WHERE pref IN (%1)) ORDER BY seq LIMIT 1")
+                     .arg(Placeholders(static_cast<int>(prefs.size()))), values, object, lockTimeout);
+}
+
+
+// オブジェクトを追加する
+int SqliteEventStore::append(const QJsonObject &object, int lockTimeout)
+{
+    auto newObject = object;
+    newObject["logged"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+    return Modify(lockTimeout, [this, &newObject](QSqlDatabase &db) {
+        return Insert(db, newObject);
+    });
+}
+
+
+// 同じ震源地の全てのオブジェクトを変更する
+int SqliteEventStore::updateByHypocentre(const QString &hypo, const std::function<void(QJsonObject&)> &update, int lockTimeout)
+{
+    return Update("SELECT seq, object FROM events WHERE hypocentre = ? ORDER BY seq", {hypo}, update, lockTimeout);
+}
+
+
+// 同じ都道府県 (最大震度) を含む全てのオブジェクトを変更する
+// 各オブジェクトは、含まれる都道府県の数に関係なく1度だけ変更する
+int SqliteEventStore::updateByPrefs(const QStringList &prefs, const std::function<void(QJsonObject&)> &update, int lockTimeout)
+{
+    if (prefs.isEmpty()) return 0;
+
+    QVariantList values;
+    for (const auto &pref : prefs) {
+        values.append(pref);
+    }
+
+    return Update(QString("SELECT seq, object FROM events WHERE seq IN (SELECT seq FROM event_prefs WHERE pref IN (%1)) ORDER BY seq")
+                  .arg(Placeholders(static_cast<int>(prefs.size()))), values, update, lockTimeout);
+}
+
+
+// 同じ震源地の全てのオブジェクトを削除する
+int SqliteEventStore::removeByHypocentre(const QString &hypo, int lockTimeout)
+{
+    return Remove("DELETE FROM events WHERE hypocentre = ?", {hypo}, lockTimeout);
+}
+
+
+// 同じ都道府県 (最大震度) を含む全てのオブジェクトを削除する
+int SqliteEventStore::removeByPrefs(const QStringList &prefs, int lockTimeout)
+{
+    if (prefs.isEmpty()) return 0;
+
+    QVariantList values;
+    for (const auto &pref : prefs) {
+        values.append(pref);
+    }
+
+    return Remove(QString("DELETE FROM events WHERE seq IN (SELECT seq FROM event_prefs WHERE pref IN (%1))")
+                  .arg(Placeholders(static_cast<int>(prefs.size()))), values, lockTimeout);
+}
+
+
+// 保持期間を過ぎたオブジェクトを削除して、WALファイルの内容をデータベースへ反映する
+// 通常はスレッドプールから呼び出される
+int SqliteEventStore::compact(int lockTimeout)
+{
+    {
+        QMutexLocker locker(&m_Mutex);
+        m_bCompacting = false;
+        m_Writes      = 0;
+    }
+
+    auto db = Database(lockTimeout);
+    if (!db.isOpen()) return -1;
+
+    auto expired = 0;
+    if (!Transaction(db, [this, &db, &expired]() {
+        expired = ApplyRetention(db);
+        return expired >= 0;
+    })) {
+        return -1;
+    }
+
+    // WALファイルの内容をデータベースへ反映して、WALファイルを空にする
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA wal_checkpoint(TRUNCATE)")) {
+        std::cerr << QString("警告 : WALファイルのチェックポイントに失敗しました %1").arg(query.lastError().text()).toStdString() << std::endl;
+    }
+
+    const auto entries = Count(db);
+
+    QMutexLocker locker(&m_Mutex);
+    m_Entries  = entries;
+    m_Expired += expired;
+    m_Compactions++;
+
+    return 0;
+}
+
+
+// 全てのオブジェクトを取得する
+// ログファイルの変換 (--convert-logオプション) に使用する
+int SqliteEventStore::exportObjects(QList<QJsonObject> &objects, int lockTimeout)
+{
+    auto db = Database(lockTimeout);
+    if (!db.isOpen()) return -1;
+
+    QSqlQuery query(db);
+    query.prepare("SELECT object FROM events ORDER BY seq");
+    if (!Exec(query)) return -1;
+
+    objects.clear();
+    while (query.next()) {
+        objects.append(QJsonDocument::fromJson(query.value(0).toByteArray()).object());
+    }
+
+    return 0;
+}
+
+
+// オブジェクトをまとめて追加する
+// 全てのオブジェクトを1つのトランザクションで追加する
+// 変換元の"logged"キー (最後に追加または変更した日時) を保持するため、保持期間は変換前から継続する
+int SqliteEventStore::importObjects(const QList<QJsonObject> &objects, int lockTimeout)
+{
+    return Modify(lockTimeout, [this, &objects](QSqlDatabase &db) {
+        const auto now = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+        for (auto newObject : objects) {
+            if (!newObject.contains("logged")) newObject["logged"] = now;
+
+            if (!Insert(db, newObject)) return false;
+        }
+
+        return true;
+    });
+}
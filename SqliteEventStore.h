@@ -0,0 +1,122 @@
+#ifndef SQLITEEVENTSTORE_H
+#define SQLITEEVENTSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QVariant>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QThreadStorage>
+#include <functional>
+#include <memory>
+#include "EventStore.h"
+
+
+// スレッドごとのデータベースの接続
+// QSqlDatabaseクラスの接続は生成したスレッドでのみ使用できるため、スレッドの終了時に接続を破棄する
+class SqliteConnections
+{
+public:     // Variables
+    QHash<QString, QString>                 m_Names;            // データベースのパスごとの接続名
+
+public:     // Methods
+    SqliteConnections() = default;
+    ~SqliteConnections();                                       // このスレッドの全ての接続を破棄する
+    SqliteConnections(const SqliteConnections&)            = delete;
+    SqliteConnections& operator=(const SqliteConnections&) = delete;
+};
+
+
+// ログファイル (緊急地震速報(警報)および発生した地震情報) をSQLiteのデータベースに保存するクラス
+// CMakeの-DSQLITE=ONオプションを付加してビルドした場合のみ使用できる
+//
+// データベースはWALモードで使用するため、書き込み中も他のプロセスおよびスレッドは読み込みができる
+// 各オブジェクトは、eventsテーブルの1行にJSON形式のまま保存して、検索に使用するキーは別の列およびテーブルに保存する
+//   events      : 報告日時、URL、震源地、スレッドのタイトル / キー / URL、最後に追加または変更した日時、オブジェクト
+//   event_ids   : 地震ID (発生した地震情報は1つのオブジェクトに複数の地震IDが存在する)
+//   event_prefs : 最も震度の大きい都道府県 (1つのオブジェクトに複数の都道府県が存在する)
+// 地震ID、URL、都道府県、震源地、日時にはインデックスを作成するため、各検索および変更は1回のインデックス検索で行う
+class SqliteEventStore : public EventStore, public std::enable_shared_from_this<SqliteEventStore>
+{
+private:    // Variables
+    QString                                         m_FileName;             // データベースのパス
+    mutable QMutex                                  m_Mutex;                // 以下のメンバ変数を保護するミューテックス
+    qint64                                          m_Entries        = 0,   // 最後に確認した時点のオブジェクト数
+                                                    m_InitialEntries = -1,  // 最初に接続した時点のオブジェクト数 (-1の場合は未接続)
+                                                    m_InitialBytes   = 0,   // 最初に接続した時点のデータベースのサイズ (WALファイルを含む)
+                                                    m_Expired        = 0,   // 保持期間または最大数により削除したオブジェクト数
+                                                    m_Compactions    = 0;   // コンパクションの回数
+    int                                             m_Writes      = 0;      // 前回のコンパクションからの変更の回数
+    bool                                            m_bCompacting = false;  // コンパクションを予約済みかどうか
+
+    static constexpr int                            CompactWrites = 256;    // コンパクションを行う変更の回数
+
+    static QThreadStorage<SqliteConnections*>       s_Connections;          // スレッドごとのデータベースの接続
+
+private:    // Methods
+    [[nodiscard]] QSqlDatabase Database(int lockTimeout);                       // 現在のスレッドのデータベースの接続を取得する (存在しない場合は作成する)
+    bool                CreateSchema(QSqlDatabase &db);                         // テーブルおよびインデックスを作成する
+    [[nodiscard]] qint64 FileSize() const;                                      // データベースのサイズ (WALファイルを含む) を取得する
+    int                 Exists(const QString &sql, const QVariantList &values,  // 指定した条件のオブジェクトが存在するかどうかを確認する
+                               int lockTimeout);
+    int                 FindFirst(const QString &sql, const QVariantList &values,   // 指定した条件の最初のオブジェクトを取得する
+                                  QJsonObject &object, int lockTimeout);
+    bool                Insert(QSqlDatabase &db, const QJsonObject &object);    // オブジェクトを追加する
+    bool                Replace(QSqlDatabase &db, qint64 row, const QJsonObject &object);   // 指定した行のオブジェクトを置き換える
+    bool                InsertKeys(QSqlDatabase &db, qint64 row, const QJsonObject &object);    // 地震IDおよび都道府県の行を追加する
+    int                 Update(const QString &sql, const QVariantList &values,  // 指定した条件の全てのオブジェクトを変更する
+                               const std::function<void(QJsonObject&)> &update, int lockTimeout);
+    int                 Remove(const QString &sql, const QVariantList &values,  // 指定した条件の全てのオブジェクトを削除する
+                               int lockTimeout);
+    int                 ApplyRetention(QSqlDatabase &db);                       // 保持期間または最大数を超えたオブジェクトを削除する
+    void                ScheduleCompaction(bool bForce = false);                // 必要な場合は、コンパクション用のスレッドでコンパクションを行う (ミューテックスを取得せずに呼び出す)
+    template <typename Function>
+    int                 Modify(int lockTimeout, Function function);             // 書き込みのトランザクション内でオブジェクトを変更する
+    template <typename Function>
+    static bool         Transaction(QSqlDatabase &db, Function function);       // 書き込みのトランザクションを開始して、成功した場合はコミットする
+
+    static void         ReleaseConnections();                                   // 現在のスレッドのデータベースの接続を破棄する
+    [[nodiscard]] static qint64 Count(QSqlDatabase &db);                        // オブジェクト数を取得する
+    static QString      Placeholders(int count);                                // 指定した数のプレースホルダ ("?, ?, ...") を作成する
+    static bool         Exec(QSqlQuery &query);                                 // SQL文を実行する (失敗した場合はエラーを表示する)
+
+public:     // Methods
+    explicit SqliteEventStore(QString fileName);
+    ~SqliteEventStore() override;
+
+    static void cleanup();                                                          // 現在のスレッドおよびコンパクション用のスレッドのデータベースの接続を破棄する
+    static void waitForCompaction();                                                // 実行中および予約済みのコンパクションの終了を待機する
+
+    [[nodiscard]] EVENTSTORESTATS GetStats() const override;                        // ログファイルの統計を取得する
+
+    // 検索 (1 : 存在する, 0 : 存在しない, -1 : データベースの読み込みに失敗)
+    int     containsID(const QString &id, int lockTimeout) override;                // 同じ地震IDが存在するかどうかを確認する
+    int     containsURL(const QString &url, int lockTimeout) override;              // 同じURLが存在するかどうかを確認する
+    int     containsReport(const QString &id, const QString &reportDateTime,        // 同じ地震IDかつ同じ報告日時が存在するかどうかを確認する
+                           int lockTimeout) override;
+    int     findByHypocentre(const QString &hypo, QJsonObject &object,              // 同じ震源地のオブジェクトを取得する
+                             int lockTimeout) override;
+    int     findByPrefs(const QStringList &prefs, QJsonObject &object,              // 同じ都道府県 (最大震度) を含む最初のオブジェクトを取得する
+                        int lockTimeout) override;
+
+    // 変更 (0 : 成功, -1 : 失敗)
+    int     append(const QJsonObject &object, int lockTimeout) override;            // オブジェクトを追加する
+    int     updateByHypocentre(const QString &hypo,                                 // 同じ震源地の全てのオブジェクトを変更する
+                               const std::function<void(QJsonObject&)> &update, int lockTimeout) override;
+    int     updateByPrefs(const QStringList &prefs,                                 // 同じ都道府県 (最大震度) を含む全てのオブジェクトを変更する
+                          const std::function<void(QJsonObject&)> &update, int lockTimeout) override;
+    int     removeByHypocentre(const QString &hypo, int lockTimeout) override;      // 同じ震源地の全てのオブジェクトを削除する
+    int     removeByPrefs(const QStringList &prefs, int lockTimeout) override;      // 同じ都道府県 (最大震度) を含む全てのオブジェクトを削除する
+    int     compact(int lockTimeout) override;                                      // 保持期間を過ぎたオブジェクトを削除して、WALファイルをデータベースへ反映する
+
+    // 変換 (0 : 成功, -1 : 失敗)
+    int     exportObjects(QList<QJsonObject> &objects, int lockTimeout) override;       // 全てのオブジェクトを取得する (追加した順序)
+    int     importObjects(const QList<QJsonObject> &objects, int lockTimeout) override; // オブジェクトをまとめて追加する ("logged"キーは保持する)
+};
+
+
+#endif // SQLITEEVENTSTORE_H
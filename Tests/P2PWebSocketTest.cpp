@@ -0,0 +1,272 @@
+#include <QtTest>
+#include <QWebSocketServer>
+#include <QWebSocket>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <memory>
+#include <utility>
+#include "P2PWebSocket.h"
+
+
+// P2P地震情報のWebSocket APIの代わりとなるローカルのWebSocketサーバ (スタンドイン)
+// 接続しているクライアントへ任意のメッセージを配信して、任意の時点で切断する
+class P2PStandIn : public QObject
+{
+    Q_OBJECT
+
+private:
+    QWebSocketServer    m_Server;           // WebSocketサーバ
+    QList<QWebSocket*>  m_Clients;          // 接続しているクライアント
+    quint16             m_Port = 0;         // 待ち受けるポート番号 (再起動後も同じポート番号を使用する)
+
+public:
+    explicit P2PStandIn(QObject *parent = nullptr) : QObject{parent},
+        m_Server(QStringLiteral("P2PStandIn"), QWebSocketServer::NonSecureMode)
+    {
+        connect(&m_Server, &QWebSocketServer::newConnection, this, [this]() {
+            while (m_Server.hasPendingConnections()) {
+                auto pClient = m_Server.nextPendingConnection();
+                m_Clients.append(pClient);
+
+                connect(pClient, &QWebSocket::disconnected, this, [this, pClient]() {
+                    m_Clients.removeAll(pClient);
+                    pClient->deleteLater();
+                });
+
+                emit clientConnected();
+            }
+        });
+    }
+
+    // 待ち受けを開始する (2回目以降は前回と同じポート番号を使用する)
+    bool listen()
+    {
+        if (!m_Server.listen(QHostAddress::LocalHost, m_Port)) return false;
+        m_Port = m_Server.serverPort();
+
+        return true;
+    }
+
+    // 待ち受けを終了して、接続しているクライアントを切断する
+    void shutdown()
+    {
+        m_Server.close();
+        dropClients();
+    }
+
+    // 接続しているクライアントを切断する
+    // 切断時にdisconnectedシグナルからクライアントを削除するため、複製したリストを使用する
+    void dropClients()
+    {
+        const auto clients = m_Clients;
+        for (auto *pClient : clients) {
+            pClient->abort();
+        }
+    }
+
+    // 接続しているクライアントへメッセージを配信する
+    void send(const QString &message)
+    {
+        for (auto *pClient : std::as_const(m_Clients)) {
+            pClient->sendTextMessage(message);
+        }
+    }
+
+    // 接続しているクライアントへP2P地震情報の形式 ("_id"キーを持つオブジェクト) のメッセージを配信する
+    void send(int code, const QString &id)
+    {
+        QJsonObject object;
+        object["_id"]  = id;
+        object["code"] = code;
+        object["time"] = QStringLiteral("2024/01/01 16:10:09.123");
+
+        send(QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact)));
+    }
+
+    [[nodiscard]] QUrl url() const
+    {
+        return QUrl(QString("ws://127.0.0.1:%1/").arg(m_Port));
+    }
+
+signals:
+    void clientConnected();     // クライアントが接続した場合
+};
+
+
+class P2PWebSocketTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    std::unique_ptr<P2PStandIn>     m_pStandIn;     // P2P地震情報のWebSocket APIのスタンドイン
+    std::unique_ptr<P2PWebSocket>   m_pSocket;      // テスト対象のオブジェクト
+
+    static constexpr int            ConnectTimeout   = 5000;    // 接続を待機する時間 [mS]
+    static constexpr int            ReceiveTimeout   = 5000;    // メッセージの受信を待機する時間 [mS]
+    static constexpr int            ReconnectTimeout = 10000;   // 再接続を待機する時間 [mS] (再接続の待機時間の最小値は1[秒]、最大で25[%]ずれる)
+
+private:
+    // 受信したメッセージのうち、index番目のメッセージの地震情報のIDを取得する
+    static QString ReceivedID(const QSignalSpy &spy, int index)
+    {
+        const auto array = QJsonDocument::fromJson(spy.at(index).at(1).toByteArray()).array();
+
+        return array.size() == 1 ? array.first().toObject().value("id").toString() : QString();
+    }
+
+private slots:
+    void init();
+    void cleanup();
+
+    void relaysEarthquakeMessages();
+    void ignoresOtherCodes();
+    void ignoresMalformedMessages();
+    void dropsReplayedMessages();
+    void reconnectsAfterDisconnect();
+    void reconnectsAfterServerRestart();
+};
+
+
+// 各テストの前に、スタンドインを起動して接続する
+void P2PWebSocketTest::init()
+{
+    m_pStandIn = std::make_unique<P2PStandIn>();
+    QVERIFY(m_pStandIn->listen());
+
+    QSignalSpy connectedSpy(m_pStandIn.get(), &P2PStandIn::clientConnected);
+
+    m_pSocket = std::make_unique<P2PWebSocket>(m_pStandIn->url());
+    m_pSocket->start();
+
+    QVERIFY(connectedSpy.wait(ConnectTimeout));
+}
+
+
+// 各テストの後に、接続を終了してスタンドインを停止する
+void P2PWebSocketTest::cleanup()
+{
+    m_pSocket.reset();
+    m_pStandIn.reset();
+}
+
+
+// 緊急地震速報(警報)および発生した地震情報は、JSON APIと同じ形式 (1件のみの配列、"id"キー) に変換して通知する
+void P2PWebSocketTest::relaysEarthquakeMessages()
+{
+    QSignalSpy receivedSpy(m_pSocket.get(), &P2PWebSocket::messageReceived);
+
+    m_pStandIn->send(556, QStringLiteral("alert-1"));
+    QVERIFY(receivedSpy.wait(ReceiveTimeout));
+
+    m_pStandIn->send(551, QStringLiteral("info-1"));
+    QTRY_COMPARE_WITH_TIMEOUT(receivedSpy.count(), 2, ReceiveTimeout);
+
+    QCOMPARE(receivedSpy.at(0).at(0).toInt(), 556);
+    QCOMPARE(ReceivedID(receivedSpy, 0), QStringLiteral("alert-1"));
+    QCOMPARE(receivedSpy.at(1).at(0).toInt(), 551);
+    QCOMPARE(ReceivedID(receivedSpy, 1), QStringLiteral("info-1"));
+    QCOMPARE(m_pSocket->GetReceived(), qint64(2));
+}
+
+
+// 緊急地震速報(警報)および発生した地震情報以外の情報 (津波予報、緊急地震速報の発表検出等) は通知しない
+void P2PWebSocketTest::ignoresOtherCodes()
+{
+    QSignalSpy receivedSpy(m_pSocket.get(), &P2PWebSocket::messageReceived);
+
+    // 同じ接続のメッセージは配信した順に受信するため、最後に配信した地震情報を受信した時点で、それ以前のメッセージも処理済みである
+    m_pStandIn->send(552, QStringLiteral("tsunami-1"));
+    m_pStandIn->send(554, QStringLiteral("detection-1"));
+    m_pStandIn->send(551, QStringLiteral("info-1"));
+    QVERIFY(receivedSpy.wait(ReceiveTimeout));
+
+    QTest::qWait(100);
+    QCOMPARE(receivedSpy.count(), 1);
+    QCOMPARE(ReceivedID(receivedSpy, 0), QStringLiteral("info-1"));
+}
+
+
+// 不正なJSON、および、IDが無いメッセージは破棄して、以降のメッセージは受信を続ける
+void P2PWebSocketTest::ignoresMalformedMessages()
+{
+    QSignalSpy receivedSpy(m_pSocket.get(), &P2PWebSocket::messageReceived);
+
+    m_pStandIn->send(QStringLiteral("{\"code\": 551, \"_id\": "));
+    m_pStandIn->send(QStringLiteral("[551]"));
+    m_pStandIn->send(551, QString());
+    m_pStandIn->send(551, QStringLiteral("info-1"));
+    QVERIFY(receivedSpy.wait(ReceiveTimeout));
+
+    QTest::qWait(100);
+    QCOMPARE(receivedSpy.count(), 1);
+    QCOMPARE(ReceivedID(receivedSpy, 0), QStringLiteral("info-1"));
+}
+
+
+// 同じ地震情報が複数回配信された場合は、最初の1回のみ通知する
+void P2PWebSocketTest::dropsReplayedMessages()
+{
+    QSignalSpy receivedSpy(m_pSocket.get(), &P2PWebSocket::messageReceived);
+
+    m_pStandIn->send(556, QStringLiteral("alert-1"));
+    m_pStandIn->send(556, QStringLiteral("alert-1"));
+    m_pStandIn->send(551, QStringLiteral("info-1"));
+    m_pStandIn->send(556, QStringLiteral("alert-1"));
+    m_pStandIn->send(551, QStringLiteral("info-2"));
+    QTRY_COMPARE_WITH_TIMEOUT(receivedSpy.count(), 3, ReceiveTimeout);
+
+    QTest::qWait(100);
+    QCOMPARE(receivedSpy.count(), 3);
+    QCOMPARE(ReceivedID(receivedSpy, 0), QStringLiteral("alert-1"));
+    QCOMPARE(ReceivedID(receivedSpy, 1), QStringLiteral("info-1"));
+    QCOMPARE(ReceivedID(receivedSpy, 2), QStringLiteral("info-2"));
+    QCOMPARE(m_pSocket->GetDuplicates(), qint64(2));
+}
+
+
+// サーバから切断された場合は、待機時間の経過後に再接続して、reconnectedシグナルを送信する
+// 再接続後も、切断前に受信した地震情報は重複として破棄する
+void P2PWebSocketTest::reconnectsAfterDisconnect()
+{
+    QSignalSpy receivedSpy(m_pSocket.get(), &P2PWebSocket::messageReceived);
+    QSignalSpy reconnectedSpy(m_pSocket.get(), &P2PWebSocket::reconnected);
+    QSignalSpy connectedSpy(m_pStandIn.get(), &P2PStandIn::clientConnected);
+
+    m_pStandIn->send(556, QStringLiteral("alert-1"));
+    QVERIFY(receivedSpy.wait(ReceiveTimeout));
+
+    m_pStandIn->dropClients();
+    QVERIFY(reconnectedSpy.wait(ReconnectTimeout));
+    QTRY_COMPARE_WITH_TIMEOUT(connectedSpy.count(), 1, ConnectTimeout);
+    QCOMPARE(m_pSocket->GetReconnects(), qint64(1));
+
+    m_pStandIn->send(556, QStringLiteral("alert-1"));
+    m_pStandIn->send(556, QStringLiteral("alert-2"));
+    QTRY_COMPARE_WITH_TIMEOUT(receivedSpy.count(), 2, ReceiveTimeout);
+
+    QCOMPARE(ReceivedID(receivedSpy, 1), QStringLiteral("alert-2"));
+    QCOMPARE(m_pSocket->GetDuplicates(), qint64(1));
+}
+
+
+// サーバが停止している間は再接続を繰り返して、サーバの再起動後に再接続する
+void P2PWebSocketTest::reconnectsAfterServerRestart()
+{
+    QSignalSpy reconnectedSpy(m_pSocket.get(), &P2PWebSocket::reconnected);
+
+    m_pStandIn->shutdown();
+
+    // 最初の再接続 (約1[秒]後) は失敗させて、待機時間を延ばした後の再接続で接続する
+    QTest::qWait(1500);
+    QCOMPARE(reconnectedSpy.count(), 0);
+
+    QVERIFY(m_pStandIn->listen());
+    QVERIFY(reconnectedSpy.wait(ReconnectTimeout));
+    QCOMPARE(m_pSocket->GetReconnects(), qint64(1));
+}
+
+
+QTEST_GUILESS_MAIN(P2PWebSocketTest)
+
+#include "P2PWebSocketTest.moc"
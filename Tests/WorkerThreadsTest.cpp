@@ -0,0 +1,425 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QUrlQuery>
+#include <QThreadPool>
+#include <memory>
+#include "EarthQuake.h"
+#include "EventStore.h"
+#include "HtmlParser.h"
+#include "XPathCache.h"
+
+
+// 掲示板および震度画像の検索ページの代わりとなるローカルのHTTPサーバ (スタンドイン)
+// 掲示板 (BbsPath) は、GETリクエストにはクッキーを返して、POSTリクエストは受信したスレッドのタイトルを通知する
+// 地震情報一覧のページ (ListPath) は、StallTime[mS]掛けて少しずつ応答して、発生した地震情報の処理を停止させる
+// (少しずつ応答するため、転送のタイムアウトは発生しない)
+class HttpStandIn : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr char   BbsPath[]       = "/test/bbs.cgi";  // 掲示板の書き込み用URLのパス
+    static constexpr char   ListPath[]      = "/eqlist";        // 地震情報一覧のページのパス
+    static constexpr int    StallTime       = 5000;             // 地震情報一覧のページの応答に掛ける時間 [mS]
+    static constexpr int    TrickleInterval = 500;              // 地震情報一覧のページを少しずつ応答する間隔 [mS]
+
+private:
+    QTcpServer                      m_Server;           // HTTPサーバ
+    QHash<QTcpSocket*, QByteArray>  m_Buffers;          // 接続ごとの受信途中のリクエスト
+    int                             m_Stalls = 0;       // 応答中の地震情報一覧のページの数
+
+private:
+    // 受信したデータからリクエストを取り出して応答する
+    // 1つの接続で複数のリクエストを受信する場合 (Keep-Alive接続) は、受信した順に応答する
+    void onReadyRead(QTcpSocket *pSocket)
+    {
+        auto &buffer = m_Buffers[pSocket];
+        buffer += pSocket->readAll();
+
+        while (true) {
+            const auto headerEnd = buffer.indexOf("\r\n\r\n");
+            if (headerEnd < 0) return;
+
+            const auto lines       = buffer.left(headerEnd).split('\n');
+            const auto requestLine = lines.first().trimmed().split(' ');
+            if (requestLine.size() < 2) return;
+
+            qint64 contentLength = 0;
+            for (const auto &line : lines.mid(1)) {
+                const auto separator = line.indexOf(':');
+                if (separator > 0 && line.left(separator).trimmed().toLower() == "content-length") {
+                    contentLength = line.mid(separator + 1).trimmed().toLongLong();
+                }
+            }
+
+            const auto requestSize = headerEnd + 4 + contentLength;
+            if (buffer.size() < requestSize) return;
+
+            const auto method = requestLine.at(0);
+            const auto path   = QUrl(QString::fromLatin1(requestLine.at(1))).path();
+            const auto body   = buffer.mid(headerEnd + 4, contentLength);
+            buffer.remove(0, requestSize);
+
+            Respond(pSocket, method, path, body);
+        }
+    }
+
+    // リクエストに応答する
+    void Respond(QTcpSocket *pSocket, const QByteArray &method, const QString &path, const QByteArray &body)
+    {
+        if (path == QLatin1String(BbsPath)) {
+            if (method == "POST") {
+                // POSTデータはUTF-8でURLエンコードされている (Shift-JISを無効にしている)
+                const QUrlQuery query(QString::fromUtf8(body));
+                emit posted(query.queryItemValue(QStringLiteral("subject"), QUrl::FullyDecoded), m_Stalls > 0);
+
+                Write(pSocket, "200 OK", QByteArray(), "<html><head><title>書きこみました。</title></head><body></body></html>");
+            }
+            else {
+                Write(pSocket, "200 OK", "Set-Cookie: standin=1; Path=/\r\n", "<html><head><title>掲示板</title></head><body></body></html>");
+            }
+
+            return;
+        }
+
+        if (path == QLatin1String(ListPath)) {
+            Stall(pSocket);
+            return;
+        }
+
+        Write(pSocket, "404 Not Found", QByteArray(), QByteArray());
+    }
+
+    // 地震情報一覧のページをStallTime[mS]掛けて、TrickleInterval[mS]ごとに1バイトずつ応答する
+    void Stall(QTcpSocket *pSocket)
+    {
+        const auto ticks = StallTime / TrickleInterval;
+        const auto page  = QByteArray(ticks - 1, ' ') + QByteArray("<html><head><title>地震情報</title></head><body><table></table></body></html>");
+
+        WriteHeader(pSocket, "200 OK", QByteArray(), page.size());
+
+        m_Stalls++;
+        emit stallStarted();
+
+        // タイマは接続の子オブジェクトとして生成するため、クライアントが切断した場合は接続と共に破棄される
+        auto pTimer = new QTimer(pSocket);
+        auto pTicks = std::make_shared<int>(0);
+        connect(pTimer, &QTimer::timeout, this, [this, pSocket, pTimer, pTicks, page, ticks]() {
+            if (++(*pTicks) < ticks) {
+                pSocket->write(page.mid(*pTicks - 1, 1));
+                return;
+            }
+
+            pSocket->write(page.mid(ticks - 1));
+            pTimer->stop();
+            pTimer->deleteLater();
+
+            m_Stalls--;
+            emit stallFinished();
+        });
+        connect(pTimer, &QObject::destroyed, this, [this, pTicks, ticks]() {
+            // 応答の途中で切断された場合
+            if (*pTicks < ticks) m_Stalls--;
+        });
+
+        pTimer->start(TrickleInterval);
+    }
+
+    static void WriteHeader(QTcpSocket *pSocket, const QByteArray &status, const QByteArray &headers, qint64 contentLength)
+    {
+        pSocket->write("HTTP/1.1 " + status + "\r\n"
+                       "Content-Type: text/html; charset=UTF-8\r\n"
+                       "Content-Length: " + QByteArray::number(contentLength) + "\r\n"
+                       "Connection: keep-alive\r\n" +
+                       headers +
+                       "\r\n");
+    }
+
+    static void Write(QTcpSocket *pSocket, const QByteArray &status, const QByteArray &headers, const QByteArray &body)
+    {
+        WriteHeader(pSocket, status, headers, body.size());
+        pSocket->write(body);
+    }
+
+public:
+    explicit HttpStandIn(QObject *parent = nullptr) : QObject{parent}
+    {
+        connect(&m_Server, &QTcpServer::newConnection, this, [this]() {
+            while (m_Server.hasPendingConnections()) {
+                auto pSocket = m_Server.nextPendingConnection();
+
+                connect(pSocket, &QTcpSocket::readyRead, this, [this, pSocket]() {
+                    onReadyRead(pSocket);
+                });
+                connect(pSocket, &QTcpSocket::disconnected, this, [this, pSocket]() {
+                    m_Buffers.remove(pSocket);
+                    pSocket->deleteLater();
+                });
+            }
+        });
+    }
+
+    bool listen()
+    {
+        return m_Server.listen(QHostAddress::LocalHost, 0);
+    }
+
+    [[nodiscard]] QString url(const QString &path) const
+    {
+        return QString("http://127.0.0.1:%1%2").arg(m_Server.serverPort()).arg(path);
+    }
+
+signals:
+    void posted(const QString &subject, bool bStalled);    // POSTリクエストを受信した場合 (bStalled : 地震情報一覧のページを応答中かどうか)
+    void stallStarted();                                    // 地震情報一覧のページの応答を開始した場合
+    void stallFinished();                                   // 地震情報一覧のページの応答を完了した場合
+};
+
+
+// 緊急地震速報(警報)と発生した地震情報を、それぞれ専用のスレッドで処理するテスト
+// 発生した地震情報の処理 (震度画像の検索) を5[秒]停止させても、緊急地震速報(警報)の書き込みまでの時間が変わらないことを確認する
+class WorkerThreadsTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    HttpStandIn                 m_StandIn;          // 掲示板および地震情報一覧のページのスタンドイン
+    QTemporaryDir               m_TempDir;          // ログファイルを作成する一時ディレクトリ
+    std::unique_ptr<EarthQuake> m_pEarthQuake;      // テスト対象のオブジェクト
+
+    static constexpr char       AlertHypocenter[] = "スタンドイン沖";       // 緊急地震速報(警報)の震源地 (書き込みの識別に使用する)
+    static constexpr char       InfoHypocenter[]  = "スタンドイン内陸";     // 発生した地震情報の震源地
+    static constexpr int        PostTimeout   = 10000;  // 書き込みを待機する時間 [mS]
+    static constexpr int        LatencyMargin = 1000;   // 停止させない場合の書き込みまでの時間に対して許容する遅延 [mS]
+
+private:
+    static QByteArray   AlertMessage(const QString &id);    // P2P地震情報の緊急地震速報(警報)のデータを作成する
+    static QByteArray   InfoMessage(const QString &id);     // P2P地震情報の発生した地震情報のデータを作成する
+    static bool         CreateLogFile(const QString &path); // 空のログファイルを作成する
+    qint64              MeasureAlertLatency(const QString &id, bool &bStalled);    // 緊急地震速報(警報)の処理の開始から書き込みを受信するまでの時間 [mS] を計測する
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void alertLatencyIgnoresStalledInfo();
+};
+
+
+// P2P地震情報の緊急地震速報(警報)のデータを作成する (JSON APIと同じ1件のみの配列)
+// 30[秒]以内に発表された緊急地震速報(警報)のみ処理されるため、発表時刻は現在時刻とする
+QByteArray WorkerThreadsTest::AlertMessage(const QString &id)
+{
+    const auto now = QDateTime::currentDateTime().toString("yyyy/MM/dd HH:mm:ss");
+
+    QJsonObject hypocenter;
+    hypocenter["name"]      = QString::fromUtf8(AlertHypocenter);
+    hypocenter["magnitude"] = 6.5;
+    hypocenter["depth"]     = 10;
+    hypocenter["latitude"]  = 35.0;
+    hypocenter["longitude"] = 140.0;
+
+    QJsonObject earthquake;
+    earthquake["originTime"]  = now;
+    earthquake["arrivalTime"] = now;
+    earthquake["hypocenter"]  = hypocenter;
+
+    QJsonObject area;
+    area["kindCode"]    = QStringLiteral("10");
+    area["name"]        = QStringLiteral("スタンドイン地方");
+    area["scaleFrom"]   = 45;
+    area["scaleTo"]     = 50;
+    area["arrivalTime"] = now;
+
+    QJsonObject alert;
+    alert["id"]         = id;
+    alert["code"]       = 556;
+    alert["issue"]      = QJsonObject{{"time", now}};
+    alert["earthquake"] = earthquake;
+    alert["areas"]      = QJsonArray{area};
+
+    return QJsonDocument(QJsonArray{alert}).toJson(QJsonDocument::Compact);
+}
+
+
+// P2P地震情報の発生した地震情報のデータを作成する (JSON APIと同じ1件のみの配列)
+// 10[分]以内に報告された地震情報のみ処理されるため、報告時刻は現在時刻とする
+QByteArray WorkerThreadsTest::InfoMessage(const QString &id)
+{
+    const auto now = QDateTime::currentDateTime();
+
+    QJsonObject hypocenter;
+    hypocenter["name"]      = QString::fromUtf8(InfoHypocenter);
+    hypocenter["magnitude"] = 5.0;
+    hypocenter["depth"]     = 10;
+    hypocenter["latitude"]  = 36.0;
+    hypocenter["longitude"] = 139.0;
+
+    QJsonObject earthquake;
+    earthquake["time"]            = now.toString("yyyy/MM/dd HH:mm:ss");
+    earthquake["maxScale"]        = 45;
+    earthquake["domesticTsunami"] = QStringLiteral("None");
+    earthquake["foreignTsunami"]  = QStringLiteral("Unknown");
+    earthquake["hypocenter"]      = hypocenter;
+
+    QJsonObject point;
+    point["addr"]   = QStringLiteral("スタンドイン市");
+    point["pref"]   = QStringLiteral("スタンドイン県");
+    point["scale"]  = 45;
+    point["isArea"] = false;
+
+    QJsonObject info;
+    info["id"]         = id;
+    info["code"]       = 551;
+    info["time"]       = now.toString(Qt::ISODate);
+    info["earthquake"] = earthquake;
+    info["points"]     = QJsonArray{point};
+
+    return QJsonDocument(QJsonArray{info}).toJson(QJsonDocument::Compact);
+}
+
+
+// 空のログファイル (空のJSON配列) を作成する
+bool WorkerThreadsTest::CreateLogFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    return file.write("[]\n") > 0;
+}
+
+
+// 緊急地震速報(警報)の処理の開始から、スタンドインが書き込み (POSTリクエスト) を受信するまでの時間 [mS] を計測する
+// 発生した地震情報の書き込みと区別するため、スレッドのタイトルに緊急地震速報(警報)の震源地を含む書き込みのみ計測する
+// bStalledには、書き込みの受信時に地震情報一覧のページを応答中だったかどうかを格納する
+// 書き込みを受信できなかった場合は-1を返す
+qint64 WorkerThreadsTest::MeasureAlertLatency(const QString &id, bool &bStalled)
+{
+    qint64        latency = -1;
+    QElapsedTimer timer;
+
+    auto connection = connect(&m_StandIn, &HttpStandIn::posted, this, [&](const QString &subject, bool bStalledAtPost) {
+        if (latency >= 0 || !subject.contains(QString::fromUtf8(AlertHypocenter))) return;
+
+        latency  = timer.elapsed();
+        bStalled = bStalledAtPost;
+    });
+
+    timer.start();
+    if (m_pEarthQuake->EQProcessAlert(AlertMessage(id)) == 0) {
+        QTest::qWaitFor([&latency]() { return latency >= 0; }, PostTimeout);
+    }
+
+    disconnect(connection);
+
+    return latency;
+}
+
+
+void WorkerThreadsTest::initTestCase()
+{
+    QVERIFY(m_TempDir.isValid());
+    QVERIFY(m_StandIn.listen());
+
+    HtmlParser::initialize();
+
+    // 掲示板
+    BOARDCONFIG board;
+    board.RequestURL          = m_StandIn.url(QLatin1String(HttpStandIn::BbsPath));
+    board.ThreadInfo.bbs      = QStringLiteral("standin");
+    board.ThreadInfo.shiftjis = false;
+    board.AlertFile           = m_TempDir.filePath(QStringLiteral("alert.json"));
+    board.InfoFile            = m_TempDir.filePath(QStringLiteral("info.json"));
+    board.MaxReplies          = 0;
+
+    QVERIFY(CreateLogFile(board.AlertFile));
+    QVERIFY(CreateLogFile(board.InfoFile));
+
+    // 緊急地震速報(警報)および発生した地震情報は、WebSocket APIから受信したデータとして渡すため、取得用のURLには接続しない
+    COMMONDATA data {};
+    data.iGetInfo       = 1;
+    data.AlertScale     = 0;
+    data.InfoScale      = 0;
+    data.ExpiredXPath   = QStringLiteral("/html/head/title");
+    data.bStreamParser  = true;
+    data.DeadlineBudget = 20000;
+
+    // 震度画像の検索 (地震情報一覧のページの取得) で、発生した地震情報の処理を停止させる
+    EQIMAGEINFO imageInfo {};
+    imageInfo.bEnable     = true;
+    imageInfo.BaseUrl     = m_StandIn.url(QString());
+    imageInfo.Url         = QUrl(m_StandIn.url(QLatin1String(HttpStandIn::ListPath)));
+    imageInfo.DateFormat  = QStringLiteral("yyyy年M月d日 H時m分");
+    imageInfo.ListXPath   = QStringLiteral("//table");
+    imageInfo.DetailXPath = QStringLiteral(".//tr");
+    imageInfo.UrlXPath    = QStringLiteral(".//a/@href");
+    imageInfo.ImgXPath    = QStringLiteral("//img/@src");
+
+    m_pEarthQuake = std::make_unique<EarthQuake>(data, QList<BOARDCONFIG>{board}, imageInfo,
+                                                 true, m_StandIn.url(QStringLiteral("/alert")),
+                                                 true, m_StandIn.url(QStringLiteral("/info")));
+}
+
+
+void WorkerThreadsTest::cleanupTestCase()
+{
+    // 各地震情報オブジェクトのスレッドを終了してから、共用のオブジェクトを破棄する
+    m_pEarthQuake.reset();
+
+    QThreadPool::globalInstance()->waitForDone();
+    EventStore::cleanup();
+    XPathCache::clear();
+    HtmlParser::cleanup();
+}
+
+
+// 発生した地震情報の処理を5[秒]停止させている間も、緊急地震速報(警報)の書き込みまでの時間が変わらないことを確認する
+void WorkerThreadsTest::alertLatencyIgnoresStalledInfo()
+{
+    bool bStalled = false;
+
+    // 最初の処理は、スレッドの生成および掲示板との接続を含むため計測しない
+    QVERIFY(MeasureAlertLatency(QStringLiteral("alert-0"), bStalled) >= 0);
+
+    // 基準 : 発生した地震情報を処理していない場合の書き込みまでの時間
+    const auto baseline = MeasureAlertLatency(QStringLiteral("alert-1"), bStalled);
+    QVERIFY(baseline >= 0);
+    QVERIFY(!bStalled);
+
+    // 発生した地震情報の処理を開始して、震度画像の検索で停止させる
+    QSignalSpy stallSpy(&m_StandIn, &HttpStandIn::stallStarted);
+    QCOMPARE(m_pEarthQuake->EQProcessInfo(InfoMessage(QStringLiteral("info-1"))), 0);
+    QVERIFY(stallSpy.wait(PostTimeout));
+
+    // 停止中の緊急地震速報(警報)の書き込みまでの時間
+    const auto stalled = MeasureAlertLatency(QStringLiteral("alert-2"), bStalled);
+    QVERIFY(stalled >= 0);
+
+    // 発生した地震情報の処理が停止している間に書き込まれており、書き込みまでの時間は停止させない場合と同等である
+    QVERIFY2(bStalled, "緊急地震速報(警報)の書き込みが、発生した地震情報の処理の停止が終了するまで遅延しました");
+    QVERIFY2(stalled <= baseline + LatencyMargin,
+             qPrintable(QString("停止させない場合 : %1[mS], 停止中 : %2[mS]").arg(baseline).arg(stalled)));
+
+    qInfo().noquote() << QString("緊急地震速報(警報)の書き込みまでの時間 : 停止させない場合 %1[mS], 発生した地震情報の処理を%2[mS]停止中 %3[mS]")
+                         .arg(baseline).arg(HttpStandIn::StallTime).arg(stalled);
+}
+
+
+// P2P地震情報の日時は日本時間であるため、テストを実行するシステムのタイムゾーンに関わらず日本時間を使用する
+// (タイムゾーンは、QCoreApplicationを生成する前に設定する)
+int main(int argc, char *argv[])
+{
+    qputenv("TZ", "Asia/Tokyo");
+
+    QCoreApplication app(argc, argv);
+    WorkerThreadsTest test;
+
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "WorkerThreadsTest.moc"
@@ -0,0 +1,275 @@
+#include <QtGlobal>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    #include <QStringDecoder>
+#else
+    #include <QTextCodec>
+#endif
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QNetworkReply>
+#include <QRegularExpression>
+#include <iostream>
+#include "ThreadCache.h"
+#include "NetworkAccess.h"
+
+
+QMutex                          ThreadCache::s_Mutex;
+QHash<QString, BOARDSUBJECTS>   ThreadCache::s_Boards;
+int                             ThreadCache::s_TTL = 60;
+std::atomic<qint64>             ThreadCache::s_Hits(0);
+std::atomic<qint64>             ThreadCache::s_Fetches(0);
+std::atomic<qint64>             ThreadCache::s_Unavailable(0);
+
+
+// スレッド一覧の有効期間を変更する
+// 設定ファイルの読み込み時 (各スレッドの開始前) に呼び出すこと
+void ThreadCache::setTTL(int seconds)
+{
+    s_TTL = seconds;
+}
+
+
+// スレッドのURLからsubject.txtのURLおよびスレッド番号を取得する
+// スレッドのURLの形式 : <スキーム>://<ホスト名>/<ディレクトリ名>/test/read.cgi/<BBS名>/<スレッド番号>/
+// subject.txtのURLの形式 : <スキーム>://<ホスト名>/<ディレクトリ名>/<BBS名>/subject.txt
+bool ThreadCache::SubjectURL(const QUrl &threadURL, QUrl &subjectURL, QString &key)
+{
+    static const QRegularExpression RegEx("^(.*)/test/read\\.cgi/([^/]+)/(\\d+)");
+
+    auto match = RegEx.match(threadURL.path());
+    if (!match.hasMatch()) return false;
+
+    subjectURL = threadURL;
+    subjectURL.setPath(QString("%1/%2/subject.txt").arg(match.captured(1), match.captured(2)));
+    subjectURL.setQuery(QString());
+    subjectURL.setFragment(QString());
+
+    key = match.captured(3);
+
+    return true;
+}
+
+
+// スレッドが生存しているかどうかを確認して、タイトルを取得する
+// スレッド一覧が有効期間内の場合は、ネットワークにアクセスせずに確認して、直ちにcallbackを呼び出す
+// 有効期間を過ぎている場合は、subject.txtを1度だけ取得して、同じ掲示板の全てのスレッドの確認に使用する
+void ThreadCache::lookup(const QUrl &threadURL, bool bShiftJIS, QObject *pContext, const std::function<void(int, const QString&)> &callback)
+{
+    QUrl    subjectURL;
+    QString key;
+
+    if (s_TTL <= 0 || !SubjectURL(threadURL, subjectURL, key)) {
+        s_Unavailable++;
+        callback(-1, QString());
+
+        return;
+    }
+
+    const auto boardName = subjectURL.toString();
+    const auto now       = std::chrono::steady_clock::now();
+
+    BOARDSUBJECTS board;
+    bool          bCached = false;
+    {
+        QMutexLocker locker(&s_Mutex);
+
+        auto it = s_Boards.constFind(boardName);
+        if (it != s_Boards.constEnd() && now - it->Fetched < std::chrono::seconds(s_TTL)) {
+            board   = it.value();
+            bCached = true;
+        }
+    }
+
+    // 取得済みのスレッド一覧に記載されていない場合、スレッド番号 (スレッドを作成したエポックタイム) が一覧の取得時刻以降の場合のみ、
+    // 一覧の取得後に作成されたスレッドの可能性があるため、再取得して確認する
+    // それ以外の場合は、落ちたスレッドとして有効期間内は再取得しない (落ちたスレッドの確認ごとに再取得しない)
+    if (bCached && board.bAvailable && !board.Titles.contains(key) && board.FetchedEpoch <= key.toLongLong()) bCached = false;
+
+    if (bCached) {
+        s_Hits++;
+
+        QString title;
+        auto    iRet = Find(board, key, title);
+        callback(iRet, title);
+
+        return;
+    }
+
+    // subject.txtの取得中はミューテックスを保持しない
+    // 取得に失敗した場合も有効期間内は再取得せずに、各スレッドを個別に確認する
+    Fetch(subjectURL, bShiftJIS, pContext, [boardName, key, callback](const BOARDSUBJECTS &fetched) {
+        auto board         = fetched;
+        board.Fetched      = std::chrono::steady_clock::now();
+        board.FetchedEpoch = QDateTime::currentSecsSinceEpoch();
+        {
+            QMutexLocker locker(&s_Mutex);
+            s_Boards.insert(boardName, board);
+        }
+
+        QString title;
+        auto    iRet = Find(board, key, title);
+        callback(iRet, title);
+    });
+}
+
+
+// スレッド一覧からスレッドを検索して、生存している場合はタイトルを取得する
+int ThreadCache::Find(const BOARDSUBJECTS &board, const QString &key, QString &title)
+{
+    if (!board.bAvailable) {
+        s_Unavailable++;
+        return -1;
+    }
+
+    auto it = board.Titles.constFind(key);
+    if (it == board.Titles.constEnd()) {
+        // 最新のsubject.txtに記載されていない場合は、スレッドが落ちている
+        return 0;
+    }
+
+    title = it.value();
+
+    return 1;
+}
+
+
+// スレッドを新規作成した場合に、取得済みのスレッド一覧へ追加する
+// 次回の確認時に、作成したスレッドをsubject.txtの再取得なしで生存していると判断する
+void ThreadCache::insert(const QUrl &threadURL, const QString &title)
+{
+    QUrl    subjectURL;
+    QString key;
+    if (!SubjectURL(threadURL, subjectURL, key)) return;
+
+    QMutexLocker locker(&s_Mutex);
+
+    auto it = s_Boards.find(subjectURL.toString());
+    if (it == s_Boards.end() || !it->bAvailable) return;
+
+    it->Titles.insert(key, title);
+}
+
+
+// スレッドが存在する掲示板のスレッド一覧を破棄する
+// スレッドに書き込んだ場合 (タイトルを変更した場合) および書き込みに失敗した場合に呼び出す
+void ThreadCache::invalidate(const QUrl &threadURL)
+{
+    QUrl    subjectURL;
+    QString key;
+    if (!SubjectURL(threadURL, subjectURL, key)) return;
+
+    QMutexLocker locker(&s_Mutex);
+    s_Boards.remove(subjectURL.toString());
+}
+
+
+// subject.txtを取得してスレッド一覧を作成する
+// レスポンスの受信時に、pContextのスレッドで作成したスレッド一覧をcallbackへ渡す (取得に失敗した場合は、使用できないスレッド一覧を渡す)
+// リクエストは共用のHTTPクライアントで送信するため、NetworkAccess::abortAll()メソッドで中断できる
+void ThreadCache::Fetch(const QUrl &subjectURL, bool bShiftJIS, QObject *pContext, const std::function<void(const BOARDSUBJECTS&)> &callback)
+{
+    auto request = NetworkAccess::createRequest(subjectURL, FetchTimeout);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
+
+    auto pReply = NetworkAccess::manager()->get(request);
+
+    // pContextが破棄された場合もリクエストを破棄する
+    QObject::connect(pReply, &QNetworkReply::finished, pReply, &QObject::deleteLater);
+    QObject::connect(pReply, &QNetworkReply::finished, pContext, [pReply, bShiftJIS, callback]() {
+        s_Fetches++;
+
+        BOARDSUBJECTS board;
+
+        if (pReply->error() != QNetworkReply::NoError) {
+            std::cerr << QString("エラー : スレッド一覧 (subject.txt) の取得に失敗 %1").arg(pReply->errorString()).toStdString() << std::endl;
+        }
+        else {
+            Parse(pReply->readAll(), bShiftJIS, board);
+        }
+
+        callback(board);
+    });
+}
+
+
+// subject.txtの内容からスレッド一覧を作成する
+bool ThreadCache::Parse(const QByteArray &data, bool bShiftJIS, BOARDSUBJECTS &board)
+{
+    board.Titles.clear();
+    board.bAvailable = false;
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QString text;
+    if (bShiftJIS) {
+        QStringDecoder decoder("Shift-JIS");
+        text = decoder(data);
+    }
+    else {
+        text = QString::fromUtf8(data);
+    }
+#else
+    const auto text = bShiftJIS ? QTextCodec::codecForName("Shift-JIS")->toUnicode(data) : QString::fromUtf8(data);
+#endif
+
+    // 各行からスレッド番号およびタイトル (末尾のレス数を除く) を取得する
+    static const QRegularExpression RegExLine("^(\\d+)\\.(?:dat|cgi)(?:<>|,)(.*?)\\s*\\(\\d+\\)\\s*$");
+
+    const auto lines = text.split('\n', Qt::SkipEmptyParts);
+    for (const auto &line : lines) {
+        auto match = RegExLine.match(line);
+        if (!match.hasMatch()) continue;
+
+        board.Titles.insert(match.captured(1), DecodeEntities(match.captured(2)));
+    }
+
+    // スレッドが1つも存在しない場合は、subject.txtの形式が異なる可能性があるため使用しない
+    board.bAvailable = !board.Titles.isEmpty();
+
+    return board.bAvailable;
+}
+
+
+// スレッドのタイトルの文字参照をデコードする
+// subject.txtのタイトルは文字参照でエスケープされているため、<title>タグから取得したタイトルと同じ形式に変換する
+QString ThreadCache::DecodeEntities(QString title)
+{
+    static const QRegularExpression RegExNumeric("&#(x?)([0-9A-Fa-f]+);");
+
+    auto it = RegExNumeric.globalMatch(title);
+    QString decoded;
+    qsizetype last = 0;
+    while (it.hasNext()) {
+        auto match = it.next();
+
+        bool ok;
+        const auto code = static_cast<char32_t>(match.captured(2).toUInt(&ok, match.captured(1).isEmpty() ? 10 : 16));
+        if (!ok) continue;
+
+        decoded += title.mid(last, match.capturedStart() - last);
+        decoded += QString::fromUcs4(&code, 1);
+        last = match.capturedEnd();
+    }
+
+    if (last != 0) {
+        decoded += title.mid(last);
+        title = decoded;
+    }
+
+    title.replace("&lt;", "<").replace("&gt;", ">").replace("&quot;", "\"").replace("&amp;", "&");
+
+    return title;
+}
+
+
+// スレッドの生存確認の統計を取得する
+THREADCACHESTATS ThreadCache::GetStats()
+{
+    THREADCACHESTATS stats;
+    stats.Hits        = s_Hits.load();
+    stats.Fetches     = s_Fetches.load();
+    stats.Unavailable = s_Unavailable.load();
+
+    return stats;
+}
@@ -0,0 +1,72 @@
+#ifndef THREADCACHE_H
+#define THREADCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QUrl>
+#include <QMutex>
+#include <QObject>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+
+// 掲示板ごとのスレッド一覧 (subject.txt)
+struct BOARDSUBJECTS {
+    QHash<QString, QString>                 Titles;             // スレッド番号ごとのスレッドのタイトル (生存しているスレッドのみ)
+    std::chrono::steady_clock::time_point   Fetched;            // subject.txtを取得した時刻
+    qint64                                  FetchedEpoch = 0;   // subject.txtを取得した時刻 (エポックタイム [秒]、スレッド番号との比較に使用する)
+    bool                                    bAvailable = false; // subject.txtを取得できたかどうか (falseの場合は、各スレッドを個別に確認する)
+};
+
+
+// スレッドの生存確認の統計
+struct THREADCACHESTATS {
+    qint64          Hits        = 0,    // 取得済みのスレッド一覧から確認した回数
+                    Fetches     = 0,    // subject.txtを取得した回数
+                    Unavailable = 0;    // subject.txtが使用できないため、スレッドを個別に確認した回数
+};
+
+
+// スレッドの生存確認に使用するスレッド一覧のキャッシュ
+// 0ch系の掲示板では、subject.txtに生存している全てのスレッドのスレッド番号およびタイトルが記載されている
+// そのため、掲示板ごとにsubject.txtを1度だけ取得して、有効期間 (TTL) 内は各スレッドのHTMLを取得せずに生存を確認する
+//
+// subject.txtの各行の形式 : <スレッド番号>.dat<><スレッドのタイトル> (<レス数>)
+class ThreadCache
+{
+private:    // Variables
+    static QMutex                               s_Mutex;        // キャッシュを保護するミューテックス
+    static QHash<QString, BOARDSUBJECTS>        s_Boards;       // subject.txtのURLごとのスレッド一覧
+    static int                                  s_TTL;          // スレッド一覧の有効期間 [秒] (0の場合はキャッシュを使用しない)
+    static std::atomic<qint64>                  s_Hits,         // 取得済みのスレッド一覧から確認した回数
+                                                s_Fetches,      // subject.txtを取得した回数
+                                                s_Unavailable;  // subject.txtが使用できないため、スレッドを個別に確認した回数
+
+    static constexpr int                        FetchTimeout = 5000;    // subject.txtを取得する場合のタイムアウト [mS]
+
+private:    // Methods
+    static bool     SubjectURL(const QUrl &threadURL, QUrl &subjectURL, QString &key);  // スレッドのURLからsubject.txtのURLおよびスレッド番号を取得する
+    static void     Fetch(const QUrl &subjectURL, bool bShiftJIS, QObject *pContext,    // subject.txtを取得してスレッド一覧を作成する (レスポンスを待機しない)
+                          const std::function<void(const BOARDSUBJECTS&)> &callback);
+    static bool     Parse(const QByteArray &data, bool bShiftJIS, BOARDSUBJECTS &board);    // subject.txtの内容からスレッド一覧を作成する
+    static int      Find(const BOARDSUBJECTS &board, const QString &key, QString &title);   // スレッド一覧からスレッドを検索する (lookup()メソッドと同じ戻り値)
+    static QString  DecodeEntities(QString title);                                      // スレッドのタイトルの文字参照をデコードする
+
+public:     // Methods
+    ThreadCache()                               = delete;
+    ThreadCache(const ThreadCache&)             = delete;
+    ThreadCache& operator=(const ThreadCache&)  = delete;
+
+    static void     setTTL(int seconds);                                                // スレッド一覧の有効期間を変更する
+    static void     lookup(const QUrl &threadURL, bool bShiftJIS, QObject *pContext,    // スレッドが生存しているかどうかを確認して、結果およびタイトルをcallbackへ渡す
+                           const std::function<void(int, const QString&)> &callback);   // 1 : 生存している, 0 : 生存していない, -1 : スレッド一覧が使用できない (個別に確認する)
+                                                                                        // 取得済みの一覧に記載されていない場合は、一覧の取得後に作成されたスレッドのみ再取得して確認する
+                                                                                        // subject.txtを取得する場合は、pContextのスレッドでレスポンスの受信時にcallbackを呼び出す
+    static void     insert(const QUrl &threadURL, const QString &title);                // 新規作成したスレッドを取得済みのスレッド一覧へ追加する
+    static void     invalidate(const QUrl &threadURL);                                  // スレッドが存在する掲示板のスレッド一覧を破棄する (次回の確認時に再取得する)
+    [[nodiscard]] static THREADCACHESTATS GetStats();                                   // スレッドの生存確認の統計を取得する
+};
+
+
+#endif // THREADCACHE_H
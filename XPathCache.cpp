@@ -0,0 +1,67 @@
+#include <QMutexLocker>
+#include <iostream>
+#include <utility>
+#include "XPathCache.h"
+
+
+QMutex                              XPathCache::s_Mutex;
+QHash<QString, xmlXPathCompExprPtr> XPathCache::s_Expressions;
+
+
+// XPath式をコンパイルしてキャッシュに登録する
+// 構文が不正な場合はfalseを返す
+bool XPathCache::compile(const QString &expression)
+{
+    return get(expression) != nullptr;
+}
+
+
+// コンパイル済みのXPath式を取得する
+// 未登録の場合はコンパイルしてキャッシュに登録する (構文が不正な場合はnullptrを返す)
+// 返されるオブジェクトの所有権はキャッシュが持つため、呼び出し元で解放してはならない
+xmlXPathCompExprPtr XPathCache::get(const QString &expression)
+{
+    QMutexLocker locker(&s_Mutex);
+
+    auto it = s_Expressions.constFind(expression);
+    if (it != s_Expressions.constEnd()) return it.value();
+
+    if (expression.isEmpty()) return nullptr;
+
+    auto comp = xmlXPathCompile(reinterpret_cast<const xmlChar*>(expression.toUtf8().constData()));
+    if (comp == nullptr) {
+        std::cerr << QString("エラー : XPath式のコンパイルに失敗しました - XPath式 : %1").arg(expression).toStdString() << std::endl;
+        return nullptr;
+    }
+
+    s_Expressions.insert(expression, comp);
+
+    return comp;
+}
+
+
+// コンパイル済みのXPath式を評価する
+// nodeを指定した場合は、そのノードを起点として評価する (xmlXPathNodeEval関数と同等)
+xmlXPathObjectPtr XPathCache::eval(const QString &expression, xmlXPathContextPtr context, xmlNodePtr node)
+{
+    auto comp = get(expression);
+    if (comp == nullptr || context == nullptr) return nullptr;
+
+    if (node != nullptr && xmlXPathSetContextNode(node, context) != 0) return nullptr;
+
+    return xmlXPathCompiledEval(comp, context);
+}
+
+
+// 全てのコンパイル済みのXPath式を破棄する
+// 他のスレッドがXPath式を評価していない状態 (アプリケーションの終了時) で呼び出すこと
+void XPathCache::clear()
+{
+    QMutexLocker locker(&s_Mutex);
+
+    for (auto comp : std::as_const(s_Expressions)) {
+        xmlXPathFreeCompExpr(comp);
+    }
+
+    s_Expressions.clear();
+}
@@ -0,0 +1,35 @@
+#ifndef XPATHCACHE_H
+#define XPATHCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <libxml/xpath.h>
+
+
+// コンパイル済みのXPath式を保持するキャッシュ
+// 設定ファイルのXPath式 (expiredxpath, eqlistxpath, eqdetailxpath, equrlxpath, imgxpath) は、
+// 設定ファイルの読み込み時に1度だけコンパイルして、以降は全てのスレッドで同じオブジェクトを使用する
+//
+// コンパイル済みのXPath式は評価時に変更されないため、複数のスレッドから同時に評価することができる
+// (評価時の状態は、スレッドごとに作成するXPathコンテキストに保持される)
+class XPathCache
+{
+private:    // Variables
+    static QMutex                               s_Mutex;            // キャッシュを保護するミューテックス
+    static QHash<QString, xmlXPathCompExprPtr>  s_Expressions;      // XPath式の文字列とコンパイル済みのXPath式
+
+public:     // Methods
+    XPathCache()                                = delete;
+    XPathCache(const XPathCache&)               = delete;
+    XPathCache& operator=(const XPathCache&)    = delete;
+
+    static bool                 compile(const QString &expression);                         // XPath式をコンパイルしてキャッシュに登録する
+    static xmlXPathCompExprPtr  get(const QString &expression);                             // コンパイル済みのXPath式を取得する (未登録の場合はコンパイルする)
+    static xmlXPathObjectPtr    eval(const QString &expression, xmlXPathContextPtr context, // コンパイル済みのXPath式を評価する
+                                     xmlNodePtr node = nullptr);                            // nodeを指定した場合は、そのノードを起点として評価する
+    static void                 clear();                                                    // 全てのコンパイル済みのXPath式を破棄する
+};
+
+
+#endif // XPATHCACHE_H
@@ -1,6 +1,10 @@
 #include <QCoreApplication>
 #include <QTimer>
+#include <QThreadPool>
 #include "Runner.h"
+#include "HtmlParser.h"
+#include "XPathCache.h"
+#include "EventStore.h"
 
 #if QT_VERSION > QT_VERSION_CHECK(6, 0, 0)
     #include <openssl/opensslv.h>
@@ -30,10 +34,30 @@ int main(int argc, char *argv[])
     app.setOrganizationDomain("Presire");
     app.setOrganizationName("Presire");
 
-    // ランナー開始
-    Runner runner(app, QCoreApplication::arguments());
-    QTimer::singleShot(0, &runner, &Runner::run);
+    // libxml2の初期化 (全てのスレッドで共用するため、アプリケーションの開始時に1度だけ行う)
+    HtmlParser::initialize();
 
-    // アプリケーションのイベントループを開始
-    return app.exec();
+    int ret = 0;
+    {
+        // ランナー開始
+        Runner runner(app, QCoreApplication::arguments());
+        QTimer::singleShot(0, &runner, &Runner::run);
+
+        // アプリケーションのイベントループを開始
+        ret = app.exec();
+    }
+
+    // ログファイルのコンパクションが実行中の場合は、終了を待機する
+    QThreadPool::globalInstance()->waitForDone();
+
+    // ログファイルのオブジェクトの破棄 (SQLite形式の場合は、メインスレッドのデータベースの接続も破棄する)
+    EventStore::cleanup();
+
+    // コンパイル済みのXPath式の破棄 (全てのワーカスレッドが終了した後に行う)
+    XPathCache::clear();
+
+    // libxml2の破棄 (アプリケーションの終了時に1度だけ行う)
+    HtmlParser::cleanup();
+
+    return ret;
 }